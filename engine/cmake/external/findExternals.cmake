@@ -19,4 +19,8 @@ include(findAssimp)
 
 if(BUILD_TESTS)
 	include(findGoogleTest)
+endif()
+
+if(BUILD_BENCHMARKS)
+	include(findGoogleBenchmark)
 endif()
\ No newline at end of file
@@ -0,0 +1,26 @@
+cmake_minimum_required(VERSION 3.27)
+include_guard()
+
+MESSAGE(STATUS "[Thirdparty] benchmark")
+
+#Only the library is needed, its own tests would pull in a second copy of googletest.
+set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_INSTALL_DOCS OFF CACHE BOOL "" FORCE)
+
+FetchContent_Declare(
+	googlebenchmark
+	GIT_REPOSITORY https://github.com/google/benchmark.git
+	GIT_TAG "v1.9.1"
+)
+FetchContent_MakeAvailable(googlebenchmark)
+
+
+mark_as_advanced(
+    BENCHMARK_ENABLE_TESTING BENCHMARK_ENABLE_GTEST_TESTS BENCHMARK_ENABLE_INSTALL BENCHMARK_INSTALL_DOCS
+    BENCHMARK_ENABLE_LTO BENCHMARK_USE_LIBCXX BENCHMARK_ENABLE_WERROR BENCHMARK_FORCE_WERROR
+)
+
+set_target_properties(benchmark PROPERTIES FOLDER "${THIRD_PARTY_FOLDER}/benchmark")
+set_target_properties(benchmark_main PROPERTIES FOLDER "${THIRD_PARTY_FOLDER}/benchmark")
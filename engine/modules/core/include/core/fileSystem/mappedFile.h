@@ -0,0 +1,56 @@
+#pragma once
+#include "core/containers/string.h"
+#include "core/valueTypes.h"
+
+namespace dxray
+{
+	/*!
+	 * @brief Read-only memory mapping of a file. Pages are loaded by the operating system on first access,
+	 * so large files can be read without copying them into a buffer first. The mapping is released when the handle is destroyed.
+	 */
+	class MappedFile final
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile& a_rhs) = delete;
+		MappedFile& operator=(const MappedFile& a_rhs) = delete;
+		MappedFile(MappedFile&& a_rhs) noexcept;
+		MappedFile& operator=(MappedFile&& a_rhs) noexcept;
+
+		/*!
+		 * @brief Maps the full file into memory, any previous mapping is released.
+		 * @param a_filePath The file to be mapped.
+		 * @return Whether the file was mapped. Empty files cannot be mapped.
+		 */
+		bool Open(const Path& a_filePath);
+		void Close();
+
+		const u8* GetData() const;
+		usize GetSizeInBytes() const;
+		bool IsOpen() const;
+
+	private:
+		const u8* m_pData = nullptr;
+		usize m_sizeInBytes = 0;
+#if PLATFORM_WINDOWS
+		void* m_fileHandle = nullptr;
+		void* m_mappingHandle = nullptr;
+#endif
+	};
+
+	inline const u8* MappedFile::GetData() const
+	{
+		return m_pData;
+	}
+
+	inline usize MappedFile::GetSizeInBytes() const
+	{
+		return m_sizeInBytes;
+	}
+
+	inline bool MappedFile::IsOpen() const
+	{
+		return m_pData != nullptr;
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "core/containers/string.h"
+#include "core/valueTypes.h"
+
+namespace dxray
+{
+	/*!
+	 * @brief Blocking TCP socket, primarily used for inter-process communication on the local machine.
+	 * Send and Receive always transfer the full requested amount of bytes, unless the connection fails.
+	 */
+	class Socket final
+	{
+	public:
+		using NativeHandle = u64;
+		static constexpr NativeHandle InvalidHandle = u64max;
+
+		Socket();
+		~Socket();
+		Socket(const Socket& a_rhs) = delete;
+		Socket& operator=(const Socket& a_rhs) = delete;
+		Socket(Socket&& a_rhs) noexcept;
+		Socket& operator=(Socket&& a_rhs) noexcept;
+
+		/*!
+		 * @brief Binds the socket to the loopback adapter and starts listening for connections.
+		 * @param a_port The port to listen on, 0 lets the operating system pick a free port - see GetLocalPort.
+		 * @return Whether the socket is listening.
+		 */
+		bool Listen(const u16 a_port, const i32 a_backlog = 16);
+
+		/*!
+		 * @brief Blocks until a connection is made to this listening socket.
+		 * @param a_timeoutInMs Time to wait for a connection, 0 waits indefinitely.
+		 * @return The connected socket, invalid when accepting failed or timed out.
+		 */
+		Socket Accept(const u32 a_timeoutInMs = 0);
+
+		/*!
+		 * @brief Connects to a listening socket.
+		 * @param a_host IPv4 address of the host, i.e. 127.0.0.1.
+		 * @param a_port Port the host is listening on.
+		 * @return Whether the connection was established.
+		 */
+		bool Connect(const String& a_host, const u16 a_port);
+
+		bool Send(const void* a_pData, const usize a_sizeInBytes);
+		bool Receive(void* a_pData, const usize a_sizeInBytes);
+		void Close();
+
+		bool IsValid() const;
+		u16 GetLocalPort() const;
+
+	private:
+		explicit Socket(const NativeHandle a_handle);
+
+		NativeHandle m_handle;
+	};
+
+	inline bool Socket::IsValid() const
+	{
+		return m_handle != InvalidHandle;
+	}
+}
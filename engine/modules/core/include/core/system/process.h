@@ -0,0 +1,53 @@
+#pragma once
+#include "core/containers/string.h"
+#include "core/valueTypes.h"
+#include <vector>
+
+namespace dxray
+{
+	/*!
+	 * @brief Handle to a spawned child process. The process is not terminated when the handle is destroyed.
+	 */
+	class Process final
+	{
+	public:
+		using NativeHandle = u64;
+		static constexpr NativeHandle InvalidHandle = u64max;
+
+		Process();
+		~Process();
+		Process(const Process& a_rhs) = delete;
+		Process& operator=(const Process& a_rhs) = delete;
+		Process(Process&& a_rhs) noexcept;
+		Process& operator=(Process&& a_rhs) noexcept;
+
+		/*!
+		 * @brief Starts the executable as a child process, which shares the console of this process.
+		 * @param a_executablePath Path to the executable.
+		 * @param a_arguments Arguments passed to the executable, excluding the executable path.
+		 * @return Whether the process was started.
+		 */
+		bool Spawn(const Path& a_executablePath, const std::vector<String>& a_arguments);
+
+		/*!
+		 * @brief Blocks until the process has exited.
+		 * @return The exit code of the process, -1 when the process could not be waited on.
+		 */
+		i32 Wait();
+
+		/*!
+		 * @brief Kills the process and waits for it to exit, does nothing when the handle is invalid.
+		 */
+		void Terminate();
+
+		bool IsValid() const;
+
+	private:
+		NativeHandle m_handle;
+	};
+
+	inline bool Process::IsValid() const
+	{
+		return m_handle != InvalidHandle;
+	}
+}
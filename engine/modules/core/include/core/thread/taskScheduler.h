@@ -3,6 +3,8 @@
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <thread>
+#include <vector>
 
 #include "core/valueTypes.h"
 
@@ -61,11 +63,13 @@ namespace dxray
 
     private:
         TaskPool m_taskPool;
+        std::vector<std::thread> m_workers;
         std::mutex m_lockMutex;
         std::condition_variable m_wakeCondition;
         std::atomic<u64> m_finishedLabel;
         usize m_workerCount;
         u64 m_currentLabel;
+        bool m_bIsRunning;
 
         void Poll();
         void WorkerThread();
@@ -0,0 +1,219 @@
+#pragma once
+#include "core/valueTypes.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define DXRAY_FLOAT8_AVX 1
+#else
+#include <emmintrin.h>
+#define DXRAY_FLOAT8_AVX 0
+#endif
+
+namespace dxray::vath
+{
+	/**
+	 * @brief Eight packed single precision floats, used to process eight lanes of structure-of-arrays data at once.
+	 * Maps onto a single AVX register when the target supports it, otherwise onto two SSE2 registers, which every x64 target supports.
+	 */
+	class alignas(32) Float8 final
+	{
+	public:
+		static constexpr usize LaneCount = 8;
+
+		Float8() = default;
+		explicit Float8(const fp32 a_scalar);
+		Float8(const fp32 a_0, const fp32 a_1, const fp32 a_2, const fp32 a_3, const fp32 a_4, const fp32 a_5, const fp32 a_6, const fp32 a_7);
+
+		/**
+		 * @brief Loads eight floats, the address does not have to be aligned.
+		 */
+		static Float8 Load(const fp32* a_pData);
+
+		/**
+		 * @brief Stores eight floats, the address does not have to be aligned.
+		 */
+		void Store(fp32* a_pData) const;
+
+		fp32 operator[](const usize a_lane) const;
+
+		Float8& operator+=(const Float8& a_rhs);
+		Float8& operator-=(const Float8& a_rhs);
+		Float8& operator*=(const Float8& a_rhs);
+		Float8& operator/=(const Float8& a_rhs);
+
+#if DXRAY_FLOAT8_AVX
+		__m256 Data;
+#else
+		__m128 Low;
+		__m128 High;
+#endif
+	};
+
+
+	//--- Float8 construction ---
+
+	inline Float8::Float8(const fp32 a_scalar)
+	{
+#if DXRAY_FLOAT8_AVX
+		Data = _mm256_set1_ps(a_scalar);
+#else
+		Low = _mm_set1_ps(a_scalar);
+		High = Low;
+#endif
+	}
+
+	inline Float8::Float8(const fp32 a_0, const fp32 a_1, const fp32 a_2, const fp32 a_3, const fp32 a_4, const fp32 a_5, const fp32 a_6, const fp32 a_7)
+	{
+#if DXRAY_FLOAT8_AVX
+		Data = _mm256_setr_ps(a_0, a_1, a_2, a_3, a_4, a_5, a_6, a_7);
+#else
+		Low = _mm_setr_ps(a_0, a_1, a_2, a_3);
+		High = _mm_setr_ps(a_4, a_5, a_6, a_7);
+#endif
+	}
+
+	inline Float8 Float8::Load(const fp32* a_pData)
+	{
+		Float8 result;
+#if DXRAY_FLOAT8_AVX
+		result.Data = _mm256_loadu_ps(a_pData);
+#else
+		result.Low = _mm_loadu_ps(a_pData);
+		result.High = _mm_loadu_ps(a_pData + 4);
+#endif
+		return result;
+	}
+
+	inline void Float8::Store(fp32* a_pData) const
+	{
+#if DXRAY_FLOAT8_AVX
+		_mm256_storeu_ps(a_pData, Data);
+#else
+		_mm_storeu_ps(a_pData, Low);
+		_mm_storeu_ps(a_pData + 4, High);
+#endif
+	}
+
+	inline fp32 Float8::operator[](const usize a_lane) const
+	{
+		alignas(32) fp32 lanes[LaneCount];
+		Store(lanes);
+		return lanes[a_lane];
+	}
+
+
+	//--- Float8 operators ---
+
+#if DXRAY_FLOAT8_AVX
+#define DXRAY_FLOAT8_BINARY_OP(a_lhs, a_rhs, avxOp, sseOp) Float8 result; result.Data = avxOp(a_lhs.Data, a_rhs.Data); return result;
+#else
+#define DXRAY_FLOAT8_BINARY_OP(a_lhs, a_rhs, avxOp, sseOp) Float8 result; result.Low = sseOp(a_lhs.Low, a_rhs.Low); result.High = sseOp(a_lhs.High, a_rhs.High); return result;
+#endif
+
+	inline Float8 operator+(const Float8& a_lhs, const Float8& a_rhs)
+	{
+		DXRAY_FLOAT8_BINARY_OP(a_lhs, a_rhs, _mm256_add_ps, _mm_add_ps)
+	}
+
+	inline Float8 operator-(const Float8& a_lhs, const Float8& a_rhs)
+	{
+		DXRAY_FLOAT8_BINARY_OP(a_lhs, a_rhs, _mm256_sub_ps, _mm_sub_ps)
+	}
+
+	inline Float8 operator*(const Float8& a_lhs, const Float8& a_rhs)
+	{
+		DXRAY_FLOAT8_BINARY_OP(a_lhs, a_rhs, _mm256_mul_ps, _mm_mul_ps)
+	}
+
+	inline Float8 operator/(const Float8& a_lhs, const Float8& a_rhs)
+	{
+		DXRAY_FLOAT8_BINARY_OP(a_lhs, a_rhs, _mm256_div_ps, _mm_div_ps)
+	}
+
+	inline Float8 Min(const Float8& a_lhs, const Float8& a_rhs)
+	{
+		DXRAY_FLOAT8_BINARY_OP(a_lhs, a_rhs, _mm256_min_ps, _mm_min_ps)
+	}
+
+	inline Float8 Max(const Float8& a_lhs, const Float8& a_rhs)
+	{
+		DXRAY_FLOAT8_BINARY_OP(a_lhs, a_rhs, _mm256_max_ps, _mm_max_ps)
+	}
+
+#undef DXRAY_FLOAT8_BINARY_OP
+
+	inline Float8 operator*(const Float8& a_lhs, const fp32 a_scalar)
+	{
+		return a_lhs * Float8(a_scalar);
+	}
+
+	inline Float8 operator*(const fp32 a_scalar, const Float8& a_rhs)
+	{
+		return Float8(a_scalar) * a_rhs;
+	}
+
+	inline Float8& Float8::operator+=(const Float8& a_rhs)
+	{
+		return *this = *this + a_rhs;
+	}
+
+	inline Float8& Float8::operator-=(const Float8& a_rhs)
+	{
+		return *this = *this - a_rhs;
+	}
+
+	inline Float8& Float8::operator*=(const Float8& a_rhs)
+	{
+		return *this = *this * a_rhs;
+	}
+
+	inline Float8& Float8::operator/=(const Float8& a_rhs)
+	{
+		return *this = *this / a_rhs;
+	}
+
+	/**
+	 * @brief Computes a * b + c, fused when the target supports it.
+	 */
+	inline Float8 MultiplyAdd(const Float8& a_a, const Float8& a_b, const Float8& a_c)
+	{
+#if DXRAY_FLOAT8_AVX && defined(__FMA__)
+		Float8 result;
+		result.Data = _mm256_fmadd_ps(a_a.Data, a_b.Data, a_c.Data);
+		return result;
+#else
+		return a_a * a_b + a_c;
+#endif
+	}
+
+	/**
+	 * @brief Rounds every lane down, lanes have to be within the range of a 32 bit integer.
+	 */
+	inline Float8 Floor(const Float8& a_value)
+	{
+		Float8 result;
+#if DXRAY_FLOAT8_AVX
+		result.Data = _mm256_floor_ps(a_value.Data);
+#else
+		//Truncate towards zero and subtract one where that rounded up, which is the case for negative fractions.
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 truncatedLow = _mm_cvtepi32_ps(_mm_cvttps_epi32(a_value.Low));
+		const __m128 truncatedHigh = _mm_cvtepi32_ps(_mm_cvttps_epi32(a_value.High));
+		result.Low = _mm_sub_ps(truncatedLow, _mm_and_ps(_mm_cmpgt_ps(truncatedLow, a_value.Low), one));
+		result.High = _mm_sub_ps(truncatedHigh, _mm_and_ps(_mm_cmpgt_ps(truncatedHigh, a_value.High), one));
+#endif
+		return result;
+	}
+
+	inline Float8 Sqrt(const Float8& a_value)
+	{
+		Float8 result;
+#if DXRAY_FLOAT8_AVX
+		result.Data = _mm256_sqrt_ps(a_value.Data);
+#else
+		result.Low = _mm_sqrt_ps(a_value.Low);
+		result.High = _mm_sqrt_ps(a_value.High);
+#endif
+		return result;
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include "core/valueTypes.h"
+
+namespace dxray::vath
+{
+	/**
+	 * @brief Converts to IEEE 754 half precision, rounding to nearest even. Values out of the half range become infinity.
+	 */
+	inline u16 FloatToHalf(const fp32 a_value)
+	{
+		const u32 bits = std::bit_cast<u32>(a_value);
+		const u32 sign = (bits >> 16) & 0x8000u;
+		const u32 floatExponent = (bits >> 23) & 0xFFu;
+		u32 mantissa = bits & 0x7FFFFFu;
+
+		//Infinity and NaN.
+		if (floatExponent == 0xFFu)
+		{
+			return static_cast<u16>(sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u));
+		}
+
+		const i32 exponent = static_cast<i32>(floatExponent) - 127 + 15;
+		if (exponent >= 31)
+		{
+			return static_cast<u16>(sign | 0x7C00u);
+		}
+
+		//Values below the normal half range become denormals, rounded to nearest even.
+		if (exponent <= 0)
+		{
+			if (exponent < -10)
+			{
+				return static_cast<u16>(sign);
+			}
+
+			mantissa |= 0x800000u;
+			const u32 shift = static_cast<u32>(14 - exponent);
+			const u32 remainder = mantissa & ((1u << shift) - 1u);
+			const u32 halfway = 1u << (shift - 1u);
+			u32 half = mantissa >> shift;
+			if (remainder > halfway || (remainder == halfway && (half & 1u) != 0))
+			{
+				++half;
+			}
+
+			return static_cast<u16>(sign | half);
+		}
+
+		//A carry out of the mantissa correctly rounds up into the exponent.
+		u32 half = sign | (static_cast<u32>(exponent) << 10) | (mantissa >> 13);
+		const u32 remainder = mantissa & 0x1FFFu;
+		if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u) != 0))
+		{
+			++half;
+		}
+
+		return static_cast<u16>(half);
+	}
+
+	/**
+	 * @brief Converts IEEE 754 half precision to single precision, which is exact.
+	 */
+	inline fp32 HalfToFloat(const u16 a_value)
+	{
+		const u32 sign = static_cast<u32>(a_value & 0x8000u) << 16;
+		const u32 exponent = (a_value >> 10) & 0x1Fu;
+		const u32 mantissa = a_value & 0x3FFu;
+
+		if (exponent == 0)
+		{
+			const fp32 denormal = std::ldexp(static_cast<fp32>(mantissa), -24);
+			return sign != 0 ? -denormal : denormal;
+		}
+
+		if (exponent == 0x1Fu)
+		{
+			return std::bit_cast<fp32>(sign | 0x7F800000u | (mantissa << 13));
+		}
+
+		return std::bit_cast<fp32>(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+	}
+}
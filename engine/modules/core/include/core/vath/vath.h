@@ -11,4 +11,7 @@
 #include "core/vath/matrix4x4.h"
 #include "core/vath/matrix3x3.h"
 #include "core/vath/matrix2x2.h"
-#include "core/vath/quaternion.h"
\ No newline at end of file
+#include "core/vath/quaternion.h"
+#include "core/vath/float8.h"
+#include "core/vath/half.h"
+#include "core/vath/warp.h"
\ No newline at end of file
@@ -0,0 +1,213 @@
+#pragma once
+#include "core/vath/vathUtility.h"
+#include "core/vath/vector2.h"
+#include "core/vath/vector3.h"
+
+namespace dxray::vath
+{
+	//Warps map uniform samples of the unit square onto a domain, each comes with the density of the directions or points it produces.
+	//Every warp consumes exactly two random numbers and has no loops and no data dependent branches, so every sample costs the same and
+	//warps of neighbouring lanes vectorize. Directions are produced in a local frame around +z, OrthonormalBasis moves them around a normal.
+
+	/**
+	 * @brief Right-handed orthonormal basis around a unit normal, which becomes the z axis of the local frame.
+	 * Built without branches or normalization, continuous everywhere except where the normal crosses the xy plane at z = 0.
+	 * See Duff et al. 2017, Building an Orthonormal Basis, Revisited.
+	 */
+	template<FloatingPoint T>
+	struct OrthonormalBasis final
+	{
+		explicit OrthonormalBasis(const Vector<3, T>& a_normal);
+
+		Vector<3, T> ToWorld(const Vector<3, T>& a_local) const;
+		Vector<3, T> ToLocal(const Vector<3, T>& a_world) const;
+
+		Vector<3, T> Tangent;
+		Vector<3, T> Bitangent;
+		Vector<3, T> Normal;
+	};
+
+	template<FloatingPoint T>
+	inline OrthonormalBasis<T>::OrthonormalBasis(const Vector<3, T>& a_normal) :
+		Normal(a_normal)
+	{
+		const T sign = std::copysign(static_cast<T>(1), a_normal.z);
+		const T a = static_cast<T>(-1) / (sign + a_normal.z);
+		const T b = a_normal.x * a_normal.y * a;
+		Tangent = Vector<3, T>(static_cast<T>(1) + sign * a_normal.x * a_normal.x * a, sign * b, -sign * a_normal.x);
+		Bitangent = Vector<3, T>(b, sign + a_normal.y * a_normal.y * a, -a_normal.y);
+	}
+
+	template<FloatingPoint T>
+	inline Vector<3, T> OrthonormalBasis<T>::ToWorld(const Vector<3, T>& a_local) const
+	{
+		return Tangent * a_local.x + Bitangent * a_local.y + Normal * a_local.z;
+	}
+
+	template<FloatingPoint T>
+	inline Vector<3, T> OrthonormalBasis<T>::ToLocal(const Vector<3, T>& a_world) const
+	{
+		return Vector<3, T>(Dot(a_world, Tangent), Dot(a_world, Bitangent), Dot(a_world, Normal));
+	}
+
+
+	//--- Disk ---
+
+	/**
+	 * @brief Uniform point on the unit disk. Concentric mapping, which keeps neighbouring samples of the square close together on the disk
+	 * and needs a single sine and cosine. See Shirley and Chiu 1997, A Low Distortion Map Between Disk and Square.
+	 */
+	template<FloatingPoint T>
+	inline Vector<2, T> SquareToConcentricDisk(const Vector<2, T>& a_sample)
+	{
+		const T x = static_cast<T>(2) * a_sample.x - static_cast<T>(1);
+		const T y = static_cast<T>(2) * a_sample.y - static_cast<T>(1);
+		const bool bXMajor = std::abs(x) > std::abs(y);
+		const T radius = bXMajor ? x : y;
+		const T ratio = radius != static_cast<T>(0) ? (bXMajor ? y / x : x / y) : static_cast<T>(0);
+		const T quarterPi = Pi<T>() * static_cast<T>(0.25);
+		const T angle = bXMajor ? quarterPi * ratio : static_cast<T>(2) * quarterPi - quarterPi * ratio;
+		return Vector<2, T>(radius * std::cos(angle), radius * std::sin(angle));
+	}
+
+	template<FloatingPoint T>
+	inline constexpr T ConcentricDiskPdf()
+	{
+		return static_cast<T>(1) / Pi<T>();
+	}
+
+
+	//--- Hemisphere and sphere ---
+
+	/**
+	 * @brief Direction on the hemisphere around +z with a density proportional to its cosine, the disk sample projected up onto the hemisphere.
+	 */
+	template<FloatingPoint T>
+	inline Vector<3, T> SquareToCosineHemisphere(const Vector<2, T>& a_sample)
+	{
+		const Vector<2, T> disk = SquareToConcentricDisk(a_sample);
+		const T z = std::sqrt(Max(static_cast<T>(0), static_cast<T>(1) - disk.x * disk.x - disk.y * disk.y));
+		return Vector<3, T>(disk.x, disk.y, z);
+	}
+
+	template<FloatingPoint T>
+	inline constexpr T CosineHemispherePdf(const T a_cosTheta)
+	{
+		return Max(a_cosTheta, static_cast<T>(0)) / Pi<T>();
+	}
+
+	/**
+	 * @brief Uniform direction on the unit sphere.
+	 */
+	template<FloatingPoint T>
+	inline Vector<3, T> SquareToUniformSphere(const Vector<2, T>& a_sample)
+	{
+		const T z = static_cast<T>(1) - static_cast<T>(2) * a_sample.x;
+		const T radius = std::sqrt(Max(static_cast<T>(0), static_cast<T>(1) - z * z));
+		const T phi = static_cast<T>(2) * Pi<T>() * a_sample.y;
+		return Vector<3, T>(radius * std::cos(phi), radius * std::sin(phi), z);
+	}
+
+	template<FloatingPoint T>
+	inline constexpr T UniformSpherePdf()
+	{
+		return static_cast<T>(1) / (static_cast<T>(4) * Pi<T>());
+	}
+
+
+	//--- Cone and spherical cap ---
+
+	/**
+	 * @brief Uniform direction within the cone around +z, equivalently a uniform point on the spherical cap the cone cuts out of the unit sphere.
+	 * The cone is given by 1 - cos of its half angle rather than the cosine, the cosine of narrow cones rounds to 1.
+	 */
+	template<FloatingPoint T>
+	inline Vector<3, T> SquareToUniformCone(const Vector<2, T>& a_sample, const T a_oneMinusCosThetaMax)
+	{
+		const T oneMinusCosTheta = a_sample.x * a_oneMinusCosThetaMax;
+		const T cosTheta = static_cast<T>(1) - oneMinusCosTheta;
+		const T sinTheta = std::sqrt(Max(static_cast<T>(0), oneMinusCosTheta * (static_cast<T>(2) - oneMinusCosTheta)));
+		const T phi = static_cast<T>(2) * Pi<T>() * a_sample.y;
+		return Vector<3, T>(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+	}
+
+	template<FloatingPoint T>
+	inline constexpr T UniformConePdf(const T a_oneMinusCosThetaMax)
+	{
+		return static_cast<T>(1) / (static_cast<T>(2) * Pi<T>() * a_oneMinusCosThetaMax);
+	}
+
+	/**
+	 * @brief 1 - cos of the half angle of the cone of directions towards a sphere, seen from a point at the distance from its center.
+	 * Uniform cone samples around the direction towards the center cover the sphere with the least variance. 0 when the point lies within the sphere.
+	 */
+	template<FloatingPoint T>
+	inline T SphereConeOneMinusCos(const T a_centerDistanceSquared, const T a_radiusSquared)
+	{
+		//1 - cos = sin^2 / (1 + cos), which keeps its precision for small cones.
+		const T sinSquared = Min(a_radiusSquared / a_centerDistanceSquared, static_cast<T>(1));
+		const T oneMinusCos = sinSquared / (static_cast<T>(1) + std::sqrt(static_cast<T>(1) - sinSquared));
+		return a_centerDistanceSquared > a_radiusSquared ? oneMinusCos : static_cast<T>(0);
+	}
+
+
+	//--- GGX microfacets ---
+
+	/**
+	 * @brief GGX (Trowbridge-Reitz) distribution of microfacet normals around +z, with roughness alpha along x and y.
+	 */
+	template<FloatingPoint T>
+	inline T GgxDistribution(const Vector<3, T>& a_microNormal, const T a_alphaX, const T a_alphaY)
+	{
+		const T x = a_microNormal.x / a_alphaX;
+		const T y = a_microNormal.y / a_alphaY;
+		const T denominator = x * x + y * y + a_microNormal.z * a_microNormal.z;
+		return a_microNormal.z > static_cast<T>(0) ? static_cast<T>(1) / (Pi<T>() * a_alphaX * a_alphaY * denominator * denominator) : static_cast<T>(0);
+	}
+
+	/**
+	 * @brief Smith masking of the GGX distribution for a direction in the upper hemisphere.
+	 */
+	template<FloatingPoint T>
+	inline T GgxSmithMasking(const Vector<3, T>& a_direction, const T a_alphaX, const T a_alphaY)
+	{
+		const T x = a_alphaX * a_direction.x;
+		const T y = a_alphaY * a_direction.y;
+		const T zSquared = a_direction.z * a_direction.z;
+		const T lambda = (std::sqrt(static_cast<T>(1) + (x * x + y * y) / zSquared) - static_cast<T>(1)) * static_cast<T>(0.5);
+		return a_direction.z > static_cast<T>(0) ? static_cast<T>(1) / (static_cast<T>(1) + lambda) : static_cast<T>(0);
+	}
+
+	/**
+	 * @brief Microfacet normal of the GGX distribution that is visible from the unit direction, which lies in the upper hemisphere.
+	 * Normals facing away from the direction are never picked, which wastes fewer samples than sampling the full distribution. The disk sample is warped onto
+	 * the projection of the hemisphere stretched by the roughness. See Heitz 2018, Sampling the GGX Distribution of Visible Normals.
+	 */
+	template<FloatingPoint T>
+	inline Vector<3, T> SampleGgxVisibleNormal(const Vector<3, T>& a_direction, const T a_alphaX, const T a_alphaY, const Vector<2, T>& a_sample)
+	{
+		const Vector<3, T> stretched = Normalize(Vector<3, T>(a_alphaX * a_direction.x, a_alphaY * a_direction.y, a_direction.z));
+		const T lengthSquared = stretched.x * stretched.x + stretched.y * stretched.y;
+		const Vector<3, T> tangent = lengthSquared > static_cast<T>(0)
+			? Vector<3, T>(-stretched.y, stretched.x, static_cast<T>(0)) / std::sqrt(lengthSquared)
+			: Vector<3, T>(static_cast<T>(1), static_cast<T>(0), static_cast<T>(0));
+		const Vector<3, T> bitangent = Cross(stretched, tangent);
+
+		const Vector<2, T> disk = SquareToConcentricDisk(a_sample);
+		const T blend = static_cast<T>(0.5) * (static_cast<T>(1) + stretched.z);
+		const T t1 = disk.x;
+		const T t2 = (static_cast<T>(1) - blend) * std::sqrt(Max(static_cast<T>(0), static_cast<T>(1) - t1 * t1)) + blend * disk.y;
+		const Vector<3, T> hemisphereNormal = tangent * t1 + bitangent * t2 + stretched * std::sqrt(Max(static_cast<T>(0), static_cast<T>(1) - t1 * t1 - t2 * t2));
+		return Normalize(Vector<3, T>(a_alphaX * hemisphereNormal.x, a_alphaY * hemisphereNormal.y, Max(static_cast<T>(0), hemisphereNormal.z)));
+	}
+
+	/**
+	 * @brief Solid angle density of SampleGgxVisibleNormal picking the microfacet normal for the direction.
+	 */
+	template<FloatingPoint T>
+	inline T GgxVisibleNormalPdf(const Vector<3, T>& a_direction, const Vector<3, T>& a_microNormal, const T a_alphaX, const T a_alphaY)
+	{
+		return GgxSmithMasking(a_direction, a_alphaX, a_alphaY) * Max(static_cast<T>(0), Dot(a_direction, a_microNormal))
+			* GgxDistribution(a_microNormal, a_alphaX, a_alphaY) / a_direction.z;
+	}
+}
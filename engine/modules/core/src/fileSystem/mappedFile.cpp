@@ -0,0 +1,128 @@
+#include "core/fileSystem/mappedFile.h"
+#include "core/debug.h"
+
+#if !PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dxray
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& a_rhs) noexcept
+	{
+		*this = std::move(a_rhs);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& a_rhs) noexcept
+	{
+		if (this != &a_rhs)
+		{
+			std::swap(m_pData, a_rhs.m_pData);
+			std::swap(m_sizeInBytes, a_rhs.m_sizeInBytes);
+#if PLATFORM_WINDOWS
+			std::swap(m_fileHandle, a_rhs.m_fileHandle);
+			std::swap(m_mappingHandle, a_rhs.m_mappingHandle);
+#endif
+		}
+
+		return *this;
+	}
+
+	bool MappedFile::Open(const Path& a_filePath)
+	{
+		Close();
+
+#if PLATFORM_WINDOWS
+		const HANDLE file = CreateFileW(a_filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			DXRAY_ERROR("Failed to open file for mapping: {}", a_filePath.string());
+			return false;
+		}
+
+		LARGE_INTEGER fileSize = {};
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			DXRAY_ERROR("Failed to map empty file: {}", a_filePath.string());
+			return false;
+		}
+
+		const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void* pView = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (pView == nullptr)
+		{
+			if (mapping != nullptr)
+			{
+				CloseHandle(mapping);
+			}
+
+			CloseHandle(file);
+			DXRAY_ERROR("Failed to map file: {}", a_filePath.string());
+			return false;
+		}
+
+		m_fileHandle = file;
+		m_mappingHandle = mapping;
+		m_pData = static_cast<const u8*>(pView);
+		m_sizeInBytes = static_cast<usize>(fileSize.QuadPart);
+#else
+		const i32 file = open(a_filePath.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			DXRAY_ERROR("Failed to open file for mapping: {}", a_filePath.string());
+			return false;
+		}
+
+		struct stat fileStatus = {};
+		if (fstat(file, &fileStatus) != 0 || fileStatus.st_size == 0)
+		{
+			close(file);
+			DXRAY_ERROR("Failed to map empty file: {}", a_filePath.string());
+			return false;
+		}
+
+		//The mapping keeps its own reference to the file, the descriptor is not needed afterwards.
+		void* pView = mmap(nullptr, static_cast<usize>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (pView == MAP_FAILED)
+		{
+			DXRAY_ERROR("Failed to map file: {}", a_filePath.string());
+			return false;
+		}
+
+		m_pData = static_cast<const u8*>(pView);
+		m_sizeInBytes = static_cast<usize>(fileStatus.st_size);
+#endif
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (!IsOpen())
+		{
+			return;
+		}
+
+#if PLATFORM_WINDOWS
+		UnmapViewOfFile(m_pData);
+		CloseHandle(m_mappingHandle);
+		CloseHandle(m_fileHandle);
+		m_mappingHandle = nullptr;
+		m_fileHandle = nullptr;
+#else
+		munmap(const_cast<u8*>(m_pData), m_sizeInBytes);
+#endif
+
+		m_pData = nullptr;
+		m_sizeInBytes = 0;
+	}
+}
@@ -0,0 +1,234 @@
+#include "core/network/socket.h"
+#include "core/debug.h"
+
+#if PLATFORM_WINDOWS
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+namespace dxray
+{
+#if PLATFORM_WINDOWS
+	using NativeSocket = SOCKET;
+	static constexpr NativeSocket InvalidNativeSocket = INVALID_SOCKET;
+	using SocketLength = int;
+	using TransferSize = int;
+	static constexpr int SendFlags = 0;
+
+	/*!
+	 * @brief Winsock has to be initialized once per process before any socket can be created.
+	 */
+	static void EnsureSocketApiInitialized()
+	{
+		static const bool bInitialized = []()
+		{
+			WSADATA wsaData;
+			const int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
+			DXRAY_ASSERT_WITH_MSG(result == 0, "Failed to initialize winsock");
+			return result == 0;
+		}();
+		(void)bInitialized;
+	}
+
+	static void CloseNativeSocket(const NativeSocket a_socket)
+	{
+		closesocket(a_socket);
+	}
+#else
+	using NativeSocket = int;
+	static constexpr NativeSocket InvalidNativeSocket = -1;
+	using SocketLength = socklen_t;
+	using TransferSize = ssize_t;
+	static constexpr int SendFlags = MSG_NOSIGNAL;
+
+	static void EnsureSocketApiInitialized()
+	{}
+
+	static void CloseNativeSocket(const NativeSocket a_socket)
+	{
+		close(a_socket);
+	}
+#endif
+
+	static NativeSocket ToNative(const Socket::NativeHandle a_handle)
+	{
+		return static_cast<NativeSocket>(a_handle);
+	}
+
+	static Socket::NativeHandle ToHandle(const NativeSocket a_socket)
+	{
+		return a_socket == InvalidNativeSocket ? Socket::InvalidHandle : static_cast<Socket::NativeHandle>(a_socket);
+	}
+
+	Socket::Socket() :
+		m_handle(InvalidHandle)
+	{}
+
+	Socket::Socket(const NativeHandle a_handle) :
+		m_handle(a_handle)
+	{}
+
+	Socket::~Socket()
+	{
+		Close();
+	}
+
+	Socket::Socket(Socket&& a_rhs) noexcept :
+		m_handle(a_rhs.m_handle)
+	{
+		a_rhs.m_handle = InvalidHandle;
+	}
+
+	Socket& Socket::operator=(Socket&& a_rhs) noexcept
+	{
+		if (this != &a_rhs)
+		{
+			Close();
+			m_handle = a_rhs.m_handle;
+			a_rhs.m_handle = InvalidHandle;
+		}
+
+		return *this;
+	}
+
+	bool Socket::Listen(const u16 a_port, const i32 a_backlog /*= 16*/)
+	{
+		EnsureSocketApiInitialized();
+		Close();
+
+		m_handle = ToHandle(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+		if (!IsValid())
+		{
+			DXRAY_ERROR("Failed to create a listening socket.");
+			return false;
+		}
+
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons(a_port);
+		if (bind(ToNative(m_handle), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(ToNative(m_handle), a_backlog) != 0)
+		{
+			DXRAY_ERROR("Failed to listen on port {}.", a_port);
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	Socket Socket::Accept(const u32 a_timeoutInMs /*= 0*/)
+	{
+		DXRAY_ASSERT(IsValid());
+		if (a_timeoutInMs > 0)
+		{
+			//A pending connection makes the listening socket readable.
+			fd_set readSet;
+			FD_ZERO(&readSet);
+			FD_SET(ToNative(m_handle), &readSet);
+			timeval timeout = {};
+			timeout.tv_sec = static_cast<decltype(timeout.tv_sec)>(a_timeoutInMs / 1000);
+			timeout.tv_usec = static_cast<decltype(timeout.tv_usec)>((a_timeoutInMs % 1000) * 1000);
+			if (select(static_cast<int>(ToNative(m_handle)) + 1, &readSet, nullptr, nullptr, &timeout) <= 0)
+			{
+				return Socket();
+			}
+		}
+
+		const NativeSocket connection = accept(ToNative(m_handle), nullptr, nullptr);
+		return Socket(ToHandle(connection));
+	}
+
+	bool Socket::Connect(const String& a_host, const u16 a_port)
+	{
+		EnsureSocketApiInitialized();
+		Close();
+
+		m_handle = ToHandle(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+		if (!IsValid())
+		{
+			return false;
+		}
+
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(a_port);
+		inet_pton(AF_INET, a_host.c_str(), &address.sin_addr);
+		if (connect(ToNative(m_handle), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+		{
+			Close();
+			return false;
+		}
+
+		//Messages are sent in one go, there is no need to wait for more data to coalesce.
+		const int noDelay = 1;
+		setsockopt(ToNative(m_handle), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+		return true;
+	}
+
+	bool Socket::Send(const void* a_pData, const usize a_sizeInBytes)
+	{
+		const char* pData = static_cast<const char*>(a_pData);
+		usize sentBytes = 0;
+		while (sentBytes < a_sizeInBytes)
+		{
+			const usize chunkSize = std::min<usize>(a_sizeInBytes - sentBytes, i32max);
+			const TransferSize result = send(ToNative(m_handle), pData + sentBytes, static_cast<int>(chunkSize), SendFlags);
+			if (result <= 0)
+			{
+				return false;
+			}
+
+			sentBytes += static_cast<usize>(result);
+		}
+
+		return true;
+	}
+
+	bool Socket::Receive(void* a_pData, const usize a_sizeInBytes)
+	{
+		char* pData = static_cast<char*>(a_pData);
+		usize receivedBytes = 0;
+		while (receivedBytes < a_sizeInBytes)
+		{
+			const usize chunkSize = std::min<usize>(a_sizeInBytes - receivedBytes, i32max);
+			const TransferSize result = recv(ToNative(m_handle), pData + receivedBytes, static_cast<int>(chunkSize), 0);
+			if (result <= 0)
+			{
+				return false;
+			}
+
+			receivedBytes += static_cast<usize>(result);
+		}
+
+		return true;
+	}
+
+	void Socket::Close()
+	{
+		if (IsValid())
+		{
+			CloseNativeSocket(ToNative(m_handle));
+			m_handle = InvalidHandle;
+		}
+	}
+
+	u16 Socket::GetLocalPort() const
+	{
+		sockaddr_in address = {};
+		SocketLength addressLength = sizeof(address);
+		if (!IsValid() || getsockname(ToNative(m_handle), reinterpret_cast<sockaddr*>(&address), &addressLength) != 0)
+		{
+			return 0;
+		}
+
+		return ntohs(address.sin_port);
+	}
+}
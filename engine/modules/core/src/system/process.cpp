@@ -0,0 +1,131 @@
+#include "core/system/process.h"
+#include "core/debug.h"
+
+#if !PLATFORM_WINDOWS
+#include <spawn.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+extern char** environ;
+#endif
+
+namespace dxray
+{
+	Process::Process() :
+		m_handle(InvalidHandle)
+	{}
+
+	Process::~Process()
+	{
+#if PLATFORM_WINDOWS
+		if (IsValid())
+		{
+			CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+		}
+#endif
+	}
+
+	Process::Process(Process&& a_rhs) noexcept :
+		m_handle(a_rhs.m_handle)
+	{
+		a_rhs.m_handle = InvalidHandle;
+	}
+
+	Process& Process::operator=(Process&& a_rhs) noexcept
+	{
+		if (this != &a_rhs)
+		{
+			std::swap(m_handle, a_rhs.m_handle);
+		}
+
+		return *this;
+	}
+
+	bool Process::Spawn(const Path& a_executablePath, const std::vector<String>& a_arguments)
+	{
+		DXRAY_ASSERT(!IsValid());
+
+#if PLATFORM_WINDOWS
+		//CreateProcess expects a single, mutable, command line in which every argument is quoted.
+		String commandLine = std::format("\"{}\"", a_executablePath.string());
+		for (const String& argument : a_arguments)
+		{
+			commandLine += std::format(" \"{}\"", argument);
+		}
+
+		STARTUPINFOA startupInfo = {};
+		startupInfo.cb = sizeof(startupInfo);
+		PROCESS_INFORMATION processInfo = {};
+		if (!CreateProcessA(nullptr, commandLine.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startupInfo, &processInfo))
+		{
+			DXRAY_ERROR("Failed to spawn process: {}", commandLine);
+			return false;
+		}
+
+		CloseHandle(processInfo.hThread);
+		m_handle = reinterpret_cast<NativeHandle>(processInfo.hProcess);
+#else
+		const String executable = a_executablePath.string();
+		std::vector<char*> argv;
+		argv.push_back(const_cast<char*>(executable.c_str()));
+		for (const String& argument : a_arguments)
+		{
+			argv.push_back(const_cast<char*>(argument.c_str()));
+		}
+		argv.push_back(nullptr);
+
+		pid_t processId = 0;
+		if (posix_spawn(&processId, executable.c_str(), nullptr, nullptr, argv.data(), environ) != 0)
+		{
+			DXRAY_ERROR("Failed to spawn process: {}", executable);
+			return false;
+		}
+
+		m_handle = static_cast<NativeHandle>(processId);
+#endif
+
+		return true;
+	}
+
+	i32 Process::Wait()
+	{
+		if (!IsValid())
+		{
+			return -1;
+		}
+
+#if PLATFORM_WINDOWS
+		const HANDLE process = reinterpret_cast<HANDLE>(m_handle);
+		WaitForSingleObject(process, INFINITE);
+		DWORD exitCode = 0;
+		GetExitCodeProcess(process, &exitCode);
+		CloseHandle(process);
+		m_handle = InvalidHandle;
+		return static_cast<i32>(exitCode);
+#else
+		i32 status = 0;
+		const pid_t result = waitpid(static_cast<pid_t>(m_handle), &status, 0);
+		m_handle = InvalidHandle;
+		return result >= 0 && WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+	}
+
+	void Process::Terminate()
+	{
+		if (!IsValid())
+		{
+			return;
+		}
+
+#if PLATFORM_WINDOWS
+		const HANDLE process = reinterpret_cast<HANDLE>(m_handle);
+		TerminateProcess(process, 1);
+		WaitForSingleObject(process, INFINITE);
+		CloseHandle(process);
+#else
+		kill(static_cast<pid_t>(m_handle), SIGKILL);
+		waitpid(static_cast<pid_t>(m_handle), nullptr, 0);
+#endif
+		m_handle = InvalidHandle;
+	}
+}
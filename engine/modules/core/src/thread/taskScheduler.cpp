@@ -3,21 +3,37 @@
 namespace dxray
 {
     TaskScheduler::TaskScheduler(const u16 a_numNoneOccupiedCores /*= 2*/) :
-        m_currentLabel(1ul)
+        m_currentLabel(1ul),
+        m_bIsRunning(true)
     {
         m_finishedLabel.store(1ul);
-        m_workerCount = std::max(1u, std::thread::hardware_concurrency() - a_numNoneOccupiedCores);
+        //#Note: Guard against the unsigned underflow on machines that have less cores than the amount that should remain unoccupied.
+        const u32 coreCount = std::thread::hardware_concurrency();
+        m_workerCount = coreCount > a_numNoneOccupiedCores ? coreCount - a_numNoneOccupiedCores : 1u;
 
+        m_workers.reserve(m_workerCount);
         for (u16 i = 0; i < m_workerCount; ++i)
         {
-            std::thread worker(&TaskScheduler::TaskScheduler::WorkerThread, this);
-            worker.detach();
+            m_workers.emplace_back(&TaskScheduler::TaskScheduler::WorkerThread, this);
         }
     }
 
     TaskScheduler::~TaskScheduler()
     {
         Flush();
+
+        //#Note: Workers are joined rather than detached, a detached worker could still be waiting on the condition variable when it is destroyed,
+        //which blocks process exit on some platforms - e.g. for the riow worker processes.
+        {
+            const std::lock_guard<std::mutex> lock(m_lockMutex);
+            m_bIsRunning = false;
+        }
+
+        m_wakeCondition.notify_all();
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
     }
 
     void TaskScheduler::Execute(const Task& a_treadJob)
@@ -28,6 +44,9 @@ namespace dxray
         {
             Poll();
         }
+
+        //Wake a worker right away, so queued tasks overlap with whatever the submitting thread does next rather than waiting on Wait.
+        m_wakeCondition.notify_one();
     }
 
     bool TaskScheduler::IsBusy() const
@@ -70,6 +89,11 @@ namespace dxray
             }
 
             std::unique_lock<std::mutex> lock(m_lockMutex);
+            if (!m_bIsRunning)
+            {
+                return;
+            }
+
             m_wakeCondition.wait(lock);
         }
     }
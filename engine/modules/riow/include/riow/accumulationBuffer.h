@@ -0,0 +1,255 @@
+#pragma once
+#include <core/containers/string.h>
+#include <core/vath/vath.h>
+#include "riow/color.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Identifies the render a buffer accumulates. A checkpoint only resumes a render with the same signature, samples of another scene or pipeline would be summed into it.
+	/// </summary>
+	struct RenderSignature final
+	{
+		u64 SceneHash = 0;
+		u64 PipelineHash = 0;	//See RendererPipeline::GetImageHash.
+		u32 SamplesPerPass = 0;
+
+		bool operator==(const RenderSignature& a_rhs) const = default;
+	};
+
+
+	/// <summary>
+	/// Holds the progressively accumulated radiance of a render, i.e. the filter weighted sum of the radiance samples and of their weights per pixel,
+	/// next to the number of samples rendered for every pixel. The weighted sums are filled in by a film (see Film), which also spreads samples over neighbouring pixels.
+	/// The buffer can be stored into a checkpoint file and restored from it, which allows a pre-empted render to continue where it stopped.
+	/// Checkpoints carry the render signature of the buffer, loading a checkpoint with another signature fails.
+	/// A buffer can cover a sub-region of the image (image offset) and a sub-range of the passes (first pass index), which allows a render to be split into work units.
+	/// Next to the radiance, the luminance and squared luminance of every sample batch rendered for a pixel are accumulated, unfiltered, which gives an estimate
+	/// of the per pixel variance used for adaptive sampling.
+	/// #Note: Radiance is stored and resolved in linear space, the display transform is applied to the resolved image (see EncodeDisplayImage).
+	/// </summary>
+	class AccumulationBuffer final
+	{
+	public:
+		AccumulationBuffer();
+		AccumulationBuffer(const vath::Vector2u32& a_dimensionsInPx, const u64 a_seed = 0u);
+		~AccumulationBuffer() = default;
+
+		void Resize(const vath::Vector2u32& a_dimensionsInPx);
+		void Clear();
+
+		/// <summary>
+		/// Counts a batch of samples rendered for a pixel, the radiance sum of the batch only feeds the variance estimate.
+		/// </summary>
+		void AddSampleBatch(const u32 a_pixelIndex, const Color& a_radianceSum, const u32 a_sampleCount);
+		void AddWeightedRadiance(const u32 a_pixelIndex, const Color& a_weightedRadianceSum, const fp32 a_weightSum);
+		void Merge(const AccumulationBuffer& a_buffer);
+		void Resolve(std::vector<Color>& a_radianceBuffer) const;
+		void ResolveSampleCounts(std::vector<Color>& a_colorBuffer) const;
+
+		/// <summary>
+		/// Filter weights and luminance variances of the pixels, normalized to the highest one in the buffer.
+		/// </summary>
+		void ResolveWeights(std::vector<Color>& a_colorBuffer) const;
+		void ResolveVariances(std::vector<Color>& a_colorBuffer, const u32 a_samplesPerBatch) const;
+
+		bool SaveCheckpoint(const Path& a_filePath) const;
+		bool LoadCheckpoint(const Path& a_filePath);
+
+		void SetSeed(const u64 a_seed);
+		void SetSignature(const RenderSignature& a_signature);
+		void SetImageOffset(const vath::Vector2u32& a_imageOffsetInPx);
+		void SetFirstPassIndex(const u32 a_passIndex);
+		void SetCompletedPassCount(const u32 a_passCount);
+
+		const vath::Vector2u32& GetDimensions() const;
+		const vath::Vector2u32& GetImageOffset() const;
+		u32 GetPixelCount() const;
+		u64 GetSeed() const;
+		const RenderSignature& GetSignature() const;
+		u32 GetFirstPassIndex() const;
+		u32 GetCompletedPassCount() const;
+		u32 GetSampleCount(const u32 a_pixelIndex) const;
+		fp32 GetWeight(const u32 a_pixelIndex) const;
+		Color GetRadiance(const u32 a_pixelIndex) const;
+
+		/// <summary>
+		/// Variance of the mean luminance of the samples rendered for a pixel, every batch mean is treated as a single estimate of the pixel.
+		/// Returns fp32max while the pixel holds less than two batches.
+		/// </summary>
+		fp32 GetVariance(const u32 a_pixelIndex, const u32 a_samplesPerBatch) const;
+		fp32 GetRelativeError(const u32 a_pixelIndex, const u32 a_samplesPerBatch) const;
+
+		Color* GetRadianceSumData();
+		const Color* GetRadianceSumData() const;
+		fp32* GetWeightSumData();
+		const fp32* GetWeightSumData() const;
+		u32* GetSampleCountData();
+		const u32* GetSampleCountData() const;
+		fp32* GetLuminanceSumData();
+		const fp32* GetLuminanceSumData() const;
+		fp32* GetLuminanceSquaredSumData();
+		const fp32* GetLuminanceSquaredSumData() const;
+
+	private:
+		std::vector<Color> m_radianceSum;
+		std::vector<fp32> m_weightSum;
+		std::vector<u32> m_sampleCounts;
+		std::vector<fp32> m_luminanceSum;
+		std::vector<fp32> m_luminanceSquaredSum;
+		vath::Vector2u32 m_dimensions;
+		vath::Vector2u32 m_imageOffset;
+		u64 m_seed;
+		RenderSignature m_signature;
+		u32 m_firstPassIndex;
+		u32 m_completedPassCount;
+	};
+
+	inline void AccumulationBuffer::AddSampleBatch(const u32 a_pixelIndex, const Color& a_radianceSum, const u32 a_sampleCount)
+	{
+		const fp32 batchLuminance = Luminance(a_radianceSum) / static_cast<fp32>(a_sampleCount);
+		m_sampleCounts[a_pixelIndex] += a_sampleCount;
+		m_luminanceSum[a_pixelIndex] += batchLuminance;
+		m_luminanceSquaredSum[a_pixelIndex] += batchLuminance * batchLuminance;
+	}
+
+	inline void AccumulationBuffer::AddWeightedRadiance(const u32 a_pixelIndex, const Color& a_weightedRadianceSum, const fp32 a_weightSum)
+	{
+		m_radianceSum[a_pixelIndex] += a_weightedRadianceSum;
+		m_weightSum[a_pixelIndex] += a_weightSum;
+	}
+
+	inline void AccumulationBuffer::SetSeed(const u64 a_seed)
+	{
+		m_seed = a_seed;
+	}
+
+	inline void AccumulationBuffer::SetSignature(const RenderSignature& a_signature)
+	{
+		m_signature = a_signature;
+	}
+
+	inline void AccumulationBuffer::SetImageOffset(const vath::Vector2u32& a_imageOffsetInPx)
+	{
+		m_imageOffset = a_imageOffsetInPx;
+	}
+
+	inline void AccumulationBuffer::SetFirstPassIndex(const u32 a_passIndex)
+	{
+		m_firstPassIndex = a_passIndex;
+		m_completedPassCount = a_passIndex;
+	}
+
+	inline void AccumulationBuffer::SetCompletedPassCount(const u32 a_passCount)
+	{
+		m_completedPassCount = a_passCount;
+	}
+
+	inline const vath::Vector2u32& AccumulationBuffer::GetDimensions() const
+	{
+		return m_dimensions;
+	}
+
+	inline const vath::Vector2u32& AccumulationBuffer::GetImageOffset() const
+	{
+		return m_imageOffset;
+	}
+
+	inline u32 AccumulationBuffer::GetPixelCount() const
+	{
+		return m_dimensions.x * m_dimensions.y;
+	}
+
+	inline u64 AccumulationBuffer::GetSeed() const
+	{
+		return m_seed;
+	}
+
+	inline const RenderSignature& AccumulationBuffer::GetSignature() const
+	{
+		return m_signature;
+	}
+
+	inline u32 AccumulationBuffer::GetFirstPassIndex() const
+	{
+		return m_firstPassIndex;
+	}
+
+	inline u32 AccumulationBuffer::GetCompletedPassCount() const
+	{
+		return m_completedPassCount;
+	}
+
+	inline u32 AccumulationBuffer::GetSampleCount(const u32 a_pixelIndex) const
+	{
+		return m_sampleCounts[a_pixelIndex];
+	}
+
+	inline fp32 AccumulationBuffer::GetWeight(const u32 a_pixelIndex) const
+	{
+		return m_weightSum[a_pixelIndex];
+	}
+
+	inline Color AccumulationBuffer::GetRadiance(const u32 a_pixelIndex) const
+	{
+		//#Note: Filters with negative lobes can weight a pixel next to a bright one into negative radiance, which is clamped.
+		const fp32 weightSum = m_weightSum[a_pixelIndex];
+		if (weightSum <= 0.0f)
+		{
+			return Color(0.0f);
+		}
+
+		const Color radiance = m_radianceSum[a_pixelIndex] / weightSum;
+		return Color(vath::Max(radiance.x, 0.0f), vath::Max(radiance.y, 0.0f), vath::Max(radiance.z, 0.0f));
+	}
+
+	inline Color* AccumulationBuffer::GetRadianceSumData()
+	{
+		return m_radianceSum.data();
+	}
+
+	inline const Color* AccumulationBuffer::GetRadianceSumData() const
+	{
+		return m_radianceSum.data();
+	}
+
+	inline fp32* AccumulationBuffer::GetWeightSumData()
+	{
+		return m_weightSum.data();
+	}
+
+	inline const fp32* AccumulationBuffer::GetWeightSumData() const
+	{
+		return m_weightSum.data();
+	}
+
+	inline u32* AccumulationBuffer::GetSampleCountData()
+	{
+		return m_sampleCounts.data();
+	}
+
+	inline const u32* AccumulationBuffer::GetSampleCountData() const
+	{
+		return m_sampleCounts.data();
+	}
+
+	inline fp32* AccumulationBuffer::GetLuminanceSumData()
+	{
+		return m_luminanceSum.data();
+	}
+
+	inline const fp32* AccumulationBuffer::GetLuminanceSumData() const
+	{
+		return m_luminanceSum.data();
+	}
+
+	inline fp32* AccumulationBuffer::GetLuminanceSquaredSumData()
+	{
+		return m_luminanceSquaredSum.data();
+	}
+
+	inline const fp32* AccumulationBuffer::GetLuminanceSquaredSumData() const
+	{
+		return m_luminanceSquaredSum.data();
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <core/valueTypes.h>
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Discrete distribution over weighted entries that is sampled in constant time, with two random numbers and two memory reads.
+	/// Every slot holds the probability of keeping its own entry and an alias that is picked otherwise, built with Vose's method.
+	/// </summary>
+	class AliasTable final
+	{
+	public:
+		AliasTable() = default;
+
+		/// <summary>
+		/// Builds the table over non-negative weights, entries without weight are never picked. All weights being zero results in an empty table.
+		/// </summary>
+		explicit AliasTable(const std::vector<fp32>& a_weights);
+
+		/// <summary>
+		/// Picks an entry with two uniform random numbers in [0, 1), the first one picks the slot and the second one decides between its entry and alias.
+		/// #Note: A single random number split into both decisions leaves too few bits for the second one on tables with millions of entries.
+		/// </summary>
+		u32 Sample(const fp32 a_slotRandom, const fp32 a_aliasRandom) const;
+
+		/// <summary>
+		/// Probability with which Sample picks the entry.
+		/// </summary>
+		fp32 GetProbability(const u32 a_index) const;
+
+		u32 GetCount() const;
+		bool IsEmpty() const;
+
+	private:
+		struct Slot final
+		{
+			fp32 KeepProbability = 1.0f;
+			u32 Alias = 0;
+		};
+
+		std::vector<Slot> m_slots;
+		std::vector<fp32> m_probabilities;
+	};
+
+	inline fp32 AliasTable::GetProbability(const u32 a_index) const
+	{
+		DXRAY_ASSERT(a_index < m_probabilities.size());
+		return m_probabilities[a_index];
+	}
+
+	inline u32 AliasTable::GetCount() const
+	{
+		return static_cast<u32>(m_slots.size());
+	}
+
+	inline bool AliasTable::IsEmpty() const
+	{
+		return m_slots.empty();
+	}
+}
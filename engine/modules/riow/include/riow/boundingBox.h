@@ -0,0 +1,76 @@
+#pragma once
+#include "riow/ray.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Axis aligned bounding box, used to bound traceables in the acceleration structure.
+	/// </summary>
+	struct BoundingBox final
+	{
+		vath::Vector3f Min = vath::Vector3f(fp32max);
+		vath::Vector3f Max = vath::Vector3f(-fp32max);
+
+		void Expand(const vath::Vector3f& a_point);
+		void Expand(const BoundingBox& a_box);
+
+		vath::Vector3f GetCenter() const;
+		fp32 GetSurfaceArea() const;
+		bool IsValid() const;
+
+		/// <summary>
+		/// Slab test, returns whether the ray overlaps the box within [tMin, tMax].
+		/// </summary>
+		bool DoesIntersect(const vath::Vector3f& a_rayOrigin, const vath::Vector3f& a_inverseRayDirection, fp32 a_tMin, fp32 a_tMax) const;
+	};
+
+	inline void BoundingBox::Expand(const vath::Vector3f& a_point)
+	{
+		Min = vath::Vector3f(vath::Min(Min.x, a_point.x), vath::Min(Min.y, a_point.y), vath::Min(Min.z, a_point.z));
+		Max = vath::Vector3f(vath::Max(Max.x, a_point.x), vath::Max(Max.y, a_point.y), vath::Max(Max.z, a_point.z));
+	}
+
+	inline void BoundingBox::Expand(const BoundingBox& a_box)
+	{
+		Expand(a_box.Min);
+		Expand(a_box.Max);
+	}
+
+	inline vath::Vector3f BoundingBox::GetCenter() const
+	{
+		return (Min + Max) * 0.5f;
+	}
+
+	inline fp32 BoundingBox::GetSurfaceArea() const
+	{
+		const vath::Vector3f extent = Max - Min;
+		return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+	}
+
+	inline bool BoundingBox::IsValid() const
+	{
+		return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z;
+	}
+
+	inline bool BoundingBox::DoesIntersect(const vath::Vector3f& a_rayOrigin, const vath::Vector3f& a_inverseRayDirection, fp32 a_tMin, fp32 a_tMax) const
+	{
+		for (u32 axis = 0; axis < 3; ++axis)
+		{
+			fp32 t0 = (Min[axis] - a_rayOrigin[axis]) * a_inverseRayDirection[axis];
+			fp32 t1 = (Max[axis] - a_rayOrigin[axis]) * a_inverseRayDirection[axis];
+			if (a_inverseRayDirection[axis] < 0.0f)
+			{
+				std::swap(t0, t1);
+			}
+
+			a_tMin = t0 > a_tMin ? t0 : a_tMin;
+			a_tMax = t1 < a_tMax ? t1 : a_tMax;
+			if (a_tMax < a_tMin)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "riow/camera.h"
+#include "riow/scene.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Type defined to identify scenes.
+	/// </summary>
+	enum class EScene : u8
+	{
+		BouncingSpheres = 0,
+		PerlinSpheres,
+		Volumes
+	};
+
+	/// <summary>
+	/// Builds the bouncing spheres scene. Materials and placement are drawn from the thread sampler, seed it to get the same scene every time.
+	/// </summary>
+	void BuildBouncingSpheresSceneComposition(Camera& a_camera, Scene& a_scene);
+
+	/// <summary>
+	/// Builds the perlin spheres scene, a bake resolution above 0 bakes the noise around the spheres into a grid of that resolution.
+	/// </summary>
+	void BuildPerlinSphereSceneComposition(Camera& a_camera, Scene& a_scene, const u32 a_noiseBakeResolution);
+
+	/// <summary>
+	/// Builds the volumes scene: a sphere of constant fog around a small solid sphere, and a grid density smoke sphere.
+	/// </summary>
+	void BuildVolumeSceneComposition(Camera& a_camera, Scene& a_scene);
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include "riow/traceable/raytraceable.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Bounding volume hierarchy over the traceables of a scene, built with a binned surface area heuristic.
+	/// The hierarchy bounds the traceables over a time window, so moving traceables are bounded over the full shutter interval of a frame.
+	/// #Note: The hierarchy only references the traceables, the owner has to keep them alive for as long as the hierarchy is used.
+	/// Hierarchies over other primitives only store the nodes, their owner intersects the primitives of the leaves.
+	/// </summary>
+	class BoundingVolumeHierarchy final
+	{
+	public:
+		/// <summary>
+		/// Nodes are stored depth first, the left child of an interior node directly follows its parent.
+		/// </summary>
+		struct Node final
+		{
+			BoundingBox Bounds;
+			u32 Index = 0;	//First primitive of a leaf, or the right child of an interior node.
+			u32 Count = 0;	//Primitive count of a leaf, 0 for interior nodes.
+		};
+
+		BoundingVolumeHierarchy() = default;
+		~BoundingVolumeHierarchy() = default;
+
+		void Build(const std::vector<std::shared_ptr<RayTraceable>>& a_traceables, const fp32 a_timeStart, const fp32 a_timeEnd);
+
+		/// <summary>
+		/// Builds the hierarchy over arbitrary primitives, such as the spheres of a sphere set. Leaves refer to ranges of
+		/// the primitive order, which receives the primitive indices in leaf order; owners store their primitives in that order.
+		/// </summary>
+		void Build(const std::vector<BoundingBox>& a_primitiveBounds, std::vector<u32>& a_primitiveOrder);
+
+		/// <summary>
+		/// Replaces the hierarchy with previously built nodes, used when loading cooked scenes.
+		/// </summary>
+		void SetNodes(const Node* a_pNodes, const usize a_nodeCount);
+		void Clear();
+
+		/// <summary>
+		/// Closest hit on the traceables, the traceable index of the hit is its index in the list the hierarchy was built over.
+		/// </summary>
+		bool DoesIntersect(const Ray& a_ray, fp32 a_tMin, fp32 a_tMax, IntersectionInfo& a_info) const;
+
+		/// <summary>
+		/// Whether any traceable blocks the ray within [tMin, tMax], stops at the first blocking traceable found.
+		/// </summary>
+		bool IsOccluded(const Ray& a_ray, fp32 a_tMin, fp32 a_tMax) const;
+
+		/// <summary>
+		/// Walks the hierarchy front to back and hands every leaf overlapped by the ray to the leaf intersector.
+		/// The intersector receives the primitive range of the leaf and the closest hit so far, which it shortens on a hit and then returns true.
+		/// </summary>
+		template<typename TLeafIntersector>
+		bool Traverse(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, const TLeafIntersector& a_intersectLeaf) const;
+
+		const std::vector<Node>& GetNodes() const;
+		const BoundingBox& GetBounds() const;
+		bool IsEmpty() const;
+		usize GetNodeCount() const;
+
+	private:
+		//The traversal stack holds at most one node per level plus the two children pushed last. Builds split deep nodes at the median,
+		//which bounds the depth by the build depth limit plus the log of the primitive count, see BuildRecursive.
+		static constexpr u32 MaxTraversalDepth = 64;
+
+		struct BuildItem final
+		{
+			BoundingBox Bounds;
+			vath::Vector3f Center;
+			u32 PrimitiveIndex = 0;
+		};
+
+		u32 BuildRecursive(std::vector<BuildItem>& a_items, const u32 a_begin, const u32 a_end, const u32 a_depth);
+
+		std::vector<Node> m_nodes;
+		std::vector<const RayTraceable*> m_traceables;
+		std::vector<u32> m_traceableIndices;	//Index of every leaf traceable in the list the hierarchy was built over, reported in hits.
+	};
+
+	template<typename TLeafIntersector>
+	inline bool BoundingVolumeHierarchy::Traverse(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, const TLeafIntersector& a_intersectLeaf) const
+	{
+		if (m_nodes.empty())
+		{
+			return false;
+		}
+
+		const vath::Vector3f& rayOrigin = a_ray.GetOrigin();
+		const vath::Vector3f& rayDirection = a_ray.GetDirection();
+		const vath::Vector3f inverseRayDirection(1.0f / rayDirection.x, 1.0f / rayDirection.y, 1.0f / rayDirection.z);
+
+		fp32 closestHit = a_tMax;
+		u32 stack[MaxTraversalDepth];
+		u32 stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize > 0)
+		{
+			const Node& node = m_nodes[stack[--stackSize]];
+			if (!node.Bounds.DoesIntersect(rayOrigin, inverseRayDirection, a_tMin, closestHit))
+			{
+				continue;
+			}
+
+			if (node.Count > 0)
+			{
+				a_intersectLeaf(node.Index, node.Count, closestHit);
+				continue;
+			}
+
+			//Visit the nearest child first, so the far child can be culled by the closest hit.
+			const u32 leftChild = static_cast<u32>(&node - m_nodes.data()) + 1;
+			const u32 rightChild = node.Index;
+			const bool bLeftFirst = vath::Dot(m_nodes[leftChild].Bounds.GetCenter() - rayOrigin, rayDirection) <= vath::Dot(m_nodes[rightChild].Bounds.GetCenter() - rayOrigin, rayDirection);
+			DXRAY_ASSERT(stackSize + 2 <= MaxTraversalDepth);
+			stack[stackSize++] = bLeftFirst ? rightChild : leftChild;
+			stack[stackSize++] = bLeftFirst ? leftChild : rightChild;
+		}
+
+		return closestHit < a_tMax;
+	}
+
+	inline const std::vector<BoundingVolumeHierarchy::Node>& BoundingVolumeHierarchy::GetNodes() const
+	{
+		return m_nodes;
+	}
+
+	inline const BoundingBox& BoundingVolumeHierarchy::GetBounds() const
+	{
+		DXRAY_ASSERT(!m_nodes.empty());
+		return m_nodes[0].Bounds;
+	}
+
+	inline bool BoundingVolumeHierarchy::IsEmpty() const
+	{
+		return m_nodes.empty();
+	}
+
+	inline usize BoundingVolumeHierarchy::GetNodeCount() const
+	{
+		return m_nodes.size();
+	}
+}
@@ -24,8 +24,16 @@ namespace dxray::riow
 		void SetFocalLength(const fp32 a_focusDistance);
 		void SetAperture(const fp32 a_focusDistance);
 		void SetShutterSpeed(const fp32 a_shutterSpeedInSec);
+		void SetShutterOpenTime(const fp32 a_timeInSec);
+
+		/// <summary>
+		/// Projects a world space point (w = 1) or direction (w = 0) onto the viewport.
+		/// </summary>
+		/// <returns>Whether the projection lies in front of the camera and within the viewport.</returns>
+		bool ProjectToPixel(const vath::Vector4f& a_world, vath::Vector2f& a_pixelCoords) const;
 
 		const vath::Vector3f GetPosition() const;
+		const vath::Vector3f& GetFocusPoint() const;
 		const vath::Vector2u32 GetViewportDimensionsInPx() const;
 		const u32 GetViewportWidthInPx() const;
 		const u32 GetViewportHeightInPx() const;
@@ -37,6 +45,7 @@ namespace dxray::riow
 		const fp32 GetAperture() const;
 		const fp32 GetFov() const;
 		const fp32 GetShutterSpeed() const;
+		const fp32 GetShutterOpenTime() const;
 		const vath::Rect<fp32>& GetViewportRect() const;
 		const vath::Matrix4x4f& GetViewTransform() const;
 		const vath::Matrix4x4f& GetWorldTransform() const;
@@ -47,11 +56,13 @@ namespace dxray::riow
 		vath::Vector2u32 m_viewportPixelDims;
 		vath::Rect<fp32> m_viewportRect;
 		vath::Vector2f m_depthLimits;
+		vath::Vector3f m_focusPoint;
 		fp32 m_aspectRatio;
 		fp32 m_focalLength;
 		fp32 m_aperture;
 		fp32 m_fov;
 		fp32 m_shutterSpeed;
+		fp32 m_shutterOpenTime;
 	};
 
 
@@ -90,12 +101,22 @@ namespace dxray::riow
 		m_shutterSpeed = a_shutterSpeedInSec;
 	}
 
+	inline void Camera::SetShutterOpenTime(const fp32 a_timeInSec)
+	{
+		m_shutterOpenTime = a_timeInSec;
+	}
+
 	inline const vath::Vector3f Camera::GetPosition() const
 	{
 		const vath::Vector4& camPos = m_worldTransform[3];
 		return vath::Vector3f(camPos.x, camPos.y, camPos.z);
 	}
 
+	inline const vath::Vector3f& Camera::GetFocusPoint() const
+	{
+		return m_focusPoint;
+	}
+
 	inline const vath::Vector2u32 Camera::GetViewportDimensionsInPx() const
 	{
 		return m_viewportPixelDims;
@@ -151,6 +172,11 @@ namespace dxray::riow
 		return m_shutterSpeed;
 	}
 
+	inline const fp32 Camera::GetShutterOpenTime() const
+	{
+		return m_shutterOpenTime;
+	}
+
 	inline const vath::Rect<fp32>& Camera::GetViewportRect() const
 	{
 		return m_viewportRect;
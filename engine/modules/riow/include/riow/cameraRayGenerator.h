@@ -0,0 +1,83 @@
+#pragma once
+#include "riow/camera.h"
+#include "riow/ray.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Camera samples of up to eight rays in structure-of-arrays layout, filled in by the renderer.
+	/// </summary>
+	struct alignas(32) CameraSampleBatch final
+	{
+		static constexpr u32 Capacity = static_cast<u32>(vath::Float8::LaneCount);
+
+		fp32 PixelX[Capacity] = {};		//Continuous pixel coordinates, the integer part is the pixel index.
+		fp32 PixelY[Capacity] = {};
+		fp32 LensX[Capacity] = {};		//Position on the unit lens disk.
+		fp32 LensY[Capacity] = {};
+		fp32 Time[Capacity] = {};		//Position in the shutter interval [0, 1).
+	};
+
+	/// <summary>
+	/// Camera rays in structure-of-arrays layout.
+	/// </summary>
+	struct alignas(32) CameraRayBatch final
+	{
+		static constexpr u32 Capacity = CameraSampleBatch::Capacity;
+
+		fp32 OriginX[Capacity];
+		fp32 OriginY[Capacity];
+		fp32 OriginZ[Capacity];
+		fp32 DirectionX[Capacity];
+		fp32 DirectionY[Capacity];
+		fp32 DirectionZ[Capacity];
+		fp32 Time[Capacity];
+
+		Ray GetRay(const u32 a_lane) const;
+	};
+
+	inline Ray CameraRayBatch::GetRay(const u32 a_lane) const
+	{
+		return Ray(
+			vath::Vector3f(OriginX[a_lane], OriginY[a_lane], OriginZ[a_lane]),
+			vath::Vector3f(DirectionX[a_lane], DirectionY[a_lane], DirectionZ[a_lane]),
+			Time[a_lane]
+		);
+	}
+
+	/// <summary>
+	/// Generates thin lens camera rays eight at a time. The image plane and lens basis are derived from the camera once,
+	/// so generating a ray only takes a handful of multiply-adds per lane instead of a matrix transform and a basis rebuild.
+	/// #Note: Rays match the ones the renderer generated from the camera matrix, directions point at the focal plane and are not normalized.
+	/// </summary>
+	class CameraRayGenerator final
+	{
+	public:
+		CameraRayGenerator(const Camera& a_camera);
+		~CameraRayGenerator() = default;
+
+		void Generate(const CameraSampleBatch& a_samples, CameraRayBatch& a_rays) const;
+
+		/// <summary>
+		/// Angle covered by a single pixel, the spread of the ray cone of a camera ray.
+		/// </summary>
+		fp32 GetPixelSpreadAngle() const;
+
+	private:
+		vath::Vector3f m_position;
+		vath::Vector3f m_imagePlaneOrigin;	//Direction through the top left corner of the image plane.
+		vath::Vector3f m_pixelStepX;		//Direction offset between horizontally adjacent pixels.
+		vath::Vector3f m_pixelStepY;
+		vath::Vector3f m_lensRight;			//Camera right and up axes, scaled by the lens radius.
+		vath::Vector3f m_lensUp;
+		fp32 m_focalLength;
+		fp32 m_shutterOpenTime;
+		fp32 m_shutterSpeed;
+		fp32 m_pixelSpreadAngle;
+	};
+
+	inline fp32 CameraRayGenerator::GetPixelSpreadAngle() const
+	{
+		return m_pixelSpreadAngle;
+	}
+}
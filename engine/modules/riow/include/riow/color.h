@@ -21,6 +21,16 @@ namespace dxray::riow
         );
     }
 
+    /// <summary>
+    /// Relative luminance of a linear color, using the Rec. 709 primaries.
+    /// </summary>
+    /// <param name="a_color"></param>
+    /// <returns></returns>
+    inline fp32 Luminance(const Color& a_color)
+    {
+        return 0.2126f * a_color.x + 0.7152f * a_color.y + 0.0722f * a_color.z;
+    }
+
     /// <summary>
     /// Rough transform function to transform color textures that are stored in srgb space to linear space.
     /// </summary>
@@ -0,0 +1,104 @@
+#pragma once
+#include <core/network/socket.h>
+#include <condition_variable>
+#include "riow/renderer.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Defines how a frame is split into work units for distributed rendering.
+	/// </summary>
+	enum class EShardingMode : u8
+	{
+		ImageRegion = 0,	//Every unit renders all passes of a band of tile rows.
+		SampleRange			//Every unit renders a range of passes for the full image, each pass draws a disjoint sampler sequence.
+	};
+
+	/// <summary>
+	/// Distributed render configuration.
+	/// </summary>
+	struct DistributedRenderSettings final
+	{
+		EShardingMode ShardingMode = EShardingMode::ImageRegion;
+		u16 WorkerCount = 2;
+		u16 Port = 0;			//0 lets the operating system pick a free port.
+		u32 UnitSize = 8;		//Tile rows per unit when sharding image regions, passes per unit when sharding sample ranges.
+		u32 ConnectTimeoutInSec = 60;	//Time the workers get to build their scene and connect, workers that miss it are terminated.
+	};
+
+	/// <summary>
+	/// Per worker bookkeeping, used to report throughput and load imbalance.
+	/// </summary>
+	struct WorkerStatistics final
+	{
+		u32 UnitCount = 0;
+		u64 SampleCount = 0;
+		fp64 BusyTimeInSec = 0.0;
+	};
+
+	/// <summary>
+	/// The coordinator splits a frame into work units and hands them out to worker processes that connect over a local socket.
+	/// Units are handed out on request, so faster workers pick up more work. Results are merged in unit order, which keeps the
+	/// merged accumulation buffer deterministic regardless of the worker count or the order units finish in.
+	/// The unit of a worker that is lost goes back to the pending units, every connected worker keeps waiting for units until all are merged.
+	/// #Note: Workers are spawned as child processes of the same executable and are expected to build the exact same scene, camera and pipeline.
+	/// Workers introduce themselves with their pipeline, workers that would render a different image are shut down.
+	/// #Note: Units are split up by pass count, pipelines with a time budget or adaptive sampling are rejected.
+	/// #Note: Every unit trains a path guide of its own, which requires the units to hold all passes of their pixels. Path guiding is therefore
+	/// rejected with sample range sharding, image region units train a guide per band.
+	/// #Note: Reservoirs are reused between the passes of a unit only, reservoir reuse is rejected with sample range sharding as well.
+	/// #Note: Image region units truncate the reconstruction filter along their borders, filters wider than a pixel require sample range sharding.
+	/// </summary>
+	class RenderCoordinator final
+	{
+	public:
+		RenderCoordinator(const DistributedRenderSettings& a_settings);
+		~RenderCoordinator() = default;
+
+		/// <summary>
+		/// Renders the remaining passes of the accumulation buffer using worker processes.
+		/// </summary>
+		/// <param name="a_accumulationBuffer">Buffer spanning the full image, merged results are added to it.</param>
+		/// <param name="a_pipeline">The pipeline the workers render with, used to split up the passes and validate the workers.</param>
+		/// <param name="a_workerExecutable">Executable spawned for every worker.</param>
+		/// <param name="a_workerArguments">Arguments passed to every worker, the coordinator appends "--worker <port>".</param>
+		/// <returns>Whether all units were rendered, false without rendering when the pipeline has a time budget or adaptive sampling.</returns>
+		bool Render(AccumulationBuffer& a_accumulationBuffer, const RendererPipeline& a_pipeline, const Path& a_workerExecutable, const std::vector<String>& a_workerArguments);
+
+		const std::vector<WorkerStatistics>& GetWorkerStatistics() const;
+
+	private:
+		struct WorkUnit final
+		{
+			vath::Vector2u32 ImageOffset;
+			vath::Vector2u32 Dimensions;
+			u32 FirstPass = 0;
+			u32 EndPass = 0;
+		};
+
+		void BuildWorkUnits(const AccumulationBuffer& a_accumulationBuffer, const RendererPipeline& a_pipeline);
+		void ServeWorker(Socket a_connection, const u32 a_workerIndex, AccumulationBuffer& a_accumulationBuffer, const RendererPipeline& a_pipeline);
+		void MergeResult(const u32 a_unitIndex, AccumulationBuffer&& a_unitBuffer, AccumulationBuffer& a_accumulationBuffer);
+		void ReportStatistics(const fp64 a_wallTimeInSec) const;
+
+		DistributedRenderSettings m_settings;
+		std::vector<WorkUnit> m_units;
+		std::vector<u32> m_pendingUnits;
+		std::unordered_map<u32, AccumulationBuffer> m_finishedUnits;
+		std::vector<WorkerStatistics> m_workerStatistics;
+		std::mutex m_unitMutex;
+		std::condition_variable m_unitCondition;	//Signalled when a unit is rescheduled or merged.
+		u32 m_nextMergeUnit;
+	};
+
+	inline const std::vector<WorkerStatistics>& RenderCoordinator::GetWorkerStatistics() const
+	{
+		return m_workerStatistics;
+	}
+
+	/// <summary>
+	/// Connects to a coordinator and renders the work units it hands out until the coordinator has no units left.
+	/// </summary>
+	/// <returns>Process exit code, 0 on success.</returns>
+	i32 RunRenderWorker(Renderer& a_renderer, const Scene& a_scene, const vath::Vector2u32& a_imageDimensions, const u16 a_coordinatorPort);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "riow/aliasTable.h"
+#include "riow/color.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Light arriving from infinitely far away, stored as an equirectangular radiance map: u follows the azimuth around the y axis, starting
+	/// at +x and continuing towards -z, v follows the polar angle from +y at the top row down to -y at the bottom row.
+	/// Directions are sampled from a piecewise constant distribution over the texels, proportional to their luminance times the solid angle they
+	/// cover, built into a single alias table so a sample costs the same regardless of the map size. Radiance is looked up from the nearest texel,
+	/// so the density matches the radiance exactly and bright texels such as the sun are sampled without leaking into their neighbours.
+	/// #Note: The texels are shared between copies, scenes are copied per frame when rendering sequences.
+	/// </summary>
+	class EnvironmentLight final
+	{
+	public:
+		/// <summary>
+		/// Builds the map from linear RGB texels, stored row by row from the top left.
+		/// </summary>
+		EnvironmentLight(const vath::Vector2u32& a_dimensions, const std::vector<Color>& a_linearTexels, const fp32 a_strength = 1.0f);
+
+		/// <summary>
+		/// Loads a high dynamic range image, a file that fails to load results in a black environment.
+		/// </summary>
+		static EnvironmentLight LoadFromFile(const Path& a_path, const fp32 a_strength = 1.0f);
+
+		/// <summary>
+		/// Radiance arriving from the direction, which doesn't have to be normalized.
+		/// </summary>
+		Color Evaluate(const vath::Vector3f& a_direction) const;
+
+		/// <summary>
+		/// Samples a unit direction towards the environment, returns false when the environment is black.
+		/// </summary>
+		bool Sample(vath::Vector3f& a_direction, Color& a_radiance, fp32& a_pdf) const;
+
+		/// <summary>
+		/// Solid angle density with which Sample picks the direction, which doesn't have to be normalized.
+		/// </summary>
+		fp32 GetPdf(const vath::Vector3f& a_direction) const;
+
+		vath::Vector2u32 GetDimensions() const;
+
+	private:
+		struct Map final
+		{
+			u32 Width = 0;
+			u32 Height = 0;
+			std::vector<Color> Radiance;		//Scaled by the strength.
+			std::vector<fp32> RowSolidAngles;	//Solid angle covered by a texel of each row, texels near the poles cover less.
+			AliasTable Distribution;
+		};
+
+		u32 GetTexelIndex(const vath::Vector3f& a_direction) const;
+
+		std::shared_ptr<const Map> m_map;
+	};
+
+	inline vath::Vector2u32 EnvironmentLight::GetDimensions() const
+	{
+		return vath::Vector2u32(m_map->Width, m_map->Height);
+	}
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include "riow/accumulationBuffer.h"
+#include <array>
+#include <map>
+#include <mutex>
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Filter that weights a sample by its distance to the center of the pixels around it.
+	/// </summary>
+	enum class EReconstructionFilter : u8
+	{
+		Box,		//Every sample counts for the pixels it lands in only, at the default radius.
+		Tent,
+		Gaussian,
+		Mitchell,	//Sharper than the others, its negative lobes can ring around high contrast edges.
+	};
+
+
+	/// <summary>
+	/// Separable reconstruction filter, the 1d profile is tabulated over its radius once so weighting a sample costs two lookups.
+	/// Offsets are in pixels, the filter is 0 beyond its radius. The table is normalized to integrate to 1 over the plane, so the weight sum of a pixel
+	/// counts the samples that reached it whatever the filter and radius.
+	/// See Mitchell and Netravali 1988, Reconstruction filters in computer graphics.
+	/// </summary>
+	class ReconstructionFilter final
+	{
+	public:
+		static constexpr u32 TableSize = 64;
+
+		/// <summary>
+		/// A radius of 0 picks the default radius of the filter.
+		/// </summary>
+		explicit ReconstructionFilter(const EReconstructionFilter a_type = EReconstructionFilter::Box, const fp32 a_radiusInPx = 0.0f);
+
+		fp32 Evaluate(const fp32 a_offsetXInPx, const fp32 a_offsetYInPx) const;
+
+		EReconstructionFilter GetType() const;
+		fp32 GetRadius() const;
+
+		/// <summary>
+		/// Pixels a sample reaches beyond the pixel it lands in, on every side.
+		/// </summary>
+		u32 GetMarginInPx() const;
+
+		static fp32 GetDefaultRadius(const EReconstructionFilter a_type);
+
+	private:
+		fp32 EvaluateTable(const fp32 a_offsetInPx) const;
+
+		std::array<fp32, TableSize> m_table;
+		EReconstructionFilter m_type;
+		fp32 m_radius;
+		fp32 m_tableScale;
+	};
+
+	inline fp32 ReconstructionFilter::Evaluate(const fp32 a_offsetXInPx, const fp32 a_offsetYInPx) const
+	{
+		return EvaluateTable(a_offsetXInPx) * EvaluateTable(a_offsetYInPx);
+	}
+
+	inline fp32 ReconstructionFilter::EvaluateTable(const fp32 a_offsetInPx) const
+	{
+		const u32 index = static_cast<u32>(vath::Abs(a_offsetInPx) * m_tableScale);
+		return m_table[vath::Min(index, TableSize - 1)];
+	}
+
+	inline EReconstructionFilter ReconstructionFilter::GetType() const
+	{
+		return m_type;
+	}
+
+	inline fp32 ReconstructionFilter::GetRadius() const
+	{
+		return m_radius;
+	}
+
+
+	/// <summary>
+	/// Weighted radiance of the pixels a task renders, plus the margin its samples reach into around them.
+	/// Tasks splat their samples into a tile of their own without synchronization and merge it into the film once they are done.
+	/// A tile can cover any rectangle of the film, samples landing outside of it are dropped.
+	/// </summary>
+	class FilmTile final
+	{
+	public:
+		FilmTile() = default;
+
+		/// <summary>
+		/// Adds the filter weighted radiance of a sample to every pixel of the tile within the filter radius around it.
+		/// The position is in image pixels, pixel x covers (x, x + 1] like the anti-aliasing offsets of the renderer.
+		/// </summary>
+		void AddSample(const vath::Vector2f& a_imagePositionInPx, const Color& a_radiance);
+
+	private:
+		friend class Film;
+
+		const ReconstructionFilter* m_pFilter = nullptr;
+		vath::Vector2i32 m_imageOffset = vath::Vector2i32(0);	//Image pixel of the first pixel of the tile.
+		vath::Vector2u32 m_dimensions = vath::Vector2u32(0u);
+		std::vector<Color> m_radianceSum;
+		std::vector<fp32> m_weightSum;
+	};
+
+
+	/// <summary>
+	/// Reconstructs the image in an accumulation buffer from samples at arbitrary positions: every sample adds its radiance to the pixels
+	/// around it, weighted by the reconstruction filter, and pixels resolve into their weighted radiance over their summed weights.
+	/// Samples are splatted into film tiles, which are merged into the buffer under a lock. Tiles of filters that stay within the pixel
+	/// a sample lands in don't overlap and merge without it.
+	/// Overlapping tiles are merged in the order they were handed out rather than the order they finish in, a tile that finishes early waits
+	/// for the tiles before it. The floating point sums of the shared pixels are therefore the same in every run, regardless of the thread count.
+	/// #Note: Pixels outside of the buffer are dropped, a buffer that covers a sub-region of the image truncates the filter along its borders.
+	/// Region sharded and streamed renders render sub-regions and therefore reject filters with a margin.
+	/// The pixels there resolve into the weighted mean of the samples that did reach them, like the pixels along the image border.
+	/// </summary>
+	class Film final
+	{
+	public:
+		Film(AccumulationBuffer& a_buffer, const ReconstructionFilter& a_filter);
+
+		/// <summary>
+		/// Clears the tile and sizes it for the samples of the pixels of a region of the buffer, including the filter margin around them.
+		/// </summary>
+		void InitializeTile(const vath::Vector2u32& a_regionOffset, const vath::Vector2u32& a_regionDimensions, FilmTile& a_tile) const;
+
+		/// <summary>
+		/// Adds the weighted radiance of the tile to the buffer, thread safe.
+		/// </summary>
+		/// <param name="a_tileIndex">Order in which the tiles of the film were handed out, counting up from 0 without gaps.
+		/// Every tile has to be merged, the tiles after a missing one are held back.</param>
+		void MergeTile(FilmTile&& a_tile, const u64 a_tileIndex);
+
+		const ReconstructionFilter& GetFilter() const;
+		AccumulationBuffer& GetAccumulationBuffer();
+
+	private:
+		void AddTile(const FilmTile& a_tile);
+
+		AccumulationBuffer& m_buffer;
+		ReconstructionFilter m_filter;
+		std::mutex m_mergeMutex;
+		std::map<u64, FilmTile> m_pendingTiles;	//Tiles that finished ahead of the next tile in order.
+		u64 m_nextTileIndex;
+	};
+
+	inline const ReconstructionFilter& Film::GetFilter() const
+	{
+		return m_filter;
+	}
+
+	inline AccumulationBuffer& Film::GetAccumulationBuffer()
+	{
+		return m_buffer;
+	}
+}
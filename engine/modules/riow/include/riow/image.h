@@ -1,6 +1,7 @@
 #pragma once
 #include <core/containers/string.h>
 #include <core/vath/vath.h>
+#include <core/thread/taskScheduler.h>
 #include "riow/color.h"
 
 namespace dxray::riow
@@ -9,7 +10,7 @@ namespace dxray::riow
 
     /// <summary>
     /// Holds byte formatted image data.
-    /// #Todo: Implement HDR image data loading, i.e. an image that can hold fp32 for it's data.
+    /// #Note: HDR image data is loaded by MipTexture, which stores linear floating point texels.
     /// </summary>
     class Image
     {
@@ -18,6 +19,8 @@ namespace dxray::riow
         {
             png = 0,
             jpg,
+            pfm,        //Portable float map, 32 bit float RGB.
+            exr,        //OpenEXR, uncompressed scanlines of half or 32 bit float RGB.
             Invalid = 255
         };
 
@@ -64,6 +67,24 @@ namespace dxray::riow
         return m_channelCount;
     }
 
-    //#Todo: Should be reimplemented to: SaveBufferToFile(takes in any buffer type + stride per data + datatype).
+    /// <summary>
+    /// Output files are stored in the binary directory of the build configuration, the extension is appended to the file name.
+    /// </summary>
+    extern Path GetOutputFilePath(const String& a_fileName, const Image::EFileExtension a_fileExtension);
+
+    /// <summary>
+    /// Stores 8 bit pixels, rows from the top left, as png or jpg. png encoding is split over the task scheduler when one is passed.
+    /// </summary>
+    extern i32 SavePixelBufferToFile(const String& a_fileName, const Image::EFileExtension a_fileExtension, i32 a_width, i32 a_height, i32 a_numChannels, const u8* a_pPixelData, TaskScheduler* a_pTaskScheduler = nullptr);
+
+    /// <summary>
+    /// Stores linear radiance without any clamping or encoding, as pfm or exr, so exposure and tone mapping can be decided afterwards.
+    /// </summary>
+    /// <param name="a_bHalfPrecision">Stores exr channels as 16 bit floats, pfm is always stored as 32 bit floats.</param>
+    extern bool SaveRadianceBufferToFile(const String& a_fileName, const Image::EFileExtension a_fileExtension, i32 a_width, i32 a_height, const Color* a_pRadianceData, const bool a_bHalfPrecision = true);
+
+    /// <summary>
+    /// Quantizes colors to 8 bits without any encoding, for debug output. Radiance meant for display goes through EncodeDisplayImage.
+    /// </summary>
     extern i32 SaveColorBufferToFile(const String& a_fileName, const Image::EFileExtension a_fileExtension, i32 a_width, i32 a_height, i32 a_numChannels, Color* a_pColorData, bool a_bNormalizedData);
 }
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+#include <fstream>
+#include "riow/image.h"
+#include "riow/postProcess.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Writes an image file row by row from the top, every row goes to the file as soon as it is passed in.
+	/// Only the rows of a single call are held in memory, which allows storing images that do not fit in memory as a whole.
+	/// png rows go through the display transform and are filtered and deflated per call, exr and pfm store the linear radiance.
+	/// </summary>
+	class ScanlineImageWriter final
+	{
+	public:
+		/// <param name="a_bHalfPrecision">Stores exr channels as 16 bit floats, ignored for the other formats.</param>
+		ScanlineImageWriter(const String& a_fileName, const Image::EFileExtension a_fileExtension, const vath::Vector2u32& a_dimensionsInPx,
+			const DisplayTransform& a_displayTransform = DisplayTransform(), const bool a_bHalfPrecision = true);
+		~ScanlineImageWriter();
+
+		ScanlineImageWriter(const ScanlineImageWriter&) = delete;
+		ScanlineImageWriter& operator=(const ScanlineImageWriter&) = delete;
+
+		/// <summary>
+		/// Writes the next rows of the image, the radiance holds a_rowCount full rows.
+		/// </summary>
+		bool WriteRows(const Color* a_pRadiance, const u32 a_rowCount);
+
+		/// <summary>
+		/// Completes the file once all rows are written, called by the destructor when not called explicitly.
+		/// </summary>
+		bool Finish();
+
+		bool IsOpen() const;
+		u32 GetWrittenRowCount() const;
+
+	private:
+		void WriteHeader();
+		void WritePngRows(const Color* a_pRadiance, const u32 a_rowCount);
+		void WriteExrRows(const Color* a_pRadiance, const u32 a_rowCount);
+		void WritePfmRows(const Color* a_pRadiance, const u32 a_rowCount);
+		void WritePngChunk(const char a_type[4], const std::vector<u8>& a_data);
+
+		std::ofstream m_file;
+		Path m_filePath;
+		vath::Vector2u32 m_dimensions;
+		DisplayTransform m_displayTransform;
+		std::vector<u8> m_encodeBuffer;
+		std::vector<u8> m_pixelBuffer;
+		std::vector<u8> m_previousRow;
+		std::vector<u8> m_deflateHistory;
+		usize m_headerSizeInBytes;
+		u32 m_writtenRowCount;
+		u32 m_pngAdler;
+		Image::EFileExtension m_fileExtension;
+		bool m_bHalfPrecision;
+		bool m_bFinished;
+	};
+
+	inline bool ScanlineImageWriter::IsOpen() const
+	{
+		return m_file.is_open() && !m_file.fail();
+	}
+
+	inline u32 ScanlineImageWriter::GetWrittenRowCount() const
+	{
+		return m_writtenRowCount;
+	}
+}
@@ -0,0 +1,218 @@
+#pragma once
+#include "riow/material.h"
+#include "riow/environmentLight.h"
+#include "riow/boundingBox.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Emissive sphere, lights are sampled towards the cone of directions a sphere covers as seen from the shaded point.
+	/// </summary>
+	struct SphereLight final
+	{
+		vath::Vector3f Center = vath::Vector3f(0.0f);		//Center at time 0.
+		fp32 Radius = 0.0f;
+		vath::Vector3f Velocity = vath::Vector3f(0.0f);	//Motion of the center per unit of time.
+		MaterialId Material = InvalidResourceId;
+
+		vath::Vector3f GetCenter(const fp32 a_time) const;
+	};
+
+	inline vath::Vector3f SphereLight::GetCenter(const fp32 a_time) const
+	{
+		return Center + Velocity * a_time;
+	}
+
+
+	/// <summary>
+	/// Sample of a light that stays meaningful from other shaded points and at other times, so a sample picked for one point can be reused at another:
+	/// a sample of the cone a sphere light covers as seen from the shaded point, which lands on the visible part of the light from every point,
+	/// or a direction towards the environment. Densities over light points are per unit of area of the cone sample square, per unit of solid angle for the environment.
+	/// </summary>
+	struct LightPoint final
+	{
+		vath::Vector3f Direction = vath::Vector3f(0.0f);	//Direction towards the environment.
+		vath::Vector2f ConeSample = vath::Vector2f(0.0f);	//Sample of the cone a sphere light covers, in the unit square.
+		u32 LightIndex = InvalidLightIndex;					//InvalidLightIndex for the environment.
+	};
+
+
+	/// <summary>
+	/// Direction towards a point on a light, sampled from a shaded point.
+	/// </summary>
+	struct LightSample final
+	{
+		vath::Vector3f Direction = vath::Vector3f(0.0f);	//Unit direction from the shaded point towards the light.
+		fp32 Distance = 0.0f;								//Distance to the sampled point on the light, fp32max for the environment.
+		fp32 Pdf = 0.0f;									//Solid angle density of the direction, including the probability of picking the light.
+		Color Radiance = Color(0.0f);
+		LightPoint Point;
+	};
+
+
+	/// <summary>
+	/// The emissive primitives and the environment of a scene, used for next-event estimation.
+	/// Lights are stored in a binary hierarchy that clusters them by position and power. Sampling walks it from the root and picks a child
+	/// proportional to an estimate of its contribution at the shaded point, its power over the squared distance, so the cost is logarithmic
+	/// in the light count and lights far away from the point are rarely picked.
+	/// Traceables add their lights while the scene builds its acceleration structure, keyed by their traceable and primitive index. The scene looks up
+	/// the light of the primitive in its hits, so the renderer can evaluate the density of light sampling for directions found by scattering.
+	/// The environment is picked with a fixed probability next to the hierarchy, its directions are sampled from its own distribution.
+	/// #Note: Spheres emit equally in all directions, which is why the clusters carry no bounds of the emitted directions.
+	/// </summary>
+	class LightList final
+	{
+	public:
+		LightList() = default;
+		~LightList() = default;
+
+		/// <summary>
+		/// Returns the index of the light, which FindLight returns for the traceable and primitive the light belongs to.
+		/// </summary>
+		u32 Add(const SphereLight& a_light, const u32 a_traceableIndex, const u32 a_primitiveIndex);
+		void Clear();
+
+		/// <summary>
+		/// Light of a primitive of a traceable, InvalidLightIndex when the primitive does not emit light.
+		/// </summary>
+		u32 FindLight(const u32 a_traceableIndex, const u32 a_primitiveIndex) const;
+
+		/// <summary>
+		/// Builds the hierarchy over the lights for motion within [timeStart, timeEnd], lights added afterwards require another build.
+		/// The environment is optional and has to outlive the list.
+		/// </summary>
+		void Build(const MaterialTable& a_materials, const TextureTable& a_textures, const EnvironmentLight* a_pEnvironment, const fp32 a_timeStart, const fp32 a_timeEnd);
+
+		/// <summary>
+		/// Picks a light and samples a direction within the cone it covers as seen from the point, or picks the environment and samples a direction towards it.
+		/// Returns false when no light can be sampled, e.g. when the point lies within the picked light.
+		/// </summary>
+		bool Sample(const vath::Vector3f& a_point, const fp32 a_time, const MaterialTable& a_materials, const TextureTable& a_textures, LightSample& a_sample) const;
+
+		/// <summary>
+		/// Solid angle density with which Sample picks a direction towards the light from the point, including the probability of picking the light.
+		/// </summary>
+		fp32 GetPdf(const u32 a_lightIndex, const vath::Vector3f& a_point, const fp32 a_time) const;
+
+		/// <summary>
+		/// Solid angle density with which Sample picks the direction towards the environment, including the probability of picking the environment.
+		/// </summary>
+		fp32 GetEnvironmentPdf(const vath::Vector3f& a_direction) const;
+
+		/// <summary>
+		/// Solid angle per unit of light point measure as seen from the point: the solid angle of the cone the light covers, 1 for the environment.
+		/// Dividing a density over light points by it gives the solid angle density at the point. 0 when the point lies within the light.
+		/// </summary>
+		fp32 GetLightPointJacobian(const LightPoint& a_lightPoint, const vath::Vector3f& a_point, const fp32 a_time) const;
+
+		/// <summary>
+		/// Direction, distance and radiance of the light point as seen from the point, the density of the sample is left at 0. Returns the jacobian of the light point.
+		/// </summary>
+		fp32 EvaluateLightPoint(const LightPoint& a_lightPoint, const vath::Vector3f& a_point, const fp32 a_time, const MaterialTable& a_materials, const TextureTable& a_textures,
+			LightSample& a_sample) const;
+
+		const SphereLight& GetLight(const u32 a_lightIndex) const;
+		u32 GetCount() const;
+		bool IsEmpty() const;
+
+	private:
+		static constexpr u32 MaxHierarchyDepth = 64;
+
+		//The environment usually lights a scene from all sides while the lights are small and bright, neither is known to dominate in advance.
+		static constexpr fp32 EnvironmentSelectionProbabilityWithLights = 0.5f;
+
+		/// <summary>
+		/// Nodes are stored depth first, the left child of an interior node directly follows its parent. Every leaf holds a single light.
+		/// Only what the importance needs is stored, sampling touches a node per level and the hierarchies of large scenes don't fit in cache.
+		/// </summary>
+		struct Node final
+		{
+			vath::Vector3f Center = vath::Vector3f(0.0f);
+			fp32 RadiusSquared = 0.0f;	//Squared half diagonal of the bounds.
+			fp32 Power = 0.0f;
+			u32 Index = 0;		//Light of a leaf, or the right child of an interior node.
+			bool bLeaf = false;
+		};
+
+		struct BuildItem final
+		{
+			BoundingBox Bounds;
+			vath::Vector3f Center;
+			fp32 Power = 0.0f;
+			u32 LightIndex = 0;
+		};
+
+		u32 BuildRecursive(std::vector<BuildItem>& a_items, const u32 a_begin, const u32 a_end, const u32 a_depth, const u64 a_trail);
+
+		/// <summary>
+		/// Estimated contribution of the lights of a node at the point, up to a constant factor.
+		/// Distances are clamped to the size of the node, which keeps points close to or within a cluster from favoring it without bound.
+		/// </summary>
+		static fp32 GetImportance(const Node& a_node, const vath::Vector3f& a_point);
+
+		/// <summary>
+		/// Probability of picking the left child of an interior node at the point.
+		/// </summary>
+		fp32 GetLeftProbability(const u32 a_nodeIndex, const vath::Vector3f& a_point) const;
+
+		/// <summary>
+		/// Probability of picking the environment over the hierarchy.
+		/// </summary>
+		fp32 GetEnvironmentSelectionProbability() const;
+
+		/// <summary>
+		/// 1 - cos of the half angle of the cone covered by the light, 0 when the point lies within the light.
+		/// Stored as this difference as the cosine of far away lights rounds to 1.
+		/// </summary>
+		static fp32 GetConeOneMinusCosAngle(const SphereLight& a_light, const vath::Vector3f& a_point, const fp32 a_time);
+
+		/// <summary>
+		/// Direction within the cone of the light for the cone sample, and the distance and radiance of the point on the light it hits.
+		/// </summary>
+		static void SampleCone(const SphereLight& a_light, const vath::Vector3f& a_point, const fp32 a_time, const fp32 a_oneMinusCosAngle, const vath::Vector2f& a_coneSample,
+			const MaterialTable& a_materials, const TextureTable& a_textures, LightSample& a_sample);
+
+		std::vector<SphereLight> m_lights;
+		std::vector<Node> m_nodes;
+		std::vector<u64> m_lightTrails;	//Child choices from the root to the leaf of every light, bit i is set when the right child is taken at depth i.
+		std::vector<std::vector<u32>> m_primitiveLights;	//Light index per primitive of every traceable, empty for traceables without lights.
+		const EnvironmentLight* m_pEnvironment = nullptr;
+	};
+
+	/// <summary>
+	/// Weight of a sample of one of two sampling techniques combined with multiple importance sampling, power heuristic with exponent 2.
+	/// </summary>
+	fp32 PowerHeuristic(const fp32 a_pdf, const fp32 a_otherPdf);
+
+	inline const SphereLight& LightList::GetLight(const u32 a_lightIndex) const
+	{
+		DXRAY_ASSERT(a_lightIndex < m_lights.size());
+		return m_lights[a_lightIndex];
+	}
+
+	inline u32 LightList::FindLight(const u32 a_traceableIndex, const u32 a_primitiveIndex) const
+	{
+		if (a_traceableIndex >= m_primitiveLights.size())
+		{
+			return InvalidLightIndex;
+		}
+
+		const std::vector<u32>& primitiveLights = m_primitiveLights[a_traceableIndex];
+		return a_primitiveIndex < primitiveLights.size() ? primitiveLights[a_primitiveIndex] : InvalidLightIndex;
+	}
+
+	inline u32 LightList::GetCount() const
+	{
+		return static_cast<u32>(m_lights.size());
+	}
+
+	inline bool LightList::IsEmpty() const
+	{
+		return m_lights.empty() && m_pEnvironment == nullptr;
+	}
+
+	inline fp32 LightList::GetEnvironmentSelectionProbability() const
+	{
+		return m_pEnvironment == nullptr ? 0.0f : (m_lights.empty() ? 1.0f : EnvironmentSelectionProbabilityWithLights);
+	}
+}
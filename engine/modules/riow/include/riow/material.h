@@ -1,6 +1,7 @@
 #pragma once
 #include "riow/traceable/raytraceable.h"
 #include "riow/texture.h"
+#include "riow/sampler.h"
 
 namespace dxray::riow
 {
@@ -13,22 +14,7 @@ namespace dxray::riow
 
     inline vath::Vector3f Random3dUnitDirection()
     {
-        //#Note: While riow uses this approach to get a 3d unit vector I believe this could result in long stalls. No research into a better approach has been conducted as of yet.
-        while (true)
-        {
-            const vath::Vector3 randomDirection(
-                vath::RandomNumber<fp32>(-1.0f, 1.0f),
-                vath::RandomNumber<fp32>(-1.0f, 1.0f),
-                vath::RandomNumber<fp32>(-1.0f, 1.0f)
-            );
-
-			//Checks if the point falls inside the sphere inside the box - if so return the normalized result.
-            const fp32 directionSqrMagnitude = vath::SqrMagnitude(randomDirection);
-            if (1e-160 < directionSqrMagnitude && directionSqrMagnitude <= 1.0f)
-            {
-                return randomDirection / std::sqrt(directionSqrMagnitude);
-            }
-        }
+        return vath::SquareToUniformSphere(vath::Vector2f(RandomFloat(), RandomFloat()));
     }
 
     inline vath::Vector3f Reflect(const vath::Vector3f& a_vector, const vath::Vector3f a_normal)
@@ -55,67 +41,45 @@ namespace dxray::riow
 
     //--- Material definitions ---
 
-    /// <summary>
-    /// Contains all info for the renderer to render the images.
-    /// #Todo: Potentially find a way to transform this into a concept to get rid of the inheritance. The issue now becomes:
-    /// how do we store/keep track of the materials - we could store them in 3 separate arrays, though there is no need to loop over them
-    /// making the approach ineffective.
-    /// </summary>
-    class Material
-    {
-    public:
-        virtual ~Material() = default;
-
-        virtual bool Scatter(const Ray& ray, const IntersectionInfo& a_hitInfo, Color& a_attenuation, Ray& a_scatteredRay) const
-        {
-            return false;
-        }
-
-        virtual Color Emitted(const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point) const
-        {
-            return Color(0.0);
-        }
-    };
-
-
     /// <summary>
     /// Material that shades using a lambertian diffuse reflection: meaning fully matte.
     /// </summary>
-    class Lambertian final : public Material
+    class Lambertian final
     {
     public:
-        Lambertian(const Color& a_albedoColor) :
-            m_albedo(std::make_shared<SolidColor>(a_albedoColor))
+        Lambertian(const TextureId a_albedo) :
+            m_albedo(a_albedo)
         { }
 
-        Lambertian(std::shared_ptr<Texture> a_texture) :
-            m_albedo(a_texture)
-        { }
-
-        bool Scatter(const Ray& a_ray, const IntersectionInfo& a_hitInfo, Color& a_attenuation, Ray& a_scatteredRay) const override
+        bool Scatter(const Ray& a_ray, const IntersectionInfo& a_hitInfo, const TextureTable& a_textures, Color& a_attenuation, Ray& a_scatteredRay) const
         {
             //Instead of sampling from the hemi-sphere through a uniform distributed direction use a cosine weighted distribution, which results in a random direction
             //thats more likely to shoot towards the normal than the edges - thereby abiding lamberts law of cosine.
-            vath::Vector3f scatterDirection = a_hitInfo.Normal + Random3dUnitDirection();
-			if (IsVectorNearZero(scatterDirection))
-            {
-                scatterDirection = a_hitInfo.Normal;
-            }
+            const vath::Vector3f localDirection = vath::SquareToCosineHemisphere(vath::Vector2f(RandomFloat(), RandomFloat()));
+            const vath::Vector3f scatterDirection = vath::OrthonormalBasis<fp32>(a_hitInfo.Normal).ToWorld(localDirection);
 
             a_scatteredRay = Ray(a_hitInfo.Point, scatterDirection, a_ray.GetTime());
-            a_attenuation = m_albedo->Sample(a_hitInfo.UvCoord, a_hitInfo.Point);
+            a_attenuation = a_textures.Sample(m_albedo, a_hitInfo.UvCoord, a_hitInfo.Point, a_hitInfo.UvFootprint);
             return true;
         }
 
+        /// <summary>
+        /// Solid angle density of the scattered direction, cosine weighted around the normal.
+        /// </summary>
+        static fp32 GetPdf(const vath::Vector3f& a_normal, const vath::Vector3f& a_unitDirection)
+        {
+            return vath::CosineHemispherePdf(vath::Dot(a_normal, a_unitDirection));
+        }
+
     private:
-        std::shared_ptr<Texture> m_albedo;
+        TextureId m_albedo;
     };
 
 
     /// <summary>
     /// Material that representing glossy material scattering.
     /// </summary>
-    class Metallic final : public Material
+    class Metallic final
     {
     public:
         Metallic(const Color& a_albedoColor, const fp32 a_glossynessFactor) :
@@ -123,7 +87,7 @@ namespace dxray::riow
             m_glossyness(vath::Min<fp32>(a_glossynessFactor, 1.0f))
         {}
 
-        bool Scatter(const Ray& a_ray, const IntersectionInfo& a_hitInfo, Color& a_attenuation, Ray& a_scatteredRay) const override
+        bool Scatter(const Ray& a_ray, const IntersectionInfo& a_hitInfo, Color& a_attenuation, Ray& a_scatteredRay) const
         {
             vath::Vector3f reflected = Reflect(a_ray.GetDirection(), a_hitInfo.Normal);
             reflected = Normalize(reflected) + m_glossyness * Random3dUnitDirection();
@@ -143,7 +107,7 @@ namespace dxray::riow
     /// <summary>
     /// Material that representing refractive mediums.
     /// </summary>
-    class Dielectric final : public Material
+    class Dielectric final
     {
     public:
         Dielectric(const fp32 a_refractiveIndex) :
@@ -151,7 +115,7 @@ namespace dxray::riow
         {
         }
 
-        bool Scatter(const Ray& a_ray, const IntersectionInfo& a_hitInfo, Color& a_attenuation, Ray& a_scatteredRay) const override
+        bool Scatter(const Ray& a_ray, const IntersectionInfo& a_hitInfo, Color& a_attenuation, Ray& a_scatteredRay) const
         {
             a_attenuation = Color(1.0f); //Color of this material is currently white.
             const fp32 ri = a_hitInfo.FrontFace ? (1.0f / m_refractiveIndex) : m_refractiveIndex;
@@ -161,7 +125,7 @@ namespace dxray::riow
             const fp32 sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
 
             //If the ray bounces back into the hemisphere it came from there is case for internal reflection.
-            const vath::Vector3f scatterDirection = (ri * sinTheta > 1.0f) || SchlickApprox(cosTheta, ri) > vath::RandomNumber<fp32>()
+            const vath::Vector3f scatterDirection = (ri * sinTheta > 1.0f) || SchlickApprox(cosTheta, ri) > RandomFloat()
                 ? Reflect(unitDirection, a_hitInfo.Normal)
                 : Refract(unitDirection, a_hitInfo.Normal, ri);
 
@@ -177,28 +141,181 @@ namespace dxray::riow
     /// <summary>
     /// The diffuse light presents itself as a light emitting surface, this can use a texture regardless to display surface-like features.
     /// </summary>
-    class DiffuseLight final : public Material
+    class DiffuseLight final
     {
     public:
         //#Todo: Implement a proper non-arbitrary strength using SE units.
-        DiffuseLight(std::shared_ptr<Texture> a_albedo, const fp32 a_strength = 1.0f) :
+        DiffuseLight(const TextureId a_albedo, const fp32 a_strength = 1.0f) :
             m_albedo(a_albedo),
             m_strength(a_strength)
         { }
 
-        DiffuseLight(Color a_lightColor, const fp32 a_strength = 1.0f) :
-            m_albedo(std::make_shared<SolidColor>(a_lightColor)),
-            m_strength(a_strength)
+        Color Emitted(const TextureTable& a_textures, const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point, const fp32 a_uvFootprint) const
+        {
+            return a_textures.Sample(m_albedo, a_uvCoord, a_point, a_uvFootprint) * m_strength;
+        }
+
+    private:
+        TextureId m_albedo;
+        fp32 m_strength;
+    };
+
+
+    /// <summary>
+    /// Phase function of a participating medium, scatters uniformly over the sphere. The normal of the hit is ignored.
+    /// </summary>
+    class Isotropic final
+    {
+    public:
+        Isotropic(const TextureId a_albedo) :
+            m_albedo(a_albedo)
         { }
 
-        Color Emitted(const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point) const override
+        bool Scatter(const Ray& a_ray, const IntersectionInfo& a_hitInfo, const TextureTable& a_textures, Color& a_attenuation, Ray& a_scatteredRay) const
+        {
+            a_scatteredRay = Ray(a_hitInfo.Point, Random3dUnitDirection(), a_ray.GetTime());
+            a_attenuation = a_textures.Sample(m_albedo, a_hitInfo.UvCoord, a_hitInfo.Point, a_hitInfo.UvFootprint);
+            return true;
+        }
+
+        static fp32 GetPdf(const vath::Vector3f& a_normal, const vath::Vector3f& a_unitDirection)
         {
-            DXRAY_ASSERT(m_albedo != nullptr);
-            return m_albedo->Sample(a_uvCoord, a_point) * m_strength;
+            return vath::UniformSpherePdf<fp32>();
         }
 
     private:
-        std::shared_ptr<Texture> m_albedo;
-        fp32 m_strength;
+        TextureId m_albedo;
+    };
+
+
+    /// <summary>
+    /// Owns all materials of a scene in contiguous per type arrays, traceables and hits refer to them by id.
+    /// Shading switches on the type stored in the id instead of calling through a vtable, and hits no longer copy a shared pointer,
+    /// which removes the atomic reference count traffic between render threads.
+    /// </summary>
+    class MaterialTable final
+    {
+    public:
+        static constexpr u32 TypeCount = 5;
+
+        template<typename TMaterial>
+        MaterialId Add(TMaterial&& a_material);
+
+        /// <summary>
+        /// Returns false when the material absorbs the ray, which is also the case for emissive and invalid materials.
+        /// </summary>
+        bool Scatter(const MaterialId a_materialId, const Ray& a_ray, const IntersectionInfo& a_hitInfo, const TextureTable& a_textures, Color& a_attenuation, Ray& a_scatteredRay) const;
+        Color Emitted(const MaterialId a_materialId, const TextureTable& a_textures, const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point, const fp32 a_uvFootprint = 0.0f) const;
+
+        /// <summary>
+        /// Solid angle density with which Scatter picks the given direction, 0 for materials that scatter into a single direction or
+        /// don't describe their distribution, such as metallic and dielectric. Only materials with a density are lit through light sampling.
+        /// The attenuation of these materials is their scattering divided by the density, multiplying it by the density gives the scattering
+        /// towards any direction, including the cosine term. The density depends on the shading normal only, not on the rest of the hit.
+        /// </summary>
+        fp32 GetScatterPdf(const MaterialId a_materialId, const vath::Vector3f& a_normal, const vath::Vector3f& a_unitDirection) const;
+        static bool HasScatterPdf(const MaterialId a_materialId);
+        static bool IsEmissive(const MaterialId a_materialId);
+
+        /// <summary>
+        /// Surfaces that scatter without a density, metallic and dielectric. Light only reaches the next vertex through them by following the scattered ray.
+        /// </summary>
+        static bool IsSpecular(const MaterialId a_materialId);
+
+        /// <summary>
+        /// Surfaces with a scattering density, as opposed to the phase function of a medium.
+        /// </summary>
+        static bool IsDiffuseSurface(const MaterialId a_materialId);
+
+        /// <summary>
+        /// Type of the material as index into the material type list, used to report statistics per material type.
+        /// Invalid materials return an index of TypeCount or above.
+        /// </summary>
+        static u32 GetTypeIndex(const MaterialId a_materialId);
+        static const char* GetTypeName(const u32 a_typeIndex);
+
+    private:
+        using Table = ResourceTable<Lambertian, Metallic, Dielectric, DiffuseLight, Isotropic>;
+        Table m_materials;
     };
+
+    template<typename TMaterial>
+    inline MaterialId MaterialTable::Add(TMaterial&& a_material)
+    {
+        return m_materials.Add(std::forward<TMaterial>(a_material));
+    }
+
+    inline bool MaterialTable::Scatter(const MaterialId a_materialId, const Ray& a_ray, const IntersectionInfo& a_hitInfo, const TextureTable& a_textures, Color& a_attenuation, Ray& a_scatteredRay) const
+    {
+        switch (Table::GetTypeIndex(a_materialId))
+        {
+        case Table::TypeIndexOf<Lambertian>():
+            return m_materials.Get<Lambertian>(a_materialId).Scatter(a_ray, a_hitInfo, a_textures, a_attenuation, a_scatteredRay);
+        case Table::TypeIndexOf<Metallic>():
+            return m_materials.Get<Metallic>(a_materialId).Scatter(a_ray, a_hitInfo, a_attenuation, a_scatteredRay);
+        case Table::TypeIndexOf<Dielectric>():
+            return m_materials.Get<Dielectric>(a_materialId).Scatter(a_ray, a_hitInfo, a_attenuation, a_scatteredRay);
+        case Table::TypeIndexOf<Isotropic>():
+            return m_materials.Get<Isotropic>(a_materialId).Scatter(a_ray, a_hitInfo, a_textures, a_attenuation, a_scatteredRay);
+        default:
+            return false;
+        }
+    }
+
+    inline Color MaterialTable::Emitted(const MaterialId a_materialId, const TextureTable& a_textures, const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point, const fp32 a_uvFootprint /*= 0.0f*/) const
+    {
+        if (Table::GetTypeIndex(a_materialId) != Table::TypeIndexOf<DiffuseLight>())
+        {
+            return Color(0.0f);
+        }
+
+        return m_materials.Get<DiffuseLight>(a_materialId).Emitted(a_textures, a_uvCoord, a_point, a_uvFootprint);
+    }
+
+    inline fp32 MaterialTable::GetScatterPdf(const MaterialId a_materialId, const vath::Vector3f& a_normal, const vath::Vector3f& a_unitDirection) const
+    {
+        switch (Table::GetTypeIndex(a_materialId))
+        {
+        case Table::TypeIndexOf<Lambertian>():
+            return Lambertian::GetPdf(a_normal, a_unitDirection);
+        case Table::TypeIndexOf<Isotropic>():
+            return Isotropic::GetPdf(a_normal, a_unitDirection);
+        default:
+            return 0.0f;
+        }
+    }
+
+    inline bool MaterialTable::HasScatterPdf(const MaterialId a_materialId)
+    {
+        const u32 typeIndex = Table::GetTypeIndex(a_materialId);
+        return typeIndex == Table::TypeIndexOf<Lambertian>() || typeIndex == Table::TypeIndexOf<Isotropic>();
+    }
+
+    inline bool MaterialTable::IsEmissive(const MaterialId a_materialId)
+    {
+        return Table::GetTypeIndex(a_materialId) == Table::TypeIndexOf<DiffuseLight>();
+    }
+
+    inline bool MaterialTable::IsSpecular(const MaterialId a_materialId)
+    {
+        const u32 typeIndex = Table::GetTypeIndex(a_materialId);
+        return typeIndex == Table::TypeIndexOf<Metallic>() || typeIndex == Table::TypeIndexOf<Dielectric>();
+    }
+
+    inline bool MaterialTable::IsDiffuseSurface(const MaterialId a_materialId)
+    {
+        return Table::GetTypeIndex(a_materialId) == Table::TypeIndexOf<Lambertian>();
+    }
+
+    inline u32 MaterialTable::GetTypeIndex(const MaterialId a_materialId)
+    {
+        return Table::GetTypeIndex(a_materialId);
+    }
+
+    inline const char* MaterialTable::GetTypeName(const u32 a_typeIndex)
+    {
+        static_assert(Table::TypeIndexOf<Isotropic>() + 1 == TypeCount, "Add the name of new material types.");
+        constexpr const char* typeNames[TypeCount] = { "lambertian", "metallic", "dielectric", "diffuseLight", "isotropic" };
+        return a_typeIndex < TypeCount ? typeNames[a_typeIndex] : "invalid";
+    }
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+#include "riow/boundingBox.h"
+#include <utility>
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Extinction density of a participating medium, either constant or a voxel grid.
+	/// Free paths are sampled with delta tracking and transmittance is estimated with ratio tracking, both unbiased and without ray marching.
+	/// Grids store a coarse grid of majorants, the maximum density within each cell, which keeps the tentative collisions close to the real ones
+	/// in sparse regions of the medium. The majorant cells are walked with a DDA and tracking restarts at every cell boundary.
+	/// </summary>
+	class MediumDensity final
+	{
+	public:
+		/// <summary>
+		/// Homogeneous medium, free paths and transmittance are evaluated analytically.
+		/// </summary>
+		/// <param name="a_density">Extinction coefficient per world unit.</param>
+		static MediumDensity Constant(const fp32 a_density);
+
+		/// <summary>
+		/// Heterogeneous medium, densities are stored per voxel from the minimum corner of the bounds, x first. Outside the bounds the density is 0.
+		/// </summary>
+		/// <param name="a_densityScale">Scales the voxel densities into extinction coefficients per world unit.</param>
+		/// <param name="a_majorantCellSize">Voxels per majorant cell along every axis.</param>
+		static MediumDensity Grid(const BoundingBox& a_bounds, const vath::Vector3u32& a_resolution, std::vector<fp32> a_densities, const fp32 a_densityScale = 1.0f, const u32 a_majorantCellSize = 8);
+
+		/// <summary>
+		/// Delta tracking: samples the distance to the first real collision along the ray within [tMin, tMax].
+		/// Returns false when the ray passes through without colliding, which happens with a probability equal to the transmittance.
+		/// </summary>
+		/// <param name="a_stepCount">Incremented by the number of tentative collisions evaluated.</param>
+		bool SampleCollision(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, fp32& a_tCollision, u32& a_stepCount) const;
+
+		/// <summary>
+		/// Ratio tracking: unbiased estimate of the transmittance along the ray within [tMin, tMax].
+		/// </summary>
+		fp32 EstimateTransmittance(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, u32& a_stepCount) const;
+
+		/// <summary>
+		/// Extinction coefficient at a point, trilinearly interpolated between voxel centers for grids.
+		/// </summary>
+		fp32 GetDensity(const vath::Vector3f& a_point) const;
+
+		bool IsHomogeneous() const;
+
+	private:
+		/// <summary>
+		/// Voxel and majorant storage, shared between copies of the medium.
+		/// </summary>
+		struct DensityGrid final
+		{
+			BoundingBox Bounds;
+			vath::Vector3u32 Resolution;
+			vath::Vector3u32 MajorantResolution;
+			vath::Vector3f VoxelSize;
+			vath::Vector3f MajorantCellSize;
+			std::vector<fp32> Densities;
+			std::vector<fp32> Majorants;
+		};
+
+		MediumDensity() = default;
+
+		/// <summary>
+		/// Walks the majorant cells overlapped by the ray within [tMin, tMax], front to back.
+		/// The visitor receives the ray interval of the cell and its majorant, and returns false to stop the walk.
+		/// </summary>
+		template<typename TVisitor>
+		void TraverseMajorants(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, const TVisitor& a_visitor) const;
+
+		std::shared_ptr<const DensityGrid> m_grid;
+		fp32 m_constantDensity = 0.0f;
+	};
+
+	/// <summary>
+	/// Tracking counters over all media. Media count into the counters of the calling thread without synchronization,
+	/// the renderer moves them into the statistics of the thread once a tile is done.
+	/// </summary>
+	struct MediumStatistics final
+	{
+		u64 TrackedRayCount = 0;
+		u64 StepCount = 0;
+		u64 CollisionCount = 0;
+	};
+
+	inline MediumStatistics& GetThreadMediumStatistics()
+	{
+		thread_local MediumStatistics statistics;
+		return statistics;
+	}
+
+	/// <summary>
+	/// Returns the counters of the calling thread and resets them.
+	/// </summary>
+	inline MediumStatistics TakeThreadMediumStatistics()
+	{
+		return std::exchange(GetThreadMediumStatistics(), MediumStatistics());
+	}
+
+	inline bool MediumDensity::IsHomogeneous() const
+	{
+		return m_grid == nullptr;
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "riow/image.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Filtered texture backed by a mip pyramid of linear texels, built once at load time.
+	/// Low dynamic range images are decoded from sRGB to linear on load, high dynamic range images (.hdr) are stored as is,
+	/// so sampling never has to convert or linearize texels. The footprint of the sample selects the mip level, which keeps
+	/// distant or grazing surfaces from aliasing and keeps the texel fetches of neighbouring samples close together in memory.
+	/// </summary>
+	class MipTexture final
+	{
+	public:
+		enum class ETexelFormat : u8
+		{
+			Float32 = 0,
+			Float16				//Half the memory, plenty of precision for albedo and environment data.
+		};
+
+		enum class EFilter : u8
+		{
+			Bilinear = 0,		//Bilinear lookup in the nearest mip level.
+			Trilinear			//Blends the bilinear lookups of the two nearest mip levels.
+		};
+
+		/// <summary>
+		/// Builds the pyramid from linear RGB texels, stored row by row from the top left.
+		/// </summary>
+		MipTexture(const vath::Vector2u32& a_dimensions, const std::vector<Color>& a_linearTexels, const ETexelFormat a_format = ETexelFormat::Float16, const EFilter a_filter = EFilter::Trilinear);
+
+		/// <summary>
+		/// Loads an image file, a file that fails to load results in a single texel texture of the invalid texture color.
+		/// </summary>
+		/// <param name="a_bSrgb">Whether the low dynamic range data is sRGB encoded, ignored for high dynamic range files.</param>
+		static MipTexture LoadFromFile(const Path& a_path, const Image::ELoadOptions a_loadFlags, const bool a_bSrgb = true, const ETexelFormat a_format = ETexelFormat::Float16, const EFilter a_filter = EFilter::Trilinear);
+
+		/// <summary>
+		/// Samples the texture with clamped addressing.
+		/// </summary>
+		/// <param name="a_uvFootprint">Width of the sample footprint in uv units, 0 samples the finest level.</param>
+		Color Sample(const vath::Vector2f& a_uvCoord, const fp32 a_uvFootprint) const;
+
+		/// <summary>
+		/// Returns a single texel of a mip level, coordinates are clamped to the level.
+		/// </summary>
+		Color ReadTexel(const u32 a_level, const i32 a_x, const i32 a_y) const;
+
+		u32 GetLevelCount() const;
+		vath::Vector2u32 GetLevelDimensions(const u32 a_level) const;
+		ETexelFormat GetTexelFormat() const;
+
+	private:
+		struct MipLevel final
+		{
+			u32 Width = 0;
+			u32 Height = 0;
+			usize Offset = 0;	//Offset of the first texel component in the texel storage.
+		};
+
+		/// <summary>
+		/// Texel storage is shared between copies of the texture, scenes are copied per frame when rendering sequences.
+		/// </summary>
+		struct MipPyramid final
+		{
+			std::vector<MipLevel> Levels;
+			std::vector<fp32> Texels32;
+			std::vector<u16> Texels16;
+			ETexelFormat Format = ETexelFormat::Float32;
+		};
+
+		Color SampleBilinear(const MipPyramid& a_pyramid, const u32 a_level, const vath::Vector2f& a_uvCoord) const;
+		static Color ReadTexel(const MipPyramid& a_pyramid, const MipLevel& a_level, const u32 a_x, const u32 a_y);
+
+		std::shared_ptr<const MipPyramid> m_pyramid;
+		EFilter m_filter;
+	};
+
+	inline u32 MipTexture::GetLevelCount() const
+	{
+		return static_cast<u32>(m_pyramid->Levels.size());
+	}
+
+	inline vath::Vector2u32 MipTexture::GetLevelDimensions(const u32 a_level) const
+	{
+		const MipLevel& level = m_pyramid->Levels[a_level];
+		return vath::Vector2u32(level.Width, level.Height);
+	}
+
+	inline MipTexture::ETexelFormat MipTexture::GetTexelFormat() const
+	{
+		return m_pyramid->Format;
+	}
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include "riow/boundingBox.h"
+#include <array>
+#include <atomic>
+#include <deque>
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Float that render threads add to concurrently. Copies load the value, so containers of them can grow while no thread is adding.
+	/// </summary>
+	class AtomicFloat final
+	{
+	public:
+		AtomicFloat(const fp32 a_value = 0.0f);
+		AtomicFloat(const AtomicFloat& a_other);
+		AtomicFloat& operator=(const AtomicFloat& a_other);
+
+		void Add(const fp32 a_value);
+		fp32 Get() const;
+
+	private:
+		std::atomic<fp32> m_value;
+	};
+
+	inline AtomicFloat::AtomicFloat(const fp32 a_value /*= 0.0f*/) :
+		m_value(a_value)
+	{}
+
+	inline AtomicFloat::AtomicFloat(const AtomicFloat& a_other) :
+		m_value(a_other.Get())
+	{}
+
+	inline AtomicFloat& AtomicFloat::operator=(const AtomicFloat& a_other)
+	{
+		m_value.store(a_other.Get(), std::memory_order_relaxed);
+		return *this;
+	}
+
+	inline void AtomicFloat::Add(const fp32 a_value)
+	{
+		m_value.fetch_add(a_value, std::memory_order_relaxed);
+	}
+
+	inline fp32 AtomicFloat::Get() const
+	{
+		return m_value.load(std::memory_order_relaxed);
+	}
+
+
+	/// <summary>
+	/// Piecewise constant distribution over the sphere of directions, stored as a quadtree over the square that cylindrically maps onto the sphere:
+	/// x follows the cosine of the angle with +z and y the azimuth around it. The mapping preserves area, so a uniform density over a quadrant
+	/// is a uniform density over the directions it covers. Every node holds the flux that arrived through each of its four quadrants.
+	/// </summary>
+	class DirectionalQuadtree final
+	{
+	public:
+		DirectionalQuadtree();
+
+		/// <summary>
+		/// Adds flux to the leaf quadrant the unit direction falls in. Safe to call from multiple threads, as long as the structure is not refined.
+		/// </summary>
+		void Record(const vath::Vector3f& a_unitDirection, const fp32 a_flux);
+
+		/// <summary>
+		/// Picks a quadrant proportional to its flux at every level, then a uniform direction within the leaf quadrant. Returns the solid angle density.
+		/// </summary>
+		vath::Vector3f Sample(vath::Vector2f a_sample, fp32& a_pdf) const;
+		fp32 GetPdf(const vath::Vector3f& a_unitDirection) const;
+
+		/// <summary>
+		/// Sums the recorded flux of the leaf quadrants up into the quadrants of their parents.
+		/// </summary>
+		void Build();
+
+		/// <summary>
+		/// Structure for the next iteration, without flux: quadrants that received more than the fraction of the total flux are subdivided,
+		/// the children of quadrants that received less are merged. Requires a built tree.
+		/// </summary>
+		DirectionalQuadtree Refine(const fp32 a_subdivisionFluxFraction, const u32 a_maxDepth) const;
+
+		fp32 GetFlux() const;
+		usize GetNodeCount() const;
+
+	private:
+		static constexpr u32 LeafChild = 0;	//The root is never a child, index 0 marks a leaf quadrant.
+		static constexpr u32 InvalidNode = u32max;
+
+		struct Node final
+		{
+			std::array<AtomicFloat, 4> Flux;
+			std::array<u32, 4> Children = { LeafChild, LeafChild, LeafChild, LeafChild };
+		};
+
+		static vath::Vector2f DirectionToSquare(const vath::Vector3f& a_unitDirection);
+		static vath::Vector3f SquareToDirection(const vath::Vector2f& a_point);
+		static u32 GetQuadrant(vath::Vector2f& a_point);
+		fp32 BuildNode(const u32 a_nodeIndex);
+		void RefineNode(const u32 a_nodeIndex, const fp32 a_flux, const u32 a_refinedIndex, const fp32 a_totalFlux, const fp32 a_subdivisionFluxFraction,
+			const u32 a_depth, const u32 a_maxDepth, DirectionalQuadtree& a_refined) const;
+
+		std::vector<Node> m_nodes;
+	};
+
+	inline fp32 DirectionalQuadtree::GetFlux() const
+	{
+		const Node& root = m_nodes[0];
+		return root.Flux[0].Get() + root.Flux[1].Get() + root.Flux[2].Get() + root.Flux[3].Get();
+	}
+
+	inline usize DirectionalQuadtree::GetNodeCount() const
+	{
+		return m_nodes.size();
+	}
+
+
+	/// <summary>
+	/// Learns the distribution of light arriving at the points of a scene, to sample scattered directions towards where the light comes from.
+	/// A binary tree subdivides the scene bounds, alternating over the axes, and every leaf holds a directional quadtree. Paths record the radiance
+	/// they find into the leaf around their vertices, over training iterations that double in length. In between iterations the leaves that
+	/// received many records are split and the quadtrees are refined towards the directions that received the most flux, while the records of the
+	/// finished iteration become the distribution that the next iteration samples from.
+	/// See Müller et al. 2017, Practical Path Guiding for Efficient Light-Transport Simulation.
+	/// </summary>
+	class PathGuide final
+	{
+	public:
+		/// <summary>
+		/// Fraction of the scattered directions picked by the material, the rest are picked by the guide.
+		/// Keeping a fixed share of material sampling bounds the variance where the guide is still poor.
+		/// </summary>
+		static constexpr fp32 MaterialSamplingFraction = 0.5f;
+
+		PathGuide() = default;
+
+		/// <summary>
+		/// Starts learning from scratch over the bounds of a scene. The guide records every path until it is frozen.
+		/// </summary>
+		void Reset(const BoundingBox& a_sceneBounds);
+
+		/// <summary>
+		/// Ends a training iteration of the given number of passes: the records become the sampling distribution and the trees are refined for the next iteration.
+		/// Render threads may not use the guide while it refines.
+		/// </summary>
+		void Refine(const u32 a_iterationPassCount);
+
+		/// <summary>
+		/// Stops recording, the guide keeps sampling from the distribution of the last iteration.
+		/// </summary>
+		void Freeze();
+
+		/// <summary>
+		/// Distribution of the light that arrived around the point in the last finished iteration, nullptr while none has.
+		/// </summary>
+		const DirectionalQuadtree* FindDistribution(const vath::Vector3f& a_point) const;
+
+		/// <summary>
+		/// Records the radiance arriving at the point from the direction, divided by the density with which the direction was scattered.
+		/// </summary>
+		void Record(const vath::Vector3f& a_point, const vath::Vector3f& a_unitDirection, const fp32 a_radianceOverPdf);
+
+		bool IsRecording() const;
+		u32 GetLeafCount() const;
+
+	private:
+		//A leaf is split once it receives this many records times the square root of the passes in the iteration.
+		static constexpr fp32 SpatialSplitRecordCount = 4000.0f;
+		static constexpr u32 MaxSpatialDepth = 48;
+		static constexpr fp32 DirectionalSubdivisionFluxFraction = 0.01f;
+		static constexpr u32 MaxDirectionalDepth = 20;
+
+		struct Leaf final
+		{
+			DirectionalQuadtree Sampling;
+			DirectionalQuadtree Recording;
+			std::atomic<u32> RecordCount = 0;
+		};
+
+		struct Node final
+		{
+			u32 Child = 0;		//Index of the first of the two children for inner nodes, index into the leaves otherwise.
+			u8 Axis = 0;
+			bool bLeaf = true;
+		};
+
+		const Leaf& FindLeaf(const vath::Vector3f& a_point) const;
+		Leaf& FindLeaf(const vath::Vector3f& a_point);
+		void SplitNode(const u32 a_nodeIndex, const u32 a_depth, const fp32 a_recordCount, const fp32 a_splitRecordCount);
+
+		BoundingBox m_bounds;
+		std::vector<Node> m_nodes;
+		std::deque<Leaf> m_leaves;	//Leaves stay in place as the tree grows, their record counters are atomic.
+		bool m_bRecording = false;
+	};
+
+	inline bool PathGuide::IsRecording() const
+	{
+		return m_bRecording;
+	}
+
+	inline u32 PathGuide::GetLeafCount() const
+	{
+		return static_cast<u32>(m_leaves.size());
+	}
+}
@@ -16,6 +16,16 @@ namespace dxray
         fp32 Noise(const vath::Vector3f& a_point) const;
         fp32 Turbulence(const vath::Vector3f& a_point, u32 a_depth) const;
 
+        /// <summary>
+        /// Evaluates the noise at eight points at once, the gradient lookups are scalar, the interpolation runs on all lanes.
+        /// </summary>
+        vath::Float8 Noise(const vath::Float8& a_x, const vath::Float8& a_y, const vath::Float8& a_z) const;
+
+        /// <summary>
+        /// Turbulence at eight points at once, used when baking noise into a grid.
+        /// </summary>
+        vath::Float8 Turbulence(const vath::Float8& a_x, const vath::Float8& a_y, const vath::Float8& a_z, u32 a_depth) const;
+
     private:
         static const i32 m_pointCount = 256;
         std::array<vath::Vector3f, m_pointCount> m_noiseMap;
@@ -0,0 +1,69 @@
+#pragma once
+#include "riow/color.h"
+#include <vector>
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Flux that arrived at a surface at the end of a photon path.
+	/// </summary>
+	struct Photon final
+	{
+		vath::Vector3f Position = vath::Vector3f(0.0f);
+		vath::Vector3f Direction = vath::Vector3f(0.0f);	//Unit direction the photon travelled in when it arrived.
+		Color Power = Color(0.0f);
+		u8 SplitAxis = 0;									//Axis along which the node of the photon splits its range, set by the build.
+	};
+
+
+	/// <summary>
+	/// Photons in a balanced kd-tree that is stored implicitly: every node is a range of the photon array, split at its median photon
+	/// into the ranges before and after it. The tree needs no child links and builds in place with a selection per node.
+	/// See Jensen 2001, Realistic image synthesis using photon mapping.
+	/// </summary>
+	class PhotonMap final
+	{
+	public:
+		PhotonMap() = default;
+
+		/// <summary>
+		/// Takes over the photons and builds the tree over them, the photons of the previous build are released.
+		/// </summary>
+		void Build(std::vector<Photon>&& a_photons);
+		void Clear();
+
+		/// <summary>
+		/// Sum of the power of the photons within the radius around the point that arrived at the side of the surface the normal points to.
+		/// </summary>
+		Color GatherPower(const vath::Vector3f& a_point, const vath::Vector3f& a_normal, const fp32 a_radius) const;
+
+		u32 GetCount() const;
+		bool IsEmpty() const;
+
+	private:
+		//Nodes on the stack of a query, the depth of a balanced tree over 2^32 photons.
+		static constexpr u32 MaxQueryStackSize = 64;
+
+		void BuildRecursive(const u32 a_begin, const u32 a_end);
+
+		std::vector<Photon> m_photons;
+	};
+
+	/// <summary>
+	/// Gather radius of a pass, in the probabilistic form of progressive photon mapping: every pass is an independent estimate of its own,
+	/// with a squared radius that shrinks as r(i + 1)^2 = r(i)^2 (i + alpha) / (i + 1), so both the bias and the variance of the mean vanish.
+	/// See Knaus and Zwicker 2011, Progressive photon mapping: a probabilistic approach.
+	/// </summary>
+	/// <param name="a_alpha">Fraction of the photons kept every pass, in (0, 1).</param>
+	fp32 GetProgressiveGatherRadius(const fp32 a_initialRadius, const fp32 a_alpha, const u32 a_pass);
+
+	inline u32 PhotonMap::GetCount() const
+	{
+		return static_cast<u32>(m_photons.size());
+	}
+
+	inline bool PhotonMap::IsEmpty() const
+	{
+		return m_photons.empty();
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <core/thread/taskScheduler.h>
+#include <core/vath/vath.h>
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Encodes 8 bit pixels, rows from the top left, into a png file in memory.
+	/// Rows are filtered and the filtered data is deflated in independent strips, the strips are stitched into a single zlib stream.
+	/// Every strip is compressed with the data preceding it as dictionary, so splitting the stream costs next to no compression.
+	/// Both stages are split over the task scheduler when one is passed, otherwise the image is encoded on the calling thread.
+	/// #Note: Pass no task scheduler when encoding from within a task, waiting on the scheduler from one of its own tasks deadlocks.
+	/// </summary>
+	void EncodePng(const u8* a_pPixels, const vath::Vector2u32& a_dimensionsInPx, const u32 a_channelCount, std::vector<u8>& a_png, TaskScheduler* a_pTaskScheduler = nullptr);
+
+
+	//--- Building blocks, shared with the scanline image writer ---
+
+	/// <summary>
+	/// Filters rows of pixels into the png scanline layout, a filter type byte followed by the filtered row.
+	/// The filter is picked per row, the one with the smallest sum of absolute filtered values.
+	/// </summary>
+	/// <param name="a_pPreviousRow">Row above the first row, nullptr for the first row of the image.</param>
+	void FilterPngRows(const u8* a_pPixels, const u8* a_pPreviousRow, const u32 a_width, const u32 a_channelCount, const u32 a_rowCount, u8* a_pFilteredRows);
+
+	/// <summary>
+	/// Deflates a segment of a deflate stream with fixed Huffman codes and LZ77 matching within a 32K window.
+	/// The segment ends on a byte boundary, non-final segments end with an empty stored block so segments can be concatenated.
+	/// </summary>
+	/// <param name="a_pData">Start of the dictionary, the segment itself starts a_dictionarySize bytes later.</param>
+	void DeflateSegment(const u8* a_pData, const usize a_dictionarySize, const usize a_segmentSize, const bool a_bFinalSegment, std::vector<u8>& a_output);
+
+	void AppendPngChunk(std::vector<u8>& a_output, const char a_type[4], const u8* a_pData, const usize a_size);
+
+	u32 Crc32(const u8* a_pData, const usize a_size, const u32 a_crc = 0);
+	u32 Adler32(const u8* a_pData, const usize a_size, const u32 a_adler = 1);
+
+	/// <summary>
+	/// Adler-32 of two concatenated blocks from the checksums of the blocks.
+	/// </summary>
+	u32 CombineAdler32(const u32 a_firstAdler, const u32 a_secondAdler, const usize a_secondSize);
+
+	inline constexpr u8 PngSignature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+	inline constexpr u8 ZlibHeader[2] = { 0x78, 0x01 };	//Deflate with a 32K window, no preset dictionary.
+	inline constexpr usize DeflateWindowSize = 32768;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <core/thread/taskScheduler.h>
+#include "riow/color.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Curve used to compress radiance above 1 into the displayable range.
+	/// </summary>
+	enum class EToneMapping : u8
+	{
+		None = 0,		//Clamps, radiance above 1 saturates.
+		Reinhard,		//x / (1 + x), per channel.
+		AcesFilmic		//Fitted ACES filmic curve (Narkowicz), per channel.
+	};
+
+	/// <summary>
+	/// Transform from linear radiance to display pixels.
+	/// </summary>
+	struct DisplayTransform final
+	{
+		fp32 Exposure = 1.0f;
+		EToneMapping ToneMapping = EToneMapping::None;
+	};
+
+	/// <summary>
+	/// Converts linear radiance to 8 bit sRGB encoded pixels: exposure, tone mapping, clamping and encoding.
+	/// Channels are processed eight at a time, the sRGB encoding is a table lookup instead of a power function per channel.
+	/// The image is split in chunks over the task scheduler when one is passed, otherwise it is converted on the calling thread.
+	/// #Note: Pass no task scheduler when converting from within a task, waiting on the scheduler from one of its own tasks deadlocks.
+	/// </summary>
+	void EncodeDisplayImage(const std::vector<Color>& a_radiance, std::vector<u8>& a_pixels, const DisplayTransform& a_transform, TaskScheduler* a_pTaskScheduler = nullptr);
+
+	/// <summary>
+	/// EncodeDisplayImage on a range of pixels, the pixel output holds three channels per radiance value.
+	/// </summary>
+	void EncodeDisplayPixels(const Color* a_pRadiance, const usize a_pixelCount, u8* a_pPixels, const DisplayTransform& a_transform, TaskScheduler* a_pTaskScheduler = nullptr);
+
+	/// <summary>
+	/// Parses the tone mapping names used on the command line: none, reinhard or aces.
+	/// </summary>
+	EToneMapping ParseToneMapping(const StringView a_name);
+}
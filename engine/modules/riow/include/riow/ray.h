@@ -25,6 +25,24 @@ namespace dxray::riow
 		fp32 m_time;
 	};
 
+	/// <summary>
+	/// Cone around a ray, used to estimate the footprint of the ray on the surfaces it hits for texture filtering.
+	/// The width grows linearly with the distance travelled.
+	/// </summary>
+	struct RayCone final
+	{
+		fp32 Width = 0.0f;
+		fp32 SpreadAngle = 0.0f;
+
+		fp32 GetWidthAt(const fp32 a_distance) const;
+	};
+
+	inline fp32 RayCone::GetWidthAt(const fp32 a_distance) const
+	{
+		return Width + SpreadAngle * a_distance;
+	}
+
+
 	inline Ray::Ray() :
 		m_origin(0.0f),
 		m_direction(1.0f),
@@ -0,0 +1,85 @@
+#pragma once
+#include <array>
+#include "riow/material.h"
+#include "riow/medium.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Reason a path stopped being traced.
+	/// </summary>
+	enum class EPathTermination : u8
+	{
+		Escaped = 0,		//Missed the scene.
+		Absorbed,			//Hit a material that does not scatter, emissive materials included.
+		MaxDepth,			//Reached the maximum trace depth.
+		RussianRoulette,	//Terminated by russian roulette.
+		Count
+	};
+
+	/// <summary>
+	/// Counters of a render, used to attribute throughput changes to the work that was done.
+	/// Every render thread counts into statistics of its own without synchronization, they are merged once the render finishes.
+	/// </summary>
+	struct RenderStatistics final
+	{
+		static constexpr usize PathLengthBucketCount = static_cast<usize>(u8max) + 1;	//Path lengths up to the largest trace depth.
+		static constexpr usize TileTimeBucketCount = 32;								//Bucket i holds tiles that took [2^i, 2^(i+1)) microseconds.
+
+		u64 CameraRayCount = 0;
+		u64 SecondaryRayCount = 0;
+		u64 ShadowRayCount = 0;
+		u64 PhotonRayCount = 0;
+		std::array<u64, static_cast<usize>(EPathTermination::Count)> PathTerminationCounts = {};
+		std::array<u64, PathLengthBucketCount> PathLengthHistogram = {};	//Indexed by the number of rays traced along the path.
+		std::array<u64, MaterialTable::TypeCount> ScatterCounts = {};		//Indexed by material type index.
+		MediumStatistics Media;
+
+		u64 TileCount = 0;
+		fp64 TileTimeInSec = 0.0;
+		fp64 MinTileTimeInSec = fp64max;
+		fp64 MaxTileTimeInSec = 0.0;
+		std::array<u64, TileTimeBucketCount> TileTimeHistogram = {};
+
+		void AddPath(const EPathTermination a_termination, const u32 a_rayCount);
+		void AddScatter(const MaterialId a_materialId);
+		void AddTile(const fp64 a_timeInSec);
+		void AddMediumStatistics(const MediumStatistics& a_statistics);
+		void Merge(const RenderStatistics& a_other);
+
+		u64 GetTracedRayCount() const;
+	};
+
+	/// <summary>
+	/// Writes the merged statistics of a render together with the statistics of every thread as a JSON report.
+	/// </summary>
+	bool SaveRenderStatisticsToFile(const Path& a_filePath, const RenderStatistics& a_statistics, const std::vector<RenderStatistics>& a_threadStatistics, const fp64 a_renderTimeInSec);
+
+
+	inline void RenderStatistics::AddPath(const EPathTermination a_termination, const u32 a_rayCount)
+	{
+		++PathTerminationCounts[static_cast<usize>(a_termination)];
+		++PathLengthHistogram[a_rayCount < PathLengthBucketCount ? a_rayCount : PathLengthBucketCount - 1];
+	}
+
+	inline void RenderStatistics::AddScatter(const MaterialId a_materialId)
+	{
+		const u32 typeIndex = MaterialTable::GetTypeIndex(a_materialId);
+		if (typeIndex < MaterialTable::TypeCount)
+		{
+			++ScatterCounts[typeIndex];
+		}
+	}
+
+	inline void RenderStatistics::AddMediumStatistics(const MediumStatistics& a_statistics)
+	{
+		Media.TrackedRayCount += a_statistics.TrackedRayCount;
+		Media.StepCount += a_statistics.StepCount;
+		Media.CollisionCount += a_statistics.CollisionCount;
+	}
+
+	inline u64 RenderStatistics::GetTracedRayCount() const
+	{
+		return CameraRayCount + SecondaryRayCount + ShadowRayCount + PhotonRayCount;
+	}
+}
@@ -3,10 +3,15 @@
 #include "riow/scene.h"
 #include "riow/camera.h"
 #include "riow/color.h"
+#include "riow/accumulationBuffer.h"
+#include "riow/film.h"
+#include "riow/temporalReuse.h"
+#include "riow/renderStatistics.h"
+#include "riow/pathGuide.h"
+#include "riow/reservoir.h"
+#include "riow/photonMap.h"
 
 //#Todo: motion blur.
-//#Todo: BVH.
-//#Todo: Volumetric.
 
 namespace dxray::riow
 {
@@ -19,30 +24,131 @@ namespace dxray::riow
 		u8 SuperSampleFactor = 2;
 		u8 DepthOfFieldSampleCount = 4;
 		u8 ClusterSize = 4;
+		u16 PassCount = 1;
+		fp32 CheckpointIntervalInSec = 0.0f; //0 disables checkpointing.
+		fp32 TimeBudgetInSec = 0.0f; //When set, passes are added until the budget runs out and the pass count is ignored.
+		fp32 AdaptiveErrorThreshold = 0.0f; //Relative error below which a pixel stops receiving samples, 0 disables adaptive sampling.
+		u16 GuidingTrainingPassCount = 0; //Passes at the start of a render during which the path guide learns, 0 disables path guiding.
+		u8 ReservoirCandidateCount = 0; //Light candidates resampled at the first vertex of camera paths, 0 samples a single light instead.
+		EReservoirReuse ReservoirReuse = EReservoirReuse::Unbiased;
+		u32 CausticPhotonCount = 0; //Photons emitted from the lights per pass to estimate caustics with, 0 leaves caustics to the camera paths.
+		EReconstructionFilter Filter = EReconstructionFilter::Box;
+		fp32 FilterRadiusInPx = 0.0f; //0 uses the default radius of the filter.
+
+		u32 GetSamplesPerPass() const;
+
+		/// <summary>
+		/// Hash of the settings that shape the image of a pass. The pass count, time budget, adaptive threshold and checkpoint interval
+		/// only decide how many passes are rendered and are left out, so a render can be resumed with more passes.
+		/// </summary>
+		u64 GetImageHash() const;
 	};
 
+	inline u32 RendererPipeline::GetSamplesPerPass() const
+	{
+		return static_cast<u32>(SuperSampleFactor) * SuperSampleFactor * DepthOfFieldSampleCount;
+	}
+
 	/// <summary>
 	/// The renderer is responsible for the construction and dispatching of rays.
+	/// Rendering is progressive: every pass adds one full set of samples to each pixel of the accumulation buffer.
+	/// Samples are reconstructed into the buffer through a film: every task splats the samples of its pixels into a film tile with the
+	/// reconstruction filter, and merges the tile into the buffer once its pixels are done.
+	/// When a checkpoint file is set the accumulation buffer is periodically stored, so a pre-empted render can be resumed.
+	/// With a time budget, passes are added until the deadline, at which point in-flight tiles stop at the next pixel. Every pixel holds
+	/// a whole number of passes, so the buffer always resolves into the best image so far.
+	/// With path guiding, the first passes of a render train the guide in iterations of 1, 2, 4, ... passes, after which it is frozen. Training passes
+	/// are accumulated like any other, they sample from the guide of the previous iteration and are unbiased, only noisier.
+	/// With reservoir resampling, the first vertex of a camera path picks its light out of many candidates and the reservoirs of the previous pass
+	/// around its pixel, and traces a single shadow ray towards it. Its scattered ray then only gathers indirect light.
+	/// With caustic photons, every pass first traces photons from the lights through specular surfaces into a photon map. The first diffuse surface
+	/// of a camera path estimates the light that reaches it through specular surfaces from the photons around it, within a radius that shrinks
+	/// from pass to pass, and its scattered ray no longer counts lights it finds through specular surfaces.
 	/// </summary>
 	class Renderer final
 	{
 	public:
-		Renderer();
+		/// <summary>
+		/// The reserved cores are left to the rest of the system, every other hardware thread becomes a render worker.
+		/// </summary>
+		explicit Renderer(const u16 a_reservedCoreCount = 2);
 		~Renderer() = default;
 
 		void SetRenderPipeline(const RendererPipeline& a_pipeline);
 		void SetCamera(const Camera& a_camera);
+
+		/// <summary>
+		/// Radiance of rays that escape a scene without environment.
+		/// </summary>
 		void SetBackgroundColor(const Color& a_color);
+		void SetCheckpointFile(const Path& a_checkpointFilePath);
+
+		void Render(const Scene& a_scene, AccumulationBuffer& a_accumulationBuffer);
+
+		/// <summary>
+		/// Traces a single ray through the center of every pixel at the middle of the shutter interval and stores the first hit.
+		/// </summary>
+		void RenderGuideBuffer(const Scene& a_scene, GuideBuffer& a_guideBuffer);
+
+		const RendererPipeline& GetRenderPipeline() const;
+		const Camera& GetCamera() const;
+		TaskScheduler& GetTaskScheduler();
+
+		/// <summary>
+		/// Statistics of the last render, merged over all threads, and the statistics of the individual threads.
+		/// </summary>
+		const RenderStatistics& GetStatistics() const;
+		const std::vector<RenderStatistics>& GetThreadStatistics() const;
+		fp64 GetRenderTimeInSec() const;
 
-		void Render(const Scene& a_scene, std::vector<vath::Vector3f>& a_colorDataBuffer);
+		/// <summary>
+		/// Number of rays intersected with the scene during the last render.
+		/// </summary>
+		u64 GetTracedRayCount() const;
+
+		/// <summary>
+		/// Writes the statistics of the last render as a JSON report.
+		/// </summary>
+		bool SaveStatistics(const Path& a_filePath) const;
 
 	private:
-		Color TraceRayColor(const riow::Ray& a_ray, const riow::Scene& a_scene, const u8 a_maxTraceDepth) const;
+		/// <summary>
+		/// Radiance arriving along the ray. Lights and the environment are sampled directly at every vertex with a scattering density, and weighted against
+		/// hitting them by scattering with multiple importance sampling. The scatter pdf is the density with which the previous vertex
+		/// scattered the ray, 0 for camera rays and specular scattering, which see emission at full weight.
+		/// With a path guide, materials with a scattering density pick their direction from a mix of their own distribution and the guide,
+		/// and while the guide records, every such vertex records the radiance that arrived along the scattered ray.
+		/// With a reservoir buffer, camera rays resample the direct light at their hit and store the reservoir for the pixel.
+		/// With a caustic map, the ray has not met a diffuse surface yet and the first one it hits gathers the caustic photons. Rays scattered
+		/// from that surface that only met specular surfaces since have their caustics gathered and ignore the lights they hit.
+		/// </summary>
+		Color TraceRayColor(const riow::Ray& a_ray, const RayCone& a_cone, const riow::Scene& a_scene, const u8 a_maxTraceDepth, const fp32 a_scatterPdf,
+			PathGuide* a_pPathGuide, ReservoirBuffer* a_pReservoirs, const u32 a_pixelIndex, const PhotonMap* a_pCausticMap, const bool a_bCausticsGathered,
+			RenderStatistics& a_statistics) const;
+
+		/// <summary>
+		/// Traces the photons of a pass from the lights into the caustic map. Photons are emitted in proportion to the power of the lights
+		/// and stored where they land on a diffuse surface after one or more specular surfaces.
+		/// </summary>
+		void TraceCausticPhotons(const Scene& a_scene, const u64 a_seed, const u32 a_pass, const u64 a_renderId);
+		RenderStatistics& GetThreadStatistics(const u64 a_renderId);
+		void ReportSampleCounts(const AccumulationBuffer& a_accumulationBuffer) const;
 
 		Camera m_camera;
 		RendererPipeline m_pipelineConfiguration;
 		TaskScheduler m_taskScheduler;
 		Color m_backgroundColor;
+		Path m_checkpointFilePath;
+		PathGuide m_pathGuide;
+		ReservoirBuffer m_reservoirs;
+		PhotonMap m_causticMap;
+		fp32 m_causticGatherRadiusInPx;
+
+		//Statistics are counted per thread, a thread claims its slot on the first tile it renders.
+		RenderStatistics m_statistics;
+		std::vector<RenderStatistics> m_threadStatistics;
+		std::atomic<u32> m_claimedThreadStatisticsCount;
+		fp64 m_renderTimeInSec;
 	};
 
 	inline void Renderer::SetRenderPipeline(const RendererPipeline& a_pipeline)
@@ -59,4 +165,49 @@ namespace dxray::riow
     {
 		m_backgroundColor = a_color;
     }
-}
\ No newline at end of file
+
+	inline void Renderer::SetCheckpointFile(const Path& a_checkpointFilePath)
+	{
+		m_checkpointFilePath = a_checkpointFilePath;
+	}
+
+	inline const RendererPipeline& Renderer::GetRenderPipeline() const
+	{
+		return m_pipelineConfiguration;
+	}
+
+	inline const Camera& Renderer::GetCamera() const
+	{
+		return m_camera;
+	}
+
+	inline TaskScheduler& Renderer::GetTaskScheduler()
+	{
+		return m_taskScheduler;
+	}
+
+	inline const RenderStatistics& Renderer::GetStatistics() const
+	{
+		return m_statistics;
+	}
+
+	inline const std::vector<RenderStatistics>& Renderer::GetThreadStatistics() const
+	{
+		return m_threadStatistics;
+	}
+
+	inline fp64 Renderer::GetRenderTimeInSec() const
+	{
+		return m_renderTimeInSec;
+	}
+
+	inline u64 Renderer::GetTracedRayCount() const
+	{
+		return m_statistics.GetTracedRayCount();
+	}
+
+	inline bool Renderer::SaveStatistics(const Path& a_filePath) const
+	{
+		return SaveRenderStatisticsToFile(a_filePath, m_statistics, m_threadStatistics, m_renderTimeInSec);
+	}
+}
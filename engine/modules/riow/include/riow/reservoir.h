@@ -0,0 +1,116 @@
+#pragma once
+#include "riow/scene.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// How the first vertex of a camera path reuses the reservoirs of neighbouring pixels in the previous pass, next to its own light candidates.
+	/// </summary>
+	enum class EReservoirReuse : u8
+	{
+		None,		//Resampling of the own candidates only.
+		Unbiased,	//Light points are shared between the reservoirs that could have kept them, in proportion to their target densities.
+		Biased,		//Light points are shared in proportion to the candidate counts alone, which saves evaluating them at the neighbours.
+					//Darkens edges where neighbours can't see the lights the pixel sees.
+	};
+
+
+	/// <summary>
+	/// Point that lights are resampled for: the first vertex of a camera path with a scattering density.
+	/// Holds only what evaluating a light point at it takes, every pixel keeps one per pass in the reservoir buffer.
+	/// </summary>
+	struct ReservoirShadingPoint final
+	{
+		vath::Vector3f Point = vath::Vector3f(0.0f);
+		vath::Vector3f Normal = vath::Vector3f(0.0f);
+		Color Attenuation = Color(0.0f);	//Scattering divided by the scatter pdf, as returned by the material.
+		MaterialId Material = InvalidResourceId;
+		fp32 Time = 0.0f;
+		fp32 ViewDistance = 0.0f;			//Distance to the camera, neighbours at very different distances are not reused.
+	};
+
+
+	/// <summary>
+	/// Weighted reservoir of light points: candidates stream through it and it keeps one, picked proportional to their resampling weights.
+	/// The target density of a light point is the luminance of the light the shading point scatters from it towards the camera, without visibility,
+	/// over the measure of the light point. Its contribution weight turns the kept light point into an estimate of the direct light:
+	/// the unshadowed contribution of the point over its target density times the contribution weight.
+	/// </summary>
+	struct Reservoir final
+	{
+		ReservoirShadingPoint ShadingPoint;
+		LightPoint Sample;
+		fp32 TargetPdf = 0.0f;				//Target density of the kept light point at the shading point.
+		fp32 WeightSum = 0.0f;
+		fp32 ContributionWeight = 0.0f;
+		u32 CandidateCount = 0;
+
+		/// <summary>
+		/// Adds a light point that stands for a number of candidates, returns true when it replaces the kept one.
+		/// </summary>
+		bool Add(const LightPoint& a_sample, const fp32 a_targetPdf, const fp32 a_weight, const u32 a_candidateCount);
+	};
+
+
+	/// <summary>
+	/// Reservoirs of the pixels of an accumulation buffer, of the previous pass and of the current one. Pixels only reuse the reservoirs
+	/// of the previous pass, which were all finished before the current pass started, so the result does not depend on the order tiles render in.
+	/// Pixels that get no samples in a pass, such as converged ones, leave an empty reservoir that their neighbours skip.
+	/// </summary>
+	class ReservoirBuffer final
+	{
+	public:
+		ReservoirBuffer() = default;
+
+		/// <summary>
+		/// Empties both passes.
+		/// </summary>
+		void Reset(const vath::Vector2u32& a_dimensions);
+
+		/// <summary>
+		/// The current pass becomes the previous one, the new current pass starts out empty.
+		/// </summary>
+		void BeginPass();
+
+		const Reservoir& GetPrevious(const u32 a_pixelIndex) const;
+		Reservoir& GetCurrent(const u32 a_pixelIndex);
+		const vath::Vector2u32& GetDimensions() const;
+
+	private:
+		vath::Vector2u32 m_dimensions = vath::Vector2u32(0u);
+		std::vector<Reservoir> m_previous;
+		std::vector<Reservoir> m_current;
+	};
+
+	inline const Reservoir& ReservoirBuffer::GetPrevious(const u32 a_pixelIndex) const
+	{
+		DXRAY_ASSERT(a_pixelIndex < m_previous.size());
+		return m_previous[a_pixelIndex];
+	}
+
+	inline Reservoir& ReservoirBuffer::GetCurrent(const u32 a_pixelIndex)
+	{
+		DXRAY_ASSERT(a_pixelIndex < m_current.size());
+		return m_current[a_pixelIndex];
+	}
+
+	inline const vath::Vector2u32& ReservoirBuffer::GetDimensions() const
+	{
+		return m_dimensions;
+	}
+
+
+	/// <summary>
+	/// Resampled importance sampling of the direct light at a shading point: the light list proposes candidates, the reservoir keeps one proportional
+	/// to its target density over its proposal density. With reuse, the reservoirs a few random neighbours kept in the previous pass are resampled
+	/// as well, their light points re-weighted by the target density at this shading point. Those reservoirs reused their neighbours in turn,
+	/// so a pixel effectively chooses among the candidates of many pixels and passes while tracing a single shadow ray.
+	/// Returns the reservoir, and the kept light point as seen from the shading point in the sample. The density of the sample is the inverse of
+	/// the contribution weight converted to solid angle, so it weights like any light sample. Both are 0 when no light was found.
+	/// See Bitterli et al. 2020, Spatiotemporal reservoir resampling for real-time ray tracing with dynamic direct lighting.
+	/// #Note: Reuse correlates neighbouring pixels and consecutive passes. The estimate stays unbiased in the unbiased mode,
+	/// but the per-pixel error that adaptive sampling uses underestimates the actual error.
+	/// </summary>
+	Reservoir ResampleLights(const Scene& a_scene, const ReservoirShadingPoint& a_shadingPoint, const u32 a_candidateCount, const EReservoirReuse a_reuse,
+		const ReservoirBuffer& a_buffer, const u32 a_pixelIndex, LightSample& a_sample);
+}
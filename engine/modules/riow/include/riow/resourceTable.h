@@ -0,0 +1,106 @@
+#pragma once
+#include <tuple>
+#include <core/valueTypes.h>
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// 32 bit handle into a resource table. The upper 8 bits store the type index within the table's type list, the lower 24 bits
+	/// the index into the contiguous array of that type.
+	/// </summary>
+	using ResourceId = u32;
+	inline constexpr ResourceId InvalidResourceId = u32max;
+
+	using TextureId = ResourceId;
+	using MaterialId = ResourceId;
+
+
+	/// <summary>
+	/// Stores resources of a fixed, compile-time list of types, every type in its own contiguous array. Resources are referenced through
+	/// ids instead of pointers, so hits carry no ownership and shading dispatches by switching on the type index rather than through a vtable.
+	/// #Note: Resources can only be added, ids stay valid for the lifetime of the table and survive copies of it.
+	/// </summary>
+	template<typename... TResources>
+	class ResourceTable final
+	{
+	public:
+		static constexpr u32 TypeIndexShift = 24;
+		static constexpr u32 ElementIndexMask = (1u << TypeIndexShift) - 1u;
+		static_assert(sizeof...(TResources) < 0xFF, "The type index has to fit in the upper 8 bits of a resource id.");
+
+		template<typename TResource>
+		ResourceId Add(TResource&& a_resource);
+
+		template<typename TResource>
+		const TResource& Get(const ResourceId a_id) const;
+
+		/// <summary>
+		/// Index of the type within the type list, known at compile time. Used as case label when dispatching.
+		/// </summary>
+		template<typename TResource>
+		static constexpr u32 TypeIndexOf();
+
+		static u32 GetTypeIndex(const ResourceId a_id);
+		static u32 GetElementIndex(const ResourceId a_id);
+
+	private:
+		template<typename TResource, typename TFirst, typename... TRest>
+		static constexpr u32 TypeIndexOfImpl();
+
+		std::tuple<std::vector<TResources>...> m_resources;
+	};
+
+	template<typename... TResources>
+	template<typename TResource>
+	inline ResourceId ResourceTable<TResources...>::Add(TResource&& a_resource)
+	{
+		using ResourceType = std::remove_cvref_t<TResource>;
+		std::vector<ResourceType>& resources = std::get<std::vector<ResourceType>>(m_resources);
+		DXRAY_ASSERT_WITH_MSG(resources.size() < ElementIndexMask, "Resource table is full.");
+
+		resources.push_back(std::forward<TResource>(a_resource));
+		return (TypeIndexOf<ResourceType>() << TypeIndexShift) | static_cast<u32>(resources.size() - 1);
+	}
+
+	template<typename... TResources>
+	template<typename TResource>
+	inline const TResource& ResourceTable<TResources...>::Get(const ResourceId a_id) const
+	{
+		DXRAY_ASSERT(GetTypeIndex(a_id) == TypeIndexOf<TResource>());
+		return std::get<std::vector<TResource>>(m_resources)[GetElementIndex(a_id)];
+	}
+
+	template<typename... TResources>
+	template<typename TResource>
+	inline constexpr u32 ResourceTable<TResources...>::TypeIndexOf()
+	{
+		return TypeIndexOfImpl<TResource, TResources...>();
+	}
+
+	template<typename... TResources>
+	template<typename TResource, typename TFirst, typename... TRest>
+	inline constexpr u32 ResourceTable<TResources...>::TypeIndexOfImpl()
+	{
+		if constexpr (std::is_same_v<TResource, TFirst>)
+		{
+			return 0;
+		}
+		else
+		{
+			static_assert(sizeof...(TRest) > 0, "Resource type is not part of the table's type list.");
+			return 1 + TypeIndexOfImpl<TResource, TRest...>();
+		}
+	}
+
+	template<typename... TResources>
+	inline u32 ResourceTable<TResources...>::GetTypeIndex(const ResourceId a_id)
+	{
+		return a_id >> TypeIndexShift;
+	}
+
+	template<typename... TResources>
+	inline u32 ResourceTable<TResources...>::GetElementIndex(const ResourceId a_id)
+	{
+		return a_id & ElementIndexMask;
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <core/valueTypes.h>
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// PCG32 random number generator used for every sampling decision riow makes.
+	/// Contrary to vath::RandomNumber the state is explicit and small, which makes renders reproducible from a seed
+	/// and allows a render to be resumed from a checkpoint with the exact same sample sequence.
+	/// #Note: Implementation based on the minimal C implementation of pcg-random.org.
+	/// </summary>
+	class Sampler final
+	{
+	public:
+		Sampler(const u64 a_seed = 0x853c49e6748fea9bull, const u64 a_stream = 0xda3e39cb94b95bdbull);
+		~Sampler() = default;
+
+		void Seed(const u64 a_seed, const u64 a_stream);
+
+		u32 NextU32();
+		fp32 NextFloat();
+		fp32 NextFloat(const fp32 a_min, const fp32 a_max);
+		i32 NextInt(const i32 a_min, const i32 a_max);
+
+		u64 GetState() const;
+		u64 GetIncrement() const;
+
+	private:
+		u64 m_state;
+		u64 m_increment;
+	};
+
+	inline Sampler::Sampler(const u64 a_seed /*= 0x853c49e6748fea9bull*/, const u64 a_stream /*= 0xda3e39cb94b95bdbull*/) :
+		m_state(0u),
+		m_increment(0u)
+	{
+		Seed(a_seed, a_stream);
+	}
+
+	inline void Sampler::Seed(const u64 a_seed, const u64 a_stream)
+	{
+		m_state = 0u;
+		m_increment = (a_stream << 1u) | 1u;
+		NextU32();
+		m_state += a_seed;
+		NextU32();
+	}
+
+	inline u32 Sampler::NextU32()
+	{
+		const u64 oldState = m_state;
+		m_state = oldState * 6364136223846793005ull + m_increment;
+		const u32 xorShifted = static_cast<u32>(((oldState >> 18u) ^ oldState) >> 27u);
+		const u32 rotation = static_cast<u32>(oldState >> 59u);
+		return (xorShifted >> rotation) | (xorShifted << ((~rotation + 1u) & 31u));
+	}
+
+	inline fp32 Sampler::NextFloat()
+	{
+		//Use the upper 24 bits, which map exactly onto the fp32 mantissa - this keeps the result in [0, 1).
+		return static_cast<fp32>(NextU32() >> 8) * 0x1p-24f;
+	}
+
+	inline fp32 Sampler::NextFloat(const fp32 a_min, const fp32 a_max)
+	{
+		return a_min + (a_max - a_min) * NextFloat();
+	}
+
+	inline i32 Sampler::NextInt(const i32 a_min, const i32 a_max)
+	{
+		const u64 range = static_cast<u64>(static_cast<i64>(a_max) - a_min) + 1u;
+		return a_min + static_cast<i32>((static_cast<u64>(NextU32()) * range) >> 32u);
+	}
+
+	inline u64 Sampler::GetState() const
+	{
+		return m_state;
+	}
+
+	inline u64 Sampler::GetIncrement() const
+	{
+		return m_increment;
+	}
+
+
+	//--- Sampling helpers ---
+
+	/// <summary>
+	/// Avalanching 64-bit hash (splitmix64 finalizer), used to decorrelate sampler seeds of neighbouring pixels.
+	/// </summary>
+	inline constexpr u64 HashSeed(u64 a_value)
+	{
+		a_value += 0x9e3779b97f4a7c15ull;
+		a_value = (a_value ^ (a_value >> 30u)) * 0xbf58476d1ce4e5b9ull;
+		a_value = (a_value ^ (a_value >> 27u)) * 0x94d049bb133111ebull;
+		return a_value ^ (a_value >> 31u);
+	}
+
+	/// <summary>
+	/// Every thread owns its own sampler, the renderer reseeds it per pixel and pass so results do not depend on task scheduling.
+	/// </summary>
+	inline Sampler& GetThreadSampler()
+	{
+		thread_local Sampler sampler;
+		return sampler;
+	}
+
+	inline fp32 RandomFloat()
+	{
+		return GetThreadSampler().NextFloat();
+	}
+
+	inline fp32 RandomFloat(const fp32 a_min, const fp32 a_max)
+	{
+		return GetThreadSampler().NextFloat(a_min, a_max);
+	}
+
+	inline i32 RandomInt(const i32 a_min, const i32 a_max)
+	{
+		return GetThreadSampler().NextInt(a_min, a_max);
+	}
+}
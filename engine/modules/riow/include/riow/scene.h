@@ -1,5 +1,8 @@
 #pragma once
-#include "riow/traceable/raytraceable.h"
+#include "riow/bvh.h"
+#include "riow/material.h"
+#include "riow/light.h"
+#include "riow/traceable/mediumVolume.h"
 
 namespace dxray::riow
 {
@@ -17,11 +20,100 @@ namespace dxray::riow
 		~Scene() = default;
 
 		void AddTraceable(std::shared_ptr<RayTraceable> a_pTraceable);
+
+		/// <summary>
+		/// Adds a participating medium as traceable and keeps track of it for transmittance queries.
+		/// </summary>
+		void AddMedium(std::shared_ptr<MediumVolume> a_pMedium);
 		void DeleteAll();
 
+		/// <summary>
+		/// Lights the scene with an environment, rays that escape the scene return its radiance. Requires a rebuild of the acceleration structure
+		/// before the environment is sampled as a light.
+		/// </summary>
+		void SetEnvironment(const EnvironmentLight& a_environment);
+
+		/// <summary>
+		/// Builds the acceleration structure over the traceables for the time window of a frame, and gathers the emissive primitives into the light list.
+		/// Traceables added afterwards require a rebuild, a scene without acceleration structure tests every traceable and has no lights to sample.
+		/// </summary>
+		void BuildAccelerationStructure(const fp32 a_timeStart, const fp32 a_timeEnd);
+
 		bool DoesIntersect(const Ray& a_ray, fp32 a_tMin, fp32 a_tMax, IntersectionInfo& a_info) const;
 
+		/// <summary>
+		/// Fraction of light arriving along the ray within [tMin, tMax], 0 when a surface blocks the ray, otherwise the transmittance of the media along it.
+		/// </summary>
+		fp32 EstimateTransmittance(const Ray& a_ray, fp32 a_tMin, fp32 a_tMax) const;
+
+		const std::vector<std::shared_ptr<MediumVolume>>& GetMedia() const;
+		const LightList& GetLights() const;
+
+		/// <summary>
+		/// Bounds of the acceleration structure, an invalid box when it isn't built.
+		/// </summary>
+		BoundingBox GetBounds() const;
+
+		/// <summary>
+		/// The environment of the scene, nullptr when escaping rays return the background color of the renderer.
+		/// </summary>
+		const EnvironmentLight* GetEnvironment() const;
+
+		/// <summary>
+		/// Materials and textures are owned by the scene, traceables refer to them by id.
+		/// </summary>
+		MaterialTable& GetMaterials();
+		const MaterialTable& GetMaterials() const;
+		TextureTable& GetTextures();
+		const TextureTable& GetTextures() const;
+
 	private:
 		std::vector<std::shared_ptr<RayTraceable>> m_traceables;
+		std::vector<std::shared_ptr<MediumVolume>> m_media;
+		BoundingVolumeHierarchy m_accelerationStructure;
+		LightList m_lights;
+		std::shared_ptr<const EnvironmentLight> m_environment;	//Shared with copies of the scene, the light list refers to it.
+		MaterialTable m_materials;
+		TextureTable m_textures;
 	};
+
+	inline const std::vector<std::shared_ptr<MediumVolume>>& Scene::GetMedia() const
+	{
+		return m_media;
+	}
+
+	inline const LightList& Scene::GetLights() const
+	{
+		return m_lights;
+	}
+
+	inline BoundingBox Scene::GetBounds() const
+	{
+		return m_accelerationStructure.IsEmpty() ? BoundingBox() : m_accelerationStructure.GetBounds();
+	}
+
+	inline const EnvironmentLight* Scene::GetEnvironment() const
+	{
+		return m_environment.get();
+	}
+
+	inline MaterialTable& Scene::GetMaterials()
+	{
+		return m_materials;
+	}
+
+	inline const MaterialTable& Scene::GetMaterials() const
+	{
+		return m_materials;
+	}
+
+	inline TextureTable& Scene::GetTextures()
+	{
+		return m_textures;
+	}
+
+	inline const TextureTable& Scene::GetTextures() const
+	{
+		return m_textures;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include "riow/scene.h"
+#include "riow/camera.h"
+#include "riow/renderer.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Render settings stored in a scene file next to the scene itself, the defaults are used by the built-in scenes.
+	/// </summary>
+	struct SceneFileSettings final
+	{
+		vath::Vector2u32 ImageDimensions = vath::Vector2u32(2560, 1400);
+		Color BackgroundColor = Color(0.01f);
+		RendererPipeline Pipeline =
+		{
+			.MaxTraceDepth = 100,
+			.SuperSampleFactor = 2,
+			.DepthOfFieldSampleCount = 2,
+			.ClusterSize = 4,
+			.PassCount = 4,
+			.CheckpointIntervalInSec = 60.0f
+		};
+	};
+
+	/// <summary>
+	/// Loads a scene file into an empty scene and overwrites the camera and settings with the ones of the file.
+	/// Both the text format and the cooked binary format are accepted, cooked files are recognized by their header.
+	///
+	/// The text format holds one statement per line, # starts a comment. Textures and materials are named and have to be declared before use:
+	///		image <width> <height>
+	///		background <r> <g> <b>
+	///		environment <equirectangular image path relative to the asset directory> [<strength>]
+	///		camera position|target <x> <y> <z>
+	///		camera fov <vertical degrees> | aperture <size> | focus <distance> | shutter <seconds>
+	///		pipeline depth|supersample|dof|cluster|passes|guiding|reservoirs|caustics <count>
+	///		filter box|tent|gaussian|mitchell [<radius in pixels>]
+	///		texture <name> solid <r> <g> <b> | checker <scale> <even texture> <odd texture> | noise <scale> | image <path relative to the asset directory>
+	///		material <name> lambertian <texture> | metallic <r> <g> <b> <fuzz> | dielectric <ior> | light <texture> <strength> | isotropic <texture>
+	///		sphere <x> <y> <z> <radius> <material> [<end x> <end y> <end z>]
+	/// All spheres of a file are stored in a single sphere set.
+	/// </summary>
+	bool LoadSceneFile(const Path& a_filePath, Camera& a_camera, Scene& a_scene, SceneFileSettings& a_settings);
+
+	/// <summary>
+	/// Parses a text scene file and stores it in the cooked binary format: fixed size records for every statement and the spheres
+	/// stored in the leaf order of a prebuilt hierarchy. Loading a cooked file maps it into memory and copies the arrays into the scene,
+	/// there is no parsing, no hierarchy build and no allocation per sphere.
+	/// #Note: Cooked files store the records as laid out in memory, they are only meant to be loaded by the build that cooked them.
+	/// </summary>
+	bool CookSceneFile(const Path& a_textFilePath, const Path& a_cookedFilePath);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "riow/renderer.h"
+#include "riow/postProcess.h"
+#include "riow/image.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Animation sequence configuration.
+	/// </summary>
+	struct SequenceSettings final
+	{
+		u32 FrameCount = 24;
+		fp32 FramesPerSecond = 24.0f;
+		String OutputName = "riowFrame";	//Frames are stored as <OutputName>_<frame index>.png.
+		fp32 CameraOrbitSpeedInRadPerSec = 0.0f;	//Orbits the camera around its focus point, along the world up axis.
+		bool bTemporalReuse = false;
+		TemporalReuseSettings TemporalReuse;
+		DisplayTransform Display;
+		Image::EFileExtension HdrOutputFormat = Image::EFileExtension::Invalid;	//exr or pfm stores the linear radiance of every frame next to the png.
+	};
+
+	/// <summary>
+	/// Renders the frames of an animation, the shutter of frame i opens at i / FramesPerSecond.
+	/// Frames are pipelined: while frame i renders on the task scheduler of the renderer, a thread next to it builds the acceleration structure
+	/// of frame i + 1 and encodes frame i - 1, so only the rendering itself is on the critical path as long as those take less time than a frame.
+	/// Frames don't checkpoint, the checkpoint interval of the pipeline is ignored.
+	/// With temporal reuse, every frame starts from the reprojected samples of the previous frame. A few fresh passes validate the history,
+	/// after which the remaining passes only render pixels that did not receive enough samples from the history.
+	/// </summary>
+	class SequenceRenderer final
+	{
+	public:
+		SequenceRenderer(Renderer& a_renderer, const SequenceSettings& a_settings);
+		~SequenceRenderer() = default;
+
+		void Render(const Scene& a_scene, const u64 a_seed);
+
+	private:
+		Camera GetFrameCamera(const Camera& a_camera, const fp32 a_frameTime) const;
+
+		Renderer& m_renderer;
+		SequenceSettings m_settings;
+	};
+}
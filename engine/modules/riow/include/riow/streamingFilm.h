@@ -0,0 +1,39 @@
+#pragma once
+#include "riow/renderer.h"
+#include "riow/imageStream.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Streamed render configuration.
+	/// </summary>
+	struct StreamingFilmSettings final
+	{
+		u32 BandHeightInPx = 64;	//Has to be a multiple of the cluster size.
+		String OutputName = "riowOutput";
+		DisplayTransform Display;
+		Image::EFileExtension HdrOutputFormat = Image::EFileExtension::Invalid;	//exr or pfm stores the linear radiance next to the png.
+	};
+
+	/// <summary>
+	/// Renders the image in bands of rows from the top, every finished band is written to the output files while the next band renders.
+	/// Only two bands are held in memory at any time, so the image size is limited by disk space instead of memory.
+	/// Bands are rendered with all passes of the pipeline, the per pixel seeding makes the result identical to a render of the full image.
+	/// #Note: Every band is a render of its own. The caustic photon maps only depend on the pass and are traced again for every band, while the
+	/// path guide and the reservoirs start over at every band, so guided or resampled images differ from a render of the full image.
+	/// #Note: Checkpoints and time budgets cover a single accumulation buffer and are disabled while streaming.
+	/// #Note: Bands truncate the reconstruction filter along their borders, filters wider than a pixel are rejected.
+	/// </summary>
+	class StreamingFilm final
+	{
+	public:
+		StreamingFilm(Renderer& a_renderer, const StreamingFilmSettings& a_settings);
+		~StreamingFilm() = default;
+
+		bool Render(const Scene& a_scene, const u64 a_seed);
+
+	private:
+		Renderer& m_renderer;
+		StreamingFilmSettings m_settings;
+	};
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "riow/accumulationBuffer.h"
+#include "riow/camera.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// First hit information of every pixel, traced through the pixel center at the middle of the shutter interval.
+	/// Used to reproject the samples of the previous frame.
+	/// </summary>
+	struct GuideBuffer final
+	{
+		static constexpr fp32 MissDepth = fp32max;
+
+		std::vector<vath::Vector3f> Positions;
+		std::vector<vath::Vector3f> Velocities;
+		std::vector<fp32> Depths;	//Distance from the camera to the first hit, MissDepth when nothing was hit.
+		vath::Vector2u32 Dimensions = vath::Vector2u32(0u, 0u);
+
+		void Resize(const vath::Vector2u32& a_dimensionsInPx);
+	};
+
+	/// <summary>
+	/// Temporal reuse configuration.
+	/// </summary>
+	struct TemporalReuseSettings final
+	{
+		u32 MaxHistoryPassCount = 8;		//Caps the reused samples, so stale history fades out.
+		u32 FreshPassCount = 1;				//Passes rendered before the history is validated against them.
+		fp32 DepthTolerance = 0.05f;		//Relative depth difference at which a reprojected sample counts as disoccluded.
+		fp32 RejectionSigmaScale = 3.0f;	//History further than this many standard deviations from the fresh samples is rejected.
+	};
+
+	/// <summary>
+	/// Outcome of reusing the samples of the previous frame, in pixels.
+	/// </summary>
+	struct TemporalReuseStatistics final
+	{
+		u32 ReprojectedPixelCount = 0;
+		u32 OffscreenPixelCount = 0;
+		u32 DisoccludedPixelCount = 0;
+		u32 VarianceRejectedPixelCount = 0;
+		u32 ReusedPixelCount = 0;
+		u64 ReusedSampleCount = 0;
+	};
+
+	/// <summary>
+	/// Gathers the samples of the previous frame for every pixel of the current frame. Every pixel first hit is moved back along its motion
+	/// vector and projected with the previous camera, samples are only taken when the previous frame saw the same surface at that pixel.
+	/// </summary>
+	/// <param name="a_previousBuffer">Accumulation buffer of the previous frame.</param>
+	/// <param name="a_historyBuffer">Receives the reprojected samples, capped to the maximum history pass count.</param>
+	void ReprojectHistory(const AccumulationBuffer& a_previousBuffer, const GuideBuffer& a_previousGuide, const Camera& a_previousCamera,
+		const GuideBuffer& a_guide, const Camera& a_camera, const fp32 a_frameDeltaTimeInSec, const u32 a_samplesPerPass,
+		const TemporalReuseSettings& a_settings, AccumulationBuffer& a_historyBuffer, TemporalReuseStatistics& a_statistics);
+
+	/// <summary>
+	/// Adds the reprojected history to the freshly rendered samples of every pixel, unless the history luminance is inconsistent with them.
+	/// </summary>
+	void MergeHistory(const AccumulationBuffer& a_historyBuffer, const u32 a_samplesPerPass, const TemporalReuseSettings& a_settings,
+		AccumulationBuffer& a_accumulationBuffer, TemporalReuseStatistics& a_statistics);
+}
@@ -3,33 +3,25 @@
 #include "riow/color.h"
 #include "riow/image.h"
 #include "riow/perlin.h"
+#include "riow/mipTexture.h"
+#include "riow/boundingBox.h"
+#include "riow/resourceTable.h"
 
 namespace dxray::riow
 {
     inline const Color InvalidTexture = Color(1.0f, 0.0f, 1.0f);
 
-    /// <summary>
-    /// Base class for any image that can be sampled 
-    /// </summary>
-    class Texture
-    {
-    public:
-        virtual ~Texture() = default;
-        virtual Color Sample(const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point) const = 0;
-    };
-
-
     /// <summary>
     /// Represents a solid color that can be used for objects. This way we can assign a color or texture based on image data regardless of static type.
     /// </summary>
-    class SolidColor final : public Texture
+    class SolidColor final
     {
     public:
         SolidColor(const Color& a_albedo) :
             m_albedo(a_albedo)
         {}
 
-        Color Sample(const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point) const override
+        Color Sample() const
         {
             return m_albedo;
         }
@@ -41,23 +33,18 @@ namespace dxray::riow
 
     /// <summary>
     /// Classic checkerboard implementation, based on even/odd floored values.
+    /// The tiles refer to other textures in the same texture table.
     /// </summary>
-    class CheckerBoard final : public Texture
+    class CheckerBoard final
     {
     public:
-        CheckerBoard(const fp32 a_scale, std::shared_ptr<Texture> a_evenTile, std::shared_ptr<Texture> a_oddTile) :
+        CheckerBoard(const fp32 a_scale, const TextureId a_evenTile, const TextureId a_oddTile) :
             m_scaleReciprocal(1.0f / a_scale),
             m_evenTileTexture(a_evenTile),
             m_oddTileTexture(a_oddTile)
         {}
 
-        CheckerBoard(const fp32 a_scale, const Color& a_evenColor, const Color& a_oddColor) :
-            m_scaleReciprocal(1.0f / a_scale),
-            m_evenTileTexture(std::make_shared<SolidColor>(a_evenColor)),
-            m_oddTileTexture(std::make_shared<SolidColor>(a_oddColor))
-        {}
-
-        Color Sample(const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point) const override
+        TextureId SelectTile(const vath::Vector3f& a_point) const
         {
             const vath::Vector3i32 tileEdges(
                 static_cast<i32>(std::floor(m_scaleReciprocal * a_point.x)),
@@ -66,42 +53,45 @@ namespace dxray::riow
             );
 
             return (std::abs(tileEdges.x) + std::abs(tileEdges.y) + std::abs(tileEdges.z)) % 2 == 0
-                ? m_evenTileTexture->Sample(a_uvCoord, a_point)
-                : m_oddTileTexture->Sample(a_uvCoord, a_point);
+                ? m_evenTileTexture
+                : m_oddTileTexture;
         }
 
     private:
         fp32 m_scaleReciprocal;
-        std::shared_ptr<Texture> m_evenTileTexture;
-        std::shared_ptr<Texture> m_oddTileTexture;
+        TextureId m_evenTileTexture;
+        TextureId m_oddTileTexture;
     };
 
 
     /// <summary>
-    /// Texture based on image data.
+    /// Texture based on image data, nearest lookups on the raw 8 bit data without any color space conversion.
+    /// Prefer MipTexture, which filters linear texels.
+    /// #Note: The image is shared between copies of the texture table, sampling only dereferences it and never touches the reference count.
     /// </summary>
-    class ImageTexture final : public Texture
+    class ImageTexture final
     {
     public:
         ImageTexture(std::shared_ptr<Image> a_image) :
             m_image(a_image)
         {}
 
-        Color Sample(const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point) const override
+        Color Sample(const vath::Vector2f& a_uvCoord) const
         {
-            if (m_image == nullptr)
+            const Image* pImage = m_image.get();
+            if (pImage == nullptr)
             {
                 return InvalidTexture;
             }
 
-            const u8* pixel = m_image->ReadPixel(vath::Vector2i32(
-                static_cast<i32>(vath::Clamp<fp32>(a_uvCoord.x, 0.0f, 1.0f) * m_image->GetWidth()),
-                static_cast<i32>(vath::Clamp<fp32>(a_uvCoord.y, 0.0f, 1.0f) * m_image->GetHeight())
+            const u8* pixel = pImage->ReadPixel(vath::Vector2i32(
+                static_cast<i32>(vath::Clamp<fp32>(a_uvCoord.x, 0.0f, 1.0f) * pImage->GetWidth()),
+                static_cast<i32>(vath::Clamp<fp32>(a_uvCoord.y, 0.0f, 1.0f) * pImage->GetHeight())
             ));
 
             Color sampledColor = Color(0.0f);
             const fp32 unitColorReciprocal = 1.0f / 255.0f;
-            for (u8 ci = 0; ci < m_image->GetChannelCount(); ++ci)
+            for (u8 ci = 0; ci < pImage->GetChannelCount(); ++ci)
             {
                 sampledColor[ci] = static_cast<fp32>(pixel[ci] * unitColorReciprocal);
             }
@@ -116,8 +106,10 @@ namespace dxray::riow
 
     /// <summary>
     /// Texture able to sample perlin noise.
+    /// The noise can be baked into a grid over a region of the scene, samples within the region then cost a single trilinear grid lookup
+    /// instead of evaluating every octave. Samples outside of the region evaluate the noise as before.
     /// </summary>
-    class NoiseTexture final : public Texture
+    class NoiseTexture final
     {
     public:
         NoiseTexture(const fp32 a_noiseScalar, const u32 a_accumilationDepth = 7) :
@@ -126,12 +118,23 @@ namespace dxray::riow
             m_accumilationDepth(a_accumilationDepth)
         {}
 
-        ~NoiseTexture() = default;
+        /// <summary>
+        /// Bakes the noise within the bounds into a grid.
+        /// #Note: Detail finer than a grid cell is lost, octaves above the grid frequency are filtered out by the interpolation.
+        /// </summary>
+        /// <param name="a_resolution">Grid points along the longest axis of the bounds, the other axes use the same cell size.</param>
+        void Bake(const BoundingBox& a_bounds, const u32 a_resolution);
 
-        Color Sample(const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point) const override
+        Color Sample(const vath::Vector3f& a_point) const
         {
+            fp32 noiseValue = 0.0f;
+            if (m_bakedGrid != nullptr && SampleBakedGrid(*m_bakedGrid, a_point, noiseValue))
+            {
+                return vath::Vector3f(noiseValue);
+            }
+
             //As perlin noise returns values between -1 and 1 due to directions being fully random they are mapped to 0 and 1.
-            const fp32 noiseValue = m_perlin.Turbulence(a_point, m_accumilationDepth);
+            noiseValue = m_perlin.Turbulence(a_point, m_accumilationDepth);
 
             //Marble like noise.
             //const fp32 noiseValue = 0.5f * (1.0f + std::sin(m_noiseScalar * a_point.x + 10.0f * m_perlin.Turbulence(a_point, m_accumilationDepth)));
@@ -139,8 +142,83 @@ namespace dxray::riow
         }
 
     private:
+        /// <summary>
+        /// Baked noise values, shared between copies of the texture.
+        /// </summary>
+        struct BakedGrid final
+        {
+            BoundingBox Bounds;
+            vath::Vector3u32 Resolution;
+            fp32 CellsPerUnit = 0.0f;
+            std::vector<fp32> Values;
+        };
+
+        static bool SampleBakedGrid(const BakedGrid& a_grid, const vath::Vector3f& a_point, fp32& a_value);
+
         Perlin m_perlin;
         fp32 m_noiseScalar;
         u32 m_accumilationDepth;
+        std::shared_ptr<const BakedGrid> m_bakedGrid;
+    };
+
+
+    /// <summary>
+    /// Owns all textures of a scene in contiguous per type arrays, textures are referenced by id.
+    /// Sampling dispatches on the type stored in the id, which keeps it free of virtual calls and reference counting.
+    /// </summary>
+    class TextureTable final
+    {
+    public:
+        template<typename TTexture>
+        TextureId Add(TTexture&& a_texture);
+
+        /// <summary>
+        /// Convenience for the common case of a single color texture.
+        /// </summary>
+        TextureId AddSolidColor(const Color& a_albedo);
+
+        /// <summary>
+        /// Samples a texture, the footprint is the width of the ray cone at the hit in uv units and is used by filtered textures.
+        /// </summary>
+        Color Sample(TextureId a_textureId, const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point, const fp32 a_uvFootprint = 0.0f) const;
+
+    private:
+        using Table = ResourceTable<SolidColor, CheckerBoard, ImageTexture, MipTexture, NoiseTexture>;
+        Table m_textures;
     };
-}
\ No newline at end of file
+
+    template<typename TTexture>
+    inline TextureId TextureTable::Add(TTexture&& a_texture)
+    {
+        return m_textures.Add(std::forward<TTexture>(a_texture));
+    }
+
+    inline TextureId TextureTable::AddSolidColor(const Color& a_albedo)
+    {
+        return m_textures.Add(SolidColor(a_albedo));
+    }
+
+    inline Color TextureTable::Sample(TextureId a_textureId, const vath::Vector2f& a_uvCoord, const vath::Vector3f& a_point, const fp32 a_uvFootprint /*= 0.0f*/) const
+    {
+        //Checkerboards refer to other textures, resolve them iteratively rather than recursing.
+        while (true)
+        {
+            switch (Table::GetTypeIndex(a_textureId))
+            {
+            case Table::TypeIndexOf<SolidColor>():
+                return m_textures.Get<SolidColor>(a_textureId).Sample();
+            case Table::TypeIndexOf<CheckerBoard>():
+                a_textureId = m_textures.Get<CheckerBoard>(a_textureId).SelectTile(a_point);
+                continue;
+            case Table::TypeIndexOf<ImageTexture>():
+                return m_textures.Get<ImageTexture>(a_textureId).Sample(a_uvCoord);
+            case Table::TypeIndexOf<MipTexture>():
+                return m_textures.Get<MipTexture>(a_textureId).Sample(a_uvCoord, a_uvFootprint);
+            case Table::TypeIndexOf<NoiseTexture>():
+                return m_textures.Get<NoiseTexture>(a_textureId).Sample(a_point);
+            default:
+                return InvalidTexture;
+            }
+        }
+    }
+}
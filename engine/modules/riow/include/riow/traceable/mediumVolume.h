@@ -0,0 +1,51 @@
+#pragma once
+#include "riow/traceable/raytraceable.h"
+#include "riow/medium.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Participating medium filling a convex boundary traceable, such as fog or smoke.
+	/// Rays entering the boundary either pass through or collide within the volume, in which case the hit carries the phase material,
+	/// e.g. Isotropic, and no meaningful normal.
+	/// Tracking is counted in the medium statistics of the calling thread.
+	/// #Note: The boundary has to be convex, rays are assumed to enter and exit it only once.
+	/// </summary>
+	class MediumVolume final : public RayTraceable
+	{
+	public:
+		MediumVolume(std::shared_ptr<RayTraceable> a_pBoundary, const MediumDensity& a_density, const MaterialId a_phaseMaterial);
+		~MediumVolume() = default;
+
+		bool DoesIntersect(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, IntersectionInfo& a_info) const override;
+		bool DoesOcclude(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax) const override;
+		BoundingBox GetBounds(const fp32 a_timeStart, const fp32 a_timeEnd) const override;
+
+		/// <summary>
+		/// Fraction of light passing through the volume along the ray within [tMin, tMax], estimated with ratio tracking.
+		/// </summary>
+		fp32 EstimateTransmittance(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax) const;
+
+		const MediumDensity& GetDensity() const;
+
+	private:
+		/// <summary>
+		/// Ray interval within the boundary, clamped to [tMin, tMax].
+		/// </summary>
+		bool GetBoundaryInterval(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, fp32& a_tEnter, fp32& a_tExit) const;
+
+		std::shared_ptr<RayTraceable> m_pBoundary;
+		MediumDensity m_density;
+		MaterialId m_phaseMaterial;
+	};
+
+	inline bool MediumVolume::DoesOcclude(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax) const
+	{
+		return false;
+	}
+
+	inline const MediumDensity& MediumVolume::GetDensity() const
+	{
+		return m_density;
+	}
+}
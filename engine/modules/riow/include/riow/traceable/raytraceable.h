@@ -1,9 +1,13 @@
 #pragma once
-#include "riow/ray.h"
+#include "riow/boundingBox.h"
+#include "riow/resourceTable.h"
 
 namespace dxray::riow
 {
-	class Material;
+	class MaterialTable;
+	class LightList;
+
+	inline constexpr u32 InvalidLightIndex = u32max;
 
 	/// <summary>
 	/// Structure containing the intersection results on a ray-traceable object.
@@ -13,8 +17,14 @@ namespace dxray::riow
 		vath::Vector3f Point = vath::Vector3(0.0f);
 		vath::Vector3f Normal = vath::Vector3(0.0f);
 		vath::Vector2f UvCoord = vath::Vector2f(0.0f, 0.0f);
-		std::shared_ptr<Material> Mat = nullptr;
+		vath::Vector3f Velocity = vath::Vector3(0.0f); //World space motion of the hit point per second.
+		MaterialId Material = InvalidResourceId;
+		u32 TraceableIndex = 0;			//Traceable of the scene that was hit, filled in by the scene.
+		u32 PrimitiveIndex = 0;			//Primitive of the traceable that was hit, e.g. the sphere of a sphere set.
+		u32 LightIndex = InvalidLightIndex;	//Index into the light list of the scene when the hit primitive is a light, filled in by the scene.
 		fp32 Length = 0.0f;
+		fp32 UvScale = 0.0f;			//Uv units per world unit around the hit point, filled in by the traceable.
+		fp32 UvFootprint = 0.0f;		//Width of the ray cone at the hit in uv units, filled in by the renderer. 0 samples textures at full resolution.
 		bool FrontFace = false;
 
 		//#Todo: move this to where applicable - probably only in refractive/volumetric volumes.
@@ -36,5 +46,31 @@ namespace dxray::riow
 	public:
 		virtual ~RayTraceable() = default;
 		virtual bool DoesIntersect(const Ray& a_ray, fp32 a_tMin, fp32 a_tMax, IntersectionInfo& a_info) const = 0;
+
+		/// <summary>
+		/// Bounds of the traceable over the time window, which covers any motion within the window.
+		/// </summary>
+		virtual BoundingBox GetBounds(const fp32 a_timeStart, const fp32 a_timeEnd) const = 0;
+
+		/// <summary>
+		/// Whether the traceable blocks the ray anywhere within [tMin, tMax], used by shadow rays which don't need the closest hit.
+		/// Participating media don't block rays, the scene estimates their transmittance separately.
+		/// </summary>
+		virtual bool DoesOcclude(const Ray& a_ray, fp32 a_tMin, fp32 a_tMax) const;
+
+		/// <summary>
+		/// Adds the emissive primitives of the traceable to the light list under the traceable index, keyed by the primitive index they report in hits.
+		/// The traceable is left untouched, so copies of a scene that share their traceables gather their lights independently.
+		/// </summary>
+		virtual void GatherLights(const MaterialTable& a_materials, const u32 a_traceableIndex, LightList& a_lights) const;
 	};
+
+	inline bool RayTraceable::DoesOcclude(const Ray& a_ray, fp32 a_tMin, fp32 a_tMax) const
+	{
+		IntersectionInfo info;
+		return DoesIntersect(a_ray, a_tMin, a_tMax, info);
+	}
+
+	inline void RayTraceable::GatherLights(const MaterialTable& a_materials, const u32 a_traceableIndex, LightList& a_lights) const
+	{ }
 }
\ No newline at end of file
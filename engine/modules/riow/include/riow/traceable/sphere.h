@@ -10,22 +10,35 @@ namespace dxray::riow
 	class Sphere final : public RayTraceable
 	{
 	public:
-		Sphere(const vath::Vector3& a_center, const fp32 a_radius, std::shared_ptr<Material> a_material = nullptr);
-		Sphere(const vath::Vector3& a_frameStartCenter, const vath::Vector3& a_frameEndCenter, const fp32 a_radius, std::shared_ptr<Material> a_material = nullptr);
+		Sphere(const vath::Vector3& a_center, const fp32 a_radius, const MaterialId a_material = InvalidResourceId);
+		Sphere(const vath::Vector3& a_frameStartCenter, const vath::Vector3& a_frameEndCenter, const fp32 a_radius, const MaterialId a_material = InvalidResourceId);
 		~Sphere() = default;
 
 		bool DoesIntersect(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, IntersectionInfo& a_info) const override;
-		void SetMaterial(std::shared_ptr<Material> a_material);
+		bool DoesOcclude(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax) const override;
+		BoundingBox GetBounds(const fp32 a_timeStart, const fp32 a_timeEnd) const override;
+		void GatherLights(const MaterialTable& a_materials, const u32 a_traceableIndex, LightList& a_lights) const override;
+		void SetMaterial(const MaterialId a_material);
 
 		static vath::Vector2f PointToUv(const vath::Vector3f& a_point);
 
+		/// <summary>
+		/// Ray-sphere intersection shared with sphere sets, returns the nearest hit distance within (tMin, tMax].
+		/// </summary>
+		static bool IntersectRay(const vath::Vector3f& a_center, const fp32 a_radius, const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, fp32& a_t);
+
+		/// <summary>
+		/// Fills the intersection info of a hit found by IntersectRay, the primitive index is left to the caller.
+		/// </summary>
+		static void SetIntersectionInfo(const vath::Vector3f& a_center, const fp32 a_radius, const vath::Vector3f& a_velocity, const MaterialId a_material, const Ray& a_ray, const fp32 a_t, IntersectionInfo& a_info);
+
 	private:
 		Ray m_translation;
 		fp32 m_radius;
-		std::shared_ptr<Material> m_material;
+		MaterialId m_material;
 	};
 
-	inline void Sphere::SetMaterial(std::shared_ptr<Material> a_material)
+	inline void Sphere::SetMaterial(const MaterialId a_material)
 	{
 		m_material = a_material;
 	}
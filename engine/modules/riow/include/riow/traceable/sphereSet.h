@@ -0,0 +1,64 @@
+#pragma once
+#include "riow/traceable/raytraceable.h"
+#include "riow/bvh.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Large amounts of spheres stored in a single contiguous array with a hierarchy of their own, traced as one traceable.
+	/// Adding a sphere costs 32 bytes instead of a heap allocated traceable, which is what allows scenes of millions of spheres to load quickly.
+	/// #Note: The hierarchy bounds the spheres over the motion window given at construction, rays outside of it can miss moving spheres.
+	/// </summary>
+	class SphereSet final : public RayTraceable
+	{
+	public:
+		/// <summary>
+		/// Sphere of a set, the layout is stored as is in cooked scene files.
+		/// </summary>
+		struct Element final
+		{
+			vath::Vector3f Center = vath::Vector3f(0.0f);		//Center at time 0.
+			fp32 Radius = 0.0f;
+			vath::Vector3f Velocity = vath::Vector3f(0.0f);	//Motion of the center per unit of time.
+			MaterialId Material = InvalidResourceId;
+		};
+
+		/// <summary>
+		/// Builds the hierarchy over the spheres for motion within [timeStart, timeEnd], the spheres are reordered to match its leaves.
+		/// </summary>
+		SphereSet(std::vector<Element> a_spheres, const fp32 a_timeStart, const fp32 a_timeEnd);
+
+		/// <summary>
+		/// Takes spheres already in the leaf order of a previously built hierarchy, as stored in cooked scene files.
+		/// </summary>
+		SphereSet(std::vector<Element> a_spheres, const BoundingVolumeHierarchy::Node* a_pNodes, const usize a_nodeCount);
+		~SphereSet() = default;
+
+		bool DoesIntersect(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, IntersectionInfo& a_info) const override;
+		bool DoesOcclude(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax) const override;
+		BoundingBox GetBounds(const fp32 a_timeStart, const fp32 a_timeEnd) const override;
+		void GatherLights(const MaterialTable& a_materials, const u32 a_traceableIndex, LightList& a_lights) const override;
+
+		/// <summary>
+		/// Bounds of a single sphere over the time window.
+		/// </summary>
+		static BoundingBox GetElementBounds(const Element& a_sphere, const fp32 a_timeStart, const fp32 a_timeEnd);
+
+		const std::vector<Element>& GetSpheres() const;
+		const BoundingVolumeHierarchy& GetHierarchy() const;
+
+	private:
+		std::vector<Element> m_spheres;
+		BoundingVolumeHierarchy m_hierarchy;
+	};
+
+	inline const std::vector<SphereSet::Element>& SphereSet::GetSpheres() const
+	{
+		return m_spheres;
+	}
+
+	inline const BoundingVolumeHierarchy& SphereSet::GetHierarchy() const
+	{
+		return m_hierarchy;
+	}
+}
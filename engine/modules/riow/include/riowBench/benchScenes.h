@@ -0,0 +1,34 @@
+#pragma once
+#include "riow/traceable/sphereSet.h"
+#include "riow/camera.h"
+#include "riow/scene.h"
+
+namespace dxray::riow::bench
+{
+	/// <summary>
+	/// Spheres resting on a square field whose side grows with the square root of the count. The density of the field stays the same
+	/// between sizes, so a ray passes a comparable number of spheres and only the depth of the hierarchy changes.
+	/// </summary>
+	std::vector<SphereSet::Element> GenerateSphereField(const u32 a_sphereCount, const std::vector<MaterialId>& a_materials, const u64 a_seed);
+
+	/// <summary>
+	/// Places the camera on a corner of the field, looking along its diagonal. The viewport dimensions have to be set beforehand.
+	/// </summary>
+	void SetupSphereFieldCamera(const u32 a_sphereCount, Camera& a_camera);
+
+	/// <summary>
+	/// Sphere field on a ground sphere with a mix of lambertian, metallic and dielectric materials, lit by the background color.
+	/// </summary>
+	void BuildSphereFieldScene(const u32 a_sphereCount, Scene& a_scene);
+
+	/// <summary>
+	/// Returns the sphere field scene of the given size with its acceleration structure built.
+	/// Only the most recently requested scene is kept alive, building the largest scenes takes seconds and gigabytes.
+	/// </summary>
+	const Scene& GetSphereFieldScene(const u32 a_sphereCount);
+
+	/// <summary>
+	/// Rays from above the field towards random points on its ground, with unnormalized directions like camera rays have.
+	/// </summary>
+	std::vector<Ray> GenerateSphereFieldRays(const u32 a_sphereCount, const u32 a_rayCount, const u64 a_seed);
+}
@@ -0,0 +1,4 @@
+#pragma once
+#include <riow/pch.h>
+
+#include <gtest/gtest.h>
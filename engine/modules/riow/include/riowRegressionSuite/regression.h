@@ -0,0 +1,55 @@
+#pragma once
+#include <map>
+#include "riow/color.h"
+#include "riow/image.h"
+
+namespace dxray::riow::regression
+{
+	/// <summary>
+	/// Options of the regression suite, set from the command line.
+	/// --update-references renders new reference images and budgets instead of comparing against them.
+	/// --budget-tolerance <fraction> is the slowdown over the budget that is still accepted.
+	/// --reference-directory <path> overrides where the references are read from and written to.
+	/// </summary>
+	struct RegressionSettings final
+	{
+		Path ReferenceDirectory = AssetRootDirectory / "regression";
+		bool bUpdateReferences = false;
+		fp64 BudgetTolerance = 0.3;
+
+		//Render cost per scene in calibration units, read from and written to budgets.txt in the reference directory.
+		std::map<String, fp64> Budgets;
+	};
+
+	RegressionSettings& GetRegressionSettings();
+
+	/// <summary>
+	/// Difference between a render and its reference, measured on tone mapped and gamma encoded values so errors weigh
+	/// roughly as they are perceived. Averages over blocks of pixels are compared, which averages out Monte Carlo noise while
+	/// changes in the image remain.
+	/// </summary>
+	struct ImageError final
+	{
+		fp64 MeanBias = 0.0;		//Mean signed difference, catches energy gained or lost over the whole image.
+		fp64 MeanBiasStandardError = 0.0;
+		fp64 BlockRmse = 0.0;		//RMSE of 4x4 pixel block averages.
+		fp64 MaxBlockError = 0.0;	//Largest difference of an 8x8 pixel block average, catches local changes such as a missing object.
+	};
+
+	ImageError CompareImages(const std::vector<Color>& a_image, const std::vector<Color>& a_reference, const vath::Vector2u32& a_dimensions);
+
+	/// <summary>
+	/// References are stored as Radiance hdr files, the shared exponent encoding is precise to well within the comparison thresholds.
+	/// </summary>
+	bool LoadReferenceImage(const Path& a_filePath, vath::Vector2u32& a_dimensions, std::vector<Color>& a_image);
+	bool SaveReferenceImage(const Path& a_filePath, const vath::Vector2u32& a_dimensions, const std::vector<Color>& a_image);
+
+	bool LoadBudgets(const Path& a_filePath, std::map<String, fp64>& a_budgets);
+	bool SaveBudgets(const Path& a_filePath, const std::map<String, fp64>& a_budgets);
+
+	/// <summary>
+	/// Time of a fixed workload of random numbers and ray-sphere tests, the best of a few runs.
+	/// Render times are expressed in multiples of it, so budgets carry over between machines of different speeds.
+	/// </summary>
+	fp64 MeasureCalibrationTimeInSec();
+}
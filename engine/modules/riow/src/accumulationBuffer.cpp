@@ -0,0 +1,271 @@
+#include "riow/accumulationBuffer.h"
+#include <core/fileSystem/fileIO.h>
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Binary layout of a checkpoint file, the header is followed by the radiance sums, the weight sums, the sample counts, the luminance sums
+	/// and the squared luminance sums of every pixel.
+	/// </summary>
+	struct CheckpointHeader final
+	{
+		char Magic[8] = { 'R', 'I', 'O', 'W', 'C', 'K', 'P', 'T' };
+		u32 Version = 4;
+		u32 Width = 0;
+		u32 Height = 0;
+		u32 CompletedPassCount = 0;
+		u32 SamplesPerPass = 0;
+		u32 Padding = 0;
+		u64 Seed = 0;
+		u64 SceneHash = 0;
+		u64 PipelineHash = 0;
+	};
+
+	static constexpr CheckpointHeader DefaultCheckpointHeader = {};
+
+	AccumulationBuffer::AccumulationBuffer() :
+		m_radianceSum(),
+		m_weightSum(),
+		m_sampleCounts(),
+		m_luminanceSum(),
+		m_luminanceSquaredSum(),
+		m_dimensions(0u, 0u),
+		m_imageOffset(0u, 0u),
+		m_seed(0u),
+		m_signature(),
+		m_firstPassIndex(0u),
+		m_completedPassCount(0u)
+	{}
+
+	AccumulationBuffer::AccumulationBuffer(const vath::Vector2u32& a_dimensionsInPx, const u64 a_seed /*= 0u*/) :
+		m_radianceSum(),
+		m_weightSum(),
+		m_sampleCounts(),
+		m_luminanceSum(),
+		m_luminanceSquaredSum(),
+		m_dimensions(0u, 0u),
+		m_imageOffset(0u, 0u),
+		m_seed(a_seed),
+		m_signature(),
+		m_firstPassIndex(0u),
+		m_completedPassCount(0u)
+	{
+		Resize(a_dimensionsInPx);
+	}
+
+	void AccumulationBuffer::Resize(const vath::Vector2u32& a_dimensionsInPx)
+	{
+		m_dimensions = a_dimensionsInPx;
+		m_radianceSum.resize(GetPixelCount());
+		m_weightSum.resize(GetPixelCount());
+		m_sampleCounts.resize(GetPixelCount());
+		m_luminanceSum.resize(GetPixelCount());
+		m_luminanceSquaredSum.resize(GetPixelCount());
+		Clear();
+	}
+
+	void AccumulationBuffer::Clear()
+	{
+		std::fill(m_radianceSum.begin(), m_radianceSum.end(), Color(0.0f));
+		std::fill(m_weightSum.begin(), m_weightSum.end(), 0.0f);
+		std::fill(m_sampleCounts.begin(), m_sampleCounts.end(), 0u);
+		std::fill(m_luminanceSum.begin(), m_luminanceSum.end(), 0.0f);
+		std::fill(m_luminanceSquaredSum.begin(), m_luminanceSquaredSum.end(), 0.0f);
+		m_completedPassCount = m_firstPassIndex;
+	}
+
+	void AccumulationBuffer::Merge(const AccumulationBuffer& a_buffer)
+	{
+		//The merged buffer has to lie fully within this buffer.
+		const vath::Vector2u32 relativeOffset(a_buffer.m_imageOffset.x - m_imageOffset.x, a_buffer.m_imageOffset.y - m_imageOffset.y);
+		DXRAY_ASSERT(a_buffer.m_imageOffset.x >= m_imageOffset.x && a_buffer.m_imageOffset.y >= m_imageOffset.y);
+		DXRAY_ASSERT(relativeOffset.x + a_buffer.m_dimensions.x <= m_dimensions.x && relativeOffset.y + a_buffer.m_dimensions.y <= m_dimensions.y);
+
+		for (u32 y = 0; y < a_buffer.m_dimensions.y; ++y)
+		{
+			for (u32 x = 0; x < a_buffer.m_dimensions.x; ++x)
+			{
+				const u32 sourceIndex = x + y * a_buffer.m_dimensions.x;
+				const u32 destinationIndex = relativeOffset.x + x + (relativeOffset.y + y) * m_dimensions.x;
+				m_radianceSum[destinationIndex] += a_buffer.m_radianceSum[sourceIndex];
+				m_weightSum[destinationIndex] += a_buffer.m_weightSum[sourceIndex];
+				m_sampleCounts[destinationIndex] += a_buffer.m_sampleCounts[sourceIndex];
+				m_luminanceSum[destinationIndex] += a_buffer.m_luminanceSum[sourceIndex];
+				m_luminanceSquaredSum[destinationIndex] += a_buffer.m_luminanceSquaredSum[sourceIndex];
+			}
+		}
+	}
+
+	void AccumulationBuffer::Resolve(std::vector<Color>& a_radianceBuffer) const
+	{
+		a_radianceBuffer.resize(GetPixelCount());
+		for (u32 pi = 0; pi < GetPixelCount(); ++pi)
+		{
+			a_radianceBuffer[pi] = GetRadiance(pi);
+		}
+	}
+
+	void AccumulationBuffer::ResolveSampleCounts(std::vector<Color>& a_colorBuffer) const
+	{
+		//Sample counts are normalized to the highest count in the buffer, so the image shows where samples went.
+		const u32 maxSampleCount = vath::Max(*std::max_element(m_sampleCounts.begin(), m_sampleCounts.end()), 1u);
+		a_colorBuffer.resize(GetPixelCount());
+		for (u32 pi = 0; pi < GetPixelCount(); ++pi)
+		{
+			a_colorBuffer[pi] = Color(static_cast<fp32>(m_sampleCounts[pi]) / static_cast<fp32>(maxSampleCount));
+		}
+	}
+
+	void AccumulationBuffer::ResolveWeights(std::vector<Color>& a_colorBuffer) const
+	{
+		const fp32 maxWeight = *std::max_element(m_weightSum.begin(), m_weightSum.end());
+		a_colorBuffer.resize(GetPixelCount());
+		for (u32 pi = 0; pi < GetPixelCount(); ++pi)
+		{
+			a_colorBuffer[pi] = Color(maxWeight > 0.0f ? vath::Max(m_weightSum[pi], 0.0f) / maxWeight : 0.0f);
+		}
+	}
+
+	void AccumulationBuffer::ResolveVariances(std::vector<Color>& a_colorBuffer, const u32 a_samplesPerBatch) const
+	{
+		//Pixels without a variance estimate yet show as 0.
+		a_colorBuffer.resize(GetPixelCount());
+		fp32 maxVariance = 0.0f;
+		for (u32 pi = 0; pi < GetPixelCount(); ++pi)
+		{
+			const fp32 variance = GetVariance(pi, a_samplesPerBatch);
+			a_colorBuffer[pi] = Color(variance == fp32max ? 0.0f : variance);
+			maxVariance = vath::Max(maxVariance, a_colorBuffer[pi].x);
+		}
+
+		if (maxVariance > 0.0f)
+		{
+			for (Color& variance : a_colorBuffer)
+			{
+				variance /= maxVariance;
+			}
+		}
+	}
+
+	fp32 AccumulationBuffer::GetVariance(const u32 a_pixelIndex, const u32 a_samplesPerBatch) const
+	{
+		//At least two batches are needed to estimate the variance.
+		const u32 batchCount = m_sampleCounts[a_pixelIndex] / a_samplesPerBatch;
+		if (batchCount < 2)
+		{
+			return fp32max;
+		}
+
+		const fp32 n = static_cast<fp32>(batchCount);
+		const fp32 mean = m_luminanceSum[a_pixelIndex] / n;
+		const fp32 batchVariance = vath::Max(m_luminanceSquaredSum[a_pixelIndex] / n - mean * mean, 0.0f) * n / (n - 1.0f);
+		return batchVariance / n;
+	}
+
+	fp32 AccumulationBuffer::GetRelativeError(const u32 a_pixelIndex, const u32 a_samplesPerBatch) const
+	{
+		const fp32 variance = GetVariance(a_pixelIndex, a_samplesPerBatch);
+		if (variance == fp32max)
+		{
+			return fp32max;
+		}
+
+		//#Note: Dark pixels are compared against a minimum luminance, otherwise their relative error never converges.
+		//The error is measured on the samples rendered for the pixel, which the filtered radiance of the pixel mostly consists of.
+		constexpr fp32 MinLuminance = 1.0f / 256.0f;
+		const fp32 mean = m_luminanceSum[a_pixelIndex] / static_cast<fp32>(m_sampleCounts[a_pixelIndex] / a_samplesPerBatch);
+		return std::sqrt(variance) / vath::Max(mean, MinLuminance);
+	}
+
+	bool AccumulationBuffer::SaveCheckpoint(const Path& a_filePath) const
+	{
+		CheckpointHeader header;
+		header.Width = m_dimensions.x;
+		header.Height = m_dimensions.y;
+		header.CompletedPassCount = m_completedPassCount;
+		header.Seed = m_seed;
+		header.SceneHash = m_signature.SceneHash;
+		header.PipelineHash = m_signature.PipelineHash;
+		header.SamplesPerPass = m_signature.SamplesPerPass;
+
+		const usize radianceSizeInBytes = m_radianceSum.size() * sizeof(Color);
+		const usize channelSizeInBytes = m_sampleCounts.size() * sizeof(u32);
+		static_assert(sizeof(u32) == sizeof(fp32));
+		std::vector<u8> blob(sizeof(CheckpointHeader) + radianceSizeInBytes + 4 * channelSizeInBytes);
+		u8* pChannel = blob.data() + sizeof(CheckpointHeader) + radianceSizeInBytes;
+		memcpy(blob.data(), &header, sizeof(CheckpointHeader));
+		memcpy(blob.data() + sizeof(CheckpointHeader), m_radianceSum.data(), radianceSizeInBytes);
+		memcpy(pChannel, m_weightSum.data(), channelSizeInBytes);
+		memcpy(pChannel + channelSizeInBytes, m_sampleCounts.data(), channelSizeInBytes);
+		memcpy(pChannel + 2 * channelSizeInBytes, m_luminanceSum.data(), channelSizeInBytes);
+		memcpy(pChannel + 3 * channelSizeInBytes, m_luminanceSquaredSum.data(), channelSizeInBytes);
+
+		//#Note: Write into a temporary file first, a pre-emption during the write should never corrupt the last valid checkpoint.
+		Path temporaryPath = a_filePath;
+		temporaryPath += ".tmp";
+		if (!WriteBinaryFile(temporaryPath, DataBlob{ blob.data(), blob.size() }))
+		{
+			return false;
+		}
+
+		std::error_code errorCode;
+		std::filesystem::rename(temporaryPath, a_filePath, errorCode);
+		if (errorCode)
+		{
+			DXRAY_ERROR("Failed to move checkpoint into place: {}", errorCode.message());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool AccumulationBuffer::LoadCheckpoint(const Path& a_filePath)
+	{
+		const String blob = ReadFile(a_filePath, true);
+		if (blob.size() < sizeof(CheckpointHeader))
+		{
+			DXRAY_WARN("No valid checkpoint found at: {}", a_filePath.string());
+			return false;
+		}
+
+		CheckpointHeader header;
+		memcpy(&header, blob.data(), sizeof(CheckpointHeader));
+		if (memcmp(header.Magic, DefaultCheckpointHeader.Magic, sizeof(header.Magic)) != 0 || header.Version != DefaultCheckpointHeader.Version)
+		{
+			DXRAY_ERROR("Checkpoint {} has an unrecognized format.", a_filePath.string());
+			return false;
+		}
+
+		if (header.Width != m_dimensions.x || header.Height != m_dimensions.y)
+		{
+			DXRAY_ERROR("Checkpoint dimensions {}x{} do not match the render dimensions {}x{}.", header.Width, header.Height, m_dimensions.x, m_dimensions.y);
+			return false;
+		}
+
+		const RenderSignature signature = { .SceneHash = header.SceneHash, .PipelineHash = header.PipelineHash, .SamplesPerPass = header.SamplesPerPass };
+		if (signature != m_signature)
+		{
+			DXRAY_ERROR("Checkpoint {} was rendered from another {}.", a_filePath.string(),
+				signature.SceneHash != m_signature.SceneHash ? "scene" : signature.SamplesPerPass != m_signature.SamplesPerPass ? "sample count per pass" : "pipeline");
+			return false;
+		}
+
+		const usize radianceSizeInBytes = m_radianceSum.size() * sizeof(Color);
+		const usize channelSizeInBytes = m_sampleCounts.size() * sizeof(u32);
+		if (blob.size() != sizeof(CheckpointHeader) + radianceSizeInBytes + 4 * channelSizeInBytes)
+		{
+			DXRAY_ERROR("Checkpoint {} is truncated.", a_filePath.string());
+			return false;
+		}
+
+		const char* const pChannel = blob.data() + sizeof(CheckpointHeader) + radianceSizeInBytes;
+		memcpy(m_radianceSum.data(), blob.data() + sizeof(CheckpointHeader), radianceSizeInBytes);
+		memcpy(m_weightSum.data(), pChannel, channelSizeInBytes);
+		memcpy(m_sampleCounts.data(), pChannel + channelSizeInBytes, channelSizeInBytes);
+		memcpy(m_luminanceSum.data(), pChannel + 2 * channelSizeInBytes, channelSizeInBytes);
+		memcpy(m_luminanceSquaredSum.data(), pChannel + 3 * channelSizeInBytes, channelSizeInBytes);
+		m_completedPassCount = header.CompletedPassCount;
+		m_seed = header.Seed;
+		return true;
+	}
+}
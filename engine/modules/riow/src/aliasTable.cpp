@@ -0,0 +1,69 @@
+#include "riow/aliasTable.h"
+
+namespace dxray::riow
+{
+	AliasTable::AliasTable(const std::vector<fp32>& a_weights)
+	{
+		fp64 weightSum = 0.0;
+		for (const fp32 weight : a_weights)
+		{
+			DXRAY_ASSERT(weight >= 0.0f);
+			weightSum += weight;
+		}
+
+		if (weightSum <= 0.0)
+		{
+			return;
+		}
+
+		const u32 count = static_cast<u32>(a_weights.size());
+		m_slots.resize(count);
+		m_probabilities.resize(count);
+
+		//Entries are scaled so the mean weight is 1, slots of entries below the mean are topped up by the aliases of entries above it.
+		std::vector<fp64> scaledWeights(count);
+		std::vector<u32> smallEntries;
+		std::vector<u32> largeEntries;
+		for (u32 i = 0; i < count; ++i)
+		{
+			m_probabilities[i] = static_cast<fp32>(a_weights[i] / weightSum);
+			scaledWeights[i] = a_weights[i] * count / weightSum;
+			(scaledWeights[i] < 1.0 ? smallEntries : largeEntries).push_back(i);
+		}
+
+		while (!smallEntries.empty() && !largeEntries.empty())
+		{
+			const u32 small = smallEntries.back();
+			const u32 large = largeEntries.back();
+			smallEntries.pop_back();
+
+			m_slots[small].KeepProbability = static_cast<fp32>(scaledWeights[small]);
+			m_slots[small].Alias = large;
+			scaledWeights[large] -= 1.0 - scaledWeights[small];
+			if (scaledWeights[large] < 1.0)
+			{
+				largeEntries.pop_back();
+				smallEntries.push_back(large);
+			}
+		}
+
+		//What is left over is 1 up to rounding, those slots keep their entry.
+		for (const u32 i : smallEntries)
+		{
+			m_slots[i] = Slot{ 1.0f, i };
+		}
+
+		for (const u32 i : largeEntries)
+		{
+			m_slots[i] = Slot{ 1.0f, i };
+		}
+	}
+
+	u32 AliasTable::Sample(const fp32 a_slotRandom, const fp32 a_aliasRandom) const
+	{
+		DXRAY_ASSERT(!m_slots.empty());
+		const u32 slotIndex = vath::Min(static_cast<u32>(a_slotRandom * static_cast<fp32>(m_slots.size())), static_cast<u32>(m_slots.size() - 1));
+		const Slot& slot = m_slots[slotIndex];
+		return a_aliasRandom < slot.KeepProbability ? slotIndex : slot.Alias;
+	}
+}
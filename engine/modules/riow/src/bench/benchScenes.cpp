@@ -0,0 +1,124 @@
+#include "riowBench/benchScenes.h"
+#include "riow/traceable/sphere.h"
+#include "riow/material.h"
+#include "riow/texture.h"
+#include "riow/sampler.h"
+
+namespace dxray::riow::bench
+{
+	static constexpr fp32 FieldSpacing = 1.0f;
+	static constexpr fp32 MaxFieldSphereRadius = 0.45f;
+	static constexpr fp32 FieldShutterSpeed = 0.001f;
+
+	static fp32 GetFieldSide(const u32 a_sphereCount)
+	{
+		return std::ceil(std::sqrt(static_cast<fp32>(a_sphereCount))) * FieldSpacing;
+	}
+
+	//The ground sphere grows with the field, so the spheres at the edges still rest on it.
+	static fp32 GetGroundRadius(const u32 a_sphereCount)
+	{
+		return vath::Max(1000.0f, GetFieldSide(a_sphereCount) * 4.0f);
+	}
+
+	static fp32 GetGroundHeight(const fp32 a_groundRadius, const fp32 a_x, const fp32 a_z)
+	{
+		return std::sqrt(a_groundRadius * a_groundRadius - a_x * a_x - a_z * a_z) - a_groundRadius;
+	}
+
+	std::vector<SphereSet::Element> GenerateSphereField(const u32 a_sphereCount, const std::vector<MaterialId>& a_materials, const u64 a_seed)
+	{
+		DXRAY_ASSERT(!a_materials.empty());
+
+		Sampler sampler(HashSeed(a_seed), 0u);
+		const u32 cellsPerRow = static_cast<u32>(GetFieldSide(a_sphereCount) / FieldSpacing);
+		const fp32 halfSide = GetFieldSide(a_sphereCount) * 0.5f;
+		const fp32 groundRadius = GetGroundRadius(a_sphereCount);
+
+		//One sphere per field cell, jittered within the cell so neighbours never overlap.
+		std::vector<SphereSet::Element> spheres(a_sphereCount);
+		for (u32 si = 0; si < a_sphereCount; ++si)
+		{
+			SphereSet::Element& sphere = spheres[si];
+			sphere.Radius = sampler.NextFloat(0.2f, MaxFieldSphereRadius);
+
+			const fp32 jitter = FieldSpacing * 0.5f - sphere.Radius;
+			const fp32 x = (static_cast<fp32>(si % cellsPerRow) + 0.5f) * FieldSpacing - halfSide + sampler.NextFloat(-jitter, jitter);
+			const fp32 z = (static_cast<fp32>(si / cellsPerRow) + 0.5f) * FieldSpacing - halfSide + sampler.NextFloat(-jitter, jitter);
+			sphere.Center = vath::Vector3f(x, GetGroundHeight(groundRadius, x, z) + sphere.Radius, z);
+			sphere.Material = a_materials[sampler.NextU32() % a_materials.size()];
+		}
+
+		return spheres;
+	}
+
+	void SetupSphereFieldCamera(const u32 a_sphereCount, Camera& a_camera)
+	{
+		const fp32 halfSide = GetFieldSide(a_sphereCount) * 0.5f;
+		const vath::Vector3f cameraPosition(-halfSide - 2.0f, 3.0f, -halfSide - 2.0f);
+		a_camera.SetVerticalFov(vath::DegToRad(40.0f));
+		a_camera.SetAperture(0.0f);
+		a_camera.SetFocalLength(10.0f);
+		a_camera.SetShutterSpeed(FieldShutterSpeed);
+		a_camera.LookAt(cameraPosition, cameraPosition + vath::Vector3f(10.0f, -2.0f, 10.0f));
+	}
+
+	void BuildSphereFieldScene(const u32 a_sphereCount, Scene& a_scene)
+	{
+		//Materials, lambertian is weighted double as it is the most common material of real scenes.
+		MaterialTable& materials = a_scene.GetMaterials();
+		TextureTable& textures = a_scene.GetTextures();
+		const std::vector<MaterialId> fieldMaterials =
+		{
+			materials.Add(Lambertian(textures.AddSolidColor(Color(0.8f, 0.3f, 0.3f)))),
+			materials.Add(Lambertian(textures.AddSolidColor(Color(0.3f, 0.8f, 0.3f)))),
+			materials.Add(Lambertian(textures.AddSolidColor(Color(0.3f, 0.3f, 0.8f)))),
+			materials.Add(Lambertian(textures.AddSolidColor(Color(0.8f, 0.8f, 0.8f)))),
+			materials.Add(Metallic(Color(0.8f, 0.6f, 0.2f), 0.0f)),
+			materials.Add(Metallic(Color(0.7f), 0.3f)),
+			materials.Add(Dielectric(1.5f))
+		};
+
+		const TextureId checkerboardTex = textures.Add(CheckerBoard(0.32f, textures.AddSolidColor(Color(0.1f)), textures.AddSolidColor(Color(0.9f))));
+		const fp32 groundRadius = GetGroundRadius(a_sphereCount);
+		a_scene.AddTraceable(std::make_shared<Sphere>(vath::Vector3f(0.0f, -groundRadius, 0.0f), groundRadius, materials.Add(Lambertian(checkerboardTex))));
+		a_scene.AddTraceable(std::make_shared<SphereSet>(GenerateSphereField(a_sphereCount, fieldMaterials, a_sphereCount), 0.0f, FieldShutterSpeed));
+	}
+
+	const Scene& GetSphereFieldScene(const u32 a_sphereCount)
+	{
+		static std::unique_ptr<Scene> pCachedScene;
+		static u32 cachedSphereCount = 0;
+
+		if (pCachedScene == nullptr || cachedSphereCount != a_sphereCount)
+		{
+			//Release the previous scene first, two of the largest scenes do not have to fit in memory at once.
+			pCachedScene.reset();
+			pCachedScene = std::make_unique<Scene>();
+			BuildSphereFieldScene(a_sphereCount, *pCachedScene);
+			pCachedScene->BuildAccelerationStructure(0.0f, FieldShutterSpeed);
+			cachedSphereCount = a_sphereCount;
+		}
+
+		return *pCachedScene;
+	}
+
+	std::vector<Ray> GenerateSphereFieldRays(const u32 a_sphereCount, const u32 a_rayCount, const u64 a_seed)
+	{
+		Sampler sampler(HashSeed(a_seed), 0u);
+		const fp32 halfSide = GetFieldSide(a_sphereCount) * 0.5f;
+		const fp32 groundRadius = GetGroundRadius(a_sphereCount);
+
+		std::vector<Ray> rays(a_rayCount);
+		for (Ray& ray : rays)
+		{
+			const fp32 x = sampler.NextFloat(-halfSide, halfSide);
+			const fp32 z = sampler.NextFloat(-halfSide, halfSide);
+			const vath::Vector3f origin(x, GetGroundHeight(groundRadius, x, z) + 5.0f, z);
+			const vath::Vector3f target(x + sampler.NextFloat(-8.0f, 8.0f), GetGroundHeight(groundRadius, x, z), z + sampler.NextFloat(-8.0f, 8.0f));
+			ray = Ray(origin, target - origin, sampler.NextFloat() * FieldShutterSpeed);
+		}
+
+		return rays;
+	}
+}
@@ -0,0 +1,315 @@
+#include "riowBench/benchScenes.h"
+#include "riow/traceable/sphere.h"
+#include "riow/material.h"
+#include "riow/texture.h"
+#include "riow/light.h"
+#include "riow/sampler.h"
+
+//Microbenchmarks of the kernels a path is made of. Every benchmark iteration processes a single element, so the reported rates
+//translate directly into the cost of one call. Inputs are generated up front and cycled through, the loops measure the kernel only.
+namespace dxray::riow::bench
+{
+	static constexpr u32 InputCount = 4096;
+	static constexpr u32 InputMask = InputCount - 1;
+	static constexpr u64 InputSeed = 0xbe7c4;
+
+	/// <summary>
+	/// Rays aimed at a unit sphere at the origin from all directions, about half of them miss it.
+	/// </summary>
+	static std::vector<Ray> GenerateUnitSphereRays(Sampler& a_sampler)
+	{
+		std::vector<Ray> rays(InputCount);
+		for (Ray& ray : rays)
+		{
+			const vath::Vector3f origin = vath::Normalize(Random3dUnitDirection()) * 5.0f;
+			const vath::Vector3f target(a_sampler.NextFloat(-1.4f, 1.4f), a_sampler.NextFloat(-1.4f, 1.4f), a_sampler.NextFloat(-1.4f, 1.4f));
+			ray = Ray(origin, target - origin);
+		}
+
+		return rays;
+	}
+
+	/// <summary>
+	/// Hits on a unit sphere at the origin together with the rays that caused them.
+	/// </summary>
+	static void GenerateUnitSphereHits(std::vector<Ray>& a_rays, std::vector<IntersectionInfo>& a_hits)
+	{
+		Sampler sampler(HashSeed(InputSeed), 0u);
+		GetThreadSampler().Seed(HashSeed(InputSeed), 1u);
+
+		while (a_hits.size() < InputCount)
+		{
+			for (const Ray& ray : GenerateUnitSphereRays(sampler))
+			{
+				fp32 t = 0.0f;
+				if (a_hits.size() < InputCount && Sphere::IntersectRay(vath::Vector3f(0.0f), 1.0f, ray, 0.001f, fp32max, t))
+				{
+					IntersectionInfo& hit = a_hits.emplace_back();
+					Sphere::SetIntersectionInfo(vath::Vector3f(0.0f), 1.0f, vath::Vector3f(0.0f), InvalidResourceId, ray, t, hit);
+					a_rays.push_back(ray);
+				}
+			}
+		}
+	}
+
+	static void SetRateCounter(benchmark::State& a_state, const char* a_pName, const fp64 a_count)
+	{
+		a_state.counters[a_pName] = benchmark::Counter(a_count, benchmark::Counter::kIsRate);
+	}
+
+
+	//--- Intersection ---
+
+	static void BM_RaySphereIntersect(benchmark::State& a_state)
+	{
+		Sampler sampler(HashSeed(InputSeed), 0u);
+		GetThreadSampler().Seed(HashSeed(InputSeed), 1u);
+		const std::vector<Ray> rays = GenerateUnitSphereRays(sampler);
+
+		u32 ri = 0;
+		for (auto _ : a_state)
+		{
+			fp32 t = 0.0f;
+			bool bHit = Sphere::IntersectRay(vath::Vector3f(0.0f), 1.0f, rays[ri++ & InputMask], 0.001f, fp32max, t);
+			benchmark::DoNotOptimize(bHit);
+			benchmark::DoNotOptimize(t);
+		}
+
+		SetRateCounter(a_state, "rays", static_cast<fp64>(a_state.iterations()));
+	}
+	BENCHMARK(BM_RaySphereIntersect);
+
+	static void BM_RaySphereIntersectInfo(benchmark::State& a_state)
+	{
+		const Sphere sphere(vath::Vector3f(0.0f), 1.0f);
+		Sampler sampler(HashSeed(InputSeed), 0u);
+		GetThreadSampler().Seed(HashSeed(InputSeed), 1u);
+		const std::vector<Ray> rays = GenerateUnitSphereRays(sampler);
+
+		u32 ri = 0;
+		for (auto _ : a_state)
+		{
+			IntersectionInfo hit;
+			bool bHit = sphere.DoesIntersect(rays[ri++ & InputMask], 0.001f, fp32max, hit);
+			benchmark::DoNotOptimize(bHit);
+			benchmark::DoNotOptimize(hit);
+		}
+
+		SetRateCounter(a_state, "rays", static_cast<fp64>(a_state.iterations()));
+	}
+	BENCHMARK(BM_RaySphereIntersectInfo);
+
+
+	//--- Materials ---
+
+	enum class EBenchMaterial : u8
+	{
+		Lambertian = 0,
+		Metallic,
+		Dielectric,
+		Isotropic
+	};
+
+	static void BM_MaterialScatter(benchmark::State& a_state, const EBenchMaterial a_material)
+	{
+		TextureTable textures;
+		MaterialTable materials;
+		const TextureId albedo = textures.AddSolidColor(Color(0.5f));
+
+		MaterialId materialId = InvalidResourceId;
+		switch (a_material)
+		{
+		case EBenchMaterial::Lambertian:	materialId = materials.Add(Lambertian(albedo)); break;
+		case EBenchMaterial::Metallic:		materialId = materials.Add(Metallic(Color(0.5f), 0.3f)); break;
+		case EBenchMaterial::Dielectric:	materialId = materials.Add(Dielectric(1.5f)); break;
+		case EBenchMaterial::Isotropic:		materialId = materials.Add(Isotropic(albedo)); break;
+		}
+
+		std::vector<Ray> rays;
+		std::vector<IntersectionInfo> hits;
+		GenerateUnitSphereHits(rays, hits);
+
+		u32 hi = 0;
+		for (auto _ : a_state)
+		{
+			const u32 inputIndex = hi++ & InputMask;
+			Color attenuation;
+			Ray scattered;
+			bool bScattered = materials.Scatter(materialId, rays[inputIndex], hits[inputIndex], textures, attenuation, scattered);
+			benchmark::DoNotOptimize(bScattered);
+			benchmark::DoNotOptimize(attenuation);
+			benchmark::DoNotOptimize(scattered);
+		}
+
+		SetRateCounter(a_state, "scatters", static_cast<fp64>(a_state.iterations()));
+	}
+	BENCHMARK_CAPTURE(BM_MaterialScatter, lambertian, EBenchMaterial::Lambertian);
+	BENCHMARK_CAPTURE(BM_MaterialScatter, metallic, EBenchMaterial::Metallic);
+	BENCHMARK_CAPTURE(BM_MaterialScatter, dielectric, EBenchMaterial::Dielectric);
+	BENCHMARK_CAPTURE(BM_MaterialScatter, isotropic, EBenchMaterial::Isotropic);
+
+
+	//--- Textures ---
+
+	enum class EBenchTexture : u8
+	{
+		SolidColor = 0,
+		CheckerBoard,
+		Noise,
+		BakedNoise,
+		Mip
+	};
+
+	static void BM_TextureSample(benchmark::State& a_state, const EBenchTexture a_texture)
+	{
+		TextureTable textures;
+		TextureId textureId = InvalidResourceId;
+		switch (a_texture)
+		{
+		case EBenchTexture::SolidColor:
+		{
+			textureId = textures.AddSolidColor(Color(0.5f));
+			break;
+		}
+		case EBenchTexture::CheckerBoard:
+		{
+			textureId = textures.Add(CheckerBoard(0.32f, textures.AddSolidColor(Color(0.1f)), textures.AddSolidColor(Color(0.9f))));
+			break;
+		}
+		case EBenchTexture::Noise:
+		case EBenchTexture::BakedNoise:
+		{
+			NoiseTexture noise(4.0f);
+			if (a_texture == EBenchTexture::BakedNoise)
+			{
+				noise.Bake(BoundingBox{ vath::Vector3f(-1.0f), vath::Vector3f(1.0f) }, 64);
+			}
+
+			textureId = textures.Add(std::move(noise));
+			break;
+		}
+		case EBenchTexture::Mip:
+		{
+			//A procedural gradient, the content does not matter for the sampling cost.
+			const vath::Vector2u32 dimensions(1024, 1024);
+			std::vector<Color> texels(static_cast<usize>(dimensions.x) * dimensions.y);
+			for (usize ti = 0; ti < texels.size(); ++ti)
+			{
+				texels[ti] = Color(static_cast<fp32>(ti % dimensions.x) / dimensions.x, static_cast<fp32>(ti / dimensions.x) / dimensions.y, 0.5f);
+			}
+
+			textureId = textures.Add(MipTexture(dimensions, texels));
+			break;
+		}
+		}
+
+		//Points inside the baked region and footprints from texel size up to a tenth of the texture.
+		Sampler sampler(HashSeed(InputSeed), 0u);
+		std::vector<vath::Vector3f> points(InputCount);
+		std::vector<vath::Vector2f> uvCoords(InputCount);
+		std::vector<fp32> footprints(InputCount);
+		for (u32 ii = 0; ii < InputCount; ++ii)
+		{
+			points[ii] = vath::Vector3f(sampler.NextFloat(-1.0f, 1.0f), sampler.NextFloat(-1.0f, 1.0f), sampler.NextFloat(-1.0f, 1.0f));
+			uvCoords[ii] = vath::Vector2f(sampler.NextFloat(), sampler.NextFloat());
+			footprints[ii] = sampler.NextFloat(0.001f, 0.1f);
+		}
+
+		u32 ii = 0;
+		for (auto _ : a_state)
+		{
+			const u32 inputIndex = ii++ & InputMask;
+			Color color = textures.Sample(textureId, uvCoords[inputIndex], points[inputIndex], footprints[inputIndex]);
+			benchmark::DoNotOptimize(color);
+		}
+
+		SetRateCounter(a_state, "samples", static_cast<fp64>(a_state.iterations()));
+	}
+	BENCHMARK_CAPTURE(BM_TextureSample, solidColor, EBenchTexture::SolidColor);
+	BENCHMARK_CAPTURE(BM_TextureSample, checkerBoard, EBenchTexture::CheckerBoard);
+	BENCHMARK_CAPTURE(BM_TextureSample, noise, EBenchTexture::Noise);
+	BENCHMARK_CAPTURE(BM_TextureSample, bakedNoise, EBenchTexture::BakedNoise);
+	BENCHMARK_CAPTURE(BM_TextureSample, mip, EBenchTexture::Mip);
+
+
+	//--- Light sampling ---
+
+	static void BM_LightSample(benchmark::State& a_state)
+	{
+		//Emissive spheres of the sphere field, sampled from points just above random spheres of it.
+		const u32 lightCount = static_cast<u32>(a_state.range(0));
+		TextureTable textures;
+		MaterialTable materials;
+		const MaterialId emissive = materials.Add(DiffuseLight(textures.AddSolidColor(Color(1.0f)), 4.0f));
+		const std::vector<SphereSet::Element> spheres = GenerateSphereField(lightCount, { emissive }, InputSeed);
+
+		LightList lights;
+		for (u32 si = 0; si < spheres.size(); ++si)
+		{
+			const SphereSet::Element& sphere = spheres[si];
+			lights.Add(SphereLight{ .Center = sphere.Center, .Radius = sphere.Radius, .Velocity = sphere.Velocity, .Material = sphere.Material }, 0, si);
+		}
+		lights.Build(materials, textures, nullptr, 0.0f, 0.0f);
+
+		Sampler sampler(HashSeed(InputSeed), 0u);
+		GetThreadSampler().Seed(HashSeed(InputSeed), 1u);
+		std::vector<vath::Vector3f> points(InputCount);
+		for (vath::Vector3f& point : points)
+		{
+			const SphereSet::Element& sphere = spheres[static_cast<usize>(sampler.NextFloat() * static_cast<fp32>(spheres.size() - 1))];
+			point = sphere.Center + vath::Vector3f(0.0f, 1.0f, 0.0f);
+		}
+
+		u32 pi = 0;
+		for (auto _ : a_state)
+		{
+			LightSample sample;
+			bool bSampled = lights.Sample(points[pi++ & InputMask], 0.0f, materials, textures, sample);
+			benchmark::DoNotOptimize(bSampled);
+			benchmark::DoNotOptimize(sample);
+		}
+
+		SetRateCounter(a_state, "samples", static_cast<fp64>(a_state.iterations()));
+	}
+	BENCHMARK(BM_LightSample)->ArgName("lights")->RangeMultiplier(16)->Range(16, 1 << 20);
+
+
+	//--- Random numbers ---
+
+	static void BM_SamplerNextFloat(benchmark::State& a_state)
+	{
+		Sampler sampler(HashSeed(InputSeed), 0u);
+		for (auto _ : a_state)
+		{
+			benchmark::DoNotOptimize(sampler.NextFloat());
+		}
+
+		SetRateCounter(a_state, "numbers", static_cast<fp64>(a_state.iterations()));
+	}
+	BENCHMARK(BM_SamplerNextFloat);
+
+	//The thread local sampler is what the renderer draws from, this measures the cost of the thread local lookup on top of the generator.
+	static void BM_ThreadSamplerRandomFloat(benchmark::State& a_state)
+	{
+		GetThreadSampler().Seed(HashSeed(InputSeed), 0u);
+		for (auto _ : a_state)
+		{
+			benchmark::DoNotOptimize(RandomFloat());
+		}
+
+		SetRateCounter(a_state, "numbers", static_cast<fp64>(a_state.iterations()));
+	}
+	BENCHMARK(BM_ThreadSamplerRandomFloat);
+
+	static void BM_Random3dUnitDirection(benchmark::State& a_state)
+	{
+		GetThreadSampler().Seed(HashSeed(InputSeed), 0u);
+		for (auto _ : a_state)
+		{
+			benchmark::DoNotOptimize(Random3dUnitDirection());
+		}
+
+		SetRateCounter(a_state, "directions", static_cast<fp64>(a_state.iterations()));
+	}
+	BENCHMARK(BM_Random3dUnitDirection);
+}
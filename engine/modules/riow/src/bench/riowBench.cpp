@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+
+using namespace dxray;
+
+/// <summary>
+/// Runs the riow benchmarks. Next to the console output the results are always written as JSON, by default to bin/<config>/riowBench.json,
+/// so runs of different revisions can be compared with the compare.py tool of Google Benchmark. Passing --benchmark_out overrides the file.
+/// </summary>
+int main(int argc, char** argv)
+{
+	std::vector<char*> arguments(argv, argv + argc);
+	const bool bHasOutputFile = std::any_of(arguments.begin(), arguments.end(), [](const char* a_pArgument)
+	{
+		return StringView(a_pArgument).starts_with("--benchmark_out=");
+	});
+
+	const Path outputFilePath = std::filesystem::path("bin") / CMAKE_INTDIR / "riowBench.json";
+	String outputArgument = "--benchmark_out=" + outputFilePath.string();
+	String formatArgument = "--benchmark_out_format=json";
+	if (!bHasOutputFile)
+	{
+		//Google Benchmark doesn't create the directory, it refuses to run any benchmark when it can't open the file.
+		std::filesystem::create_directories(outputFilePath.parent_path());
+		arguments.push_back(outputArgument.data());
+		arguments.push_back(formatArgument.data());
+	}
+
+	i32 argumentCount = static_cast<i32>(arguments.size());
+	benchmark::Initialize(&argumentCount, arguments.data());
+	if (benchmark::ReportUnrecognizedArguments(argumentCount, arguments.data()))
+	{
+		return 1;
+	}
+
+	benchmark::AddCustomContext("hardware_threads", std::to_string(std::thread::hardware_concurrency()));
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
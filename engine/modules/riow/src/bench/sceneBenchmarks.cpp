@@ -0,0 +1,114 @@
+#include "riowBench/benchScenes.h"
+#include "riow/renderer.h"
+#include "riow/sampler.h"
+
+//Benchmarks on the procedurally scaled sphere field, from a thousand up to ten million spheres.
+//#Note: The build benchmark is registered before the intersection benchmark so the cached scenes of the latter are not alive while building.
+namespace dxray::riow::bench
+{
+	static constexpr u64 FieldSeed = 0xf1e1d;
+	static constexpr u32 FieldRayCount = 1u << 16;
+
+	static void ApplySphereCounts(benchmark::internal::Benchmark* a_pBenchmark)
+	{
+		a_pBenchmark->ArgName("spheres")->RangeMultiplier(10)->Range(1'000, 10'000'000);
+	}
+
+	static void BM_SphereSetBuild(benchmark::State& a_state)
+	{
+		const u32 sphereCount = static_cast<u32>(a_state.range(0));
+		const std::vector<SphereSet::Element> spheres = GenerateSphereField(sphereCount, { InvalidResourceId }, FieldSeed);
+
+		for (auto _ : a_state)
+		{
+			SphereSet sphereSet(spheres, 0.0f, 0.001f);
+			const BoundingVolumeHierarchy::Node* pNodes = sphereSet.GetHierarchy().GetNodes().data();
+			benchmark::DoNotOptimize(pNodes);
+		}
+
+		a_state.counters["spheresBuilt"] = benchmark::Counter(static_cast<fp64>(a_state.iterations()) * sphereCount, benchmark::Counter::kIsRate);
+	}
+	BENCHMARK(BM_SphereSetBuild)->Apply(ApplySphereCounts)->Unit(benchmark::kMillisecond);
+
+	static void BM_SceneIntersect(benchmark::State& a_state)
+	{
+		const u32 sphereCount = static_cast<u32>(a_state.range(0));
+		const Scene& scene = GetSphereFieldScene(sphereCount);
+		const std::vector<Ray> rays = GenerateSphereFieldRays(sphereCount, FieldRayCount, FieldSeed);
+
+		u32 ri = 0;
+		u64 hitCount = 0;
+		for (auto _ : a_state)
+		{
+			IntersectionInfo hit;
+			hitCount += scene.DoesIntersect(rays[ri++ & (FieldRayCount - 1)], 0.001f, fp32max, hit) ? 1 : 0;
+			benchmark::DoNotOptimize(hit);
+		}
+
+		a_state.counters["rays"] = benchmark::Counter(static_cast<fp64>(a_state.iterations()), benchmark::Counter::kIsRate);
+		a_state.counters["hitRatio"] = static_cast<fp64>(hitCount) / vath::Max<fp64>(static_cast<fp64>(a_state.iterations()), 1.0);
+	}
+	BENCHMARK(BM_SceneIntersect)->Apply(ApplySphereCounts);
+
+	/// <summary>
+	/// Worker counts of the thread scaling curve, powers of two up to the hardware thread count, which is always included.
+	/// </summary>
+	static void ApplyRenderArguments(benchmark::internal::Benchmark* a_pBenchmark)
+	{
+		const i64 hardwareThreadCount = vath::Max<i64>(std::thread::hardware_concurrency(), 1);
+		a_pBenchmark->ArgNames({ "spheres", "workers" });
+		for (const i64 sphereCount : { 1'000, 1'000'000 })
+		{
+			for (i64 workerCount = 1; workerCount < hardwareThreadCount; workerCount *= 2)
+			{
+				a_pBenchmark->Args({ sphereCount, workerCount });
+			}
+
+			a_pBenchmark->Args({ sphereCount, hardwareThreadCount });
+		}
+	}
+
+	/// <summary>
+	/// Renders full frames of the sphere field, a single pass of four samples per pixel at a small resolution.
+	/// Wall clock time is measured, the render runs on the workers of the renderer rather than the benchmark thread.
+	/// </summary>
+	static void BM_RenderFrame(benchmark::State& a_state)
+	{
+		const u32 sphereCount = static_cast<u32>(a_state.range(0));
+		const u32 workerCount = static_cast<u32>(a_state.range(1));
+		const Scene& scene = GetSphereFieldScene(sphereCount);
+
+		Camera camera;
+		camera.SetViewportDimensionInPx(vath::Vector2u32(320, 176));
+		SetupSphereFieldCamera(sphereCount, camera);
+
+		RendererPipeline pipeline;
+		pipeline.MaxTraceDepth = 8;
+		pipeline.SuperSampleFactor = 2;
+		pipeline.DepthOfFieldSampleCount = 1;
+		pipeline.ClusterSize = 16;
+		pipeline.PassCount = 1;
+
+		const u32 hardwareThreadCount = vath::Max(std::thread::hardware_concurrency(), 1u);
+		Renderer renderer(static_cast<u16>(hardwareThreadCount > workerCount ? hardwareThreadCount - workerCount : 0));
+		renderer.SetCamera(camera);
+		renderer.SetBackgroundColor(Color(0.7f, 0.8f, 1.0f));
+		renderer.SetRenderPipeline(pipeline);
+
+		u64 tracedRayCount = 0;
+		for (auto _ : a_state)
+		{
+			AccumulationBuffer accumulationBuffer(camera.GetViewportDimensionsInPx(), FieldSeed);
+			renderer.Render(scene, accumulationBuffer);
+			tracedRayCount += renderer.GetTracedRayCount();
+		}
+
+		const vath::Vector2u32 viewportDims = camera.GetViewportDimensionsInPx();
+		const fp64 samplesPerFrame = static_cast<fp64>(viewportDims.x) * viewportDims.y * pipeline.GetSamplesPerPass();
+		a_state.counters["rays"] = benchmark::Counter(static_cast<fp64>(tracedRayCount), benchmark::Counter::kIsRate);
+		a_state.counters["samples"] = benchmark::Counter(samplesPerFrame * a_state.iterations(), benchmark::Counter::kIsRate);
+		a_state.counters["raysPerSample"] = static_cast<fp64>(tracedRayCount) / (samplesPerFrame * vath::Max<fp64>(static_cast<fp64>(a_state.iterations()), 1.0));
+		a_state.counters["workerCount"] = renderer.GetTaskScheduler().GetWorkerCount();
+	}
+	BENCHMARK(BM_RenderFrame)->Apply(ApplyRenderArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+}
@@ -0,0 +1,171 @@
+#include "riow/builtinScenes.h"
+#include "riow/traceable/sphere.h"
+#include "riow/traceable/mediumVolume.h"
+#include "riow/perlin.h"
+#include "riow/material.h"
+#include "riow/texture.h"
+#include "riow/mipTexture.h"
+#include "riow/image.h"
+#include "riow/sampler.h"
+
+namespace dxray::riow
+{
+	void BuildBouncingSpheresSceneComposition(Camera& a_camera, Scene& a_scene)
+	{
+		//Camera.
+		a_camera.SetVerticalFov(vath::DegToRad(20.0f));
+		a_camera.SetAperture(0.35f);
+		a_camera.SetFocalLength(10.0f);
+		a_camera.SetShutterSpeed(0.001f);
+		a_camera.LookAt(vath::Vector3f(13.0f, 2.0f, 3.0f), vath::Vector3f(0.0f, 0.0f, 0.0f));
+
+		//Scene.
+		riow::MaterialTable& materials = a_scene.GetMaterials();
+		riow::TextureTable& textures = a_scene.GetTextures();
+
+		const riow::TextureId checkerboardTex = textures.Add(riow::CheckerBoard(0.32f, textures.AddSolidColor(riow::Color(0.1f)), textures.AddSolidColor(riow::Color(0.9f))));
+		const riow::MaterialId groundMat = materials.Add(riow::Lambertian(checkerboardTex));
+		a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(0.0f, -1000.0f, 0.0f), 1000.0f, groundMat));
+	    const riow::TextureId moonTexture = textures.Add(riow::MipTexture::LoadFromFile(riow::AssetRootDirectory / "textures/diffuseMoon.jpg", riow::Image::ELoadOptions::FlipVertically));
+
+		for (i32 i = -11; i < 11; i++)
+		{
+			for (i32 j = -11; j < 11; j++)
+			{
+				const fp32 randomMat = riow::RandomFloat();
+				const vath::Vector3f center(i + 0.9f * riow::RandomFloat(), 0.2f, j + 0.9f * riow::RandomFloat());
+
+				if (vath::Magnitude(center - vath::Vector3f(4.0f, 0.2f, 0.0f)) > 0.9f)
+				{
+					riow::MaterialId sphereMat;
+	                const vath::Vector3f translation = center + vath::Vector3f(0.0f, riow::RandomFloat(0.0f, 1.0f), 0.0f);
+
+					if (randomMat < 0.25f)
+					{
+						//5% chance on moon
+	                    if (randomMat < 0.05f)
+	                    {
+	                        //Emissive moon lights.
+	                        sphereMat = materials.Add(riow::DiffuseLight(moonTexture, 1.0f));
+	                        a_scene.AddTraceable(std::make_shared<riow::Sphere>(center, translation, 0.2f, sphereMat));
+							continue;
+	                    }
+
+						//20% - Emissive - emitting light.
+	                    const riow::Color albedo(riow::RandomFloat(), riow::RandomFloat(), riow::RandomFloat());
+	                    sphereMat = materials.Add(riow::DiffuseLight(textures.AddSolidColor(albedo), riow::RandomFloat(0.5f, 1.0f)));
+	                    a_scene.AddTraceable(std::make_shared<riow::Sphere>(center, translation, 0.2f, sphereMat));
+						continue;
+					}
+					else if (randomMat < 0.8f)
+					{
+	                    //55% - Lambertian.
+						sphereMat = materials.Add(riow::Lambertian(textures.AddSolidColor(riow::Color(riow::RandomFloat(), riow::RandomFloat(), riow::RandomFloat()))));
+	                    a_scene.AddTraceable(std::make_shared<riow::Sphere>(center, translation, 0.2f, sphereMat));
+						continue;
+					}
+					else if (randomMat < 0.95f)
+					{
+						//15% - Metallic.
+						const riow::Color metallic(riow::RandomFloat(), riow::RandomFloat(), riow::RandomFloat());
+						const fp32 fuzzy = riow::RandomFloat();
+						sphereMat = materials.Add(riow::Metallic(metallic, fuzzy));
+	                    a_scene.AddTraceable(std::make_shared<riow::Sphere>(center, 0.2f, sphereMat));
+						continue;
+					}
+
+					//5% - Dielectric.
+					sphereMat = materials.Add(riow::Dielectric(1.5f));
+	                a_scene.AddTraceable(std::make_shared<riow::Sphere>(center, 0.2f, sphereMat));
+				}
+			}
+		}
+
+		const riow::MaterialId largeDielectric = materials.Add(riow::Dielectric(1.5f));
+		a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(0, 1, 0), 1.0f, largeDielectric));
+
+		const riow::MaterialId largeLambert = materials.Add(riow::DiffuseLight(textures.AddSolidColor(riow::Color(0.4f, 0.2f, 0.1f))));
+		a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(-4, 1, 0), 1.0f, largeLambert));
+
+		const riow::MaterialId largeMetal = materials.Add(riow::Metallic(riow::Color(0.4f, 0.2f, 0.1f), 0.0f));
+		a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(4, 1, 0), 1.0f, largeMetal));
+	}
+
+	void BuildPerlinSphereSceneComposition(Camera& a_camera, Scene& a_scene, const u32 a_noiseBakeResolution)
+	{
+	    //Camera.
+	    a_camera.SetVerticalFov(vath::DegToRad(20.0f));
+	    a_camera.SetAperture(0.001f);
+	    a_camera.SetFocalLength(10.0f);
+	    a_camera.SetShutterSpeed(0.001f);
+	    a_camera.LookAt(vath::Vector3f(12.0f, 2.0f, 3.0f), vath::Vector3f(0.0f, 0.0f, 0.0f));
+
+		//Scene.
+		riow::NoiseTexture noise(4.0f);
+		if (a_noiseBakeResolution > 0)
+		{
+			//Covers the small sphere and the part of the ground in view, the horizon falls back to evaluating the noise.
+			noise.Bake(riow::BoundingBox{ vath::Vector3f(-8.0f, -0.1f, -8.0f), vath::Vector3f(8.0f, 4.1f, 8.0f) }, a_noiseBakeResolution);
+		}
+
+		const riow::TextureId noiseTex = a_scene.GetTextures().Add(std::move(noise));
+		const riow::MaterialId lambertian = a_scene.GetMaterials().Add(riow::Lambertian(noiseTex));
+		a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(0.0f, -1000.0f, 0.0f), 1000.0f, lambertian));
+		a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(0.0f, 2.0f, 0.0f), 2.0f, lambertian));
+	}
+
+	void BuildVolumeSceneComposition(Camera& a_camera, Scene& a_scene)
+	{
+		//Camera.
+		a_camera.SetVerticalFov(vath::DegToRad(25.0f));
+		a_camera.SetAperture(0.001f);
+		a_camera.SetFocalLength(10.0f);
+		a_camera.SetShutterSpeed(0.001f);
+		a_camera.LookAt(vath::Vector3f(13.0f, 3.0f, 6.0f), vath::Vector3f(0.0f, 1.0f, 0.0f));
+
+		//Scene.
+		riow::MaterialTable& materials = a_scene.GetMaterials();
+		riow::TextureTable& textures = a_scene.GetTextures();
+
+		const riow::TextureId checkerboardTex = textures.Add(riow::CheckerBoard(0.32f, textures.AddSolidColor(riow::Color(0.1f)), textures.AddSolidColor(riow::Color(0.9f))));
+		a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(0.0f, -1000.0f, 0.0f), 1000.0f, materials.Add(riow::Lambertian(checkerboardTex))));
+		a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(0.0f, 8.0f, 0.0f), 2.0f, materials.Add(riow::DiffuseLight(textures.AddSolidColor(riow::Color(1.0f)), 6.0f))));
+
+		//Thin fog with a solid sphere inside of it.
+		const vath::Vector3f fogCenter(0.0f, 1.5f, 2.2f);
+		a_scene.AddTraceable(std::make_shared<riow::Sphere>(fogCenter, 0.5f, materials.Add(riow::Lambertian(textures.AddSolidColor(riow::Color(0.8f, 0.2f, 0.1f))))));
+		a_scene.AddMedium(std::make_shared<riow::MediumVolume>(
+			std::make_shared<riow::Sphere>(fogCenter, 1.5f),
+			riow::MediumDensity::Constant(0.6f),
+			materials.Add(riow::Isotropic(textures.AddSolidColor(riow::Color(0.9f))))
+		));
+
+		//Smoke, turbulence baked into a density grid that falls off towards the boundary of the sphere.
+		const vath::Vector3f smokeCenter(0.0f, 1.5f, -2.2f);
+		const fp32 smokeRadius = 1.5f;
+		constexpr u32 smokeResolution = 64;
+		const riow::BoundingBox smokeBounds{ smokeCenter - vath::Vector3f(smokeRadius), smokeCenter + vath::Vector3f(smokeRadius) };
+		const std::unique_ptr<Perlin> pPerlin = std::make_unique<Perlin>();
+		std::vector<fp32> smokeDensities(static_cast<usize>(smokeResolution) * smokeResolution * smokeResolution);
+		for (u32 z = 0; z < smokeResolution; ++z)
+		{
+			for (u32 y = 0; y < smokeResolution; ++y)
+			{
+				for (u32 x = 0; x < smokeResolution; ++x)
+				{
+					const vath::Vector3f voxelCenter = (vath::Vector3f(static_cast<fp32>(x), static_cast<fp32>(y), static_cast<fp32>(z)) + vath::Vector3f(0.5f)) / static_cast<fp32>(smokeResolution);
+					const vath::Vector3f point = smokeBounds.Min + voxelCenter * (2.0f * smokeRadius);
+					const fp32 falloff = vath::Max(1.0f - vath::Magnitude(point - smokeCenter) / smokeRadius, 0.0f);
+					const fp32 turbulence = pPerlin->Turbulence(point * 2.0f, 7);
+					smokeDensities[x + smokeResolution * (y + static_cast<usize>(smokeResolution) * z)] = vath::Max(turbulence - 0.15f, 0.0f) * falloff;
+				}
+			}
+		}
+
+		a_scene.AddMedium(std::make_shared<riow::MediumVolume>(
+			std::make_shared<riow::Sphere>(smokeCenter, smokeRadius),
+			riow::MediumDensity::Grid(smokeBounds, vath::Vector3u32(smokeResolution), std::move(smokeDensities), 40.0f),
+			materials.Add(riow::Isotropic(textures.AddSolidColor(riow::Color(0.7f))))
+		));
+	}
+}
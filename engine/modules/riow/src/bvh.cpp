@@ -0,0 +1,208 @@
+#include "riow/bvh.h"
+
+namespace dxray::riow
+{
+	static constexpr u32 MaxLeafSize = 2;
+	static constexpr u32 SplitBinCount = 12;
+
+	void BoundingVolumeHierarchy::Build(const std::vector<std::shared_ptr<RayTraceable>>& a_traceables, const fp32 a_timeStart, const fp32 a_timeEnd)
+	{
+		std::vector<BoundingBox> bounds(a_traceables.size());
+		for (usize ti = 0; ti < a_traceables.size(); ++ti)
+		{
+			bounds[ti] = a_traceables[ti]->GetBounds(a_timeStart, a_timeEnd);
+		}
+
+		std::vector<u32> traceableOrder;
+		Build(bounds, traceableOrder);
+
+		m_traceables.resize(traceableOrder.size());
+		for (usize ti = 0; ti < traceableOrder.size(); ++ti)
+		{
+			m_traceables[ti] = a_traceables[traceableOrder[ti]].get();
+		}
+		m_traceableIndices = std::move(traceableOrder);
+	}
+
+	void BoundingVolumeHierarchy::Build(const std::vector<BoundingBox>& a_primitiveBounds, std::vector<u32>& a_primitiveOrder)
+	{
+		Clear();
+		a_primitiveOrder.clear();
+		if (a_primitiveBounds.empty())
+		{
+			return;
+		}
+
+		std::vector<BuildItem> items(a_primitiveBounds.size());
+		for (usize pi = 0; pi < a_primitiveBounds.size(); ++pi)
+		{
+			items[pi].Bounds = a_primitiveBounds[pi];
+			items[pi].Center = items[pi].Bounds.GetCenter();
+			items[pi].PrimitiveIndex = static_cast<u32>(pi);
+		}
+
+		m_nodes.reserve(2 * items.size());
+		BuildRecursive(items, 0, static_cast<u32>(items.size()), 0);
+
+		//Items are partitioned in place, leaves refer to their range of the items.
+		a_primitiveOrder.resize(items.size());
+		for (usize pi = 0; pi < items.size(); ++pi)
+		{
+			a_primitiveOrder[pi] = items[pi].PrimitiveIndex;
+		}
+	}
+
+	void BoundingVolumeHierarchy::SetNodes(const Node* a_pNodes, const usize a_nodeCount)
+	{
+		Clear();
+		m_nodes.assign(a_pNodes, a_pNodes + a_nodeCount);
+	}
+
+	void BoundingVolumeHierarchy::Clear()
+	{
+		m_nodes.clear();
+		m_traceables.clear();
+		m_traceableIndices.clear();
+	}
+
+	u32 BoundingVolumeHierarchy::BuildRecursive(std::vector<BuildItem>& a_items, const u32 a_begin, const u32 a_end, const u32 a_depth)
+	{
+		const u32 nodeIndex = static_cast<u32>(m_nodes.size());
+		m_nodes.emplace_back();
+
+		BoundingBox bounds;
+		BoundingBox centerBounds;
+		for (u32 i = a_begin; i < a_end; ++i)
+		{
+			bounds.Expand(a_items[i].Bounds);
+			centerBounds.Expand(a_items[i].Center);
+		}
+
+		m_nodes[nodeIndex].Bounds = bounds;
+		const u32 count = a_end - a_begin;
+
+		//Split along the axis with the largest center extent.
+		const vath::Vector3f centerExtent = centerBounds.Max - centerBounds.Min;
+		const u32 axis = centerExtent.x > centerExtent.y && centerExtent.x > centerExtent.z ? 0 : (centerExtent.y > centerExtent.z ? 1 : 2);
+		if (count <= MaxLeafSize || centerExtent[axis] <= 0.0f)
+		{
+			m_nodes[nodeIndex].Index = a_begin;
+			m_nodes[nodeIndex].Count = count;
+			return nodeIndex;
+		}
+
+		//Deep nodes split at the median, which bounds the depth of the remaining levels by the log of the primitive count.
+		u32 middle = a_begin;
+		if (a_depth + 32 < MaxTraversalDepth)
+		{
+			//Binned SAH, bins the centers and evaluates every bin boundary as split candidate.
+			struct Bin final
+			{
+				BoundingBox Bounds;
+				u32 Count = 0;
+			};
+
+			Bin bins[SplitBinCount];
+			const fp32 binScale = SplitBinCount / centerExtent[axis];
+			auto GetBinIndex = [&](const BuildItem& a_item)
+			{
+				const u32 bin = static_cast<u32>((a_item.Center[axis] - centerBounds.Min[axis]) * binScale);
+				return vath::Min(bin, SplitBinCount - 1);
+			};
+
+			for (u32 i = a_begin; i < a_end; ++i)
+			{
+				Bin& bin = bins[GetBinIndex(a_items[i])];
+				bin.Bounds.Expand(a_items[i].Bounds);
+				bin.Count++;
+			}
+
+			fp32 rightCosts[SplitBinCount] = {};
+			BoundingBox rightBounds;
+			u32 rightCount = 0;
+			for (u32 b = SplitBinCount - 1; b > 0; --b)
+			{
+				rightBounds.Expand(bins[b].Bounds);
+				rightCount += bins[b].Count;
+				rightCosts[b] = rightCount > 0 ? rightBounds.GetSurfaceArea() * rightCount : 0.0f;
+			}
+
+			fp32 bestCost = fp32max;
+			u32 bestSplit = 1;
+			BoundingBox leftBounds;
+			u32 leftCount = 0;
+			for (u32 b = 1; b < SplitBinCount; ++b)
+			{
+				leftBounds.Expand(bins[b - 1].Bounds);
+				leftCount += bins[b - 1].Count;
+				const fp32 cost = (leftCount > 0 ? leftBounds.GetSurfaceArea() * leftCount : 0.0f) + rightCosts[b];
+				if (leftCount > 0 && leftCount < count && cost < bestCost)
+				{
+					bestCost = cost;
+					bestSplit = b;
+				}
+			}
+
+			BuildItem* const pMiddle = std::partition(a_items.data() + a_begin, a_items.data() + a_end, [&](const BuildItem& a_item)
+			{
+				return GetBinIndex(a_item) < bestSplit;
+			});
+
+			middle = static_cast<u32>(pMiddle - a_items.data());
+		}
+
+		//All centers ended up on one side, or the node is too deep for the surface area heuristic, fall back to a median split.
+		if (middle == a_begin || middle == a_end)
+		{
+			middle = a_begin + count / 2;
+			std::nth_element(a_items.begin() + a_begin, a_items.begin() + middle, a_items.begin() + a_end, [axis](const BuildItem& a_lhs, const BuildItem& a_rhs)
+			{
+				return a_lhs.Center[axis] < a_rhs.Center[axis];
+			});
+		}
+
+		BuildRecursive(a_items, a_begin, middle, a_depth + 1);
+		const u32 rightChild = BuildRecursive(a_items, middle, a_end, a_depth + 1);
+		m_nodes[nodeIndex].Index = rightChild;
+		return nodeIndex;
+	}
+
+	bool BoundingVolumeHierarchy::DoesIntersect(const Ray& a_ray, fp32 a_tMin, fp32 a_tMax, IntersectionInfo& a_info) const
+	{
+		IntersectionInfo currentHitInfo;
+		return Traverse(a_ray, a_tMin, a_tMax, [&](const u32 a_first, const u32 a_count, fp32& a_closestHit)
+		{
+			bool bHit = false;
+			for (u32 i = a_first; i < a_first + a_count; ++i)
+			{
+				if (m_traceables[i]->DoesIntersect(a_ray, a_tMin, a_closestHit, currentHitInfo))
+				{
+					a_closestHit = currentHitInfo.Length;
+					a_info = currentHitInfo;
+					a_info.TraceableIndex = m_traceableIndices[i];
+					bHit = true;
+				}
+			}
+
+			return bHit;
+		});
+	}
+
+	bool BoundingVolumeHierarchy::IsOccluded(const Ray& a_ray, fp32 a_tMin, fp32 a_tMax) const
+	{
+		//Any hit ends the traversal, a closest hit below every entry distance culls the remaining nodes.
+		return Traverse(a_ray, a_tMin, a_tMax, [&](const u32 a_first, const u32 a_count, fp32& a_closestHit)
+		{
+			for (u32 i = a_first; i < a_first + a_count; ++i)
+			{
+				if (m_traceables[i]->DoesOcclude(a_ray, a_tMin, a_closestHit))
+				{
+					a_closestHit = -fp32max;
+					return true;
+				}
+			}
+
+			return false;
+		});
+	}
+}
@@ -7,11 +7,13 @@ namespace dxray::riow
 		m_viewTransform(),
 		m_viewportPixelDims(0u, 0u),
 		m_depthLimits(0.001f, 1000.0f),
+		m_focusPoint(0.0f),
 		m_aspectRatio(0.0f),
 		m_focalLength(1.0f),
 		m_aperture(0.0f),
 		m_fov(90.0f),
-		m_shutterSpeed(1.0f)
+		m_shutterSpeed(1.0f),
+		m_shutterOpenTime(0.0f)
 	{}
 
 	void Camera::SetViewportDimensionInPx(const vath::Vector2u32& a_viewportDimensionInPx)
@@ -24,6 +26,7 @@ namespace dxray::riow
     {
 		DXRAY_ASSERT_WITH_MSG(vath::SqrMagnitude(m_viewportPixelDims) > 0.0f, "Ensure that the viewport pixel dimensions are set -> Camera::SetViewportDimensionInPx");
 
+		m_focusPoint = a_focusPoint;
 		m_viewTransform = vath::LookAtRH(a_position, a_focusPoint, a_worldNormal);
 		m_worldTransform = vath::Inverse(m_viewTransform);
 
@@ -36,4 +39,22 @@ namespace dxray::riow
 		m_viewportRect.x = -m_viewportRect.Width * 0.5f;
 		m_viewportRect.y = -m_viewportRect.Height * 0.5f;
 	}
-}
\ No newline at end of file
+
+	bool Camera::ProjectToPixel(const vath::Vector4f& a_world, vath::Vector2f& a_pixelCoords) const
+	{
+		//Inverse of the ray generation in the renderer, rays are generated as worldTransform * (viewport x, viewport y, 1, 0).
+		const vath::Vector4f view = m_viewTransform * a_world;
+		if (view.z <= 0.0f)
+		{
+			return false;
+		}
+
+		const vath::Vector2f pixelDelta(m_viewportRect.Width / static_cast<fp32>(m_viewportPixelDims.x), m_viewportRect.Height / static_cast<fp32>(m_viewportPixelDims.y));
+		a_pixelCoords = vath::Vector2f(
+			(view.x / view.z - m_viewportRect.x) / pixelDelta.x,
+			(view.y / view.z - m_viewportRect.y) / pixelDelta.y
+		);
+
+		return a_pixelCoords.x >= 0.0f && a_pixelCoords.y >= 0.0f && a_pixelCoords.x < m_viewportPixelDims.x && a_pixelCoords.y < m_viewportPixelDims.y;
+	}
+}
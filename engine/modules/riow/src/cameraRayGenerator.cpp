@@ -0,0 +1,61 @@
+#include "riow/cameraRayGenerator.h"
+
+namespace dxray::riow
+{
+	CameraRayGenerator::CameraRayGenerator(const Camera& a_camera) :
+		m_position(a_camera.GetPosition()),
+		m_focalLength(a_camera.GetFocalLength()),
+		m_shutterOpenTime(a_camera.GetShutterOpenTime()),
+		m_shutterSpeed(a_camera.GetShutterSpeed())
+	{
+		//The renderer generates directions as worldTransform * (viewport x, viewport y, 1, 0), which is linear in the pixel coordinates.
+		const vath::Matrix4x4f& worldTransform = a_camera.GetWorldTransform();
+		const vath::Vector3f right(worldTransform[0]);
+		const vath::Vector3f up(worldTransform[1]);
+		const vath::Vector3f forward(worldTransform[2]);
+		const vath::Rect<fp32>& viewportRect = a_camera.GetViewportRect();
+		const vath::Vector2u32 viewportDimsInPx = a_camera.GetViewportDimensionsInPx();
+		const fp32 lensRadius = a_camera.GetAperture() / 2.0f;
+
+		m_imagePlaneOrigin = forward + right * viewportRect.x + up * viewportRect.y;
+		m_pixelStepX = right * (viewportRect.Width / static_cast<fp32>(viewportDimsInPx.x));
+		m_pixelStepY = up * (viewportRect.Height / static_cast<fp32>(viewportDimsInPx.y));
+		m_lensRight = right * lensRadius;
+		m_lensUp = up * lensRadius;
+		m_pixelSpreadAngle = std::atan(vath::Magnitude(m_pixelStepY));
+	}
+
+	void CameraRayGenerator::Generate(const CameraSampleBatch& a_samples, CameraRayBatch& a_rays) const
+	{
+		using vath::Float8;
+
+		const Float8 pixelX = Float8::Load(a_samples.PixelX);
+		const Float8 pixelY = Float8::Load(a_samples.PixelY);
+		const Float8 lensX = Float8::Load(a_samples.LensX);
+		const Float8 lensY = Float8::Load(a_samples.LensY);
+
+		//Direction through the sampled image plane position.
+		const Float8 planeX = vath::MultiplyAdd(pixelY, Float8(m_pixelStepY.x), vath::MultiplyAdd(pixelX, Float8(m_pixelStepX.x), Float8(m_imagePlaneOrigin.x)));
+		const Float8 planeY = vath::MultiplyAdd(pixelY, Float8(m_pixelStepY.y), vath::MultiplyAdd(pixelX, Float8(m_pixelStepX.y), Float8(m_imagePlaneOrigin.y)));
+		const Float8 planeZ = vath::MultiplyAdd(pixelY, Float8(m_pixelStepY.z), vath::MultiplyAdd(pixelX, Float8(m_pixelStepX.z), Float8(m_imagePlaneOrigin.z)));
+
+		//Point on the focal plane, relative to the camera position.
+		const Float8 focalScale = Float8(m_focalLength) / vath::Sqrt(planeX * planeX + planeY * planeY + planeZ * planeZ);
+		const Float8 focalX = planeX * focalScale;
+		const Float8 focalY = planeY * focalScale;
+		const Float8 focalZ = planeZ * focalScale;
+
+		//Offset on the lens, the ray starts at the lens and passes through the focal point.
+		const Float8 lensOffsetX = vath::MultiplyAdd(lensY, Float8(m_lensUp.x), lensX * m_lensRight.x);
+		const Float8 lensOffsetY = vath::MultiplyAdd(lensY, Float8(m_lensUp.y), lensX * m_lensRight.y);
+		const Float8 lensOffsetZ = vath::MultiplyAdd(lensY, Float8(m_lensUp.z), lensX * m_lensRight.z);
+
+		(Float8(m_position.x) + lensOffsetX).Store(a_rays.OriginX);
+		(Float8(m_position.y) + lensOffsetY).Store(a_rays.OriginY);
+		(Float8(m_position.z) + lensOffsetZ).Store(a_rays.OriginZ);
+		(focalX - lensOffsetX).Store(a_rays.DirectionX);
+		(focalY - lensOffsetY).Store(a_rays.DirectionY);
+		(focalZ - lensOffsetZ).Store(a_rays.DirectionZ);
+		vath::MultiplyAdd(Float8::Load(a_samples.Time), Float8(m_shutterSpeed), Float8(m_shutterOpenTime)).Store(a_rays.Time);
+	}
+}
@@ -0,0 +1,449 @@
+#include "riow/distributed.h"
+#include <core/system/process.h>
+
+namespace dxray::riow
+{
+	//--- Wire protocol ---
+
+	enum class EMessageType : u32
+	{
+		Hello = 0,
+		WorkUnit,
+		UnitResult,
+		Shutdown
+	};
+
+	struct MessageHeader final
+	{
+		EMessageType Type = EMessageType::Hello;
+		u32 Padding = 0;
+		u64 PayloadSizeInBytes = 0;
+	};
+
+	struct HelloMessage final
+	{
+		u32 ImageWidth = 0;
+		u32 ImageHeight = 0;
+		RendererPipeline Pipeline;
+	};
+
+	struct WorkUnitMessage final
+	{
+		u32 UnitIndex = 0;
+		u32 OffsetX = 0;
+		u32 OffsetY = 0;
+		u32 Width = 0;
+		u32 Height = 0;
+		u32 FirstPass = 0;
+		u32 EndPass = 0;
+		u32 Padding = 0;
+		u64 Seed = 0;
+	};
+
+	struct UnitResultMessage final
+	{
+		u32 UnitIndex = 0;
+		u32 Padding = 0;
+		fp64 RenderTimeInSec = 0.0;
+	};
+
+	static bool SendMessage(Socket& a_socket, const EMessageType a_type, const void* a_pPayload = nullptr, const usize a_payloadSizeInBytes = 0)
+	{
+		const MessageHeader header = { a_type, 0, a_payloadSizeInBytes };
+		return a_socket.Send(&header, sizeof(header)) && (a_payloadSizeInBytes == 0 || a_socket.Send(a_pPayload, a_payloadSizeInBytes));
+	}
+
+	template<typename Message>
+	static bool ReceiveMessage(Socket& a_socket, const EMessageType a_expectedType, Message& a_message)
+	{
+		MessageHeader header;
+		return a_socket.Receive(&header, sizeof(header))
+			&& header.Type == a_expectedType
+			&& header.PayloadSizeInBytes == sizeof(Message)
+			&& a_socket.Receive(&a_message, sizeof(Message));
+	}
+
+	/// <summary>
+	/// Whether a worker renders the same image as the coordinator. Pass counts, budgets and checkpoints are set per unit and left out of the hash.
+	/// The super sample factor and depth of field sample count are hashed separately, splits with the same samples per pass render different images.
+	/// </summary>
+	static bool IsSameImagePipeline(const RendererPipeline& a_lhs, const RendererPipeline& a_rhs)
+	{
+		return a_lhs.GetImageHash() == a_rhs.GetImageHash();
+	}
+
+	static bool SendAccumulationBuffer(Socket& a_socket, const AccumulationBuffer& a_buffer)
+	{
+		return a_socket.Send(a_buffer.GetRadianceSumData(), a_buffer.GetPixelCount() * sizeof(Color))
+			&& a_socket.Send(a_buffer.GetWeightSumData(), a_buffer.GetPixelCount() * sizeof(fp32))
+			&& a_socket.Send(a_buffer.GetSampleCountData(), a_buffer.GetPixelCount() * sizeof(u32))
+			&& a_socket.Send(a_buffer.GetLuminanceSumData(), a_buffer.GetPixelCount() * sizeof(fp32))
+			&& a_socket.Send(a_buffer.GetLuminanceSquaredSumData(), a_buffer.GetPixelCount() * sizeof(fp32));
+	}
+
+	static bool ReceiveAccumulationBuffer(Socket& a_socket, AccumulationBuffer& a_buffer)
+	{
+		return a_socket.Receive(a_buffer.GetRadianceSumData(), a_buffer.GetPixelCount() * sizeof(Color))
+			&& a_socket.Receive(a_buffer.GetWeightSumData(), a_buffer.GetPixelCount() * sizeof(fp32))
+			&& a_socket.Receive(a_buffer.GetSampleCountData(), a_buffer.GetPixelCount() * sizeof(u32))
+			&& a_socket.Receive(a_buffer.GetLuminanceSumData(), a_buffer.GetPixelCount() * sizeof(fp32))
+			&& a_socket.Receive(a_buffer.GetLuminanceSquaredSumData(), a_buffer.GetPixelCount() * sizeof(fp32));
+	}
+
+
+	//--- Coordinator ---
+
+	RenderCoordinator::RenderCoordinator(const DistributedRenderSettings& a_settings) :
+		m_settings(a_settings),
+		m_units(),
+		m_pendingUnits(),
+		m_finishedUnits(),
+		m_workerStatistics(),
+		m_unitMutex(),
+		m_unitCondition(),
+		m_nextMergeUnit(0)
+	{
+		DXRAY_ASSERT(m_settings.WorkerCount > 0 && m_settings.UnitSize > 0);
+	}
+
+	bool RenderCoordinator::Render(AccumulationBuffer& a_accumulationBuffer, const RendererPipeline& a_pipeline, const Path& a_workerExecutable, const std::vector<String>& a_workerArguments)
+	{
+		//Units are built from the pass count, a deadline or converged pixels would be ignored rather than honoured.
+		if (a_pipeline.TimeBudgetInSec > 0.0f || a_pipeline.AdaptiveErrorThreshold > 0.0f)
+		{
+			DXRAY_ERROR("Distributed renders do not support a time budget or adaptive sampling.");
+			return false;
+		}
+
+		//Region units only hold their own rows, samples near a unit border would lose their splats into the neighbouring unit.
+		if (m_settings.ShardingMode == EShardingMode::ImageRegion && ReconstructionFilter(a_pipeline.Filter, a_pipeline.FilterRadiusInPx).GetMarginInPx() > 0)
+		{
+			DXRAY_ERROR("Image region sharding does not support reconstruction filters wider than a pixel, use sample range sharding instead.");
+			return false;
+		}
+
+		//Every unit is a render of its own that trains a fresh guide, sample range units are too short for the guide to get past its first iteration.
+		if (m_settings.ShardingMode == EShardingMode::SampleRange && a_pipeline.GuidingTrainingPassCount > 0)
+		{
+			DXRAY_ERROR("Sample range sharding does not support path guiding, use image region sharding instead.");
+			return false;
+		}
+
+		//Reservoirs carry over between the passes of a unit only, single pass units have no previous pass to reuse reservoirs from.
+		if (m_settings.ShardingMode == EShardingMode::SampleRange && a_pipeline.ReservoirCandidateCount > 0 && a_pipeline.ReservoirReuse != EReservoirReuse::None)
+		{
+			DXRAY_ERROR("Sample range sharding does not support reservoir reuse, use image region sharding or --reservoir-reuse none instead.");
+			return false;
+		}
+
+		//Units always start from a pass boundary, a checkpoint taken in the middle of a pass has to be finished locally first.
+		const u32 resumedSampleCount = a_accumulationBuffer.GetCompletedPassCount() * a_pipeline.GetSamplesPerPass();
+		for (u32 pi = 0; pi < a_accumulationBuffer.GetPixelCount(); ++pi)
+		{
+			if (a_accumulationBuffer.GetSampleCount(pi) > resumedSampleCount)
+			{
+				DXRAY_ERROR("Accumulation buffer holds a partially rendered pass, which cannot be distributed.");
+				return false;
+			}
+		}
+
+		Stopwatchd wallTimer(true);
+		BuildWorkUnits(a_accumulationBuffer, a_pipeline);
+		m_workerStatistics.assign(m_settings.WorkerCount, WorkerStatistics());
+		m_finishedUnits.clear();
+		m_nextMergeUnit = 0;
+
+		Socket listener;
+		if (!listener.Listen(m_settings.Port))
+		{
+			return false;
+		}
+
+		const u16 port = listener.GetLocalPort();
+		DXRAY_INFO("=================================");
+		DXRAY_INFO("Distributed render:");
+		DXRAY_INFO("Coordinator port: {}", port);
+		DXRAY_INFO("Worker count: {}", m_settings.WorkerCount);
+		DXRAY_INFO("Sharding: {}", m_settings.ShardingMode == EShardingMode::ImageRegion ? "image regions" : "sample ranges");
+		DXRAY_INFO("Work units: {}", m_units.size());
+		DXRAY_INFO("=================================");
+
+		std::vector<String> workerArguments = a_workerArguments;
+		workerArguments.push_back("--worker");
+		workerArguments.push_back(std::to_string(port));
+
+		//#Note: Process handles don't terminate their process, workers that were already started are terminated explicitly.
+		std::vector<Process> workerProcesses(m_settings.WorkerCount);
+		for (Process& workerProcess : workerProcesses)
+		{
+			if (!workerProcess.Spawn(a_workerExecutable, workerArguments))
+			{
+				for (Process& startedProcess : workerProcesses)
+				{
+					startedProcess.Terminate();
+				}
+
+				return false;
+			}
+		}
+
+		//Every connection is served by its own thread, the threads only block on socket IO and while waiting for units.
+		//Workers that die before they connect would be waited on forever, the coordinator stops accepting once the timeout passes without a connection.
+		std::vector<std::thread> workerThreads;
+		for (u32 wi = 0; wi < m_settings.WorkerCount; ++wi)
+		{
+			Socket connection = listener.Accept(m_settings.ConnectTimeoutInSec * 1000);
+			if (!connection.IsValid())
+			{
+				DXRAY_ERROR("{} of {} workers connected within {} s.", wi, m_settings.WorkerCount, m_settings.ConnectTimeoutInSec);
+				break;
+			}
+
+			workerThreads.emplace_back(&RenderCoordinator::ServeWorker, this, std::move(connection), wi, std::ref(a_accumulationBuffer), std::cref(a_pipeline));
+		}
+
+		for (std::thread& workerThread : workerThreads)
+		{
+			workerThread.join();
+		}
+
+		//The connected workers were told to shut down, the ones that never connected can't be and are terminated.
+		const bool bAllWorkersConnected = workerThreads.size() == m_settings.WorkerCount;
+		for (Process& workerProcess : workerProcesses)
+		{
+			if (bAllWorkersConnected)
+			{
+				workerProcess.Wait();
+			}
+			else
+			{
+				workerProcess.Terminate();
+			}
+		}
+
+		const bool bSucceeded = m_nextMergeUnit == m_units.size();
+		if (bSucceeded)
+		{
+			a_accumulationBuffer.SetCompletedPassCount(a_pipeline.PassCount);
+		}
+		else
+		{
+			DXRAY_ERROR("Distributed render failed, merged {} / {} units.", m_nextMergeUnit, m_units.size());
+		}
+
+		ReportStatistics(wallTimer.GetElapsedSeconds());
+		return bSucceeded;
+	}
+
+	void RenderCoordinator::BuildWorkUnits(const AccumulationBuffer& a_accumulationBuffer, const RendererPipeline& a_pipeline)
+	{
+		const vath::Vector2u32 imageDims = a_accumulationBuffer.GetDimensions();
+		const u32 firstPass = a_accumulationBuffer.GetCompletedPassCount();
+		m_units.clear();
+
+		switch (m_settings.ShardingMode)
+		{
+		case EShardingMode::ImageRegion:
+		{
+			const u32 bandHeight = m_settings.UnitSize * a_pipeline.ClusterSize;
+			for (u32 y = 0; y < imageDims.y; y += bandHeight)
+			{
+				m_units.push_back(WorkUnit{ vath::Vector2u32(0u, y), vath::Vector2u32(imageDims.x, vath::Min(bandHeight, imageDims.y - y)), firstPass, a_pipeline.PassCount });
+			}
+			break;
+		}
+		case EShardingMode::SampleRange:
+		{
+			for (u32 pass = firstPass; pass < a_pipeline.PassCount; pass += m_settings.UnitSize)
+			{
+				m_units.push_back(WorkUnit{ vath::Vector2u32(0u, 0u), imageDims, pass, vath::Min(pass + m_settings.UnitSize, static_cast<u32>(a_pipeline.PassCount)) });
+			}
+			break;
+		}
+		}
+
+		//Units are popped from the back, reverse the order so they are handed out front to back.
+		m_pendingUnits.resize(m_units.size());
+		for (u32 ui = 0; ui < m_units.size(); ++ui)
+		{
+			m_pendingUnits[ui] = static_cast<u32>(m_units.size()) - 1 - ui;
+		}
+	}
+
+	void RenderCoordinator::ServeWorker(Socket a_connection, const u32 a_workerIndex, AccumulationBuffer& a_accumulationBuffer, const RendererPipeline& a_pipeline)
+	{
+		HelloMessage hello;
+		if (!ReceiveMessage(a_connection, EMessageType::Hello, hello))
+		{
+			DXRAY_ERROR("Worker {} did not introduce itself.", a_workerIndex);
+			return;
+		}
+
+		if (hello.ImageWidth != a_accumulationBuffer.GetDimensions().x || hello.ImageHeight != a_accumulationBuffer.GetDimensions().y || !IsSameImagePipeline(hello.Pipeline, a_pipeline))
+		{
+			DXRAY_ERROR("Worker {} renders with a different configuration, it is ignored.", a_workerIndex);
+			SendMessage(a_connection, EMessageType::Shutdown);
+			return;
+		}
+
+		WorkerStatistics& statistics = m_workerStatistics[a_workerIndex];
+		while (true)
+		{
+			//Units in flight at other workers can still come back, the worker waits until every unit is merged.
+			u32 unitIndex = 0;
+			{
+				std::unique_lock<std::mutex> lock(m_unitMutex);
+				m_unitCondition.wait(lock, [this]() { return !m_pendingUnits.empty() || m_nextMergeUnit == m_units.size(); });
+				if (m_pendingUnits.empty())
+				{
+					break;
+				}
+
+				unitIndex = m_pendingUnits.back();
+				m_pendingUnits.pop_back();
+			}
+
+			const WorkUnit& unit = m_units[unitIndex];
+			const WorkUnitMessage unitMessage = { unitIndex, unit.ImageOffset.x, unit.ImageOffset.y, unit.Dimensions.x, unit.Dimensions.y, unit.FirstPass, unit.EndPass, 0, a_accumulationBuffer.GetSeed() };
+
+			AccumulationBuffer unitBuffer(unit.Dimensions, a_accumulationBuffer.GetSeed());
+			UnitResultMessage result;
+			const bool bUnitRendered = SendMessage(a_connection, EMessageType::WorkUnit, &unitMessage, sizeof(unitMessage))
+				&& ReceiveMessage(a_connection, EMessageType::UnitResult, result)
+				&& result.UnitIndex == unitIndex
+				&& ReceiveAccumulationBuffer(a_connection, unitBuffer);
+
+			if (!bUnitRendered)
+			{
+				//Hand the unit to one of the remaining workers.
+				DXRAY_ERROR("Lost connection to worker {}, unit {} is rescheduled.", a_workerIndex, unitIndex);
+				{
+					const std::lock_guard<std::mutex> lock(m_unitMutex);
+					m_pendingUnits.push_back(unitIndex);
+				}
+
+				m_unitCondition.notify_all();
+				return;
+			}
+
+			statistics.UnitCount++;
+			statistics.SampleCount += static_cast<u64>(unit.Dimensions.x) * unit.Dimensions.y * (unit.EndPass - unit.FirstPass) * a_pipeline.GetSamplesPerPass();
+			statistics.BusyTimeInSec += result.RenderTimeInSec;
+
+			unitBuffer.SetImageOffset(unit.ImageOffset);
+			MergeResult(unitIndex, std::move(unitBuffer), a_accumulationBuffer);
+			m_unitCondition.notify_all();
+		}
+
+		SendMessage(a_connection, EMessageType::Shutdown);
+	}
+
+	void RenderCoordinator::MergeResult(const u32 a_unitIndex, AccumulationBuffer&& a_unitBuffer, AccumulationBuffer& a_accumulationBuffer)
+	{
+		//Floating point addition is not associative, merging strictly in unit order makes the result independent of worker timing.
+		const std::lock_guard<std::mutex> lock(m_unitMutex);
+		m_finishedUnits.emplace(a_unitIndex, std::move(a_unitBuffer));
+
+		auto unitIt = m_finishedUnits.find(m_nextMergeUnit);
+		while (unitIt != m_finishedUnits.end())
+		{
+			a_accumulationBuffer.Merge(unitIt->second);
+			m_finishedUnits.erase(unitIt);
+			unitIt = m_finishedUnits.find(++m_nextMergeUnit);
+		}
+	}
+
+	void RenderCoordinator::ReportStatistics(const fp64 a_wallTimeInSec) const
+	{
+		fp64 totalBusyTime = 0.0;
+		fp64 maxBusyTime = 0.0;
+		u64 totalSampleCount = 0;
+		for (const WorkerStatistics& statistics : m_workerStatistics)
+		{
+			totalBusyTime += statistics.BusyTimeInSec;
+			maxBusyTime = vath::Max(maxBusyTime, statistics.BusyTimeInSec);
+			totalSampleCount += statistics.SampleCount;
+		}
+
+		DXRAY_INFO("=================================");
+		DXRAY_INFO("Worker statistics:");
+		for (u32 wi = 0; wi < m_workerStatistics.size(); ++wi)
+		{
+			const WorkerStatistics& statistics = m_workerStatistics[wi];
+			const fp64 throughput = statistics.BusyTimeInSec > 0.0 ? statistics.SampleCount / statistics.BusyTimeInSec / 1'000'000.0 : 0.0;
+			DXRAY_INFO("Worker {}: {} units, {} samples, busy {} s, {} Msamples/s", wi, statistics.UnitCount, statistics.SampleCount, statistics.BusyTimeInSec, throughput);
+		}
+
+		//Load imbalance: how much longer the slowest worker was busy compared to the average worker, 0% is perfectly balanced.
+		const fp64 meanBusyTime = totalBusyTime / vath::Max<usize>(m_workerStatistics.size(), 1);
+		const fp64 imbalance = meanBusyTime > 0.0 ? (maxBusyTime / meanBusyTime - 1.0) * 100.0 : 0.0;
+		DXRAY_INFO("Total: {} samples in {} s wall time, {} Msamples/s", totalSampleCount, a_wallTimeInSec, totalSampleCount / a_wallTimeInSec / 1'000'000.0);
+		DXRAY_INFO("Load imbalance: {}%", imbalance);
+		DXRAY_INFO("=================================");
+	}
+
+
+	//--- Worker ---
+
+	i32 RunRenderWorker(Renderer& a_renderer, const Scene& a_scene, const vath::Vector2u32& a_imageDimensions, const u16 a_coordinatorPort)
+	{
+		//The coordinator starts listening before spawning the workers, though retry for a bit in case the connection is refused.
+		Socket connection;
+		for (u32 attempt = 0; attempt < 50 && !connection.Connect("127.0.0.1", a_coordinatorPort); ++attempt)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		}
+
+		if (!connection.IsValid())
+		{
+			DXRAY_ERROR("Worker failed to connect to coordinator port {}.", a_coordinatorPort);
+			return 1;
+		}
+
+		const RendererPipeline pipeline = a_renderer.GetRenderPipeline();
+		const HelloMessage hello = { a_imageDimensions.x, a_imageDimensions.y, pipeline };
+		if (!SendMessage(connection, EMessageType::Hello, &hello, sizeof(hello)))
+		{
+			return 1;
+		}
+
+		while (true)
+		{
+			MessageHeader header;
+			if (!connection.Receive(&header, sizeof(header)))
+			{
+				DXRAY_ERROR("Worker lost the connection to the coordinator.");
+				return 1;
+			}
+
+			if (header.Type == EMessageType::Shutdown)
+			{
+				return 0;
+			}
+
+			WorkUnitMessage unit;
+			if (header.Type != EMessageType::WorkUnit || header.PayloadSizeInBytes != sizeof(unit) || !connection.Receive(&unit, sizeof(unit)))
+			{
+				DXRAY_ERROR("Worker received an invalid message.");
+				return 1;
+			}
+
+			Stopwatchd unitTimer(true);
+			AccumulationBuffer unitBuffer(vath::Vector2u32(unit.Width, unit.Height), unit.Seed);
+			unitBuffer.SetImageOffset(vath::Vector2u32(unit.OffsetX, unit.OffsetY));
+			unitBuffer.SetFirstPassIndex(unit.FirstPass);
+
+			RendererPipeline unitPipeline = pipeline;
+			unitPipeline.PassCount = static_cast<u16>(unit.EndPass);
+			unitPipeline.CheckpointIntervalInSec = 0.0f;
+			a_renderer.SetRenderPipeline(unitPipeline);
+			a_renderer.Render(a_scene, unitBuffer);
+
+			const UnitResultMessage result = { unit.UnitIndex, 0, unitTimer.GetElapsedSeconds() };
+			if (!SendMessage(connection, EMessageType::UnitResult, &result, sizeof(result)) || !SendAccumulationBuffer(connection, unitBuffer))
+			{
+				return 1;
+			}
+		}
+	}
+}
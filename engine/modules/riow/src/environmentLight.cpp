@@ -0,0 +1,122 @@
+#include "riow/environmentLight.h"
+#include "riow/sampler.h"
+#include <stb/stbImageLoad.h>
+
+namespace dxray::riow
+{
+	EnvironmentLight::EnvironmentLight(const vath::Vector2u32& a_dimensions, const std::vector<Color>& a_linearTexels, const fp32 a_strength /*= 1.0f*/)
+	{
+		DXRAY_ASSERT(a_dimensions.x > 0 && a_dimensions.y > 0);
+		DXRAY_ASSERT(a_linearTexels.size() == static_cast<usize>(a_dimensions.x) * a_dimensions.y);
+
+		std::shared_ptr<Map> map = std::make_shared<Map>();
+		map->Width = a_dimensions.x;
+		map->Height = a_dimensions.y;
+
+		const fp64 pi = vath::Pi<fp64>();
+		map->RowSolidAngles.resize(map->Height);
+		for (u32 y = 0; y < map->Height; ++y)
+		{
+			const fp64 cosTop = std::cos(pi * y / map->Height);
+			const fp64 cosBottom = std::cos(pi * (y + 1) / map->Height);
+			map->RowSolidAngles[y] = static_cast<fp32>(2.0 * pi / map->Width * (cosTop - cosBottom));
+		}
+
+		//Texels are picked proportional to the light they contribute, their luminance times the solid angle they cover.
+		map->Radiance.resize(a_linearTexels.size());
+		std::vector<fp32> weights(a_linearTexels.size());
+		for (usize ti = 0; ti < a_linearTexels.size(); ++ti)
+		{
+			const Color& texel = a_linearTexels[ti];
+			map->Radiance[ti] = Color(vath::Max(texel.x, 0.0f), vath::Max(texel.y, 0.0f), vath::Max(texel.z, 0.0f)) * a_strength;
+			weights[ti] = Luminance(map->Radiance[ti]) * map->RowSolidAngles[ti / map->Width];
+		}
+
+		map->Distribution = AliasTable(weights);
+		m_map = std::move(map);
+	}
+
+	EnvironmentLight EnvironmentLight::LoadFromFile(const Path& a_path, const fp32 a_strength /*= 1.0f*/)
+	{
+		const String pathString = a_path.string();
+		stbi_set_flip_vertically_on_load(false);
+
+		//Low dynamic range files are converted to linear values by stb.
+		vath::Vector2i32 dimensions(0, 0);
+		i32 fileChannelCount = 0;
+		fp32* pData = stbi_loadf(pathString.c_str(), &dimensions.x, &dimensions.y, &fileChannelCount, 3);
+		if (pData == nullptr)
+		{
+			DXRAY_ERROR("Failed to load environment: {}", pathString.c_str());
+			return EnvironmentLight(vath::Vector2u32(1, 1), { Color(0.0f) });
+		}
+
+		std::vector<Color> texels(static_cast<usize>(dimensions.x) * dimensions.y);
+		for (usize ti = 0; ti < texels.size(); ++ti)
+		{
+			texels[ti] = Color(pData[ti * 3], pData[ti * 3 + 1], pData[ti * 3 + 2]);
+		}
+		stbi_image_free(pData);
+
+		DXRAY_INFO("Successfully loaded: {} ({}x{})", pathString.c_str(), dimensions.x, dimensions.y);
+		return EnvironmentLight(vath::Vector2u32(dimensions.x, dimensions.y), texels, a_strength);
+	}
+
+	Color EnvironmentLight::Evaluate(const vath::Vector3f& a_direction) const
+	{
+		return m_map->Radiance[GetTexelIndex(a_direction)];
+	}
+
+	bool EnvironmentLight::Sample(vath::Vector3f& a_direction, Color& a_radiance, fp32& a_pdf) const
+	{
+		const Map& map = *m_map;
+		if (map.Distribution.IsEmpty())
+		{
+			return false;
+		}
+
+		const u32 texelIndex = map.Distribution.Sample(RandomFloat(), RandomFloat());
+		const u32 x = texelIndex % map.Width;
+		const u32 y = texelIndex / map.Width;
+
+		//Uniform direction within the texel, uniform in the azimuth and in the cosine of the polar angle.
+		const fp32 pi = vath::Pi<fp32>();
+		const fp32 cosTop = std::cos(pi * static_cast<fp32>(y) / static_cast<fp32>(map.Height));
+		const fp32 cosBottom = std::cos(pi * static_cast<fp32>(y + 1) / static_cast<fp32>(map.Height));
+		const fp32 cosTheta = cosTop + (cosBottom - cosTop) * RandomFloat();
+		const fp32 sinTheta = std::sqrt(vath::Max(0.0f, 1.0f - cosTheta * cosTheta));
+		const fp32 phi = 2.0f * pi * (static_cast<fp32>(x) + RandomFloat()) / static_cast<fp32>(map.Width);
+
+		a_direction = vath::Vector3f(sinTheta * std::cos(phi), cosTheta, -sinTheta * std::sin(phi));
+		a_radiance = map.Radiance[texelIndex];
+		a_pdf = map.Distribution.GetProbability(texelIndex) / map.RowSolidAngles[y];
+		return a_pdf > 0.0f;
+	}
+
+	fp32 EnvironmentLight::GetPdf(const vath::Vector3f& a_direction) const
+	{
+		const Map& map = *m_map;
+		if (map.Distribution.IsEmpty())
+		{
+			return 0.0f;
+		}
+
+		const u32 texelIndex = GetTexelIndex(a_direction);
+		return map.Distribution.GetProbability(texelIndex) / map.RowSolidAngles[texelIndex / map.Width];
+	}
+
+	u32 EnvironmentLight::GetTexelIndex(const vath::Vector3f& a_direction) const
+	{
+		const Map& map = *m_map;
+		const fp32 pi = vath::Pi<fp32>();
+		const fp32 magnitude = vath::Magnitude(a_direction);
+
+		fp32 phi = std::atan2(-a_direction.z, a_direction.x);
+		phi = phi < 0.0f ? phi + 2.0f * pi : phi;
+		const fp32 theta = std::acos(vath::Clamp<fp32>(a_direction.y / magnitude, -1.0f, 1.0f));
+
+		const u32 x = vath::Min(static_cast<u32>(phi / (2.0f * pi) * static_cast<fp32>(map.Width)), map.Width - 1);
+		const u32 y = vath::Min(static_cast<u32>(theta / pi * static_cast<fp32>(map.Height)), map.Height - 1);
+		return y * map.Width + x;
+	}
+}
@@ -0,0 +1,179 @@
+#include "riow/film.h"
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Mitchell-Netravali cubic over [0, 2), with the B = C = 1/3 the paper recommends.
+	/// </summary>
+	static fp32 EvaluateMitchell(const fp32 a_t)
+	{
+		constexpr fp32 B = 1.0f / 3.0f;
+		constexpr fp32 C = 1.0f / 3.0f;
+		const fp32 t2 = a_t * a_t;
+		const fp32 t3 = t2 * a_t;
+		if (a_t < 1.0f)
+		{
+			return ((12.0f - 9.0f * B - 6.0f * C) * t3 + (-18.0f + 12.0f * B + 6.0f * C) * t2 + (6.0f - 2.0f * B)) / 6.0f;
+		}
+
+		if (a_t < 2.0f)
+		{
+			return ((-B - 6.0f * C) * t3 + (6.0f * B + 30.0f * C) * t2 + (-12.0f * B - 48.0f * C) * a_t + (8.0f * B + 24.0f * C)) / 6.0f;
+		}
+
+		return 0.0f;
+	}
+
+	ReconstructionFilter::ReconstructionFilter(const EReconstructionFilter a_type /*= EReconstructionFilter::Box*/, const fp32 a_radiusInPx /*= 0.0f*/) :
+		m_table(),
+		m_type(a_type),
+		m_radius(a_radiusInPx > 0.0f ? a_radiusInPx : GetDefaultRadius(a_type)),
+		m_tableScale(0.0f)
+	{
+		m_tableScale = static_cast<fp32>(TableSize) / m_radius;
+
+		//Entries hold the profile at the center of the offsets they cover. The gaussian is shifted down to reach 0 at the radius,
+		//its standard deviation is a third of the radius.
+		const fp32 gaussianAlpha = 4.5f / (m_radius * m_radius);
+		const fp32 gaussianEdge = std::exp(-gaussianAlpha * m_radius * m_radius);
+		for (u32 i = 0; i < TableSize; ++i)
+		{
+			const fp32 offset = (static_cast<fp32>(i) + 0.5f) / m_tableScale;
+			switch (m_type)
+			{
+			case EReconstructionFilter::Box:
+				m_table[i] = 1.0f;
+				break;
+			case EReconstructionFilter::Tent:
+				m_table[i] = 1.0f - offset / m_radius;
+				break;
+			case EReconstructionFilter::Gaussian:
+				m_table[i] = std::exp(-gaussianAlpha * offset * offset) - gaussianEdge;
+				break;
+			case EReconstructionFilter::Mitchell:
+				m_table[i] = EvaluateMitchell(2.0f * offset / m_radius);
+				break;
+			}
+		}
+
+		//The filter is the product of two profiles, a profile that integrates to 1 normalizes it. Every entry covers 1 / tableScale on both sides of 0.
+		fp32 integral = 0.0f;
+		for (const fp32 entry : m_table)
+		{
+			integral += 2.0f * entry / m_tableScale;
+		}
+
+		for (fp32& entry : m_table)
+		{
+			entry /= integral;
+		}
+	}
+
+	u32 ReconstructionFilter::GetMarginInPx() const
+	{
+		return static_cast<u32>(vath::Max(std::ceil(m_radius - 0.5f), 0.0f));
+	}
+
+	fp32 ReconstructionFilter::GetDefaultRadius(const EReconstructionFilter a_type)
+	{
+		switch (a_type)
+		{
+		case EReconstructionFilter::Tent:
+			return 1.0f;
+		case EReconstructionFilter::Gaussian:
+			return 1.5f;
+		case EReconstructionFilter::Mitchell:
+			return 2.0f;
+		default:
+			return 0.5f;
+		}
+	}
+
+	void FilmTile::AddSample(const vath::Vector2f& a_imagePositionInPx, const Color& a_radiance)
+	{
+		//Pixels whose center lies within [position - radius, position + radius). The interval is half open so the default box filter
+		//gives every sample to exactly one pixel, also when it lies on the border between two: the pixel left of or above it.
+		const fp32 radius = m_pFilter->GetRadius();
+		const i32 minX = vath::Max(static_cast<i32>(std::ceil(a_imagePositionInPx.x - 0.5f - radius)) - m_imageOffset.x, 0);
+		const i32 minY = vath::Max(static_cast<i32>(std::ceil(a_imagePositionInPx.y - 0.5f - radius)) - m_imageOffset.y, 0);
+		const i32 endX = vath::Min(static_cast<i32>(std::ceil(a_imagePositionInPx.x - 0.5f + radius)) - m_imageOffset.x, static_cast<i32>(m_dimensions.x));
+		const i32 endY = vath::Min(static_cast<i32>(std::ceil(a_imagePositionInPx.y - 0.5f + radius)) - m_imageOffset.y, static_cast<i32>(m_dimensions.y));
+		for (i32 y = minY; y < endY; ++y)
+		{
+			const fp32 offsetY = static_cast<fp32>(m_imageOffset.y + y) + 0.5f - a_imagePositionInPx.y;
+			for (i32 x = minX; x < endX; ++x)
+			{
+				const fp32 offsetX = static_cast<fp32>(m_imageOffset.x + x) + 0.5f - a_imagePositionInPx.x;
+				const fp32 weight = m_pFilter->Evaluate(offsetX, offsetY);
+				const u32 ti = static_cast<u32>(x) + static_cast<u32>(y) * m_dimensions.x;
+				m_radianceSum[ti] += a_radiance * weight;
+				m_weightSum[ti] += weight;
+			}
+		}
+	}
+
+	Film::Film(AccumulationBuffer& a_buffer, const ReconstructionFilter& a_filter) :
+		m_buffer(a_buffer),
+		m_filter(a_filter),
+		m_mergeMutex(),
+		m_pendingTiles(),
+		m_nextTileIndex(0)
+	{}
+
+	void Film::InitializeTile(const vath::Vector2u32& a_regionOffset, const vath::Vector2u32& a_regionDimensions, FilmTile& a_tile) const
+	{
+		const u32 margin = m_filter.GetMarginInPx();
+		const vath::Vector2u32& bufferDims = m_buffer.GetDimensions();
+		const vath::Vector2u32 tileMin(a_regionOffset.x - vath::Min(a_regionOffset.x, margin), a_regionOffset.y - vath::Min(a_regionOffset.y, margin));
+		const vath::Vector2u32 tileEnd(vath::Min(a_regionOffset.x + a_regionDimensions.x + margin, bufferDims.x), vath::Min(a_regionOffset.y + a_regionDimensions.y + margin, bufferDims.y));
+		const vath::Vector2u32& imageOffset = m_buffer.GetImageOffset();
+
+		a_tile.m_pFilter = &m_filter;
+		a_tile.m_imageOffset = vath::Vector2i32(static_cast<i32>(imageOffset.x + tileMin.x), static_cast<i32>(imageOffset.y + tileMin.y));
+		a_tile.m_dimensions = vath::Vector2u32(tileEnd.x - tileMin.x, tileEnd.y - tileMin.y);
+		const usize pixelCount = static_cast<usize>(a_tile.m_dimensions.x) * a_tile.m_dimensions.y;
+		a_tile.m_radianceSum.assign(pixelCount, Color(0.0f));
+		a_tile.m_weightSum.assign(pixelCount, 0.0f);
+	}
+
+	void Film::MergeTile(FilmTile&& a_tile, const u64 a_tileIndex)
+	{
+		//Tiles without a margin cover pixels of their own, the order they are added in does not change the sums.
+		if (m_filter.GetMarginInPx() == 0)
+		{
+			AddTile(a_tile);
+			return;
+		}
+
+		const std::lock_guard<std::mutex> lock(m_mergeMutex);
+		if (a_tileIndex != m_nextTileIndex)
+		{
+			m_pendingTiles.emplace(a_tileIndex, std::move(a_tile));
+			return;
+		}
+
+		AddTile(a_tile);
+		++m_nextTileIndex;
+		for (auto it = m_pendingTiles.begin(); it != m_pendingTiles.end() && it->first == m_nextTileIndex; it = m_pendingTiles.erase(it))
+		{
+			AddTile(it->second);
+			++m_nextTileIndex;
+		}
+	}
+
+	void Film::AddTile(const FilmTile& a_tile)
+	{
+		const vath::Vector2u32& imageOffset = m_buffer.GetImageOffset();
+		const u32 bufferWidth = m_buffer.GetDimensions().x;
+		const u32 tileX = static_cast<u32>(a_tile.m_imageOffset.x) - imageOffset.x;
+		const u32 tileY = static_cast<u32>(a_tile.m_imageOffset.y) - imageOffset.y;
+		for (u32 y = 0; y < a_tile.m_dimensions.y; ++y)
+		{
+			for (u32 x = 0; x < a_tile.m_dimensions.x; ++x)
+			{
+				const u32 ti = x + y * a_tile.m_dimensions.x;
+				m_buffer.AddWeightedRadiance(tileX + x + (tileY + y) * bufferWidth, a_tile.m_radianceSum[ti], a_tile.m_weightSum[ti]);
+			}
+		}
+	}
+}
@@ -1,4 +1,6 @@
 #include "riow/image.h"
+#include "riow/imageStream.h"
+#include "riow/pngEncoder.h"
 #include <filesystem>
 
 #define STBI_MSC_SECURE_CRT
@@ -23,6 +25,10 @@ namespace dxray::riow
             return String(".png");
         case Image::EFileExtension::jpg:
             return String(".jpg");
+        case Image::EFileExtension::pfm:
+            return String(".pfm");
+        case Image::EFileExtension::exr:
+            return String(".exr");
         case Image::EFileExtension::Invalid:
         default:
             DXRAY_ASSERT_WITH_MSG(false, "Invalid image file format chosen");
@@ -31,6 +37,11 @@ namespace dxray::riow
         return String("");
     }
 
+    Path GetOutputFilePath(const String& a_fileName, const Image::EFileExtension a_fileExtension)
+    {
+        return std::filesystem::path("bin") / CMAKE_INTDIR / String(a_fileName + GetFileExtension(a_fileExtension));
+    }
+
     Image::Image(const Path& a_path, const ELoadOptions a_loadFlags, u8 a_numChannels /*= 3*/) :
         m_dimensions(0, 0),
         m_channelCount(0),
@@ -72,41 +83,58 @@ namespace dxray::riow
             return CyanPixelColor;
         }
 
+        //Clamping the coordinates keeps the index within the image, no need to clamp the index as well.
         const vath::Vector2i32 clampedCoords(vath::Clamp<i32>(a_pixelCoords.x, 0, m_dimensions.x - 1), vath::Clamp<i32>(a_pixelCoords.y, 0, m_dimensions.y - 1));
-        const i32 pixelIndex = vath::Clamp<i32>(clampedCoords.x * m_channelCount + m_dimensions.x * m_channelCount * clampedCoords.y, 0, m_dimensions.x * m_dimensions.y * m_channelCount - 1);
-        return &m_data[pixelIndex];
+        return &m_data[(clampedCoords.x + m_dimensions.x * clampedCoords.y) * m_channelCount];
+    }
+
+    i32 SavePixelBufferToFile(const String& a_fileName, const Image::EFileExtension a_fileExtension, i32 a_width, i32 a_height, i32 a_numChannels, const u8* a_pPixelData, TaskScheduler* a_pTaskScheduler /*= nullptr*/)
+    {
+        const Path filePath = GetOutputFilePath(a_fileName, a_fileExtension);
+        i32 result = 0;
+        switch (a_fileExtension)
+        {
+        case Image::EFileExtension::png:
+        {
+            std::vector<u8> png;
+            EncodePng(a_pPixelData, vath::Vector2u32(a_width, a_height), static_cast<u32>(a_numChannels), png, a_pTaskScheduler);
+            std::ofstream file(filePath, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+            result = file.good() ? 1 : 0;
+            break;
+        }
+        case Image::EFileExtension::jpg:
+            result = stbi_write_jpg(filePath.string().c_str(), a_width, a_height, a_numChannels, a_pPixelData, 95);
+            break;
+        default:
+            DXRAY_ASSERT_WITH_MSG(false, "Pixel buffers can only be stored as png or jpg.");
+        }
+
+        DXRAY_ASSERT(result > 0); //0 - failure.
+        return result;
+    }
+
+    bool SaveRadianceBufferToFile(const String& a_fileName, const Image::EFileExtension a_fileExtension, i32 a_width, i32 a_height, const Color* a_pRadianceData, const bool a_bHalfPrecision /*= true*/)
+    {
+        DXRAY_ASSERT_WITH_MSG(a_fileExtension == Image::EFileExtension::pfm || a_fileExtension == Image::EFileExtension::exr, "Radiance buffers can only be stored as pfm or exr.");
+        ScanlineImageWriter writer(a_fileName, a_fileExtension, vath::Vector2u32(a_width, a_height), DisplayTransform(), a_bHalfPrecision);
+        return writer.WriteRows(a_pRadianceData, static_cast<u32>(a_height)) && writer.Finish();
     }
 
     i32 SaveColorBufferToFile(const String& a_fileName, const Image::EFileExtension a_fileExtension, i32 a_width, i32 a_height, i32 a_numChannels, Color* a_pColorData, bool a_bNormalizedData)
     {
-        const i32 pixelCount = a_width * a_height;
-        u8* const pixels = new u8[pixelCount * a_numChannels];
+        const usize pixelCount = static_cast<usize>(a_width) * a_height;
+        const fp32 channelScale = a_bNormalizedData ? 255.0f : 1.0f;
+        std::vector<u8> pixels(pixelCount * a_numChannels);
 
-        for (i32 pixelIndex = 0; pixelIndex < pixelCount * a_numChannels; pixelIndex += a_numChannels)
+        for (usize pixelIndex = 0; pixelIndex < pixelCount; ++pixelIndex)
         {
             for (i32 channelIndex = 0; channelIndex < a_numChannels; channelIndex++)
             {
-                if (a_bNormalizedData)
-                {
-                    fp32 channelValue = vath::Clamp<fp32>(a_pColorData[pixelIndex / a_numChannels][channelIndex], 0.0f, 1.0f);
-                    pixels[pixelIndex + channelIndex] = static_cast<u8>(channelValue * 255.0f);
-                }
-                else
-                {
-                    fp32 channelValue = vath::Clamp<fp32>(a_pColorData[pixelIndex / a_numChannels][channelIndex], 0.0f, 255.0f);
-                    pixels[pixelIndex + channelIndex] = static_cast<u8>(channelValue);
-                }
+                pixels[pixelIndex * a_numChannels + channelIndex] = static_cast<u8>(vath::Clamp<fp32>(a_pColorData[pixelIndex][channelIndex] * channelScale, 0.0f, 255.0f));
             }
         }
 
-        const auto filepath = std::filesystem::path("bin") / CMAKE_INTDIR / String(a_fileName + GetFileExtension(a_fileExtension));
-        const i32 result = stbi_write_png(filepath.string().c_str(), a_width, a_height, a_numChannels, pixels, a_width * a_numChannels);
-        DXRAY_ASSERT(result > 0); //0 - failure.
-        if (pixels != nullptr)
-        {
-            delete[] pixels;
-        }
-
-        return result;
+        return SavePixelBufferToFile(a_fileName, a_fileExtension, a_width, a_height, a_numChannels, pixels.data());
     }
 }
\ No newline at end of file
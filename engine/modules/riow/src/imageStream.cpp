@@ -0,0 +1,320 @@
+#include "riow/imageStream.h"
+#include "riow/pngEncoder.h"
+#include <filesystem>
+
+namespace dxray::riow
+{
+	/// <summary>
+	/// Appends the raw bytes of a value, exr and pfm files are little endian.
+	/// </summary>
+	template<typename T>
+	static void AppendBytes(std::vector<u8>& a_buffer, const T& a_value)
+	{
+		const u8* pBytes = reinterpret_cast<const u8*>(&a_value);
+		a_buffer.insert(a_buffer.end(), pBytes, pBytes + sizeof(T));
+	}
+
+	static void AppendBigEndian(std::vector<u8>& a_buffer, const u32 a_value)
+	{
+		a_buffer.push_back(static_cast<u8>(a_value >> 24));
+		a_buffer.push_back(static_cast<u8>(a_value >> 16));
+		a_buffer.push_back(static_cast<u8>(a_value >> 8));
+		a_buffer.push_back(static_cast<u8>(a_value));
+	}
+
+	static void AppendString(std::vector<u8>& a_buffer, const char* a_pString)
+	{
+		a_buffer.insert(a_buffer.end(), a_pString, a_pString + std::strlen(a_pString) + 1);
+	}
+
+	static void AppendExrAttribute(std::vector<u8>& a_buffer, const char* a_pName, const char* a_pType, const std::vector<u8>& a_value)
+	{
+		AppendString(a_buffer, a_pName);
+		AppendString(a_buffer, a_pType);
+		AppendBytes(a_buffer, static_cast<i32>(a_value.size()));
+		a_buffer.insert(a_buffer.end(), a_value.begin(), a_value.end());
+	}
+
+	ScanlineImageWriter::ScanlineImageWriter(const String& a_fileName, const Image::EFileExtension a_fileExtension, const vath::Vector2u32& a_dimensionsInPx,
+		const DisplayTransform& a_displayTransform /*= DisplayTransform()*/, const bool a_bHalfPrecision /*= true*/) :
+		m_file(),
+		m_filePath(GetOutputFilePath(a_fileName, a_fileExtension)),
+		m_dimensions(a_dimensionsInPx),
+		m_displayTransform(a_displayTransform),
+		m_encodeBuffer(),
+		m_pixelBuffer(),
+		m_previousRow(),
+		m_deflateHistory(),
+		m_headerSizeInBytes(0),
+		m_writtenRowCount(0),
+		m_pngAdler(1),
+		m_fileExtension(a_fileExtension),
+		m_bHalfPrecision(a_bHalfPrecision),
+		m_bFinished(false)
+	{
+		DXRAY_ASSERT_WITH_MSG(a_fileExtension == Image::EFileExtension::png || a_fileExtension == Image::EFileExtension::exr || a_fileExtension == Image::EFileExtension::pfm,
+			"Scanline images can only be written as png, exr or pfm.");
+
+		m_file.open(m_filePath, std::ios::binary | std::ios::trunc);
+		if (!m_file)
+		{
+			DXRAY_ERROR("Failed to open image for writing: {}", m_filePath.string());
+			return;
+		}
+
+		WriteHeader();
+	}
+
+	ScanlineImageWriter::~ScanlineImageWriter()
+	{
+		Finish();
+	}
+
+	bool ScanlineImageWriter::WriteRows(const Color* a_pRadiance, const u32 a_rowCount)
+	{
+		DXRAY_ASSERT_WITH_MSG(!m_bFinished && m_writtenRowCount + a_rowCount <= m_dimensions.y, "Writing more rows than the image holds.");
+		if (!IsOpen())
+		{
+			return false;
+		}
+
+		switch (m_fileExtension)
+		{
+		case Image::EFileExtension::png:
+			WritePngRows(a_pRadiance, a_rowCount);
+			break;
+		case Image::EFileExtension::exr:
+			WriteExrRows(a_pRadiance, a_rowCount);
+			break;
+		case Image::EFileExtension::pfm:
+			WritePfmRows(a_pRadiance, a_rowCount);
+			break;
+		default:
+			break;
+		}
+
+		m_writtenRowCount += a_rowCount;
+		if (!IsOpen())
+		{
+			DXRAY_ERROR("Failed to write image rows: {}", m_filePath.string());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool ScanlineImageWriter::Finish()
+	{
+		if (m_bFinished)
+		{
+			return IsOpen();
+		}
+
+		m_bFinished = true;
+		if (!IsOpen())
+		{
+			return false;
+		}
+
+		if (m_writtenRowCount != m_dimensions.y)
+		{
+			DXRAY_WARN("{} is incomplete, {} of {} rows were written.", m_filePath.string(), m_writtenRowCount, m_dimensions.y);
+		}
+
+		if (m_fileExtension == Image::EFileExtension::png)
+		{
+			//A final empty stored block closes the deflate stream, the adler checksum closes the zlib stream.
+			std::vector<u8> streamEnd = { 0x01, 0x00, 0x00, 0xFF, 0xFF };
+			AppendBigEndian(streamEnd, m_pngAdler);
+			WritePngChunk("IDAT", streamEnd);
+			WritePngChunk("IEND", {});
+		}
+
+		m_file.close();
+		if (m_file.fail())
+		{
+			DXRAY_ERROR("Failed to store image: {}", m_filePath.string());
+			return false;
+		}
+
+		return true;
+	}
+
+	void ScanlineImageWriter::WriteHeader()
+	{
+		std::vector<u8> header;
+		switch (m_fileExtension)
+		{
+		case Image::EFileExtension::png:
+		{
+			m_file.write(reinterpret_cast<const char*>(PngSignature), sizeof(PngSignature));
+
+			//8 bit RGB, no interlacing.
+			std::vector<u8> imageHeader;
+			AppendBigEndian(imageHeader, m_dimensions.x);
+			AppendBigEndian(imageHeader, m_dimensions.y);
+			imageHeader.insert(imageHeader.end(), { 8, 2, 0, 0, 0 });
+			WritePngChunk("IHDR", imageHeader);
+
+			WritePngChunk("IDAT", std::vector<u8>(std::begin(ZlibHeader), std::end(ZlibHeader)));
+			return;
+		}
+		case Image::EFileExtension::exr:
+		{
+			constexpr i32 exrMagicNumber = 20000630;
+			constexpr i32 exrVersion = 2;	//Single part scanline file, no flags.
+			constexpr i32 exrPixelTypeHalf = 1;
+			constexpr i32 exrPixelTypeFloat = 2;
+			const i32 pixelType = m_bHalfPrecision ? exrPixelTypeHalf : exrPixelTypeFloat;
+			AppendBytes(header, exrMagicNumber);
+			AppendBytes(header, exrVersion);
+
+			//Channels are listed, and stored per scanline, in alphabetical order.
+			std::vector<u8> channelList;
+			for (const char* pChannelName : { "B", "G", "R" })
+			{
+				AppendString(channelList, pChannelName);
+				AppendBytes(channelList, pixelType);
+				AppendBytes(channelList, u32(0));	//Linear flag and reserved bytes.
+				AppendBytes(channelList, i32(1));	//Sampling in x.
+				AppendBytes(channelList, i32(1));	//Sampling in y.
+			}
+			channelList.push_back(0);
+
+			std::vector<u8> window;
+			AppendBytes(window, i32(0));
+			AppendBytes(window, i32(0));
+			AppendBytes(window, static_cast<i32>(m_dimensions.x) - 1);
+			AppendBytes(window, static_cast<i32>(m_dimensions.y) - 1);
+
+			std::vector<u8> screenWindowCenter;
+			AppendBytes(screenWindowCenter, 0.0f);
+			AppendBytes(screenWindowCenter, 0.0f);
+
+			std::vector<u8> unitFloat;
+			AppendBytes(unitFloat, 1.0f);
+
+			AppendExrAttribute(header, "channels", "chlist", channelList);
+			AppendExrAttribute(header, "compression", "compression", { 0 });	//No compression.
+			AppendExrAttribute(header, "dataWindow", "box2i", window);
+			AppendExrAttribute(header, "displayWindow", "box2i", window);
+			AppendExrAttribute(header, "lineOrder", "lineOrder", { 0 });		//Increasing y.
+			AppendExrAttribute(header, "pixelAspectRatio", "float", unitFloat);
+			AppendExrAttribute(header, "screenWindowCenter", "v2f", screenWindowCenter);
+			AppendExrAttribute(header, "screenWindowWidth", "float", unitFloat);
+			header.push_back(0);
+
+			//Uncompressed files store one scanline per block, all blocks have the same size so the offset table is known up front.
+			const usize channelSize = m_bHalfPrecision ? sizeof(u16) : sizeof(fp32);
+			const usize blockSize = sizeof(i32) * 2 + static_cast<usize>(m_dimensions.x) * 3 * channelSize;
+			const u64 firstBlockOffset = header.size() + static_cast<usize>(m_dimensions.y) * sizeof(u64);
+			for (u32 y = 0; y < m_dimensions.y; ++y)
+			{
+				AppendBytes(header, firstBlockOffset + static_cast<u64>(y) * blockSize);
+			}
+			break;
+		}
+		case Image::EFileExtension::pfm:
+		{
+			//Color format, dimensions and a negative scale which marks the data as little endian.
+			const String pfmHeader = std::format("PF\n{} {}\n-1.0\n", m_dimensions.x, m_dimensions.y);
+			header.assign(pfmHeader.begin(), pfmHeader.end());
+			m_headerSizeInBytes = header.size();
+			m_file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+
+			//Scanlines are stored from the bottom up, the file is sized up front so the rows can be written into place as they come in.
+			m_file.close();
+			std::error_code errorCode;
+			std::filesystem::resize_file(m_filePath, m_headerSizeInBytes + static_cast<usize>(m_dimensions.x) * m_dimensions.y * sizeof(Color), errorCode);
+			m_file.open(m_filePath, std::ios::binary | std::ios::in | std::ios::out);
+			if (errorCode)
+			{
+				m_file.setstate(std::ios::failbit);
+			}
+			return;
+		}
+		default:
+			return;
+		}
+
+		m_headerSizeInBytes = header.size();
+		m_file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+	}
+
+	void ScanlineImageWriter::WritePngRows(const Color* a_pRadiance, const u32 a_rowCount)
+	{
+		const usize rowSizeInBytes = static_cast<usize>(m_dimensions.x) * 3;
+		m_pixelBuffer.resize(rowSizeInBytes * a_rowCount);
+		for (u32 y = 0; y < a_rowCount; ++y)
+		{
+			EncodeDisplayPixels(a_pRadiance + static_cast<usize>(y) * m_dimensions.x, m_dimensions.x, &m_pixelBuffer[y * rowSizeInBytes], m_displayTransform);
+		}
+
+		//The filtered rows are appended to the tail of the previously written rows, which serves as dictionary for the deflate segment.
+		const usize dictionarySize = m_deflateHistory.size();
+		const usize filteredSize = (rowSizeInBytes + 1) * a_rowCount;
+		m_deflateHistory.resize(dictionarySize + filteredSize);
+		FilterPngRows(m_pixelBuffer.data(), m_previousRow.empty() ? nullptr : m_previousRow.data(), m_dimensions.x, 3, a_rowCount, &m_deflateHistory[dictionarySize]);
+		m_previousRow.assign(m_pixelBuffer.end() - rowSizeInBytes, m_pixelBuffer.end());
+		m_pngAdler = Adler32(&m_deflateHistory[dictionarySize], filteredSize, m_pngAdler);
+
+		//None of the segments is final as the stream is closed by Finish.
+		m_encodeBuffer.clear();
+		DeflateSegment(m_deflateHistory.data(), dictionarySize, filteredSize, false, m_encodeBuffer);
+		WritePngChunk("IDAT", m_encodeBuffer);
+
+		if (m_deflateHistory.size() > DeflateWindowSize)
+		{
+			m_deflateHistory.erase(m_deflateHistory.begin(), m_deflateHistory.end() - DeflateWindowSize);
+		}
+	}
+
+	void ScanlineImageWriter::WriteExrRows(const Color* a_pRadiance, const u32 a_rowCount)
+	{
+		const usize channelSize = m_bHalfPrecision ? sizeof(u16) : sizeof(fp32);
+		const i32 scanlineDataSize = static_cast<i32>(static_cast<usize>(m_dimensions.x) * 3 * channelSize);
+		m_encodeBuffer.clear();
+		m_encodeBuffer.reserve((sizeof(i32) * 2 + scanlineDataSize) * a_rowCount);
+		for (u32 y = 0; y < a_rowCount; ++y)
+		{
+			AppendBytes(m_encodeBuffer, static_cast<i32>(m_writtenRowCount + y));
+			AppendBytes(m_encodeBuffer, scanlineDataSize);
+			const Color* pRow = a_pRadiance + static_cast<usize>(y) * m_dimensions.x;
+			for (const u32 component : { 2u, 1u, 0u })
+			{
+				for (u32 x = 0; x < m_dimensions.x; ++x)
+				{
+					if (m_bHalfPrecision)
+					{
+						AppendBytes(m_encodeBuffer, vath::FloatToHalf(pRow[x][component]));
+					}
+					else
+					{
+						AppendBytes(m_encodeBuffer, pRow[x][component]);
+					}
+				}
+			}
+		}
+
+		m_file.write(reinterpret_cast<const char*>(m_encodeBuffer.data()), static_cast<std::streamsize>(m_encodeBuffer.size()));
+	}
+
+	void ScanlineImageWriter::WritePfmRows(const Color* a_pRadiance, const u32 a_rowCount)
+	{
+		const usize rowSizeInBytes = static_cast<usize>(m_dimensions.x) * sizeof(Color);
+		for (u32 y = 0; y < a_rowCount; ++y)
+		{
+			const usize fileRow = m_dimensions.y - 1 - (m_writtenRowCount + y);
+			m_file.seekp(static_cast<std::streamoff>(m_headerSizeInBytes + fileRow * rowSizeInBytes));
+			m_file.write(reinterpret_cast<const char*>(a_pRadiance + static_cast<usize>(y) * m_dimensions.x), static_cast<std::streamsize>(rowSizeInBytes));
+		}
+	}
+
+	void ScanlineImageWriter::WritePngChunk(const char a_type[4], const std::vector<u8>& a_data)
+	{
+		std::vector<u8> chunk;
+		chunk.reserve(a_data.size() + 12);
+		AppendPngChunk(chunk, a_type, a_data.data(), a_data.size());
+		m_file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+	}
+}
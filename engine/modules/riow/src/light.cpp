@@ -0,0 +1,362 @@
+#include "riow/light.h"
+#include "riow/traceable/sphere.h"
+#include "riow/sampler.h"
+
+namespace dxray::riow
+{
+	u32 LightList::Add(const SphereLight& a_light, const u32 a_traceableIndex, const u32 a_primitiveIndex)
+	{
+		const u32 lightIndex = static_cast<u32>(m_lights.size());
+		m_lights.push_back(a_light);
+
+		if (a_traceableIndex >= m_primitiveLights.size())
+		{
+			m_primitiveLights.resize(a_traceableIndex + 1);
+		}
+
+		std::vector<u32>& primitiveLights = m_primitiveLights[a_traceableIndex];
+		if (a_primitiveIndex >= primitiveLights.size())
+		{
+			primitiveLights.resize(a_primitiveIndex + 1, InvalidLightIndex);
+		}
+		primitiveLights[a_primitiveIndex] = lightIndex;
+		return lightIndex;
+	}
+
+	void LightList::Clear()
+	{
+		m_lights.clear();
+		m_nodes.clear();
+		m_lightTrails.clear();
+		m_primitiveLights.clear();
+		m_pEnvironment = nullptr;
+	}
+
+	void LightList::Build(const MaterialTable& a_materials, const TextureTable& a_textures, const EnvironmentLight* a_pEnvironment, const fp32 a_timeStart, const fp32 a_timeEnd)
+	{
+		//Every light keeps a small share of the power, so lights with dark centers of their texture are still sampled.
+		constexpr fp32 MinPowerFraction = 0.01f;
+
+		m_pEnvironment = a_pEnvironment;
+		m_nodes.clear();
+		m_lightTrails.assign(m_lights.size(), 0ull);
+		if (m_lights.empty())
+		{
+			return;
+		}
+
+		std::vector<BuildItem> items(m_lights.size());
+		fp32 maxPower = 0.0f;
+		for (u32 li = 0; li < static_cast<u32>(m_lights.size()); ++li)
+		{
+			const SphereLight& light = m_lights[li];
+			const vath::Vector3f extent(light.Radius);
+			BuildItem& item = items[li];
+			item.Bounds.Expand(light.GetCenter(a_timeStart) - extent);
+			item.Bounds.Expand(light.GetCenter(a_timeStart) + extent);
+			item.Bounds.Expand(light.GetCenter(a_timeEnd) - extent);
+			item.Bounds.Expand(light.GetCenter(a_timeEnd) + extent);
+			item.Center = item.Bounds.GetCenter();
+			item.LightIndex = li;
+
+			const Color emitted = a_materials.Emitted(light.Material, a_textures, vath::Vector2f(0.5f, 0.5f), light.Center);
+			item.Power = Luminance(emitted) * 4.0f * vath::Pi<fp32>() * light.Radius * light.Radius;
+			maxPower = vath::Max(maxPower, item.Power);
+		}
+
+		for (BuildItem& item : items)
+		{
+			item.Power = maxPower > 0.0f ? vath::Max(item.Power, MinPowerFraction * maxPower) : 1.0f;
+		}
+
+		m_nodes.reserve(items.size() * 2 - 1);
+		BuildRecursive(items, 0, static_cast<u32>(items.size()), 0, 0ull);
+	}
+
+	u32 LightList::BuildRecursive(std::vector<BuildItem>& a_items, const u32 a_begin, const u32 a_end, const u32 a_depth, const u64 a_trail)
+	{
+		static constexpr u32 SplitBinCount = 12;
+
+		const u32 nodeIndex = static_cast<u32>(m_nodes.size());
+		m_nodes.emplace_back();
+
+		BoundingBox bounds;
+		BoundingBox centerBounds;
+		fp32 power = 0.0f;
+		for (u32 i = a_begin; i < a_end; ++i)
+		{
+			bounds.Expand(a_items[i].Bounds);
+			centerBounds.Expand(a_items[i].Center);
+			power += a_items[i].Power;
+		}
+
+		m_nodes[nodeIndex].Center = bounds.GetCenter();
+		m_nodes[nodeIndex].RadiusSquared = vath::SqrMagnitude(bounds.Max - bounds.Min) * 0.25f;
+		m_nodes[nodeIndex].Power = power;
+		const u32 count = a_end - a_begin;
+		if (count == 1)
+		{
+			m_nodes[nodeIndex].Index = a_items[a_begin].LightIndex;
+			m_nodes[nodeIndex].bLeaf = true;
+			m_lightTrails[a_items[a_begin].LightIndex] = a_trail;
+			return nodeIndex;
+		}
+
+		//Split along the axis with the largest center extent, at the bin boundary that minimizes the power weighted surface area.
+		//Deep nodes split at the median, which bounds the depth of the remaining levels by the log of the light count.
+		const vath::Vector3f centerExtent = centerBounds.Max - centerBounds.Min;
+		const u32 axis = centerExtent.x > centerExtent.y && centerExtent.x > centerExtent.z ? 0 : (centerExtent.y > centerExtent.z ? 1 : 2);
+		u32 middle = a_begin;
+		if (centerExtent[axis] > 0.0f && a_depth + 32 < MaxHierarchyDepth)
+		{
+			struct Bin final
+			{
+				BoundingBox Bounds;
+				fp32 Power = 0.0f;
+				u32 Count = 0;
+			};
+
+			Bin bins[SplitBinCount];
+			const fp32 binScale = SplitBinCount / centerExtent[axis];
+			auto GetBinIndex = [&](const BuildItem& a_item)
+			{
+				const u32 bin = static_cast<u32>((a_item.Center[axis] - centerBounds.Min[axis]) * binScale);
+				return vath::Min(bin, SplitBinCount - 1);
+			};
+
+			for (u32 i = a_begin; i < a_end; ++i)
+			{
+				Bin& bin = bins[GetBinIndex(a_items[i])];
+				bin.Bounds.Expand(a_items[i].Bounds);
+				bin.Power += a_items[i].Power;
+				bin.Count++;
+			}
+
+			fp32 rightCosts[SplitBinCount] = {};
+			Bin right;
+			for (u32 b = SplitBinCount - 1; b > 0; --b)
+			{
+				right.Bounds.Expand(bins[b].Bounds);
+				right.Power += bins[b].Power;
+				right.Count += bins[b].Count;
+				rightCosts[b] = right.Count > 0 ? right.Bounds.GetSurfaceArea() * right.Power : 0.0f;
+			}
+
+			fp32 bestCost = fp32max;
+			u32 bestSplit = 1;
+			Bin left;
+			for (u32 b = 1; b < SplitBinCount; ++b)
+			{
+				left.Bounds.Expand(bins[b - 1].Bounds);
+				left.Power += bins[b - 1].Power;
+				left.Count += bins[b - 1].Count;
+				const fp32 cost = (left.Count > 0 ? left.Bounds.GetSurfaceArea() * left.Power : 0.0f) + rightCosts[b];
+				if (left.Count > 0 && left.Count < count && cost < bestCost)
+				{
+					bestCost = cost;
+					bestSplit = b;
+				}
+			}
+
+			BuildItem* const pMiddle = std::partition(a_items.data() + a_begin, a_items.data() + a_end, [&](const BuildItem& a_item)
+			{
+				return GetBinIndex(a_item) < bestSplit;
+			});
+			middle = static_cast<u32>(pMiddle - a_items.data());
+		}
+
+		//All centers ended up on one side, fall back to a median split.
+		if (middle == a_begin || middle == a_end)
+		{
+			middle = a_begin + count / 2;
+			std::nth_element(a_items.begin() + a_begin, a_items.begin() + middle, a_items.begin() + a_end, [axis](const BuildItem& a_lhs, const BuildItem& a_rhs)
+			{
+				return a_lhs.Center[axis] < a_rhs.Center[axis];
+			});
+		}
+
+		DXRAY_ASSERT(a_depth < MaxHierarchyDepth);
+		BuildRecursive(a_items, a_begin, middle, a_depth + 1, a_trail);
+		const u32 rightChild = BuildRecursive(a_items, middle, a_end, a_depth + 1, a_trail | (1ull << a_depth));
+		m_nodes[nodeIndex].Index = rightChild;
+		return nodeIndex;
+	}
+
+	bool LightList::Sample(const vath::Vector3f& a_point, const fp32 a_time, const MaterialTable& a_materials, const TextureTable& a_textures, LightSample& a_sample) const
+	{
+		const fp32 environmentProbability = GetEnvironmentSelectionProbability();
+		if (environmentProbability > 0.0f && RandomFloat() < environmentProbability)
+		{
+			if (!m_pEnvironment->Sample(a_sample.Direction, a_sample.Radiance, a_sample.Pdf))
+			{
+				return false;
+			}
+
+			a_sample.Distance = fp32max;
+			a_sample.Pdf *= environmentProbability;
+			a_sample.Point = LightPoint{ a_sample.Direction, vath::Vector2f(0.0f), InvalidLightIndex };
+			return true;
+		}
+
+		if (m_lights.empty())
+		{
+			return false;
+		}
+
+		DXRAY_ASSERT_WITH_MSG(!m_nodes.empty(), "The light list has to be built before sampling.");
+		u32 nodeIndex = 0;
+		fp32 selectionPdf = 1.0f - environmentProbability;
+		while (!m_nodes[nodeIndex].bLeaf)
+		{
+			const fp32 leftProbability = GetLeftProbability(nodeIndex, a_point);
+			if (RandomFloat() < leftProbability)
+			{
+				selectionPdf *= leftProbability;
+				nodeIndex = nodeIndex + 1;
+			}
+			else
+			{
+				selectionPdf *= 1.0f - leftProbability;
+				nodeIndex = m_nodes[nodeIndex].Index;
+			}
+		}
+
+		const u32 lightIndex = m_nodes[nodeIndex].Index;
+		const SphereLight& light = m_lights[lightIndex];
+		const fp32 oneMinusCosAngle = GetConeOneMinusCosAngle(light, a_point, a_time);
+		if (oneMinusCosAngle <= 0.0f || selectionPdf <= 0.0f)
+		{
+			return false;
+		}
+
+		const vath::Vector2f coneSample(RandomFloat(), RandomFloat());
+		SampleCone(light, a_point, a_time, oneMinusCosAngle, coneSample, a_materials, a_textures, a_sample);
+		a_sample.Pdf = selectionPdf * vath::UniformConePdf(oneMinusCosAngle);
+		a_sample.Point = LightPoint{ vath::Vector3f(0.0f), coneSample, lightIndex };
+		return true;
+	}
+
+	fp32 LightList::GetPdf(const u32 a_lightIndex, const vath::Vector3f& a_point, const fp32 a_time) const
+	{
+		DXRAY_ASSERT(a_lightIndex < m_lightTrails.size());
+		const fp32 oneMinusCosAngle = GetConeOneMinusCosAngle(m_lights[a_lightIndex], a_point, a_time);
+		if (oneMinusCosAngle <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		//Retraces the choices that lead from the root to the light.
+		const u64 trail = m_lightTrails[a_lightIndex];
+		u32 nodeIndex = 0;
+		fp32 selectionPdf = 1.0f - GetEnvironmentSelectionProbability();
+		for (u32 depth = 0; !m_nodes[nodeIndex].bLeaf; ++depth)
+		{
+			const fp32 leftProbability = GetLeftProbability(nodeIndex, a_point);
+			if ((trail >> depth) & 1ull)
+			{
+				selectionPdf *= 1.0f - leftProbability;
+				nodeIndex = m_nodes[nodeIndex].Index;
+			}
+			else
+			{
+				selectionPdf *= leftProbability;
+				nodeIndex = nodeIndex + 1;
+			}
+		}
+
+		DXRAY_ASSERT(m_nodes[nodeIndex].Index == a_lightIndex);
+		return selectionPdf * vath::UniformConePdf(oneMinusCosAngle);
+	}
+
+	fp32 LightList::GetEnvironmentPdf(const vath::Vector3f& a_direction) const
+	{
+		return m_pEnvironment == nullptr ? 0.0f : GetEnvironmentSelectionProbability() * m_pEnvironment->GetPdf(a_direction);
+	}
+
+	fp32 LightList::GetLightPointJacobian(const LightPoint& a_lightPoint, const vath::Vector3f& a_point, const fp32 a_time) const
+	{
+		if (a_lightPoint.LightIndex == InvalidLightIndex)
+		{
+			return 1.0f;
+		}
+
+		const fp32 oneMinusCosAngle = GetConeOneMinusCosAngle(GetLight(a_lightPoint.LightIndex), a_point, a_time);
+		return oneMinusCosAngle > 0.0f ? 1.0f / vath::UniformConePdf(oneMinusCosAngle) : 0.0f;
+	}
+
+	fp32 LightList::EvaluateLightPoint(const LightPoint& a_lightPoint, const vath::Vector3f& a_point, const fp32 a_time, const MaterialTable& a_materials, const TextureTable& a_textures,
+		LightSample& a_sample) const
+	{
+		a_sample.Pdf = 0.0f;
+		a_sample.Point = a_lightPoint;
+		if (a_lightPoint.LightIndex == InvalidLightIndex)
+		{
+			if (m_pEnvironment == nullptr)
+			{
+				return 0.0f;
+			}
+
+			a_sample.Direction = a_lightPoint.Direction;
+			a_sample.Distance = fp32max;
+			a_sample.Radiance = m_pEnvironment->Evaluate(a_lightPoint.Direction);
+			return 1.0f;
+		}
+
+		const SphereLight& light = GetLight(a_lightPoint.LightIndex);
+		const fp32 oneMinusCosAngle = GetConeOneMinusCosAngle(light, a_point, a_time);
+		if (oneMinusCosAngle <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		SampleCone(light, a_point, a_time, oneMinusCosAngle, a_lightPoint.ConeSample, a_materials, a_textures, a_sample);
+		return 1.0f / vath::UniformConePdf(oneMinusCosAngle);
+	}
+
+	fp32 LightList::GetImportance(const Node& a_node, const vath::Vector3f& a_point)
+	{
+		const fp32 distanceSquared = vath::Max(vath::SqrMagnitude(a_point - a_node.Center), a_node.RadiusSquared);
+		return a_node.Power / distanceSquared;
+	}
+
+	fp32 LightList::GetLeftProbability(const u32 a_nodeIndex, const vath::Vector3f& a_point) const
+	{
+		const fp32 leftImportance = GetImportance(m_nodes[a_nodeIndex + 1], a_point);
+		const fp32 rightImportance = GetImportance(m_nodes[m_nodes[a_nodeIndex].Index], a_point);
+		const fp32 importanceSum = leftImportance + rightImportance;
+		return importanceSum > 0.0f ? leftImportance / importanceSum : 0.5f;
+	}
+
+	fp32 LightList::GetConeOneMinusCosAngle(const SphereLight& a_light, const vath::Vector3f& a_point, const fp32 a_time)
+	{
+		const fp32 centerDistanceSquared = vath::SqrMagnitude(a_light.GetCenter(a_time) - a_point);
+		return vath::SphereConeOneMinusCos(centerDistanceSquared, a_light.Radius * a_light.Radius);
+	}
+
+	void LightList::SampleCone(const SphereLight& a_light, const vath::Vector3f& a_point, const fp32 a_time, const fp32 a_oneMinusCosAngle, const vath::Vector2f& a_coneSample,
+		const MaterialTable& a_materials, const TextureTable& a_textures, LightSample& a_sample)
+	{
+		//Uniform direction within the cone around the direction towards the center.
+		const vath::Vector3f toCenter = a_light.GetCenter(a_time) - a_point;
+		const fp32 centerDistance = vath::Magnitude(toCenter);
+		const vath::Vector3f localDirection = vath::SquareToUniformCone(a_coneSample, a_oneMinusCosAngle);
+		a_sample.Direction = vath::OrthonormalBasis<fp32>(toCenter / centerDistance).ToWorld(localDirection);
+		const fp32 cosTheta = localDirection.z;
+		const fp32 sinThetaSquared = localDirection.x * localDirection.x + localDirection.y * localDirection.y;
+
+		//Nearest intersection of the direction with the sphere, directions on the border of the cone touch it.
+		const fp32 projectedRadiusSquared = a_light.Radius * a_light.Radius - centerDistance * centerDistance * sinThetaSquared;
+		a_sample.Distance = centerDistance * cosTheta - std::sqrt(vath::Max(0.0f, projectedRadiusSquared));
+
+		const vath::Vector3f lightPoint = a_point + a_sample.Direction * a_sample.Distance;
+		const vath::Vector2f uv = Sphere::PointToUv((lightPoint - a_light.GetCenter(a_time)) / a_light.Radius);
+		a_sample.Radiance = a_materials.Emitted(a_light.Material, a_textures, uv, lightPoint);
+	}
+
+	fp32 PowerHeuristic(const fp32 a_pdf, const fp32 a_otherPdf)
+	{
+		const fp32 pdfSquared = a_pdf * a_pdf;
+		const fp32 sum = pdfSquared + a_otherPdf * a_otherPdf;
+		return sum > 0.0f ? pdfSquared / sum : 0.0f;
+	}
+}
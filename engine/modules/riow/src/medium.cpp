@@ -0,0 +1,295 @@
+#include "riow/medium.h"
+#include "riow/sampler.h"
+
+namespace dxray::riow
+{
+	MediumDensity MediumDensity::Constant(const fp32 a_density)
+	{
+		DXRAY_ASSERT(a_density >= 0.0f);
+		MediumDensity medium;
+		medium.m_constantDensity = a_density;
+		return medium;
+	}
+
+	MediumDensity MediumDensity::Grid(const BoundingBox& a_bounds, const vath::Vector3u32& a_resolution, std::vector<fp32> a_densities, const fp32 a_densityScale /*= 1.0f*/, const u32 a_majorantCellSize /*= 8*/)
+	{
+		DXRAY_ASSERT(a_bounds.IsValid() && a_resolution.x > 0 && a_resolution.y > 0 && a_resolution.z > 0 && a_majorantCellSize > 0);
+		DXRAY_ASSERT(a_densities.size() == static_cast<usize>(a_resolution.x) * a_resolution.y * a_resolution.z);
+
+		std::shared_ptr<DensityGrid> grid = std::make_shared<DensityGrid>();
+		grid->Bounds = a_bounds;
+		grid->Resolution = a_resolution;
+		grid->Densities = std::move(a_densities);
+		for (fp32& density : grid->Densities)
+		{
+			density = vath::Max(density, 0.0f) * a_densityScale;
+		}
+
+		const vath::Vector3f extent = a_bounds.Max - a_bounds.Min;
+		for (u32 axis = 0; axis < 3; ++axis)
+		{
+			grid->MajorantResolution[axis] = (a_resolution[axis] + a_majorantCellSize - 1) / a_majorantCellSize;
+			grid->VoxelSize[axis] = extent[axis] / static_cast<fp32>(a_resolution[axis]);
+			grid->MajorantCellSize[axis] = grid->VoxelSize[axis] * static_cast<fp32>(a_majorantCellSize);
+		}
+
+		//Interpolation blends a voxel with its neighbours, so the majorant of a cell covers the voxels one beyond its border as well.
+		const vath::Vector3u32& majorantResolution = grid->MajorantResolution;
+		grid->Majorants.resize(static_cast<usize>(majorantResolution.x) * majorantResolution.y * majorantResolution.z);
+		for (u32 cz = 0; cz < majorantResolution.z; ++cz)
+		{
+			for (u32 cy = 0; cy < majorantResolution.y; ++cy)
+			{
+				for (u32 cx = 0; cx < majorantResolution.x; ++cx)
+				{
+					const vath::Vector3u32 cell(cx, cy, cz);
+					vath::Vector3u32 voxelStart;
+					vath::Vector3u32 voxelEnd;
+					for (u32 axis = 0; axis < 3; ++axis)
+					{
+						voxelStart[axis] = cell[axis] * a_majorantCellSize > 0 ? cell[axis] * a_majorantCellSize - 1 : 0;
+						voxelEnd[axis] = vath::Min((cell[axis] + 1) * a_majorantCellSize, a_resolution[axis] - 1);
+					}
+
+					fp32 majorant = 0.0f;
+					for (u32 z = voxelStart.z; z <= voxelEnd.z; ++z)
+					{
+						for (u32 y = voxelStart.y; y <= voxelEnd.y; ++y)
+						{
+							for (u32 x = voxelStart.x; x <= voxelEnd.x; ++x)
+							{
+								majorant = vath::Max(majorant, grid->Densities[x + a_resolution.x * (y + static_cast<usize>(a_resolution.y) * z)]);
+							}
+						}
+					}
+
+					grid->Majorants[cx + majorantResolution.x * (cy + static_cast<usize>(majorantResolution.y) * cz)] = majorant;
+				}
+			}
+		}
+
+		MediumDensity medium;
+		medium.m_grid = std::move(grid);
+		return medium;
+	}
+
+	bool MediumDensity::SampleCollision(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, fp32& a_tCollision, u32& a_stepCount) const
+	{
+		//Ray directions are not normalized, the rates below are per unit of t.
+		const fp32 directionMagnitude = vath::Magnitude(a_ray.GetDirection());
+		if (IsHomogeneous())
+		{
+			++a_stepCount;
+			if (m_constantDensity <= 0.0f)
+			{
+				return false;
+			}
+
+			a_tCollision = a_tMin - std::log(1.0f - RandomFloat()) / (m_constantDensity * directionMagnitude);
+			return a_tCollision < a_tMax;
+		}
+
+		bool bCollided = false;
+		TraverseMajorants(a_ray, a_tMin, a_tMax, [&](const fp32 a_tCellStart, const fp32 a_tCellEnd, const fp32 a_majorant)
+		{
+			if (a_majorant <= 0.0f)
+			{
+				return true;
+			}
+
+			//Tentative collisions are sampled against the majorant, a collision is real with the probability density / majorant.
+			const fp32 majorantPerT = a_majorant * directionMagnitude;
+			fp32 t = a_tCellStart;
+			while (true)
+			{
+				t -= std::log(1.0f - RandomFloat()) / majorantPerT;
+				if (t >= a_tCellEnd)
+				{
+					return true;
+				}
+
+				++a_stepCount;
+				if (RandomFloat() * a_majorant < GetDensity(a_ray.At(t)))
+				{
+					a_tCollision = t;
+					bCollided = true;
+					return false;
+				}
+			}
+		});
+
+		return bCollided;
+	}
+
+	fp32 MediumDensity::EstimateTransmittance(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, u32& a_stepCount) const
+	{
+		const fp32 directionMagnitude = vath::Magnitude(a_ray.GetDirection());
+		if (IsHomogeneous())
+		{
+			return std::exp(-m_constantDensity * directionMagnitude * (a_tMax - a_tMin));
+		}
+
+		fp32 transmittance = 1.0f;
+		TraverseMajorants(a_ray, a_tMin, a_tMax, [&](const fp32 a_tCellStart, const fp32 a_tCellEnd, const fp32 a_majorant)
+		{
+			if (a_majorant <= 0.0f)
+			{
+				return true;
+			}
+
+			//Every tentative collision weighs the estimate by the probability of it being a null collision.
+			const fp32 majorantPerT = a_majorant * directionMagnitude;
+			fp32 t = a_tCellStart;
+			while (true)
+			{
+				t -= std::log(1.0f - RandomFloat()) / majorantPerT;
+				if (t >= a_tCellEnd)
+				{
+					return true;
+				}
+
+				++a_stepCount;
+				transmittance *= 1.0f - GetDensity(a_ray.At(t)) / a_majorant;
+
+				//Russian roulette on low estimates keeps the estimate unbiased while bounding the steps through thick media.
+				constexpr fp32 rouletteThreshold = 0.1f;
+				constexpr fp32 rouletteSurvival = 0.25f;
+				if (transmittance < rouletteThreshold)
+				{
+					if (RandomFloat() >= rouletteSurvival)
+					{
+						transmittance = 0.0f;
+						return false;
+					}
+
+					transmittance /= rouletteSurvival;
+				}
+			}
+		});
+
+		return transmittance;
+	}
+
+	fp32 MediumDensity::GetDensity(const vath::Vector3f& a_point) const
+	{
+		if (IsHomogeneous())
+		{
+			return m_constantDensity;
+		}
+
+		const DensityGrid& grid = *m_grid;
+		if (a_point.x < grid.Bounds.Min.x || a_point.y < grid.Bounds.Min.y || a_point.z < grid.Bounds.Min.z ||
+			a_point.x > grid.Bounds.Max.x || a_point.y > grid.Bounds.Max.y || a_point.z > grid.Bounds.Max.z)
+		{
+			return 0.0f;
+		}
+
+		//Voxel values sit at the voxel centers, lookups beyond the outer centers clamp to the border voxels.
+		i32 voxels[2][3];
+		fp32 weights[3];
+		for (u32 axis = 0; axis < 3; ++axis)
+		{
+			const fp32 gridCoordinate = (a_point[axis] - grid.Bounds.Min[axis]) / grid.VoxelSize[axis] - 0.5f;
+			const fp32 flooredCoordinate = std::floor(gridCoordinate);
+			const i32 lastVoxel = static_cast<i32>(grid.Resolution[axis]) - 1;
+			voxels[0][axis] = vath::Clamp<i32>(static_cast<i32>(flooredCoordinate), 0, lastVoxel);
+			voxels[1][axis] = vath::Clamp<i32>(static_cast<i32>(flooredCoordinate) + 1, 0, lastVoxel);
+			weights[axis] = gridCoordinate - flooredCoordinate;
+		}
+
+		fp32 density = 0.0f;
+		for (u32 corner = 0; corner < 8; ++corner)
+		{
+			const u32 ix = corner & 1;
+			const u32 iy = (corner >> 1) & 1;
+			const u32 iz = corner >> 2;
+			const fp32 weight = (ix ? weights[0] : 1.0f - weights[0]) * (iy ? weights[1] : 1.0f - weights[1]) * (iz ? weights[2] : 1.0f - weights[2]);
+			density += weight * grid.Densities[voxels[ix][0] + grid.Resolution.x * (voxels[iy][1] + static_cast<usize>(grid.Resolution.y) * voxels[iz][2])];
+		}
+
+		return density;
+	}
+
+	template<typename TVisitor>
+	void MediumDensity::TraverseMajorants(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, const TVisitor& a_visitor) const
+	{
+		const DensityGrid& grid = *m_grid;
+		const vath::Vector3f& origin = a_ray.GetOrigin();
+		const vath::Vector3f& direction = a_ray.GetDirection();
+
+		//Clip the ray to the grid, comparisons are ordered so a NaN from an axis parallel ray keeps the current interval.
+		fp32 tStart = a_tMin;
+		fp32 tEnd = a_tMax;
+		for (u32 axis = 0; axis < 3; ++axis)
+		{
+			const fp32 inverseDirection = 1.0f / direction[axis];
+			fp32 t0 = (grid.Bounds.Min[axis] - origin[axis]) * inverseDirection;
+			fp32 t1 = (grid.Bounds.Max[axis] - origin[axis]) * inverseDirection;
+			if (inverseDirection < 0.0f)
+			{
+				std::swap(t0, t1);
+			}
+
+			tStart = t0 > tStart ? t0 : tStart;
+			tEnd = t1 < tEnd ? t1 : tEnd;
+		}
+
+		if (tStart >= tEnd)
+		{
+			return;
+		}
+
+		//3D DDA over the majorant cells, starting at the cell of the entry point.
+		const vath::Vector3f entryPoint = a_ray.At(tStart) - grid.Bounds.Min;
+		i32 cell[3];
+		i32 cellStep[3];
+		fp32 tNextCrossing[3];
+		fp32 tCellCrossing[3];
+		for (u32 axis = 0; axis < 3; ++axis)
+		{
+			const fp32 cellSize = grid.MajorantCellSize[axis];
+			cell[axis] = vath::Clamp<i32>(static_cast<i32>(entryPoint[axis] / cellSize), 0, static_cast<i32>(grid.MajorantResolution[axis]) - 1);
+			if (direction[axis] > 0.0f)
+			{
+				cellStep[axis] = 1;
+				tNextCrossing[axis] = tStart + ((cell[axis] + 1) * cellSize - entryPoint[axis]) / direction[axis];
+				tCellCrossing[axis] = cellSize / direction[axis];
+			}
+			else if (direction[axis] < 0.0f)
+			{
+				cellStep[axis] = -1;
+				tNextCrossing[axis] = tStart + (cell[axis] * cellSize - entryPoint[axis]) / direction[axis];
+				tCellCrossing[axis] = -cellSize / direction[axis];
+			}
+			else
+			{
+				cellStep[axis] = 0;
+				tNextCrossing[axis] = fp32max;
+				tCellCrossing[axis] = fp32max;
+			}
+		}
+
+		fp32 tCellStart = tStart;
+		while (true)
+		{
+			const u32 crossingAxis = tNextCrossing[0] < tNextCrossing[1]
+				? (tNextCrossing[0] < tNextCrossing[2] ? 0 : 2)
+				: (tNextCrossing[1] < tNextCrossing[2] ? 1 : 2);
+			const fp32 tCellEnd = vath::Min(tNextCrossing[crossingAxis], tEnd);
+			const fp32 majorant = grid.Majorants[cell[0] + grid.MajorantResolution.x * (cell[1] + static_cast<usize>(grid.MajorantResolution.y) * cell[2])];
+			if (!a_visitor(tCellStart, tCellEnd, majorant) || tCellEnd >= tEnd)
+			{
+				return;
+			}
+
+			cell[crossingAxis] += cellStep[crossingAxis];
+			if (cell[crossingAxis] < 0 || cell[crossingAxis] >= static_cast<i32>(grid.MajorantResolution[crossingAxis]))
+			{
+				return;
+			}
+
+			tCellStart = tCellEnd;
+			tNextCrossing[crossingAxis] += tCellCrossing[crossingAxis];
+		}
+	}
+}
@@ -0,0 +1,225 @@
+#include "riow/mipTexture.h"
+#include "riow/texture.h"
+#include <stb/stbImageLoad.h>
+
+namespace dxray::riow
+{
+	static constexpr u32 TexelChannelCount = 3;
+
+	//--- Texel conversion ---
+
+	/// <summary>
+	/// 8 bit sRGB to linear lookup table, decoding happens once at load time.
+	/// </summary>
+	static const std::array<fp32, 256>& GetSrgbDecodeTable()
+	{
+		static const std::array<fp32, 256> decodeTable = []()
+		{
+			std::array<fp32, 256> table;
+			for (u32 i = 0; i < table.size(); ++i)
+			{
+				table[i] = SrgbToLinear(Color(static_cast<fp32>(i) / 255.0f)).x;
+			}
+
+			return table;
+		}();
+
+		return decodeTable;
+	}
+
+
+	//--- MipTexture ---
+
+	MipTexture::MipTexture(const vath::Vector2u32& a_dimensions, const std::vector<Color>& a_linearTexels, const ETexelFormat a_format /*= ETexelFormat::Float16*/, const EFilter a_filter /*= EFilter::Trilinear*/) :
+		m_filter(a_filter)
+	{
+		DXRAY_ASSERT(a_dimensions.x > 0 && a_dimensions.y > 0);
+		DXRAY_ASSERT(a_linearTexels.size() == static_cast<usize>(a_dimensions.x) * a_dimensions.y);
+
+		std::shared_ptr<MipPyramid> pyramid = std::make_shared<MipPyramid>();
+		pyramid->Format = a_format;
+
+		//Level 0 is a copy of the source, every following level is a 2x2 box filtered version of the previous one.
+		//#Note: Odd dimensions drop the last row or column of the previous level, which is not noticeable on textures of practical size.
+		std::vector<fp32> texels;
+		texels.reserve(a_linearTexels.size() * TexelChannelCount * 4 / 3 + TexelChannelCount * 32);
+		for (const Color& texel : a_linearTexels)
+		{
+			texels.push_back(texel.x);
+			texels.push_back(texel.y);
+			texels.push_back(texel.z);
+		}
+
+		pyramid->Levels.push_back(MipLevel{ a_dimensions.x, a_dimensions.y, 0 });
+		while (pyramid->Levels.back().Width > 1 || pyramid->Levels.back().Height > 1)
+		{
+			const MipLevel source = pyramid->Levels.back();
+			const MipLevel level{ vath::Max(source.Width / 2, 1u), vath::Max(source.Height / 2, 1u), texels.size() };
+			texels.resize(texels.size() + static_cast<usize>(level.Width) * level.Height * TexelChannelCount);
+
+			for (u32 y = 0; y < level.Height; ++y)
+			{
+				const u32 sourceY0 = vath::Min(y * 2, source.Height - 1);
+				const u32 sourceY1 = vath::Min(y * 2 + 1, source.Height - 1);
+				for (u32 x = 0; x < level.Width; ++x)
+				{
+					const u32 sourceX0 = vath::Min(x * 2, source.Width - 1);
+					const u32 sourceX1 = vath::Min(x * 2 + 1, source.Width - 1);
+					const usize texelIndex = level.Offset + (static_cast<usize>(y) * level.Width + x) * TexelChannelCount;
+					for (u32 ci = 0; ci < TexelChannelCount; ++ci)
+					{
+						const fp32 sum =
+							texels[source.Offset + (static_cast<usize>(sourceY0) * source.Width + sourceX0) * TexelChannelCount + ci] +
+							texels[source.Offset + (static_cast<usize>(sourceY0) * source.Width + sourceX1) * TexelChannelCount + ci] +
+							texels[source.Offset + (static_cast<usize>(sourceY1) * source.Width + sourceX0) * TexelChannelCount + ci] +
+							texels[source.Offset + (static_cast<usize>(sourceY1) * source.Width + sourceX1) * TexelChannelCount + ci];
+						texels[texelIndex + ci] = sum * 0.25f;
+					}
+				}
+			}
+
+			pyramid->Levels.push_back(level);
+		}
+
+		if (a_format == ETexelFormat::Float16)
+		{
+			pyramid->Texels16.resize(texels.size());
+			for (usize i = 0; i < texels.size(); ++i)
+			{
+				pyramid->Texels16[i] = vath::FloatToHalf(texels[i]);
+			}
+		}
+		else
+		{
+			pyramid->Texels32 = std::move(texels);
+		}
+
+		m_pyramid = std::move(pyramid);
+	}
+
+	MipTexture MipTexture::LoadFromFile(const Path& a_path, const Image::ELoadOptions a_loadFlags, const bool a_bSrgb /*= true*/, const ETexelFormat a_format /*= ETexelFormat::Float16*/, const EFilter a_filter /*= EFilter::Trilinear*/)
+	{
+		const String pathString = a_path.string();
+		stbi_set_flip_vertically_on_load((a_loadFlags & Image::ELoadOptions::FlipVertically) != 0);
+
+		vath::Vector2i32 dimensions(0, 0);
+		i32 fileChannelCount = 0;
+		std::vector<Color> texels;
+
+		if (stbi_is_hdr(pathString.c_str()))
+		{
+			fp32* pData = stbi_loadf(pathString.c_str(), &dimensions.x, &dimensions.y, &fileChannelCount, TexelChannelCount);
+			if (pData != nullptr)
+			{
+				texels.resize(static_cast<usize>(dimensions.x) * dimensions.y);
+				for (usize ti = 0; ti < texels.size(); ++ti)
+				{
+					texels[ti] = Color(pData[ti * TexelChannelCount], pData[ti * TexelChannelCount + 1], pData[ti * TexelChannelCount + 2]);
+				}
+
+				stbi_image_free(pData);
+			}
+		}
+		else
+		{
+			u8* pData = stbi_load(pathString.c_str(), &dimensions.x, &dimensions.y, &fileChannelCount, TexelChannelCount);
+			if (pData != nullptr)
+			{
+				const std::array<fp32, 256>& srgbDecodeTable = GetSrgbDecodeTable();
+				const fp32 unitColorReciprocal = 1.0f / 255.0f;
+
+				texels.resize(static_cast<usize>(dimensions.x) * dimensions.y);
+				for (usize ti = 0; ti < texels.size(); ++ti)
+				{
+					const u8* pTexel = &pData[ti * TexelChannelCount];
+					texels[ti] = a_bSrgb
+						? Color(srgbDecodeTable[pTexel[0]], srgbDecodeTable[pTexel[1]], srgbDecodeTable[pTexel[2]])
+						: Color(pTexel[0] * unitColorReciprocal, pTexel[1] * unitColorReciprocal, pTexel[2] * unitColorReciprocal);
+				}
+
+				stbi_image_free(pData);
+			}
+		}
+
+		if (texels.empty())
+		{
+			DXRAY_ERROR("Failed to load texture: {}", pathString.c_str());
+			return MipTexture(vath::Vector2u32(1, 1), { InvalidTexture }, a_format, a_filter);
+		}
+
+		MipTexture texture(vath::Vector2u32(dimensions.x, dimensions.y), texels, a_format, a_filter);
+		DXRAY_INFO("Successfully loaded: {} ({}x{}, {} mip levels)", pathString.c_str(), dimensions.x, dimensions.y, texture.GetLevelCount());
+		return texture;
+	}
+
+	Color MipTexture::Sample(const vath::Vector2f& a_uvCoord, const fp32 a_uvFootprint) const
+	{
+		const MipPyramid& pyramid = *m_pyramid;
+		const MipLevel& baseLevel = pyramid.Levels[0];
+
+		//The level whose texels match the footprint, log2 of the footprint measured in texels of the finest level.
+		const fp32 footprintInTexels = a_uvFootprint * static_cast<fp32>(vath::Max(baseLevel.Width, baseLevel.Height));
+		const fp32 maxLod = static_cast<fp32>(pyramid.Levels.size() - 1);
+		const fp32 lod = footprintInTexels > 1.0f ? vath::Min(std::log2(footprintInTexels), maxLod) : 0.0f;
+
+		if (m_filter == EFilter::Bilinear)
+		{
+			return SampleBilinear(pyramid, static_cast<u32>(lod + 0.5f), a_uvCoord);
+		}
+
+		const u32 fineLevel = static_cast<u32>(lod);
+		const fp32 levelBlend = lod - static_cast<fp32>(fineLevel);
+		const Color fineColor = SampleBilinear(pyramid, fineLevel, a_uvCoord);
+		if (levelBlend <= 0.0f)
+		{
+			return fineColor;
+		}
+
+		const Color coarseColor = SampleBilinear(pyramid, fineLevel + 1, a_uvCoord);
+		return fineColor + (coarseColor - fineColor) * levelBlend;
+	}
+
+	Color MipTexture::ReadTexel(const u32 a_level, const i32 a_x, const i32 a_y) const
+	{
+		const MipLevel& level = m_pyramid->Levels[a_level];
+		return ReadTexel(*m_pyramid, level,
+			static_cast<u32>(vath::Clamp<i32>(a_x, 0, level.Width - 1)),
+			static_cast<u32>(vath::Clamp<i32>(a_y, 0, level.Height - 1))
+		);
+	}
+
+	Color MipTexture::SampleBilinear(const MipPyramid& a_pyramid, const u32 a_level, const vath::Vector2f& a_uvCoord) const
+	{
+		const MipLevel& level = a_pyramid.Levels[a_level];
+
+		//Texel centers sit at half texel offsets.
+		const fp32 x = vath::Clamp<fp32>(a_uvCoord.x, 0.0f, 1.0f) * level.Width - 0.5f;
+		const fp32 y = vath::Clamp<fp32>(a_uvCoord.y, 0.0f, 1.0f) * level.Height - 0.5f;
+		const fp32 floorX = std::floor(x);
+		const fp32 floorY = std::floor(y);
+		const fp32 tx = x - floorX;
+		const fp32 ty = y - floorY;
+
+		const u32 x0 = static_cast<u32>(vath::Max(floorX, 0.0f));
+		const u32 y0 = static_cast<u32>(vath::Max(floorY, 0.0f));
+		const u32 x1 = vath::Min(static_cast<u32>(floorX + 1.0f), level.Width - 1);
+		const u32 y1 = vath::Min(static_cast<u32>(floorY + 1.0f), level.Height - 1);
+
+		const Color top = ReadTexel(a_pyramid, level, x0, y0) * (1.0f - tx) + ReadTexel(a_pyramid, level, x1, y0) * tx;
+		const Color bottom = ReadTexel(a_pyramid, level, x0, y1) * (1.0f - tx) + ReadTexel(a_pyramid, level, x1, y1) * tx;
+		return top * (1.0f - ty) + bottom * ty;
+	}
+
+	Color MipTexture::ReadTexel(const MipPyramid& a_pyramid, const MipLevel& a_level, const u32 a_x, const u32 a_y)
+	{
+		const usize texelIndex = a_level.Offset + (static_cast<usize>(a_y) * a_level.Width + a_x) * TexelChannelCount;
+		if (a_pyramid.Format == ETexelFormat::Float16)
+		{
+			const u16* pTexel = &a_pyramid.Texels16[texelIndex];
+			return Color(vath::HalfToFloat(pTexel[0]), vath::HalfToFloat(pTexel[1]), vath::HalfToFloat(pTexel[2]));
+		}
+
+		const fp32* pTexel = &a_pyramid.Texels32[texelIndex];
+		return Color(pTexel[0], pTexel[1], pTexel[2]);
+	}
+}
@@ -0,0 +1,297 @@
+#include "riow/pathGuide.h"
+
+namespace dxray::riow
+{
+	//Largest float below 1, random numbers that are rescaled while descending the quadtree stay within [0, 1).
+	static constexpr fp32 OneMinusEpsilon = 0x1.fffffep-1f;
+
+	DirectionalQuadtree::DirectionalQuadtree() :
+		m_nodes(1)
+	{}
+
+	void DirectionalQuadtree::Record(const vath::Vector3f& a_unitDirection, const fp32 a_flux)
+	{
+		vath::Vector2f point = DirectionToSquare(a_unitDirection);
+		u32 nodeIndex = 0;
+		while (true)
+		{
+			Node& node = m_nodes[nodeIndex];
+			const u32 quadrant = GetQuadrant(point);
+			if (node.Children[quadrant] == LeafChild)
+			{
+				node.Flux[quadrant].Add(a_flux);
+				return;
+			}
+
+			nodeIndex = node.Children[quadrant];
+		}
+	}
+
+	vath::Vector3f DirectionalQuadtree::Sample(vath::Vector2f a_sample, fp32& a_pdf) const
+	{
+		vath::Vector2f origin(0.0f);
+		fp32 size = 1.0f;
+		fp32 pdf = 1.0f;
+		u32 nodeIndex = 0;
+		while (true)
+		{
+			//The column is picked first and the quadrant within it second, each decision rescales its random number to [0, 1) for the next level.
+			const Node& node = m_nodes[nodeIndex];
+			const std::array<fp32, 4> flux = { node.Flux[0].Get(), node.Flux[1].Get(), node.Flux[2].Get(), node.Flux[3].Get() };
+			const fp32 totalFlux = flux[0] + flux[1] + flux[2] + flux[3];
+			DXRAY_ASSERT(totalFlux > 0.0f);
+
+			const fp32 leftProbability = (flux[0] + flux[2]) / totalFlux;
+			const u32 right = a_sample.x < leftProbability ? 0 : 1;
+			a_sample.x = right == 0 ? a_sample.x / leftProbability : (a_sample.x - leftProbability) / (1.0f - leftProbability);
+
+			const fp32 bottomProbability = flux[right] / (flux[right] + flux[right + 2]);
+			const u32 top = a_sample.y < bottomProbability ? 0 : 1;
+			a_sample.y = top == 0 ? a_sample.y / bottomProbability : (a_sample.y - bottomProbability) / (1.0f - bottomProbability);
+			a_sample = vath::Vector2f(vath::Min(a_sample.x, OneMinusEpsilon), vath::Min(a_sample.y, OneMinusEpsilon));
+
+			const u32 quadrant = right + 2 * top;
+			pdf *= 4.0f * flux[quadrant] / totalFlux;
+			size *= 0.5f;
+			origin = origin + vath::Vector2f(static_cast<fp32>(right), static_cast<fp32>(top)) * size;
+			if (node.Children[quadrant] == LeafChild)
+			{
+				a_pdf = pdf / (4.0f * vath::Pi<fp32>());
+				return SquareToDirection(origin + a_sample * size);
+			}
+
+			nodeIndex = node.Children[quadrant];
+		}
+	}
+
+	fp32 DirectionalQuadtree::GetPdf(const vath::Vector3f& a_unitDirection) const
+	{
+		vath::Vector2f point = DirectionToSquare(a_unitDirection);
+		fp32 pdf = 1.0f / (4.0f * vath::Pi<fp32>());
+		u32 nodeIndex = 0;
+		while (true)
+		{
+			const Node& node = m_nodes[nodeIndex];
+			const fp32 totalFlux = node.Flux[0].Get() + node.Flux[1].Get() + node.Flux[2].Get() + node.Flux[3].Get();
+			const u32 quadrant = GetQuadrant(point);
+			const fp32 flux = node.Flux[quadrant].Get();
+			if (flux <= 0.0f)
+			{
+				return 0.0f;
+			}
+
+			pdf *= 4.0f * flux / totalFlux;
+			if (node.Children[quadrant] == LeafChild)
+			{
+				return pdf;
+			}
+
+			nodeIndex = node.Children[quadrant];
+		}
+	}
+
+	void DirectionalQuadtree::Build()
+	{
+		BuildNode(0);
+	}
+
+	DirectionalQuadtree DirectionalQuadtree::Refine(const fp32 a_subdivisionFluxFraction, const u32 a_maxDepth) const
+	{
+		DirectionalQuadtree refined;
+		RefineNode(0, 0.0f, 0, GetFlux(), a_subdivisionFluxFraction, 1, a_maxDepth, refined);
+		return refined;
+	}
+
+	vath::Vector2f DirectionalQuadtree::DirectionToSquare(const vath::Vector3f& a_unitDirection)
+	{
+		const fp32 cosTheta = vath::Clamp<fp32>(a_unitDirection.z, -1.0f, 1.0f);
+		fp32 phi = std::atan2(a_unitDirection.y, a_unitDirection.x);
+		phi = phi < 0.0f ? phi + 2.0f * vath::Pi<fp32>() : phi;
+		return vath::Vector2f(vath::Min((cosTheta + 1.0f) * 0.5f, OneMinusEpsilon), vath::Min(phi / (2.0f * vath::Pi<fp32>()), OneMinusEpsilon));
+	}
+
+	vath::Vector3f DirectionalQuadtree::SquareToDirection(const vath::Vector2f& a_point)
+	{
+		const fp32 cosTheta = 2.0f * a_point.x - 1.0f;
+		const fp32 sinTheta = std::sqrt(vath::Max(0.0f, 1.0f - cosTheta * cosTheta));
+		const fp32 phi = 2.0f * vath::Pi<fp32>() * a_point.y;
+		return vath::Vector3f(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+	}
+
+	u32 DirectionalQuadtree::GetQuadrant(vath::Vector2f& a_point)
+	{
+		const u32 right = a_point.x < 0.5f ? 0 : 1;
+		const u32 top = a_point.y < 0.5f ? 0 : 1;
+		a_point = vath::Vector2f(a_point.x * 2.0f - static_cast<fp32>(right), a_point.y * 2.0f - static_cast<fp32>(top));
+		return right + 2 * top;
+	}
+
+	fp32 DirectionalQuadtree::BuildNode(const u32 a_nodeIndex)
+	{
+		fp32 totalFlux = 0.0f;
+		for (u32 quadrant = 0; quadrant < 4; ++quadrant)
+		{
+			const u32 child = m_nodes[a_nodeIndex].Children[quadrant];
+			if (child != LeafChild)
+			{
+				m_nodes[a_nodeIndex].Flux[quadrant] = AtomicFloat(BuildNode(child));
+			}
+
+			totalFlux += m_nodes[a_nodeIndex].Flux[quadrant].Get();
+		}
+
+		return totalFlux;
+	}
+
+	void DirectionalQuadtree::RefineNode(const u32 a_nodeIndex, const fp32 a_flux, const u32 a_refinedIndex, const fp32 a_totalFlux, const fp32 a_subdivisionFluxFraction,
+		const u32 a_depth, const u32 a_maxDepth, DirectionalQuadtree& a_refined) const
+	{
+		//Quadrants that were leaves spread their flux evenly over the children they are subdivided into, those have no node to read from.
+		const bool bHasNode = a_nodeIndex != InvalidNode;
+		for (u32 quadrant = 0; quadrant < 4; ++quadrant)
+		{
+			const fp32 flux = bHasNode ? m_nodes[a_nodeIndex].Flux[quadrant].Get() : a_flux * 0.25f;
+			if (a_depth >= a_maxDepth || flux <= a_totalFlux * a_subdivisionFluxFraction)
+			{
+				continue;
+			}
+
+			const u32 refinedChild = static_cast<u32>(a_refined.m_nodes.size());
+			a_refined.m_nodes.emplace_back();
+			a_refined.m_nodes[a_refinedIndex].Children[quadrant] = refinedChild;
+
+			const u32 child = bHasNode ? m_nodes[a_nodeIndex].Children[quadrant] : LeafChild;
+			RefineNode(child == LeafChild ? InvalidNode : child, flux, refinedChild, a_totalFlux, a_subdivisionFluxFraction, a_depth + 1, a_maxDepth, a_refined);
+		}
+	}
+
+
+	//--- Path guide ---
+
+	void PathGuide::Reset(const BoundingBox& a_sceneBounds)
+	{
+		m_bounds = a_sceneBounds;
+		m_nodes.assign(1, Node());
+		m_leaves.clear();
+		m_leaves.emplace_back();
+		m_bRecording = true;
+	}
+
+	void PathGuide::Refine(const u32 a_iterationPassCount)
+	{
+		DXRAY_ASSERT(m_bRecording);
+
+		//The records of the iteration become the distribution that is sampled from.
+		std::vector<fp32> recordCounts(m_leaves.size());
+		for (usize li = 0; li < m_leaves.size(); ++li)
+		{
+			Leaf& leaf = m_leaves[li];
+			leaf.Recording.Build();
+			leaf.Sampling = leaf.Recording;
+			recordCounts[li] = static_cast<fp32>(leaf.RecordCount.load());
+		}
+
+		//Longer iterations record more per leaf, the threshold grows slower than the records so the tree keeps refining.
+		const fp32 splitRecordCount = SpatialSplitRecordCount * std::sqrt(static_cast<fp32>(a_iterationPassCount));
+		std::vector<std::pair<u32, u32>> stack = { { 0u, 0u } };
+		while (!stack.empty())
+		{
+			const auto [nodeIndex, depth] = stack.back();
+			stack.pop_back();
+
+			const Node& node = m_nodes[nodeIndex];
+			if (node.bLeaf)
+			{
+				SplitNode(nodeIndex, depth, recordCounts[node.Child], splitRecordCount);
+				continue;
+			}
+
+			stack.push_back({ node.Child, depth + 1 });
+			stack.push_back({ node.Child + 1, depth + 1 });
+		}
+
+		//Every leaf records into a structure refined towards where its light came from.
+		for (Leaf& leaf : m_leaves)
+		{
+			leaf.Recording = leaf.Sampling.Refine(DirectionalSubdivisionFluxFraction, MaxDirectionalDepth);
+			leaf.RecordCount.store(0);
+		}
+	}
+
+	void PathGuide::Freeze()
+	{
+		m_bRecording = false;
+		for (Leaf& leaf : m_leaves)
+		{
+			leaf.Recording = DirectionalQuadtree();
+		}
+	}
+
+	const DirectionalQuadtree* PathGuide::FindDistribution(const vath::Vector3f& a_point) const
+	{
+		const DirectionalQuadtree& distribution = FindLeaf(a_point).Sampling;
+		return distribution.GetFlux() > 0.0f ? &distribution : nullptr;
+	}
+
+	void PathGuide::Record(const vath::Vector3f& a_point, const vath::Vector3f& a_unitDirection, const fp32 a_radianceOverPdf)
+	{
+		DXRAY_ASSERT(m_bRecording);
+		Leaf& leaf = FindLeaf(a_point);
+		leaf.RecordCount.fetch_add(1u, std::memory_order_relaxed);
+		if (a_radianceOverPdf > 0.0f && std::isfinite(a_radianceOverPdf))
+		{
+			leaf.Recording.Record(a_unitDirection, a_radianceOverPdf);
+		}
+	}
+
+	const PathGuide::Leaf& PathGuide::FindLeaf(const vath::Vector3f& a_point) const
+	{
+		//Bounds of the nodes are halved on the way down, points outside the scene bounds end up in the nearest leaf.
+		vath::Vector3f boundsMin = m_bounds.Min;
+		vath::Vector3f boundsMax = m_bounds.Max;
+		u32 nodeIndex = 0;
+		while (!m_nodes[nodeIndex].bLeaf)
+		{
+			const Node& node = m_nodes[nodeIndex];
+			const fp32 split = (boundsMin[node.Axis] + boundsMax[node.Axis]) * 0.5f;
+			if (a_point[node.Axis] < split)
+			{
+				boundsMax[node.Axis] = split;
+				nodeIndex = node.Child;
+			}
+			else
+			{
+				boundsMin[node.Axis] = split;
+				nodeIndex = node.Child + 1;
+			}
+		}
+
+		return m_leaves[m_nodes[nodeIndex].Child];
+	}
+
+	PathGuide::Leaf& PathGuide::FindLeaf(const vath::Vector3f& a_point)
+	{
+		return const_cast<Leaf&>(static_cast<const PathGuide&>(*this).FindLeaf(a_point));
+	}
+
+	void PathGuide::SplitNode(const u32 a_nodeIndex, const u32 a_depth, const fp32 a_recordCount, const fp32 a_splitRecordCount)
+	{
+		if (a_recordCount <= a_splitRecordCount || a_depth >= MaxSpatialDepth)
+		{
+			return;
+		}
+
+		//Both halves start from the distribution of the leaf, each is assumed to have received half of its records.
+		const u32 leafIndex = m_nodes[a_nodeIndex].Child;
+		const u32 newLeafIndex = static_cast<u32>(m_leaves.size());
+		m_leaves.emplace_back().Sampling = m_leaves[leafIndex].Sampling;
+
+		const u32 firstChild = static_cast<u32>(m_nodes.size());
+		m_nodes.push_back(Node{ .Child = leafIndex, .Axis = 0, .bLeaf = true });
+		m_nodes.push_back(Node{ .Child = newLeafIndex, .Axis = 0, .bLeaf = true });
+		m_nodes[a_nodeIndex] = Node{ .Child = firstChild, .Axis = static_cast<u8>(a_depth % 3), .bLeaf = false };
+
+		SplitNode(firstChild, a_depth + 1, a_recordCount * 0.5f, a_splitRecordCount);
+		SplitNode(firstChild + 1, a_depth + 1, a_recordCount * 0.5f, a_splitRecordCount);
+	}
+}
@@ -1,5 +1,6 @@
 #include "riow/perlin.h"
 #include <core/vath/vathUtility.h>
+#include "riow/sampler.h"
 
 namespace dxray
 {
@@ -10,9 +11,9 @@ namespace dxray
         for (i32 i = 0; i < m_pointCount; i++)
         {
             m_noiseMap[i] = vath::Normalize(vath::Vector3f(
-                vath::RandomNumber<fp32>(-1.0f, 1.0f),
-                vath::RandomNumber<fp32>(-1.0f, 1.0f),
-                vath::RandomNumber<fp32>(-1.0f, 1.0f)
+                riow::RandomFloat(-1.0f, 1.0f),
+                riow::RandomFloat(-1.0f, 1.0f),
+                riow::RandomFloat(-1.0f, 1.0f)
             ));
         }
 
@@ -37,7 +38,7 @@ namespace dxray
     {
         for (i32 i = m_pointCount - 1; i > 0; i--)
         {
-            const i32 target = vath::RandomNumber<i32>(0, i);
+            const i32 target = riow::RandomInt(0, i);
             std::swap(a_pPermutation[i], a_pPermutation[target]);
         }
     }
@@ -80,23 +81,127 @@ namespace dxray
 
     fp32 Perlin::Turbulence(const vath::Vector3f& a_point, u32 a_depth) const
     {
+        constexpr u32 laneCount = static_cast<u32>(vath::Float8::LaneCount);
+
         fp32 accumulated = 0.0f;
         vath::Vector3f frequency = a_point;
         fp32 weight = 1.0f;
 
         //The concept behind turbulence is to take the sum of multiple summed frequencies.
-        //Hence multiple noise samples are taken and averaged.
-        for (u32 i = 0; i < a_depth; i++)
+        //Hence multiple noise samples are taken and averaged, eight octaves at a time with every lane sampling its own frequency.
+        for (u32 firstOctave = 0; firstOctave < a_depth; firstOctave += laneCount)
         {
-            accumulated += weight * Noise(frequency);
-            weight *= 0.5f;
-            frequency *= 2.0f;
+            alignas(32) fp32 x[laneCount] = {};
+            alignas(32) fp32 y[laneCount] = {};
+            alignas(32) fp32 z[laneCount] = {};
+            alignas(32) fp32 weights[laneCount] = {};
+            const u32 octaveCount = vath::Min(a_depth - firstOctave, laneCount);
+            for (u32 li = 0; li < octaveCount; ++li)
+            {
+                x[li] = frequency.x;
+                y[li] = frequency.y;
+                z[li] = frequency.z;
+                weights[li] = weight;
+                weight *= 0.5f;
+                frequency *= 2.0f;
+            }
+
+            alignas(32) fp32 weightedNoise[laneCount];
+            (Noise(vath::Float8::Load(x), vath::Float8::Load(y), vath::Float8::Load(z)) * vath::Float8::Load(weights)).Store(weightedNoise);
+            for (u32 li = 0; li < octaveCount; ++li)
+            {
+                accumulated += weightedNoise[li];
+            }
         }
 
         //Take the abs of the value as noise samples are taken from -1 and 1 pointing directions.
         return vath::Abs<fp32>(accumulated);
     }
 
+    vath::Float8 Perlin::Noise(const vath::Float8& a_x, const vath::Float8& a_y, const vath::Float8& a_z) const
+    {
+        using vath::Float8;
+        constexpr usize laneCount = Float8::LaneCount;
+
+        const Float8 flooredX = vath::Floor(a_x);
+        const Float8 flooredY = vath::Floor(a_y);
+        const Float8 flooredZ = vath::Floor(a_z);
+
+        alignas(32) fp32 latticePoints[3][laneCount];
+        flooredX.Store(latticePoints[0]);
+        flooredY.Store(latticePoints[1]);
+        flooredZ.Store(latticePoints[2]);
+
+        //The gradient lookups go through the permutation tables and stay scalar, they are gathered per corner in structure-of-arrays layout.
+        alignas(32) fp32 gradients[8][3][laneCount];
+        for (usize li = 0; li < laneCount; ++li)
+        {
+            const i32 latticeX = static_cast<i32>(latticePoints[0][li]);
+            const i32 latticeY = static_cast<i32>(latticePoints[1][li]);
+            const i32 latticeZ = static_cast<i32>(latticePoints[2][li]);
+            const i32 permutationsX[2] = { m_permutationx[latticeX & 255], m_permutationx[(latticeX + 1) & 255] };
+            const i32 permutationsY[2] = { m_permutationy[latticeY & 255], m_permutationy[(latticeY + 1) & 255] };
+            const i32 permutationsZ[2] = { m_permutationz[latticeZ & 255], m_permutationz[(latticeZ + 1) & 255] };
+
+            for (i32 corner = 0; corner < 8; ++corner)
+            {
+                const vath::Vector3f& gradient = m_noiseMap[permutationsX[corner >> 2] ^ permutationsY[(corner >> 1) & 1] ^ permutationsZ[corner & 1]];
+                gradients[corner][0][li] = gradient.x;
+                gradients[corner][1][li] = gradient.y;
+                gradients[corner][2][li] = gradient.z;
+            }
+        }
+
+        //Same hermitian smoothed tri-linear interpolation as TrilinearInterpolate, on all lanes at once.
+        const Float8 one(1.0f);
+        const Float8 u = a_x - flooredX;
+        const Float8 v = a_y - flooredY;
+        const Float8 w = a_z - flooredZ;
+        const Float8 smoothedU = u * u * (Float8(3.0f) - Float8(2.0f) * u);
+        const Float8 smoothedV = v * v * (Float8(3.0f) - Float8(2.0f) * v);
+        const Float8 smoothedW = w * w * (Float8(3.0f) - Float8(2.0f) * w);
+
+        const Float8 weightsU[2] = { one - smoothedU, smoothedU };
+        const Float8 weightsV[2] = { one - smoothedV, smoothedV };
+        const Float8 weightsW[2] = { one - smoothedW, smoothedW };
+        const Float8 offsetsU[2] = { u, u - one };
+        const Float8 offsetsV[2] = { v, v - one };
+        const Float8 offsetsW[2] = { w, w - one };
+
+        Float8 accumulated(0.0f);
+        for (i32 corner = 0; corner < 8; ++corner)
+        {
+            const i32 i = corner >> 2;
+            const i32 j = (corner >> 1) & 1;
+            const i32 k = corner & 1;
+            const Float8 gradientDot = vath::MultiplyAdd(Float8::Load(gradients[corner][0]), offsetsU[i],
+                vath::MultiplyAdd(Float8::Load(gradients[corner][1]), offsetsV[j], Float8::Load(gradients[corner][2]) * offsetsW[k]));
+            accumulated = vath::MultiplyAdd(weightsU[i] * weightsV[j] * weightsW[k], gradientDot, accumulated);
+        }
+
+        return accumulated;
+    }
+
+    vath::Float8 Perlin::Turbulence(const vath::Float8& a_x, const vath::Float8& a_y, const vath::Float8& a_z, u32 a_depth) const
+    {
+        vath::Float8 accumulated(0.0f);
+        vath::Float8 x = a_x;
+        vath::Float8 y = a_y;
+        vath::Float8 z = a_z;
+        fp32 weight = 1.0f;
+
+        for (u32 i = 0; i < a_depth; i++)
+        {
+            accumulated = vath::MultiplyAdd(vath::Float8(weight), Noise(x, y, z), accumulated);
+            weight *= 0.5f;
+            x *= vath::Float8(2.0f);
+            y *= vath::Float8(2.0f);
+            z *= vath::Float8(2.0f);
+        }
+
+        return vath::Max(accumulated, vath::Float8(0.0f) - accumulated);
+    }
+
     fp32 Perlin::TrilinearInterpolate(const vath::Vector3f c[2][2][2], const vath::Vector3f& a_uvw)
     {
         //Hermitian smoothing to get rid of Mach-bands - an common artifact from the result of color lerping.
@@ -0,0 +1,103 @@
+#include "riow/photonMap.h"
+#include "riow/boundingBox.h"
+#include <algorithm>
+#include <array>
+
+namespace dxray::riow
+{
+	void PhotonMap::Build(std::vector<Photon>&& a_photons)
+	{
+		m_photons = std::move(a_photons);
+		BuildRecursive(0, static_cast<u32>(m_photons.size()));
+	}
+
+	void PhotonMap::Clear()
+	{
+		m_photons.clear();
+	}
+
+	void PhotonMap::BuildRecursive(const u32 a_begin, const u32 a_end)
+	{
+		if (a_end - a_begin <= 1)
+		{
+			return;
+		}
+
+		//Split along the axis with the largest extent, the median photon becomes the node and the photons on either side its children.
+		BoundingBox bounds;
+		for (u32 i = a_begin; i < a_end; ++i)
+		{
+			bounds.Expand(m_photons[i].Position);
+		}
+
+		const vath::Vector3f extent = bounds.Max - bounds.Min;
+		const u8 axis = extent.x > extent.y && extent.x > extent.z ? 0 : (extent.y > extent.z ? 1 : 2);
+		const u32 middle = a_begin + (a_end - a_begin) / 2;
+		std::nth_element(m_photons.begin() + a_begin, m_photons.begin() + middle, m_photons.begin() + a_end,
+			[axis](const Photon& a_lhs, const Photon& a_rhs) { return a_lhs.Position[axis] < a_rhs.Position[axis]; });
+
+		m_photons[middle].SplitAxis = axis;
+		BuildRecursive(a_begin, middle);
+		BuildRecursive(middle + 1, a_end);
+	}
+
+	Color PhotonMap::GatherPower(const vath::Vector3f& a_point, const vath::Vector3f& a_normal, const fp32 a_radius) const
+	{
+		struct Range final
+		{
+			u32 Begin;
+			u32 End;
+		};
+
+		const fp32 radiusSquared = a_radius * a_radius;
+		Color power(0.0f);
+		std::array<Range, MaxQueryStackSize> stack;
+		u32 stackSize = 0;
+		if (!m_photons.empty())
+		{
+			stack[stackSize++] = Range{ 0, static_cast<u32>(m_photons.size()) };
+		}
+
+		while (stackSize > 0)
+		{
+			const Range range = stack[--stackSize];
+			const u32 middle = range.Begin + (range.End - range.Begin) / 2;
+			const Photon& photon = m_photons[middle];
+			if (vath::SqrMagnitude(photon.Position - a_point) <= radiusSquared && vath::Dot(photon.Direction, a_normal) < 0.0f)
+			{
+				power += photon.Power;
+			}
+
+			if (range.End - range.Begin <= 1)
+			{
+				continue;
+			}
+
+			//Photons before the median lie at or below it along the split axis, photons after it at or above it.
+			const fp32 distanceToSplit = a_point[photon.SplitAxis] - photon.Position[photon.SplitAxis];
+			DXRAY_ASSERT(stackSize + 2 <= MaxQueryStackSize);
+			if (distanceToSplit <= a_radius && range.Begin < middle)
+			{
+				stack[stackSize++] = Range{ range.Begin, middle };
+			}
+
+			if (distanceToSplit >= -a_radius && middle + 1 < range.End)
+			{
+				stack[stackSize++] = Range{ middle + 1, range.End };
+			}
+		}
+
+		return power;
+	}
+
+	fp32 GetProgressiveGatherRadius(const fp32 a_initialRadius, const fp32 a_alpha, const u32 a_pass)
+	{
+		fp32 radiusSquared = a_initialRadius * a_initialRadius;
+		for (u32 i = 1; i <= a_pass; ++i)
+		{
+			radiusSquared *= (static_cast<fp32>(i) + a_alpha) / static_cast<fp32>(i + 1);
+		}
+
+		return std::sqrt(radiusSquared);
+	}
+}
@@ -0,0 +1,540 @@
+#include "riow/pngEncoder.h"
+#include <bit>
+
+namespace dxray::riow
+{
+	//--- Checksums ---
+
+	u32 Crc32(const u8* a_pData, const usize a_size, const u32 a_crc /*= 0*/)
+	{
+		static const std::array<u32, 256> crcTable = []()
+		{
+			std::array<u32, 256> table;
+			for (u32 i = 0; i < 256; ++i)
+			{
+				u32 value = i;
+				for (u32 bit = 0; bit < 8; ++bit)
+				{
+					value = (value & 1u) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+				}
+				table[i] = value;
+			}
+
+			return table;
+		}();
+
+		u32 crc = ~a_crc;
+		for (usize i = 0; i < a_size; ++i)
+		{
+			crc = crcTable[(crc ^ a_pData[i]) & 0xFF] ^ (crc >> 8);
+		}
+
+		return ~crc;
+	}
+
+	static constexpr u32 AdlerModulo = 65521;
+
+	u32 Adler32(const u8* a_pData, const usize a_size, const u32 a_adler /*= 1*/)
+	{
+		//5552 is the largest block for which the sums cannot overflow before the modulo.
+		constexpr usize adlerBlockSize = 5552;
+		u32 s1 = a_adler & 0xFFFF;
+		u32 s2 = a_adler >> 16;
+		for (usize blockStart = 0; blockStart < a_size; blockStart += adlerBlockSize)
+		{
+			const usize blockEnd = vath::Min(blockStart + adlerBlockSize, a_size);
+			for (usize i = blockStart; i < blockEnd; ++i)
+			{
+				s1 += a_pData[i];
+				s2 += s1;
+			}
+
+			s1 %= AdlerModulo;
+			s2 %= AdlerModulo;
+		}
+
+		return (s2 << 16) | s1;
+	}
+
+	u32 CombineAdler32(const u32 a_firstAdler, const u32 a_secondAdler, const usize a_secondSize)
+	{
+		//The second block's s1 starts from the first block's s1 instead of 1, which adds it to s2 once for every byte of the second block.
+		const u64 remainder = a_secondSize % AdlerModulo;
+		const u64 firstS1 = a_firstAdler & 0xFFFF;
+		const u64 s1 = (firstS1 + (a_secondAdler & 0xFFFF) + AdlerModulo - 1) % AdlerModulo;
+		const u64 s2 = ((a_firstAdler >> 16) + (a_secondAdler >> 16) + remainder * firstS1 + AdlerModulo - remainder) % AdlerModulo;
+		return static_cast<u32>((s2 << 16) | s1);
+	}
+
+
+	//--- Filtering ---
+
+	static u8 PaethPredictor(const i32 a_left, const i32 a_up, const i32 a_upLeft)
+	{
+		const i32 prediction = a_left + a_up - a_upLeft;
+		const i32 leftDistance = std::abs(prediction - a_left);
+		const i32 upDistance = std::abs(prediction - a_up);
+		const i32 upLeftDistance = std::abs(prediction - a_upLeft);
+		if (leftDistance <= upDistance && leftDistance <= upLeftDistance)
+		{
+			return static_cast<u8>(a_left);
+		}
+
+		return static_cast<u8>(upDistance <= upLeftDistance ? a_up : a_upLeft);
+	}
+
+	void FilterPngRows(const u8* a_pPixels, const u8* a_pPreviousRow, const u32 a_width, const u32 a_channelCount, const u32 a_rowCount, u8* a_pFilteredRows)
+	{
+		constexpr u32 filterCount = 5;	//None, Sub, Up, Average, Paeth.
+		const usize rowSize = static_cast<usize>(a_width) * a_channelCount;
+		std::vector<u8> candidates(rowSize * filterCount);
+		const std::vector<u8> emptyRow(a_pPreviousRow == nullptr ? rowSize : 0, 0);
+		const u8* pUp = a_pPreviousRow != nullptr ? a_pPreviousRow : emptyRow.data();
+
+		for (u32 y = 0; y < a_rowCount; ++y)
+		{
+			//Every filter runs over the whole row in its own loop, which keeps the loops simple enough to vectorize.
+			const u8* pRow = a_pPixels + y * rowSize;
+			u8* pNone = &candidates[0];
+			u8* pSub = &candidates[rowSize];
+			u8* pUpFiltered = &candidates[rowSize * 2];
+			u8* pAverage = &candidates[rowSize * 3];
+			u8* pPaeth = &candidates[rowSize * 4];
+			for (usize i = 0; i < a_channelCount; ++i)
+			{
+				pSub[i] = pRow[i];
+				pAverage[i] = static_cast<u8>(pRow[i] - (pUp[i] >> 1));
+				pPaeth[i] = static_cast<u8>(pRow[i] - pUp[i]);
+			}
+
+			std::copy_n(pRow, rowSize, pNone);
+			for (usize i = a_channelCount; i < rowSize; ++i)
+			{
+				pSub[i] = static_cast<u8>(pRow[i] - pRow[i - a_channelCount]);
+			}
+
+			for (usize i = 0; i < rowSize; ++i)
+			{
+				pUpFiltered[i] = static_cast<u8>(pRow[i] - pUp[i]);
+			}
+
+			for (usize i = a_channelCount; i < rowSize; ++i)
+			{
+				pAverage[i] = static_cast<u8>(pRow[i] - ((pRow[i - a_channelCount] + pUp[i]) >> 1));
+			}
+
+			for (usize i = a_channelCount; i < rowSize; ++i)
+			{
+				pPaeth[i] = static_cast<u8>(pRow[i] - PaethPredictor(pRow[i - a_channelCount], pUp[i], pUp[i - a_channelCount]));
+			}
+
+			//The cost treats the filtered bytes as signed, small differences in either direction compress well.
+			u32 filterCosts[filterCount] = {};
+			for (u32 fi = 0; fi < filterCount; ++fi)
+			{
+				const u8* pCandidate = &candidates[fi * rowSize];
+				u32 cost = 0;
+				for (usize i = 0; i < rowSize; ++i)
+				{
+					cost += static_cast<u32>(std::abs(static_cast<i32>(static_cast<i8>(pCandidate[i]))));
+				}
+				filterCosts[fi] = cost;
+			}
+
+			const u32 bestFilter = static_cast<u32>(std::min_element(filterCosts, filterCosts + filterCount) - filterCosts);
+			u8* pFilteredRow = a_pFilteredRows + y * (rowSize + 1);
+			pFilteredRow[0] = static_cast<u8>(bestFilter);
+			std::copy_n(&candidates[bestFilter * rowSize], rowSize, pFilteredRow + 1);
+			pUp = pRow;
+		}
+	}
+
+
+	//--- Deflate ---
+
+	/// <summary>
+	/// Deflate streams are packed from the least significant bit, Huffman codes are stored bit reversed to match.
+	/// </summary>
+	class DeflateBitWriter final
+	{
+	public:
+		DeflateBitWriter(std::vector<u8>& a_output) :
+			m_output(a_output),
+			m_bits(0),
+			m_bitCount(0)
+		{}
+
+		void Write(const u32 a_value, const u32 a_bitCount)
+		{
+			m_bits |= static_cast<u64>(a_value) << m_bitCount;
+			m_bitCount += a_bitCount;
+			if (m_bitCount >= 32)
+			{
+				const u8 bytes[4] = { static_cast<u8>(m_bits), static_cast<u8>(m_bits >> 8), static_cast<u8>(m_bits >> 16), static_cast<u8>(m_bits >> 24) };
+				m_output.insert(m_output.end(), bytes, bytes + 4);
+				m_bits >>= 32;
+				m_bitCount -= 32;
+			}
+		}
+
+		void AlignToByte()
+		{
+			while (m_bitCount > 0)
+			{
+				m_output.push_back(static_cast<u8>(m_bits));
+				m_bits >>= 8;
+				m_bitCount = m_bitCount > 8 ? m_bitCount - 8 : 0;
+			}
+		}
+
+	private:
+		std::vector<u8>& m_output;
+		u64 m_bits;
+		u32 m_bitCount;
+	};
+
+	struct HuffmanCode final
+	{
+		u16 Code = 0;	//Bit reversed.
+		u16 Length = 0;
+	};
+
+	static u16 ReverseBits(const u32 a_code, const u32 a_length)
+	{
+		u32 reversed = 0;
+		for (u32 bit = 0; bit < a_length; ++bit)
+		{
+			reversed |= ((a_code >> bit) & 1u) << (a_length - 1 - bit);
+		}
+
+		return static_cast<u16>(reversed);
+	}
+
+	/// <summary>
+	/// Fixed Huffman code tables of the deflate specification, with the length and distance symbol lookups.
+	/// </summary>
+	struct FixedHuffmanTables final
+	{
+		static constexpr u16 LengthBases[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		static constexpr u8 LengthExtraBits[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		static constexpr u16 DistanceBases[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		static constexpr u8 DistanceExtraBits[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+		FixedHuffmanTables()
+		{
+			for (u32 symbol = 0; symbol < 288; ++symbol)
+			{
+				if (symbol <= 143)
+				{
+					LiteralLengthCodes[symbol] = { ReverseBits(0x30 + symbol, 8), 8 };
+				}
+				else if (symbol <= 255)
+				{
+					LiteralLengthCodes[symbol] = { ReverseBits(0x190 + symbol - 144, 9), 9 };
+				}
+				else if (symbol <= 279)
+				{
+					LiteralLengthCodes[symbol] = { ReverseBits(symbol - 256, 7), 7 };
+				}
+				else
+				{
+					LiteralLengthCodes[symbol] = { ReverseBits(0xC0 + symbol - 280, 8), 8 };
+				}
+			}
+
+			for (u32 code = 0; code < 30; ++code)
+			{
+				DistanceCodes[code] = ReverseBits(code, 5);
+			}
+
+			for (u32 length = 3, code = 0; length <= 258; ++length)
+			{
+				while (code + 1 < 29 && LengthBases[code + 1] <= length)
+				{
+					++code;
+				}
+				LengthSymbols[length] = static_cast<u8>(code);
+			}
+
+			for (u32 distance = 1, code = 0; distance <= DeflateWindowSize; ++distance)
+			{
+				while (code + 1 < 30 && DistanceBases[code + 1] <= distance)
+				{
+					++code;
+				}
+				DistanceSymbols[distance - 1] = static_cast<u8>(code);
+			}
+		}
+
+		std::array<HuffmanCode, 288> LiteralLengthCodes;
+		std::array<u16, 30> DistanceCodes;
+		std::array<u8, 259> LengthSymbols;
+		std::array<u8, DeflateWindowSize> DistanceSymbols;
+	};
+
+	static const FixedHuffmanTables& GetFixedHuffmanTables()
+	{
+		static const FixedHuffmanTables tables;
+		return tables;
+	}
+
+	static u32 GetMatchLength(const u8* a_pFirst, const u8* a_pSecond, const u32 a_maxLength)
+	{
+		//Eight bytes per comparison, the first differing byte is found from the trailing zero bits of the difference.
+		u32 length = 0;
+		while (length + sizeof(u64) <= a_maxLength)
+		{
+			u64 first;
+			u64 second;
+			std::memcpy(&first, a_pFirst + length, sizeof(u64));
+			std::memcpy(&second, a_pSecond + length, sizeof(u64));
+			const u64 difference = first ^ second;
+			if (difference != 0)
+			{
+				return length + static_cast<u32>(std::countr_zero(difference) / 8);
+			}
+			length += sizeof(u64);
+		}
+
+		while (length < a_maxLength && a_pFirst[length] == a_pSecond[length])
+		{
+			++length;
+		}
+
+		return length;
+	}
+
+	void DeflateSegment(const u8* a_pData, const usize a_dictionarySize, const usize a_segmentSize, const bool a_bFinalSegment, std::vector<u8>& a_output)
+	{
+		DXRAY_ASSERT(a_dictionarySize <= DeflateWindowSize);
+		constexpr u32 minMatchLength = 3;
+		constexpr u32 maxMatchLength = 258;
+		constexpr u32 maxChainLength = 16;
+		constexpr u32 hashBits = 15;
+		constexpr usize windowMask = DeflateWindowSize - 1;
+
+		const FixedHuffmanTables& tables = GetFixedHuffmanTables();
+		const usize dataEnd = a_dictionarySize + a_segmentSize;
+		std::vector<i32> hashHeads(1u << hashBits, -1);
+		std::vector<i32> hashChain(DeflateWindowSize, -1);
+
+		auto Hash = [a_pData](const usize a_position)
+		{
+			const u32 value = a_pData[a_position] | (a_pData[a_position + 1] << 8) | (a_pData[a_position + 2] << 16);
+			return (value * 2654435761u) >> (32 - hashBits);
+		};
+
+		auto Insert = [&](const usize a_position)
+		{
+			if (a_position + minMatchLength <= dataEnd)
+			{
+				const u32 hash = Hash(a_position);
+				hashChain[a_position & windowMask] = hashHeads[hash];
+				hashHeads[hash] = static_cast<i32>(a_position);
+			}
+		};
+
+		//The dictionary was compressed by the previous segment, its data is known to the decoder and can be matched against.
+		for (usize position = 0; position < a_dictionarySize; ++position)
+		{
+			Insert(position);
+		}
+
+		a_output.reserve(a_output.size() + a_segmentSize / 2);
+		DeflateBitWriter bitWriter(a_output);
+		bitWriter.Write(a_bFinalSegment ? 1u : 0u, 1);
+		bitWriter.Write(1u, 2);	//Fixed Huffman codes.
+
+		usize position = a_dictionarySize;
+		while (position < dataEnd)
+		{
+			u32 bestLength = 0;
+			u32 bestDistance = 0;
+			if (position + minMatchLength <= dataEnd)
+			{
+				const u32 maxLength = static_cast<u32>(vath::Min<usize>(maxMatchLength, dataEnd - position));
+				i32 candidate = hashHeads[Hash(position)];
+				for (u32 chain = 0; chain < maxChainLength && candidate >= 0 && position - candidate <= DeflateWindowSize; ++chain)
+				{
+					//Checking the byte that would extend the best match first rejects most candidates in one comparison.
+					if (a_pData[candidate + bestLength] == a_pData[position + bestLength])
+					{
+						const u32 length = GetMatchLength(a_pData + candidate, a_pData + position, maxLength);
+
+						if (length > bestLength)
+						{
+							bestLength = length;
+							bestDistance = static_cast<u32>(position - candidate);
+							if (length == maxLength)
+							{
+								break;
+							}
+						}
+					}
+
+					//Chain entries older than the window were overwritten by newer positions, which ends the chain.
+					const i32 nextCandidate = hashChain[candidate & windowMask];
+					if (nextCandidate >= candidate)
+					{
+						break;
+					}
+					candidate = nextCandidate;
+				}
+			}
+
+			if (bestLength >= minMatchLength)
+			{
+				const u32 lengthCode = tables.LengthSymbols[bestLength];
+				const HuffmanCode& lengthSymbol = tables.LiteralLengthCodes[257 + lengthCode];
+				bitWriter.Write(lengthSymbol.Code, lengthSymbol.Length);
+				bitWriter.Write(bestLength - FixedHuffmanTables::LengthBases[lengthCode], FixedHuffmanTables::LengthExtraBits[lengthCode]);
+
+				const u32 distanceCode = tables.DistanceSymbols[bestDistance - 1];
+				bitWriter.Write(tables.DistanceCodes[distanceCode], 5);
+				bitWriter.Write(bestDistance - FixedHuffmanTables::DistanceBases[distanceCode], FixedHuffmanTables::DistanceExtraBits[distanceCode]);
+
+				for (u32 i = 0; i < bestLength; ++i)
+				{
+					Insert(position + i);
+				}
+				position += bestLength;
+			}
+			else
+			{
+				const HuffmanCode& literal = tables.LiteralLengthCodes[a_pData[position]];
+				bitWriter.Write(literal.Code, literal.Length);
+				Insert(position);
+				++position;
+			}
+		}
+
+		const HuffmanCode& endOfBlock = tables.LiteralLengthCodes[256];
+		bitWriter.Write(endOfBlock.Code, endOfBlock.Length);
+
+		//An empty stored block aligns the stream to a byte boundary, so the next segment can be appended as is.
+		if (!a_bFinalSegment)
+		{
+			bitWriter.Write(0u, 3);
+			bitWriter.AlignToByte();
+			a_output.insert(a_output.end(), { 0x00, 0x00, 0xFF, 0xFF });
+		}
+
+		bitWriter.AlignToByte();
+	}
+
+
+	//--- Png ---
+
+	void AppendPngChunk(std::vector<u8>& a_output, const char a_type[4], const u8* a_pData, const usize a_size)
+	{
+		const usize chunkStart = a_output.size();
+		for (const u32 shift : { 24u, 16u, 8u, 0u })
+		{
+			a_output.push_back(static_cast<u8>(a_size >> shift));
+		}
+
+		a_output.insert(a_output.end(), a_type, a_type + 4);
+		a_output.insert(a_output.end(), a_pData, a_pData + a_size);
+
+		//The checksum covers the chunk type and data.
+		const u32 crc = Crc32(&a_output[chunkStart + 4], a_size + 4);
+		for (const u32 shift : { 24u, 16u, 8u, 0u })
+		{
+			a_output.push_back(static_cast<u8>(crc >> shift));
+		}
+	}
+
+	/// <summary>
+	/// Runs a_function(task index) for every task, on the task scheduler when one is passed.
+	/// </summary>
+	template<typename TFunction>
+	static void RunTasks(const u32 a_taskCount, TaskScheduler* a_pTaskScheduler, const TFunction& a_function)
+	{
+		for (u32 ti = 0; ti < a_taskCount; ++ti)
+		{
+			if (a_pTaskScheduler != nullptr)
+			{
+				a_pTaskScheduler->Execute([&a_function, ti]() { a_function(ti); });
+			}
+			else
+			{
+				a_function(ti);
+			}
+		}
+
+		if (a_pTaskScheduler != nullptr)
+		{
+			a_pTaskScheduler->Wait();
+		}
+	}
+
+	void EncodePng(const u8* a_pPixels, const vath::Vector2u32& a_dimensionsInPx, const u32 a_channelCount, std::vector<u8>& a_png, TaskScheduler* a_pTaskScheduler /*= nullptr*/)
+	{
+		DXRAY_ASSERT_WITH_MSG(a_channelCount >= 1 && a_channelCount <= 4, "Png pixels hold 1 to 4 channels.");
+		const usize rowSize = static_cast<usize>(a_dimensionsInPx.x) * a_channelCount;
+		const usize filteredRowSize = rowSize + 1;
+		const usize filteredSize = filteredRowSize * a_dimensionsInPx.y;
+
+		//Filtering only depends on the row above, rows are filtered in chunks of about the strip size.
+		constexpr usize stripSize = 256 * 1024;
+		const u32 rowsPerFilterTask = static_cast<u32>(vath::Max<usize>(stripSize / filteredRowSize, 1));
+		const u32 filterTaskCount = (a_dimensionsInPx.y + rowsPerFilterTask - 1) / rowsPerFilterTask;
+		std::vector<u8> filteredRows(filteredSize);
+		RunTasks(filterTaskCount, a_pTaskScheduler, [&](const u32 a_taskIndex)
+		{
+			const u32 firstRow = a_taskIndex * rowsPerFilterTask;
+			const u32 rowCount = vath::Min(rowsPerFilterTask, a_dimensionsInPx.y - firstRow);
+			FilterPngRows(a_pPixels + firstRow * rowSize, firstRow > 0 ? a_pPixels + (firstRow - 1) * rowSize : nullptr,
+				a_dimensionsInPx.x, a_channelCount, rowCount, &filteredRows[firstRow * filteredRowSize]);
+		});
+
+		//Every strip is a complete IDAT chunk, checksums included, so stitching is a copy.
+		struct DeflatedStrip final
+		{
+			std::vector<u8> Chunk;
+			u32 Adler = 1;
+		};
+
+		const u32 stripCount = static_cast<u32>(vath::Max<usize>((filteredSize + stripSize - 1) / stripSize, 1));
+		std::vector<DeflatedStrip> strips(stripCount);
+		RunTasks(stripCount, a_pTaskScheduler, [&](const u32 a_stripIndex)
+		{
+			const usize stripStart = a_stripIndex * stripSize;
+			const usize stripLength = vath::Min(stripSize, filteredSize - stripStart);
+			const usize dictionarySize = vath::Min(stripStart, DeflateWindowSize);
+
+			std::vector<u8> deflated;
+			deflated.reserve(stripLength / 2);
+			DeflateSegment(&filteredRows[stripStart - dictionarySize], dictionarySize, stripLength, a_stripIndex + 1 == stripCount, deflated);
+			strips[a_stripIndex].Adler = Adler32(&filteredRows[stripStart], stripLength);
+			AppendPngChunk(strips[a_stripIndex].Chunk, "IDAT", deflated.data(), deflated.size());
+		});
+
+		constexpr u8 colorTypes[4] = { 0, 4, 2, 6 };	//Gray, gray alpha, RGB, RGBA.
+		std::vector<u8> imageHeader;
+		for (const u32 value : { a_dimensionsInPx.x, a_dimensionsInPx.y })
+		{
+			for (const u32 shift : { 24u, 16u, 8u, 0u })
+			{
+				imageHeader.push_back(static_cast<u8>(value >> shift));
+			}
+		}
+		imageHeader.insert(imageHeader.end(), { 8, colorTypes[a_channelCount - 1], 0, 0, 0 });
+
+		a_png.clear();
+		a_png.insert(a_png.end(), std::begin(PngSignature), std::end(PngSignature));
+		AppendPngChunk(a_png, "IHDR", imageHeader.data(), imageHeader.size());
+		AppendPngChunk(a_png, "IDAT", ZlibHeader, sizeof(ZlibHeader));
+
+		u32 adler = 1;
+		for (u32 si = 0; si < stripCount; ++si)
+		{
+			a_png.insert(a_png.end(), strips[si].Chunk.begin(), strips[si].Chunk.end());
+			adler = CombineAdler32(adler, strips[si].Adler, vath::Min(stripSize, filteredSize - si * stripSize));
+		}
+
+		const u8 adlerBytes[4] = { static_cast<u8>(adler >> 24), static_cast<u8>(adler >> 16), static_cast<u8>(adler >> 8), static_cast<u8>(adler) };
+		AppendPngChunk(a_png, "IDAT", adlerBytes, sizeof(adlerBytes));
+		AppendPngChunk(a_png, "IEND", nullptr, 0);
+	}
+}
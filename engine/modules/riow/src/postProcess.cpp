@@ -0,0 +1,135 @@
+#include "riow/postProcess.h"
+
+namespace dxray::riow
+{
+	static_assert(sizeof(Color) == 3 * sizeof(fp32), "Radiance buffers are processed as flat channel arrays.");
+
+	//The table is indexed by the square root of the linear value, which spends more entries on the dark end where the sRGB curve is steep.
+	static constexpr u32 SrgbEncodeTableSize = 4096;
+
+	static const std::array<u8, SrgbEncodeTableSize>& GetSrgbEncodeTable()
+	{
+		static const std::array<u8, SrgbEncodeTableSize> encodeTable = []()
+		{
+			std::array<u8, SrgbEncodeTableSize> table;
+			for (u32 i = 0; i < SrgbEncodeTableSize; ++i)
+			{
+				const fp32 root = static_cast<fp32>(i) / static_cast<fp32>(SrgbEncodeTableSize - 1);
+				const fp32 encoded = LinearToSrgb(Color(root * root)).x;
+				table[i] = static_cast<u8>(vath::Clamp<fp32>(encoded * 255.0f + 0.5f, 0.0f, 255.0f));
+			}
+
+			return table;
+		}();
+
+		return encodeTable;
+	}
+
+	static vath::Float8 ApplyToneMapping(const vath::Float8& a_value, const EToneMapping a_toneMapping)
+	{
+		using vath::Float8;
+
+		switch (a_toneMapping)
+		{
+		case EToneMapping::Reinhard:
+			return a_value / (Float8(1.0f) + a_value);
+		case EToneMapping::AcesFilmic:
+			return (a_value * vath::MultiplyAdd(a_value, Float8(2.51f), Float8(0.03f))) /
+				vath::MultiplyAdd(a_value, vath::MultiplyAdd(a_value, Float8(2.43f), Float8(0.59f)), Float8(0.14f));
+		case EToneMapping::None:
+		default:
+			return a_value;
+		}
+	}
+
+	static void EncodeDisplayChannels(const fp32* a_pRadiance, u8* a_pPixels, const usize a_channelCount, const DisplayTransform& a_transform)
+	{
+		using vath::Float8;
+		constexpr usize laneCount = Float8::LaneCount;
+
+		const std::array<u8, SrgbEncodeTableSize>& encodeTable = GetSrgbEncodeTable();
+		const Float8 exposure(a_transform.Exposure);
+		const Float8 zero(0.0f);
+		const Float8 one(1.0f);
+		const Float8 tableScale(static_cast<fp32>(SrgbEncodeTableSize - 1));
+		const Float8 roundingOffset(0.5f);
+
+		alignas(32) fp32 tableIndices[laneCount];
+		for (usize ci = 0; ci < a_channelCount; ci += laneCount)
+		{
+			const usize activeLaneCount = vath::Min(a_channelCount - ci, laneCount);
+			Float8 value;
+			if (activeLaneCount == laneCount)
+			{
+				value = Float8::Load(a_pRadiance + ci);
+			}
+			else
+			{
+				alignas(32) fp32 tail[laneCount] = {};
+				std::copy_n(a_pRadiance + ci, activeLaneCount, tail);
+				value = Float8::Load(tail);
+			}
+
+			//Max with the value as first operand maps NaN to 0.
+			value = ApplyToneMapping(value * exposure, a_transform.ToneMapping);
+			value = vath::Min(vath::Max(value, zero), one);
+			vath::MultiplyAdd(vath::Sqrt(value), tableScale, roundingOffset).Store(tableIndices);
+			for (usize li = 0; li < activeLaneCount; ++li)
+			{
+				a_pPixels[ci + li] = encodeTable[static_cast<u32>(tableIndices[li])];
+			}
+		}
+	}
+
+	void EncodeDisplayImage(const std::vector<Color>& a_radiance, std::vector<u8>& a_pixels, const DisplayTransform& a_transform, TaskScheduler* a_pTaskScheduler /*= nullptr*/)
+	{
+		a_pixels.resize(a_radiance.size() * 3);
+		EncodeDisplayPixels(a_radiance.data(), a_radiance.size(), a_pixels.data(), a_transform, a_pTaskScheduler);
+	}
+
+	void EncodeDisplayPixels(const Color* a_pRadiance, const usize a_pixelCount, u8* a_pPixels, const DisplayTransform& a_transform, TaskScheduler* a_pTaskScheduler /*= nullptr*/)
+	{
+		const usize channelCount = a_pixelCount * 3;
+		const fp32* pRadiance = reinterpret_cast<const fp32*>(a_pRadiance);
+		u8* pPixels = a_pPixels;
+
+		//Chunks are a multiple of the lane count, so only the last chunk has a partial tail.
+		constexpr usize chunkSize = 64 * 1024;
+		if (a_pTaskScheduler == nullptr || channelCount <= chunkSize)
+		{
+			EncodeDisplayChannels(pRadiance, pPixels, channelCount, a_transform);
+			return;
+		}
+
+		for (usize chunkStart = 0; chunkStart < channelCount; chunkStart += chunkSize)
+		{
+			const usize chunkChannelCount = vath::Min(channelCount - chunkStart, chunkSize);
+			a_pTaskScheduler->Execute([=, &a_transform]()
+			{
+				EncodeDisplayChannels(pRadiance + chunkStart, pPixels + chunkStart, chunkChannelCount, a_transform);
+			});
+		}
+
+		a_pTaskScheduler->Wait();
+	}
+
+	EToneMapping ParseToneMapping(const StringView a_name)
+	{
+		if (a_name == "reinhard")
+		{
+			return EToneMapping::Reinhard;
+		}
+
+		if (a_name == "aces")
+		{
+			return EToneMapping::AcesFilmic;
+		}
+
+		if (a_name != "none")
+		{
+			DXRAY_WARN("Unknown tone mapping {}, falling back to none.", String(a_name));
+		}
+
+		return EToneMapping::None;
+	}
+}
@@ -0,0 +1,80 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/aliasTable.h"
+
+using namespace dxray;
+using namespace dxray::riow;
+
+static constexpr u32 SampleCount = 1 << 20;
+
+/// <summary>
+/// Weights spanning several orders of magnitude, with entries that carry no weight at all.
+/// </summary>
+static std::vector<fp32> MakeTestWeights(const u32 a_count)
+{
+	std::vector<fp32> weights(a_count);
+	for (u32 wi = 0; wi < a_count; ++wi)
+	{
+		weights[wi] = wi % 7 == 3 ? 0.0f : std::exp2(static_cast<fp32>(wi % 11) - 4.0f) * (1.0f + 0.5f * std::sin(static_cast<fp32>(wi)));
+	}
+
+	return weights;
+}
+
+/// <summary>
+/// Each count follows a binomial distribution, a correct sampler stays within a few standard deviations of the expected count.
+/// </summary>
+static void ExpectCountNear(const u32 a_count, const fp64 a_probability, const u32 a_sampleCount)
+{
+	const fp64 expected = a_probability * a_sampleCount;
+	const fp64 standardDeviation = std::sqrt(vath::Max(expected * (1.0 - a_probability), 1.0));
+	EXPECT_NEAR(static_cast<fp64>(a_count), expected, 5.0 * standardDeviation + 0.01 * expected);
+}
+
+TEST(AliasTable, ReproducesItsDistribution)
+{
+	for (const u32 entryCount : { 1u, 2u, 13u, 1000u })
+	{
+		SCOPED_TRACE(std::format("{} entries", entryCount));
+		std::vector<fp32> weights = MakeTestWeights(entryCount);
+		weights[0] = 1.0f;
+		fp64 weightSum = 0.0;
+		for (const fp32 weight : weights)
+		{
+			weightSum += weight;
+		}
+
+		const AliasTable table(weights);
+		ASSERT_EQ(table.GetCount(), entryCount);
+
+		std::mt19937 generator(0x5eed);
+		std::uniform_real_distribution<fp32> distribution(0.0f, 1.0f);
+		std::vector<u32> counts(entryCount, 0u);
+		for (u32 si = 0; si < SampleCount; ++si)
+		{
+			const fp32 slotRandom = distribution(generator);
+			const u32 index = table.Sample(slotRandom, distribution(generator));
+			ASSERT_LT(index, entryCount);
+			counts[index]++;
+		}
+
+		fp64 probabilitySum = 0.0;
+		for (u32 ei = 0; ei < entryCount; ++ei)
+		{
+			const fp64 probability = weights[ei] / weightSum;
+			EXPECT_NEAR(table.GetProbability(ei), probability, 1e-6 + 1e-5 * probability) << "entry " << ei;
+			probabilitySum += table.GetProbability(ei);
+
+			if (weights[ei] == 0.0f)
+			{
+				EXPECT_EQ(counts[ei], 0u) << "entry " << ei;
+				continue;
+			}
+
+			ExpectCountNear(counts[ei], probability, SampleCount);
+		}
+
+		EXPECT_NEAR(probabilitySum, 1.0, 1e-5);
+	}
+
+	EXPECT_TRUE(AliasTable(std::vector<fp32>(8, 0.0f)).IsEmpty());
+}
@@ -0,0 +1,57 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/bvh.h"
+
+using namespace dxray;
+using namespace dxray::riow;
+
+//Three rows of points, one along every axis, spaced by a factor above the bin count of the build. The surface area heuristic
+//splits a single point off per level for them, alternating between the rows, which without a depth limit builds a hierarchy of 99 levels.
+static constexpr u32 RowLength = 34;
+static constexpr fp32 RowSpacing = 13.0f;
+static constexpr u32 MaxTraversalDepth = 64;
+
+static u32 GetMaxDepth(const std::vector<BoundingVolumeHierarchy::Node>& a_nodes, const u32 a_nodeIndex)
+{
+	const BoundingVolumeHierarchy::Node& node = a_nodes[a_nodeIndex];
+	if (node.Count > 0)
+	{
+		return 0;
+	}
+
+	return 1 + vath::Max(GetMaxDepth(a_nodes, a_nodeIndex + 1), GetMaxDepth(a_nodes, node.Index));
+}
+
+TEST(BoundingVolumeHierarchy, DepthStaysWithinTraversalStack)
+{
+	std::vector<BoundingBox> primitiveBounds;
+	for (u32 axis = 0; axis < 3; ++axis)
+	{
+		for (u32 pi = 0; pi < RowLength; ++pi)
+		{
+			vath::Vector3f point(1.0f);
+			point[axis] = std::pow(RowSpacing, static_cast<fp32>(pi));
+			primitiveBounds.emplace_back().Expand(point);
+		}
+	}
+
+	BoundingVolumeHierarchy bvh;
+	std::vector<u32> primitiveOrder;
+	bvh.Build(primitiveBounds, primitiveOrder);
+	ASSERT_EQ(primitiveOrder.size(), primitiveBounds.size());
+
+	//The traversal stack holds one node per level plus the two children pushed last.
+	ASSERT_LT(GetMaxDepth(bvh.GetNodes(), 0), MaxTraversalDepth - 1);
+
+	//A ray along the first row overlaps every one of its leaves.
+	u32 visitedPrimitiveCount = 0;
+	const Ray ray(vath::Vector3f(0.0f, 1.0f, 1.0f), vath::Vector3f(1.0f, 0.0f, 0.0f), 0.0f);
+	bvh.Traverse(ray, 0.0f, fp32max, [&](const u32 a_first, const u32 a_count, fp32& a_closestHit)
+	{
+		(void)a_first;
+		(void)a_closestHit;
+		visitedPrimitiveCount += a_count;
+		return false;
+	});
+
+	EXPECT_GE(visitedPrimitiveCount, RowLength);
+}
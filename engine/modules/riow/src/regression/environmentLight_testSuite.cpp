@@ -0,0 +1,149 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/environmentLight.h"
+#include "riow/sampler.h"
+
+using namespace dxray;
+using namespace dxray::riow;
+
+static constexpr u32 SampleCount = 1 << 20;
+
+/// <summary>
+/// Each count follows a binomial distribution, a correct sampler stays within a few standard deviations of the expected count.
+/// </summary>
+static void ExpectCountNear(const u32 a_count, const fp64 a_probability, const u32 a_sampleCount)
+{
+	const fp64 expected = a_probability * a_sampleCount;
+	const fp64 standardDeviation = std::sqrt(vath::Max(expected * (1.0 - a_probability), 1.0));
+	EXPECT_NEAR(static_cast<fp64>(a_count), expected, 5.0 * standardDeviation + 0.01 * expected);
+}
+
+/// <summary>
+/// A dim sky that brightens towards the horizon, a bright sun and a black band, on a map small enough to bin every texel.
+/// </summary>
+static EnvironmentLight BuildTestEnvironment(vath::Vector2u32& a_dimensions)
+{
+	a_dimensions = vath::Vector2u32(32u, 16u);
+	std::vector<Color> texels(static_cast<usize>(a_dimensions.x) * a_dimensions.y);
+	for (u32 y = 0; y < a_dimensions.y; ++y)
+	{
+		for (u32 x = 0; x < a_dimensions.x; ++x)
+		{
+			const fp32 horizon = 1.0f - vath::Abs(static_cast<fp32>(y) + 0.5f - 0.5f * a_dimensions.y) / (0.5f * a_dimensions.y);
+			texels[x + y * a_dimensions.x] = y >= 13 ? Color(0.0f) : Color(0.2f + horizon, 0.3f + horizon, 0.5f + 0.1f * x);
+		}
+	}
+
+	texels[7 + 3 * a_dimensions.x] = Color(400.0f, 380.0f, 300.0f);
+	return EnvironmentLight(a_dimensions, texels, 2.0f);
+}
+
+/// <summary>
+/// Direction through the center of a texel, following the equirectangular layout of the environment.
+/// </summary>
+static vath::Vector3f GetTexelDirection(const vath::Vector2u32& a_dimensions, const fp64 a_x, const fp64 a_y)
+{
+	const fp64 phi = 2.0 * vath::Pi<fp64>() * a_x / a_dimensions.x;
+	const fp64 theta = vath::Pi<fp64>() * a_y / a_dimensions.y;
+	return vath::Vector3f(static_cast<fp32>(std::sin(theta) * std::cos(phi)), static_cast<fp32>(std::cos(theta)), static_cast<fp32>(-std::sin(theta) * std::sin(phi)));
+}
+
+static fp64 GetTexelSolidAngle(const vath::Vector2u32& a_dimensions, const u32 a_y)
+{
+	const fp64 pi = vath::Pi<fp64>();
+	return 2.0 * pi / a_dimensions.x * (std::cos(pi * a_y / a_dimensions.y) - std::cos(pi * (a_y + 1) / a_dimensions.y));
+}
+
+//The density is constant over every texel, so summing it over the texels integrates it exactly. A grid that ignores the texels confirms it.
+TEST(EnvironmentLight, PdfIntegratesToOne)
+{
+	vath::Vector2u32 dimensions;
+	const EnvironmentLight environment = BuildTestEnvironment(dimensions);
+
+	fp64 texelIntegral = 0.0;
+	for (u32 y = 0; y < dimensions.y; ++y)
+	{
+		for (u32 x = 0; x < dimensions.x; ++x)
+		{
+			texelIntegral += environment.GetPdf(GetTexelDirection(dimensions, x + 0.5, y + 0.5)) * GetTexelSolidAngle(dimensions, y);
+		}
+	}
+	EXPECT_NEAR(texelIntegral, 1.0, 1e-4);
+
+	constexpr u32 CosThetaStepCount = 1024;
+	constexpr u32 PhiStepCount = 2048;
+	const fp64 pi = vath::Pi<fp64>();
+	fp64 gridIntegral = 0.0;
+	for (u32 ci = 0; ci < CosThetaStepCount; ++ci)
+	{
+		const fp64 cosTheta = 1.0 - 2.0 * (ci + 0.5) / CosThetaStepCount;
+		const fp64 sinTheta = std::sqrt(1.0 - cosTheta * cosTheta);
+		for (u32 phiIndex = 0; phiIndex < PhiStepCount; ++phiIndex)
+		{
+			const fp64 phi = 2.0 * pi * (phiIndex + 0.5) / PhiStepCount;
+			const vath::Vector3f direction(static_cast<fp32>(sinTheta * std::cos(phi)), static_cast<fp32>(cosTheta), static_cast<fp32>(-sinTheta * std::sin(phi)));
+			gridIntegral += environment.GetPdf(direction) * (2.0 / CosThetaStepCount) * (2.0 * pi / PhiStepCount);
+		}
+	}
+	EXPECT_NEAR(gridIntegral, 1.0, 1e-2);
+
+	//Directions don't have to be normalized.
+	const vath::Vector3f sunDirection = GetTexelDirection(dimensions, 7.5, 3.5);
+	EXPECT_FLOAT_EQ(environment.GetPdf(sunDirection * 3.0f), environment.GetPdf(sunDirection));
+}
+
+//Samples land in every texel proportional to its luminance times its solid angle, and report the density and radiance of where they land.
+TEST(EnvironmentLight, SamplesFollowThePdf)
+{
+	vath::Vector2u32 dimensions;
+	const EnvironmentLight environment = BuildTestEnvironment(dimensions);
+
+	GetThreadSampler().Seed(0x5eed, 0u);
+	std::vector<u32> counts(static_cast<usize>(dimensions.x) * dimensions.y, 0u);
+	for (u32 si = 0; si < SampleCount; ++si)
+	{
+		vath::Vector3f direction;
+		Color radiance;
+		fp32 pdf = 0.0f;
+		ASSERT_TRUE(environment.Sample(direction, radiance, pdf));
+		ASSERT_NEAR(vath::Magnitude(direction), 1.0f, 1e-5f);
+		ASSERT_GT(Luminance(radiance), 0.0f);
+
+		//Directions on a texel border can round into the neighbouring texel, whose density differs.
+		const fp64 phi = std::atan2(-static_cast<fp64>(direction.z), static_cast<fp64>(direction.x));
+		const fp64 x = (phi < 0.0 ? phi + 2.0 * vath::Pi<fp64>() : phi) / (2.0 * vath::Pi<fp64>()) * dimensions.x;
+		const fp64 y = std::acos(vath::Clamp<fp64>(direction.y, -1.0, 1.0)) / vath::Pi<fp64>() * dimensions.y;
+		const u32 texelX = vath::Min(static_cast<u32>(x), dimensions.x - 1);
+		const u32 texelY = vath::Min(static_cast<u32>(y), dimensions.y - 1);
+		const fp64 borderDistance = vath::Min(vath::Min(x - std::floor(x), std::ceil(x) - x), vath::Min(y - std::floor(y), std::ceil(y) - y));
+		if (borderDistance > 1e-3)
+		{
+			ASSERT_NEAR(environment.GetPdf(direction), pdf, 1e-4f * pdf) << "sample " << si;
+			const Color evaluated = environment.Evaluate(direction);
+			ASSERT_EQ(evaluated.x, radiance.x);
+			ASSERT_EQ(evaluated.y, radiance.y);
+			ASSERT_EQ(evaluated.z, radiance.z);
+		}
+
+		counts[texelX + texelY * dimensions.x]++;
+	}
+
+	for (u32 y = 0; y < dimensions.y; ++y)
+	{
+		for (u32 x = 0; x < dimensions.x; ++x)
+		{
+			const fp64 probability = environment.GetPdf(GetTexelDirection(dimensions, x + 0.5, y + 0.5)) * GetTexelSolidAngle(dimensions, y);
+			SCOPED_TRACE(std::format("Texel {}, {}", x, y));
+			ExpectCountNear(counts[x + y * dimensions.x], probability, SampleCount);
+		}
+	}
+}
+
+TEST(EnvironmentLight, BlackEnvironmentIsNotSampled)
+{
+	const EnvironmentLight environment(vath::Vector2u32(4u, 2u), std::vector<Color>(8, Color(0.0f)));
+	vath::Vector3f direction;
+	Color radiance;
+	fp32 pdf = 0.0f;
+	EXPECT_FALSE(environment.Sample(direction, radiance, pdf));
+	EXPECT_EQ(environment.GetPdf(vath::Vector3f(0.0f, 1.0f, 0.0f)), 0.0f);
+}
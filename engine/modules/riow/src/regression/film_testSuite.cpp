@@ -0,0 +1,152 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/film.h"
+
+using namespace dxray;
+using namespace dxray::riow;
+
+static constexpr EReconstructionFilter FilterTypes[] = { EReconstructionFilter::Box, EReconstructionFilter::Tent, EReconstructionFilter::Gaussian, EReconstructionFilter::Mitchell };
+
+/// <summary>
+/// Splats a regular grid of samples per pixel over the region into a tile of its own and merges it.
+/// </summary>
+static void SplatSampleGrid(Film& a_film, const vath::Vector2u32& a_regionOffset, const vath::Vector2u32& a_regionDimensions, const u32 a_gridSize, const u64 a_tileIndex)
+{
+	FilmTile tile;
+	a_film.InitializeTile(a_regionOffset, a_regionDimensions, tile);
+	for (u32 y = a_regionOffset.y; y < a_regionOffset.y + a_regionDimensions.y; ++y)
+	{
+		for (u32 x = a_regionOffset.x; x < a_regionOffset.x + a_regionDimensions.x; ++x)
+		{
+			for (u32 si = 0; si < a_gridSize * a_gridSize; ++si)
+			{
+				const vath::Vector2f offset((static_cast<fp32>(si % a_gridSize) + 0.5f) / a_gridSize, (static_cast<fp32>(si / a_gridSize) + 0.5f) / a_gridSize);
+				tile.AddSample(vath::Vector2f(static_cast<fp32>(x), static_cast<fp32>(y)) + offset, Color(0.25f + 0.05f * x, 0.5f, 0.1f * y));
+			}
+		}
+	}
+
+	a_film.MergeTile(std::move(tile), a_tileIndex);
+}
+
+//The table is constant over every entry, a grid with a whole number of steps per entry integrates it exactly.
+TEST(ReconstructionFilter, IntegratesToOne)
+{
+	constexpr u32 StepCount = 4 * 2 * ReconstructionFilter::TableSize;
+	for (const EReconstructionFilter type : FilterTypes)
+	{
+		for (const fp32 radius : { 0.0f, 1.7f })
+		{
+			const ReconstructionFilter filter(type, radius);
+			SCOPED_TRACE(std::format("Filter {}, radius {}", static_cast<u32>(type), filter.GetRadius()));
+
+			const fp64 step = 2.0 * filter.GetRadius() / StepCount;
+			fp64 integral = 0.0;
+			for (u32 yi = 0; yi < StepCount; ++yi)
+			{
+				const fp32 y = static_cast<fp32>((yi + 0.5) * step - filter.GetRadius());
+				for (u32 xi = 0; xi < StepCount; ++xi)
+				{
+					integral += filter.Evaluate(static_cast<fp32>((xi + 0.5) * step - filter.GetRadius()), y) * step * step;
+				}
+			}
+
+			EXPECT_NEAR(integral, 1.0, 1e-4);
+		}
+	}
+}
+
+//Every sample adds a weight of 1 spread over the pixels around it, away from the border a pixel sums the weights of as many samples as landed in it.
+TEST(Film, PixelWeightsCountTheSamples)
+{
+	constexpr u32 GridSize = 29;
+	const vath::Vector2u32 dimensions(12u, 10u);
+	for (const EReconstructionFilter type : FilterTypes)
+	{
+		SCOPED_TRACE(std::format("Filter {}", static_cast<u32>(type)));
+		AccumulationBuffer buffer(dimensions);
+		Film film(buffer, ReconstructionFilter(type));
+		SplatSampleGrid(film, vath::Vector2u32(0u), dimensions, GridSize, 0);
+
+		const u32 margin = film.GetFilter().GetMarginInPx();
+		for (u32 y = margin; y < dimensions.y - margin; ++y)
+		{
+			for (u32 x = margin; x < dimensions.x - margin; ++x)
+			{
+				EXPECT_NEAR(buffer.GetWeightSumData()[x + y * dimensions.x], GridSize * GridSize, 0.02f * GridSize * GridSize) << "pixel " << x << ", " << y;
+			}
+		}
+	}
+}
+
+//The border between two pixels belongs to the pixel left of or above it, as the anti-aliasing offsets of the renderer lie in (0, 1].
+TEST(Film, BorderSamplesLandInASinglePixel)
+{
+	const vath::Vector2u32 dimensions(4u, 3u);
+	AccumulationBuffer buffer(dimensions);
+	Film film(buffer, ReconstructionFilter(EReconstructionFilter::Box));
+	ASSERT_EQ(film.GetFilter().GetMarginInPx(), 0u);
+
+	for (u32 yi = 0; yi <= 4 * dimensions.y; ++yi)
+	{
+		for (u32 xi = 0; xi <= 4 * dimensions.x; ++xi)
+		{
+			const vath::Vector2f position(0.25f * xi, 0.25f * yi);
+			SCOPED_TRACE(std::format("Sample {}, {}", position.x, position.y));
+			buffer.Clear();
+
+			FilmTile tile;
+			film.InitializeTile(vath::Vector2u32(0u), dimensions, tile);
+			tile.AddSample(position, Color(1.0f));
+			film.MergeTile(std::move(tile), 0);
+
+			//Samples on the left and top border of the image belong to the pixels before it.
+			const i32 pixelX = static_cast<i32>(std::ceil(position.x)) - 1;
+			const i32 pixelY = static_cast<i32>(std::ceil(position.y)) - 1;
+			for (u32 pi = 0; pi < buffer.GetPixelCount(); ++pi)
+			{
+				const bool bOwner = static_cast<i32>(pi % dimensions.x) == pixelX && static_cast<i32>(pi / dimensions.x) == pixelY;
+				EXPECT_EQ(buffer.GetWeightSumData()[pi], bOwner ? 1.0f : 0.0f) << "pixel " << pi;
+			}
+		}
+	}
+}
+
+//Tiles whose margins overlap are summed in the order they were handed out, whatever order they are merged in.
+TEST(Film, OverlappingTilesMergeInTileOrder)
+{
+	const vath::Vector2u32 dimensions(16u, 16u);
+	const vath::Vector2u32 tileDimensions(8u, 8u);
+	const u64 mergeOrders[][4] = { { 0, 1, 2, 3 }, { 2, 0, 3, 1 }, { 3, 2, 1, 0 } };
+
+	std::vector<fp32> referenceWeights;
+	std::vector<Color> referenceRadiance;
+	for (const u64 (&mergeOrder)[4] : mergeOrders)
+	{
+		AccumulationBuffer buffer(dimensions);
+		Film film(buffer, ReconstructionFilter(EReconstructionFilter::Gaussian));
+		ASSERT_GT(film.GetFilter().GetMarginInPx(), 0u);
+		for (const u64 tileIndex : mergeOrder)
+		{
+			const vath::Vector2u32 regionOffset(static_cast<u32>(tileIndex % 2) * tileDimensions.x, static_cast<u32>(tileIndex / 2) * tileDimensions.y);
+			SplatSampleGrid(film, regionOffset, tileDimensions, 3, tileIndex);
+		}
+
+		const std::vector<fp32> weights(buffer.GetWeightSumData(), buffer.GetWeightSumData() + buffer.GetPixelCount());
+		std::vector<Color> radiance;
+		buffer.Resolve(radiance);
+		if (referenceWeights.empty())
+		{
+			referenceWeights = weights;
+			referenceRadiance = radiance;
+			continue;
+		}
+
+		for (u32 pi = 0; pi < buffer.GetPixelCount(); ++pi)
+		{
+			ASSERT_EQ(weights[pi], referenceWeights[pi]) << "pixel " << pi;
+			ASSERT_EQ(radiance[pi].x, referenceRadiance[pi].x) << "pixel " << pi;
+			ASSERT_EQ(radiance[pi].y, referenceRadiance[pi].y) << "pixel " << pi;
+			ASSERT_EQ(radiance[pi].z, referenceRadiance[pi].z) << "pixel " << pi;
+		}
+	}
+}
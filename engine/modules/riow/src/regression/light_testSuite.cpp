@@ -0,0 +1,151 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/light.h"
+#include "riow/sampler.h"
+
+using namespace dxray;
+using namespace dxray::riow;
+
+static constexpr u32 LightCount = 64;
+
+/// <summary>
+/// Lights of different sizes and strengths scattered over a box, every fourth one moving.
+/// </summary>
+static void BuildTestLights(LightList& a_lights, MaterialTable& a_materials, TextureTable& a_textures, const EnvironmentLight* a_pEnvironment)
+{
+	std::mt19937 generator(0x5eed);
+	std::uniform_real_distribution<fp32> distribution(0.0f, 1.0f);
+	const TextureId white = a_textures.AddSolidColor(Color(1.0f));
+	for (u32 li = 0; li < LightCount; ++li)
+	{
+		SphereLight light;
+		light.Center = vath::Vector3f(distribution(generator), distribution(generator), distribution(generator)) * 20.0f - vath::Vector3f(10.0f);
+		light.Radius = 0.05f + 0.45f * distribution(generator);
+		light.Velocity = li % 4 == 0 ? vath::Vector3f(distribution(generator) - 0.5f, distribution(generator) - 0.5f, distribution(generator) - 0.5f) * 4.0f : vath::Vector3f(0.0f);
+		light.Material = a_materials.Add(DiffuseLight(white, std::exp2(distribution(generator) * 8.0f - 2.0f)));
+		a_lights.Add(light, 0, li);
+	}
+
+	a_lights.Build(a_materials, a_textures, a_pEnvironment, 0.0f, 1.0f);
+}
+
+/// <summary>
+/// 1 - cos of the half angle of the cone the light covers from the point, 0 within the light.
+/// </summary>
+static fp64 GetConeOneMinusCosAngle(const SphereLight& a_light, const vath::Vector3f& a_point, const fp32 a_time)
+{
+	const vath::Vector3f toCenter = a_light.GetCenter(a_time) - a_point;
+	const fp64 sinSquared = static_cast<fp64>(a_light.Radius) * a_light.Radius / vath::SqrMagnitude(toCenter);
+	return sinSquared >= 1.0 ? 0.0 : sinSquared / (1.0 + std::sqrt(1.0 - sinSquared));
+}
+
+static bool IsWithinAnyLight(const LightList& a_lights, const vath::Vector3f& a_point, const fp32 a_time)
+{
+	for (u32 li = 0; li < a_lights.GetCount(); ++li)
+	{
+		if (GetConeOneMinusCosAngle(a_lights.GetLight(li), a_point, a_time) <= 0.0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//Multiple importance sampling weighs the directions found by scattering with GetPdf, which has to agree with the density Sample reports.
+TEST(LightList, PdfMatchesTheSampledDensity)
+{
+	//A single texel has no borders to round across, its density is the same in every direction.
+	const EnvironmentLight environment(vath::Vector2u32(1u, 1u), { Color(0.3f, 0.5f, 0.9f) });
+	for (const EnvironmentLight* pEnvironment : { static_cast<const EnvironmentLight*>(nullptr), &environment })
+	{
+		SCOPED_TRACE(pEnvironment == nullptr ? "Without environment" : "With environment");
+		LightList lights;
+		MaterialTable materials;
+		TextureTable textures;
+		BuildTestLights(lights, materials, textures, pEnvironment);
+
+		std::mt19937 generator(0x5eed);
+		std::uniform_real_distribution<fp32> distribution(0.0f, 1.0f);
+		GetThreadSampler().Seed(0x5eed, 0u);
+		u32 lightSampleCount = 0;
+		u32 environmentSampleCount = 0;
+		for (u32 pi = 0; pi < 512; ++pi)
+		{
+			const vath::Vector3f point = vath::Vector3f(distribution(generator), distribution(generator), distribution(generator)) * 24.0f - vath::Vector3f(12.0f);
+			const fp32 time = distribution(generator);
+			if (IsWithinAnyLight(lights, point, time))
+			{
+				continue;
+			}
+
+			for (u32 si = 0; si < 64; ++si)
+			{
+				LightSample sample;
+				ASSERT_TRUE(lights.Sample(point, time, materials, textures, sample));
+				ASSERT_GT(sample.Pdf, 0.0f);
+				if (sample.Point.LightIndex == InvalidLightIndex)
+				{
+					ASSERT_NE(pEnvironment, nullptr);
+					ASSERT_NEAR(lights.GetEnvironmentPdf(sample.Direction), sample.Pdf, 1e-5f * sample.Pdf) << "point " << pi;
+					++environmentSampleCount;
+				}
+				else
+				{
+					ASSERT_NEAR(lights.GetPdf(sample.Point.LightIndex, point, time), sample.Pdf, 1e-4f * sample.Pdf) << "point " << pi << ", light " << sample.Point.LightIndex;
+					++lightSampleCount;
+				}
+			}
+		}
+
+		EXPECT_GT(lightSampleCount, 0u);
+		EXPECT_EQ(environmentSampleCount > 0, pEnvironment != nullptr);
+	}
+}
+
+//The probability of picking a light is its density over the density of sampling its cone, the lights are picked that often and together with the environment sum to 1.
+TEST(LightList, LightsArePickedWithTheirSelectionProbability)
+{
+	constexpr u32 SampleCount = 1 << 18;
+	const EnvironmentLight environment(vath::Vector2u32(1u, 1u), { Color(1.0f) });
+	LightList lights;
+	MaterialTable materials;
+	TextureTable textures;
+	BuildTestLights(lights, materials, textures, &environment);
+
+	const vath::Vector3f points[] =
+	{
+		vath::Vector3f(0.0f),
+		vath::Vector3f(9.5f, -3.0f, 2.0f),
+		vath::Vector3f(-30.0f, 20.0f, 5.0f),
+	};
+
+	const fp32 time = 0.5f;
+	GetThreadSampler().Seed(0x5eed, 0u);
+	for (const vath::Vector3f& point : points)
+	{
+		SCOPED_TRACE(std::format("Point {} {} {}", point.x, point.y, point.z));
+		ASSERT_FALSE(IsWithinAnyLight(lights, point, time));
+
+		std::vector<u32> counts(LightCount + 1, 0u);
+		for (u32 si = 0; si < SampleCount; ++si)
+		{
+			LightSample sample;
+			ASSERT_TRUE(lights.Sample(point, time, materials, textures, sample));
+			counts[sample.Point.LightIndex == InvalidLightIndex ? LightCount : sample.Point.LightIndex]++;
+		}
+
+		fp64 probabilitySum = 0.0;
+		for (u32 li = 0; li <= LightCount; ++li)
+		{
+			const fp64 probability = li == LightCount ? 0.5 :
+				lights.GetPdf(li, point, time) * 2.0 * vath::Pi<fp64>() * GetConeOneMinusCosAngle(lights.GetLight(li), point, time);
+			probabilitySum += probability;
+
+			const fp64 expected = probability * SampleCount;
+			const fp64 standardDeviation = std::sqrt(vath::Max(expected * (1.0 - probability), 1.0));
+			EXPECT_NEAR(static_cast<fp64>(counts[li]), expected, 5.0 * standardDeviation + 0.01 * expected) << "light " << li;
+		}
+
+		EXPECT_NEAR(probabilitySum, 1.0, 1e-4);
+	}
+}
@@ -0,0 +1,186 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/medium.h"
+#include "riow/sampler.h"
+
+using namespace dxray;
+using namespace dxray::riow;
+
+static constexpr u32 EstimateCount = 1 << 15;
+static constexpr u32 MarchStepCount = 4096;
+
+/// <summary>
+/// Smoke over the lower half of [0, 4] along x, the upper half is empty. With majorant cells of 4 voxels the
+/// outer cells along x hold no density, not even through interpolation.
+/// </summary>
+static MediumDensity BuildHalfFilledGrid(const u32 a_majorantCellSize)
+{
+	constexpr u32 resolution = 16;
+	BoundingBox bounds;
+	bounds.Expand(vath::Vector3f(0.0f));
+	bounds.Expand(vath::Vector3f(4.0f));
+
+	std::vector<fp32> densities(resolution * resolution * resolution);
+	for (u32 z = 0; z < resolution; ++z)
+	{
+		for (u32 y = 0; y < resolution; ++y)
+		{
+			for (u32 x = 0; x < resolution; ++x)
+			{
+				const vath::Vector3f center = (vath::Vector3f(static_cast<fp32>(x), static_cast<fp32>(y), static_cast<fp32>(z)) + vath::Vector3f(0.5f)) * 0.25f;
+				densities[x + resolution * (y + resolution * z)] = center.x < 2.0f ? 0.1f + 0.4f * (1.0f + std::sin(2.3f * center.x + 1.7f * center.y) * std::cos(1.3f * center.z)) : 0.0f;
+			}
+		}
+	}
+
+	return MediumDensity::Grid(bounds, vath::Vector3u32(resolution), std::move(densities), 1.0f, a_majorantCellSize);
+}
+
+/// <summary>
+/// Transmittance along the ray from the midpoint rule over the interpolated density.
+/// </summary>
+static fp64 RayMarchTransmittance(const MediumDensity& a_medium, const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax)
+{
+	const fp64 step = static_cast<fp64>(a_tMax - a_tMin) / MarchStepCount;
+	fp64 opticalDepth = 0.0;
+	for (u32 si = 0; si < MarchStepCount; ++si)
+	{
+		opticalDepth += a_medium.GetDensity(a_ray.At(a_tMin + static_cast<fp32>(step * (si + 0.5)))) * step;
+	}
+
+	return std::exp(-opticalDepth * vath::Magnitude(a_ray.GetDirection()));
+}
+
+//Directions are not normalized, tracking has to scale its rates by their length.
+static const Ray TestRays[] =
+{
+	Ray(vath::Vector3f(-1.0f, 1.3f, 2.1f), vath::Vector3f(2.0f, 0.1f, -0.2f)),
+	Ray(vath::Vector3f(0.5f, -1.0f, 0.7f), vath::Vector3f(0.1f, 0.5f, 0.3f)),
+	Ray(vath::Vector3f(1.0f, 2.0f, 5.0f), vath::Vector3f(0.0f, 0.0f, -1.0f)),
+};
+
+TEST(MediumDensity, ConstantMatchesBeerLambert)
+{
+	const MediumDensity medium = MediumDensity::Constant(0.7f);
+	const Ray ray(vath::Vector3f(0.0f), vath::Vector3f(0.0f, 0.0f, 2.0f));
+	const fp64 transmittance = std::exp(-0.7 * 2.0 * 1.5);
+
+	u32 stepCount = 0;
+	EXPECT_NEAR(medium.EstimateTransmittance(ray, 0.0f, 1.5f, stepCount), transmittance, 1e-6);
+
+	GetThreadSampler().Seed(0x5eed, 0u);
+	u32 passedCount = 0;
+	for (u32 ei = 0; ei < EstimateCount; ++ei)
+	{
+		fp32 tCollision = 0.0f;
+		passedCount += medium.SampleCollision(ray, 0.0f, 1.5f, tCollision, stepCount) ? 0 : 1;
+	}
+
+	const fp64 standardDeviation = std::sqrt(transmittance * (1.0 - transmittance) / EstimateCount);
+	EXPECT_NEAR(static_cast<fp64>(passedCount) / EstimateCount, transmittance, 5.0 * standardDeviation);
+}
+
+//Cells without density are stepped over without a single tentative collision, a majorant over the whole grid has to track through them.
+TEST(MediumDensity, EmptyMajorantCellsAreSkipped)
+{
+	const Ray emptyRay(vath::Vector3f(3.5f, 0.5f, -1.0f), vath::Vector3f(0.0f, 0.5f, 1.0f));
+	GetThreadSampler().Seed(0x5eed, 0u);
+
+	const MediumDensity fineMedium = BuildHalfFilledGrid(4);
+	u32 fineStepCount = 0;
+	for (u32 ei = 0; ei < 64; ++ei)
+	{
+		fp32 tCollision = 0.0f;
+		EXPECT_FALSE(fineMedium.SampleCollision(emptyRay, 0.0f, 10.0f, tCollision, fineStepCount));
+		EXPECT_EQ(fineMedium.EstimateTransmittance(emptyRay, 0.0f, 10.0f, fineStepCount), 1.0f);
+	}
+	EXPECT_EQ(fineStepCount, 0u);
+
+	const MediumDensity coarseMedium = BuildHalfFilledGrid(16);
+	u32 coarseStepCount = 0;
+	for (u32 ei = 0; ei < 64; ++ei)
+	{
+		fp32 tCollision = 0.0f;
+		EXPECT_FALSE(coarseMedium.SampleCollision(emptyRay, 0.0f, 10.0f, tCollision, coarseStepCount));
+		EXPECT_EQ(coarseMedium.EstimateTransmittance(emptyRay, 0.0f, 10.0f, coarseStepCount), 1.0f);
+	}
+	EXPECT_GT(coarseStepCount, 0u);
+}
+
+//A tighter majorant grid takes fewer tentative collisions through the smoke, both estimate the same transmittance.
+TEST(MediumDensity, RatioTrackingMatchesRayMarchedTransmittance)
+{
+	for (const u32 majorantCellSize : { 4u, 16u })
+	{
+		const MediumDensity medium = BuildHalfFilledGrid(majorantCellSize);
+		GetThreadSampler().Seed(0x5eed, majorantCellSize);
+		for (const Ray& ray : TestRays)
+		{
+			SCOPED_TRACE(std::format("Majorant cell size {}, ray direction {} {} {}", majorantCellSize, ray.GetDirection().x, ray.GetDirection().y, ray.GetDirection().z));
+			const fp64 transmittance = RayMarchTransmittance(medium, ray, 0.0f, 6.0f);
+			ASSERT_GT(transmittance, 0.01);
+			ASSERT_LT(transmittance, 0.99);
+
+			fp64 sum = 0.0;
+			fp64 squaredSum = 0.0;
+			u32 stepCount = 0;
+			for (u32 ei = 0; ei < EstimateCount; ++ei)
+			{
+				const fp64 estimate = medium.EstimateTransmittance(ray, 0.0f, 6.0f, stepCount);
+				sum += estimate;
+				squaredSum += estimate * estimate;
+			}
+
+			const fp64 mean = sum / EstimateCount;
+			const fp64 standardError = std::sqrt(vath::Max(squaredSum / EstimateCount - mean * mean, 0.0) / EstimateCount);
+			EXPECT_NEAR(mean, transmittance, 5.0 * standardError + 1e-3);
+		}
+	}
+
+	u32 fineStepCount = 0;
+	u32 coarseStepCount = 0;
+	const MediumDensity fineMedium = BuildHalfFilledGrid(2);
+	const MediumDensity coarseMedium = BuildHalfFilledGrid(16);
+	for (u32 ei = 0; ei < 1024; ++ei)
+	{
+		fineMedium.EstimateTransmittance(TestRays[0], 0.0f, 6.0f, fineStepCount);
+		coarseMedium.EstimateTransmittance(TestRays[0], 0.0f, 6.0f, coarseStepCount);
+	}
+	EXPECT_LT(fineStepCount, coarseStepCount);
+}
+
+//The first collision is distributed as 1 - T(t), checked at the quartiles of the ray interval.
+TEST(MediumDensity, DeltaTrackingMatchesRayMarchedTransmittance)
+{
+	constexpr u32 QuartileCount = 4;
+	for (const u32 majorantCellSize : { 4u, 16u })
+	{
+		const MediumDensity medium = BuildHalfFilledGrid(majorantCellSize);
+		GetThreadSampler().Seed(0x5eed, majorantCellSize);
+		for (const Ray& ray : TestRays)
+		{
+			SCOPED_TRACE(std::format("Majorant cell size {}, ray direction {} {} {}", majorantCellSize, ray.GetDirection().x, ray.GetDirection().y, ray.GetDirection().z));
+			u32 collisionCounts[QuartileCount] = {};
+			u32 stepCount = 0;
+			for (u32 ei = 0; ei < EstimateCount; ++ei)
+			{
+				fp32 tCollision = 0.0f;
+				if (medium.SampleCollision(ray, 0.0f, 6.0f, tCollision, stepCount))
+				{
+					ASSERT_GE(tCollision, 0.0f);
+					ASSERT_LT(tCollision, 6.0f);
+					ASSERT_GT(medium.GetDensity(ray.At(tCollision)), 0.0f);
+					collisionCounts[vath::Min(static_cast<u32>(tCollision / 6.0f * QuartileCount), QuartileCount - 1)]++;
+				}
+			}
+
+			u32 collidedCount = 0;
+			for (u32 qi = 0; qi < QuartileCount; ++qi)
+			{
+				collidedCount += collisionCounts[qi];
+				const fp64 probability = 1.0 - RayMarchTransmittance(medium, ray, 0.0f, 6.0f * (qi + 1) / QuartileCount);
+				const fp64 standardDeviation = std::sqrt(vath::Max(probability * (1.0 - probability), 1e-4) / EstimateCount);
+				EXPECT_NEAR(static_cast<fp64>(collidedCount) / EstimateCount, probability, 5.0 * standardDeviation) << "quartile " << qi;
+			}
+		}
+	}
+}
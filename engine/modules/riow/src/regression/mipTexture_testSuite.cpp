@@ -0,0 +1,204 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/mipTexture.h"
+#include "riow/traceable/sphere.h"
+
+using namespace dxray;
+using namespace dxray::riow;
+
+static constexpr u32 LevelCount = 5;
+static const vath::Vector2u32 TextureDimensions(16u, 8u);
+
+/// <summary>
+/// Texels without structure, so every mip level and every bilinear weight shows in the samples.
+/// </summary>
+static std::vector<Color> MakeTestTexels(const vath::Vector2u32& a_dimensions)
+{
+	std::vector<Color> texels(static_cast<usize>(a_dimensions.x) * a_dimensions.y);
+	u32 state = 0x9E3779B9u;
+	auto NextUnitFloat = [&state]()
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return static_cast<fp32>(state >> 8) / static_cast<fp32>(1u << 24);
+	};
+
+	for (Color& texel : texels)
+	{
+		texel = Color(NextUnitFloat(), NextUnitFloat(), NextUnitFloat());
+	}
+
+	return texels;
+}
+
+/// <summary>
+/// Bilinear lookup from the texels of a level, texel centers at half texel offsets and clamped addressing.
+/// </summary>
+static Color ReferenceBilinear(const MipTexture& a_texture, const u32 a_level, const vath::Vector2f& a_uvCoord)
+{
+	const vath::Vector2u32 dimensions = a_texture.GetLevelDimensions(a_level);
+	const fp64 x = static_cast<fp64>(vath::Clamp(a_uvCoord.x, 0.0f, 1.0f)) * dimensions.x - 0.5;
+	const fp64 y = static_cast<fp64>(vath::Clamp(a_uvCoord.y, 0.0f, 1.0f)) * dimensions.y - 0.5;
+	const i32 x0 = static_cast<i32>(std::floor(x));
+	const i32 y0 = static_cast<i32>(std::floor(y));
+	const fp32 tx = static_cast<fp32>(x - x0);
+	const fp32 ty = static_cast<fp32>(y - y0);
+	return a_texture.ReadTexel(a_level, x0, y0) * (1.0f - tx) * (1.0f - ty) + a_texture.ReadTexel(a_level, x0 + 1, y0) * tx * (1.0f - ty) +
+		a_texture.ReadTexel(a_level, x0, y0 + 1) * (1.0f - tx) * ty + a_texture.ReadTexel(a_level, x0 + 1, y0 + 1) * tx * ty;
+}
+
+static void ExpectColorNear(const Color& a_lhs, const Color& a_rhs, const fp32 a_tolerance)
+{
+	EXPECT_NEAR(a_lhs.x, a_rhs.x, a_tolerance);
+	EXPECT_NEAR(a_lhs.y, a_rhs.y, a_tolerance);
+	EXPECT_NEAR(a_lhs.z, a_rhs.z, a_tolerance);
+}
+
+static const vath::Vector2f TestUvs[] =
+{
+	vath::Vector2f(0.0f, 0.0f), vath::Vector2f(1.0f, 1.0f), vath::Vector2f(0.5f, 0.5f), vath::Vector2f(0.137f, 0.811f),
+	vath::Vector2f(0.93f, 0.21f), vath::Vector2f(0.3125f, 0.0625f), vath::Vector2f(-0.2f, 1.3f)
+};
+
+//Every level is the 2x2 box filtered level before it, down to a single texel holding the mean of the texture. Half texels stay within their precision.
+TEST(MipTexture, BuildsTheMipChain)
+{
+	const std::vector<Color> texels = MakeTestTexels(TextureDimensions);
+	for (const MipTexture::ETexelFormat format : { MipTexture::ETexelFormat::Float32, MipTexture::ETexelFormat::Float16 })
+	{
+		SCOPED_TRACE(format == MipTexture::ETexelFormat::Float32 ? "Float32" : "Float16");
+		const fp32 tolerance = format == MipTexture::ETexelFormat::Float32 ? 1e-6f : 1e-3f;
+		const MipTexture texture(TextureDimensions, texels, format);
+		ASSERT_EQ(texture.GetLevelCount(), LevelCount);
+		EXPECT_EQ(texture.GetTexelFormat(), format);
+
+		for (u32 ti = 0; ti < texels.size(); ++ti)
+		{
+			ExpectColorNear(texture.ReadTexel(0, ti % TextureDimensions.x, ti / TextureDimensions.x), texels[ti], tolerance);
+		}
+
+		for (u32 level = 1; level < LevelCount; ++level)
+		{
+			const vath::Vector2u32 dimensions = texture.GetLevelDimensions(level);
+			EXPECT_EQ(dimensions.x, vath::Max(TextureDimensions.x >> level, 1u));
+			EXPECT_EQ(dimensions.y, vath::Max(TextureDimensions.y >> level, 1u));
+
+			const vath::Vector2u32 sourceDimensions = texture.GetLevelDimensions(level - 1);
+			for (u32 y = 0; y < dimensions.y; ++y)
+			{
+				for (u32 x = 0; x < dimensions.x; ++x)
+				{
+					const i32 sourceX = static_cast<i32>(vath::Min(x * 2, sourceDimensions.x - 1));
+					const i32 sourceY = static_cast<i32>(vath::Min(y * 2, sourceDimensions.y - 1));
+					const Color expected = (texture.ReadTexel(level - 1, sourceX, sourceY) + texture.ReadTexel(level - 1, sourceX + 1, sourceY) +
+						texture.ReadTexel(level - 1, sourceX, sourceY + 1) + texture.ReadTexel(level - 1, sourceX + 1, sourceY + 1)) * 0.25f;
+					ExpectColorNear(texture.ReadTexel(level, x, y), expected, tolerance);
+				}
+			}
+		}
+
+		Color mean(0.0f);
+		for (const Color& texel : texels)
+		{
+			mean += texel / static_cast<fp32>(texels.size());
+		}
+		ExpectColorNear(texture.ReadTexel(LevelCount - 1, 0, 0), mean, tolerance);
+	}
+
+	//Odd dimensions drop the last row and column of the level before.
+	const MipTexture oddTexture(vath::Vector2u32(5u, 3u), MakeTestTexels(vath::Vector2u32(5u, 3u)), MipTexture::ETexelFormat::Float32);
+	ASSERT_EQ(oddTexture.GetLevelCount(), 3u);
+	EXPECT_EQ(oddTexture.GetLevelDimensions(1).x, 2u);
+	EXPECT_EQ(oddTexture.GetLevelDimensions(1).y, 1u);
+	EXPECT_EQ(oddTexture.GetLevelDimensions(2).x, 1u);
+	EXPECT_EQ(oddTexture.GetLevelDimensions(2).y, 1u);
+	ExpectColorNear(oddTexture.ReadTexel(1, 1, 0), (oddTexture.ReadTexel(0, 2, 0) + oddTexture.ReadTexel(0, 3, 0) + oddTexture.ReadTexel(0, 2, 1) + oddTexture.ReadTexel(0, 3, 1)) * 0.25f, 1e-6f);
+}
+
+TEST(MipTexture, BilinearLookupInterpolatesTexelCenters)
+{
+	const std::vector<Color> texels = MakeTestTexels(TextureDimensions);
+	const MipTexture texture(TextureDimensions, texels, MipTexture::ETexelFormat::Float32, MipTexture::EFilter::Bilinear);
+
+	//Texel centers return the texel, the midpoint between two centers their mean.
+	const vath::Vector2f texelSize(1.0f / TextureDimensions.x, 1.0f / TextureDimensions.y);
+	ExpectColorNear(texture.Sample(vath::Vector2f(3.5f * texelSize.x, 2.5f * texelSize.y), 0.0f), texels[3 + 2 * TextureDimensions.x], 1e-6f);
+	ExpectColorNear(texture.Sample(vath::Vector2f(4.0f * texelSize.x, 2.5f * texelSize.y), 0.0f), (texels[3 + 2 * TextureDimensions.x] + texels[4 + 2 * TextureDimensions.x]) * 0.5f, 1e-6f);
+
+	//Addressing is clamped, the corners beyond the outer texel centers return the corner texels.
+	ExpectColorNear(texture.Sample(vath::Vector2f(0.0f, 0.0f), 0.0f), texels[0], 1e-6f);
+	ExpectColorNear(texture.Sample(vath::Vector2f(1.2f, 1.0f), 0.0f), texels.back(), 1e-6f);
+
+	for (const vath::Vector2f& uv : TestUvs)
+	{
+		ExpectColorNear(texture.Sample(uv, 0.0f), ReferenceBilinear(texture, 0, uv), 1e-5f);
+	}
+}
+
+//The footprint in texels of the finest level picks log2 of it as the level, bilinear lookups round to the nearest level.
+TEST(MipTexture, FootprintSelectsTheMipLevel)
+{
+	const MipTexture texture(TextureDimensions, MakeTestTexels(TextureDimensions), MipTexture::ETexelFormat::Float32, MipTexture::EFilter::Bilinear);
+	const fp32 texelFootprint = 1.0f / static_cast<fp32>(vath::Max(TextureDimensions.x, TextureDimensions.y));
+	for (const vath::Vector2f& uv : TestUvs)
+	{
+		ExpectColorNear(texture.Sample(uv, 0.5f * texelFootprint), ReferenceBilinear(texture, 0, uv), 1e-5f);
+		for (u32 level = 0; level < LevelCount; ++level)
+		{
+			SCOPED_TRACE(std::format("Level {}", level));
+			ExpectColorNear(texture.Sample(uv, std::exp2(static_cast<fp32>(level)) * texelFootprint), ReferenceBilinear(texture, level, uv), 1e-5f);
+			ExpectColorNear(texture.Sample(uv, std::exp2(static_cast<fp32>(level) + 0.4f) * texelFootprint), ReferenceBilinear(texture, level, uv), 1e-5f);
+			if (level + 1 < LevelCount)
+			{
+				ExpectColorNear(texture.Sample(uv, std::exp2(static_cast<fp32>(level) + 0.6f) * texelFootprint), ReferenceBilinear(texture, level + 1, uv), 1e-5f);
+			}
+		}
+
+		//Footprints wider than the texture stay at the single texel level.
+		ExpectColorNear(texture.Sample(uv, 100.0f), texture.ReadTexel(LevelCount - 1, 0, 0), 1e-5f);
+	}
+}
+
+TEST(MipTexture, TrilinearBlendsNeighbouringLevels)
+{
+	const MipTexture texture(TextureDimensions, MakeTestTexels(TextureDimensions), MipTexture::ETexelFormat::Float32, MipTexture::EFilter::Trilinear);
+	const fp32 texelFootprint = 1.0f / static_cast<fp32>(vath::Max(TextureDimensions.x, TextureDimensions.y));
+	for (const vath::Vector2f& uv : TestUvs)
+	{
+		for (u32 level = 0; level + 1 < LevelCount; ++level)
+		{
+			for (const fp32 blend : { 0.0f, 0.25f, 0.5f, 0.9f })
+			{
+				SCOPED_TRACE(std::format("Level {}, blend {}", level, blend));
+				const Color fine = ReferenceBilinear(texture, level, uv);
+				const Color coarse = ReferenceBilinear(texture, level + 1, uv);
+				ExpectColorNear(texture.Sample(uv, std::exp2(static_cast<fp32>(level) + blend) * texelFootprint), fine + (coarse - fine) * blend, 1e-4f);
+			}
+		}
+	}
+}
+
+//A pixel cone hitting a sphere head on covers twice the uv footprint at twice the distance, which moves the lookup one level up.
+TEST(MipTexture, RayConeFootprintSelectsCoarserLevelsWithDistance)
+{
+	const MipTexture texture(TextureDimensions, MakeTestTexels(TextureDimensions), MipTexture::ETexelFormat::Float32, MipTexture::EFilter::Bilinear);
+	const Sphere sphere(vath::Vector3f(0.0f), 1.0f);
+
+	//At the first distance the cone covers a single texel of the finest level.
+	constexpr fp32 firstDistance = 2.0f;
+	const RayCone cone{ 0.0f, vath::Pi<fp32>() / (static_cast<fp32>(TextureDimensions.x) * firstDistance) };
+	for (u32 level = 0; level < LevelCount; ++level)
+	{
+		SCOPED_TRACE(std::format("Level {}", level));
+		const fp32 distance = firstDistance * std::exp2(static_cast<fp32>(level));
+		const Ray ray(vath::Vector3f(0.3f, 0.2f, 1.0f + distance), vath::Vector3f(0.0f, 0.0f, -1.0f));
+
+		IntersectionInfo hitInfo;
+		ASSERT_TRUE(sphere.DoesIntersect(ray, 0.001f, fp32max, hitInfo));
+		EXPECT_NEAR(hitInfo.UvScale, 1.0f / vath::Pi<fp32>(), 1e-6f);
+
+		//The renderer widens the footprint at grazing angles as well, the hits here are close enough to head on to leave it out.
+		const fp32 uvFootprint = cone.GetWidthAt(hitInfo.Length) * hitInfo.UvScale;
+		ExpectColorNear(texture.Sample(hitInfo.UvCoord, uvFootprint), ReferenceBilinear(texture, level, hitInfo.UvCoord), 1e-5f);
+	}
+}
@@ -0,0 +1,127 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/pathGuide.h"
+#include "riow/sampler.h"
+
+using namespace dxray;
+using namespace dxray::riow;
+
+static constexpr u32 SampleCount = 1 << 20;
+static constexpr u32 RecordCount = 1 << 16;
+
+//Bins over the square the quadtree maps onto the sphere, x follows the cosine and y the azimuth. Quadrants at the test depth are dyadic squares
+//no smaller than a subdivision of a bin, so the pdf is constant over every subdivision and the midpoint rule integrates it exactly.
+static constexpr u32 BinCount = 16;
+static constexpr u32 SubdivisionCount = 8;
+static constexpr u32 MaxDirectionalDepth = 7;
+
+/// <summary>
+/// Quadtree trained on two lobes of flux over a dim floor, refined twice so it is several levels deep around the lobes and shallow elsewhere.
+/// </summary>
+static DirectionalQuadtree BuildTrainedQuadtree()
+{
+	const vath::Vector3f lobeDirections[] = { vath::Normalize(vath::Vector3f(1.0f, 1.0f, 2.0f)), vath::Normalize(vath::Vector3f(-1.0f, 0.2f, -0.5f)) };
+	GetThreadSampler().Seed(0x5eed, 0u);
+
+	DirectionalQuadtree quadtree;
+	for (u32 iteration = 0; iteration < 3; ++iteration)
+	{
+		if (iteration > 0)
+		{
+			quadtree = quadtree.Refine(0.01f, MaxDirectionalDepth);
+		}
+
+		for (u32 ri = 0; ri < RecordCount; ++ri)
+		{
+			const vath::Vector3f direction = vath::SquareToUniformSphere(vath::Vector2f(RandomFloat(), RandomFloat()));
+			fp32 flux = 0.05f;
+			for (const vath::Vector3f& lobeDirection : lobeDirections)
+			{
+				flux += std::pow(vath::Max(vath::Dot(direction, lobeDirection), 0.0f), 20.0f);
+			}
+
+			quadtree.Record(direction, flux);
+		}
+
+		quadtree.Build();
+	}
+
+	return quadtree;
+}
+
+static vath::Vector3f BinPointToDirection(const fp64 a_x, const fp64 a_y)
+{
+	const fp64 cosTheta = 2.0 * a_x - 1.0;
+	const fp64 sinTheta = std::sqrt(vath::Max(0.0, 1.0 - cosTheta * cosTheta));
+	const fp64 phi = 2.0 * vath::Pi<fp64>() * a_y;
+	return vath::Vector3f(static_cast<fp32>(sinTheta * std::cos(phi)), static_cast<fp32>(sinTheta * std::sin(phi)), static_cast<fp32>(cosTheta));
+}
+
+TEST(DirectionalQuadtree, RefinesTowardsFlux)
+{
+	const DirectionalQuadtree quadtree = BuildTrainedQuadtree();
+	EXPECT_GT(quadtree.GetNodeCount(), 16u);
+	EXPECT_GT(quadtree.GetFlux(), 0.0f);
+
+	//The lobes get a far higher density than the floor between them.
+	EXPECT_GT(quadtree.GetPdf(vath::Normalize(vath::Vector3f(1.0f, 1.0f, 2.0f))), 10.0f * quadtree.GetPdf(vath::Vector3f(0.0f, -1.0f, 0.0f)));
+}
+
+TEST(DirectionalQuadtree, SamplePdfMatchesGetPdf)
+{
+	const DirectionalQuadtree quadtree = BuildTrainedQuadtree();
+	GetThreadSampler().Seed(0x12345678, 0u);
+	for (u32 si = 0; si < SampleCount / 16; ++si)
+	{
+		fp32 pdf = 0.0f;
+		const vath::Vector3f direction = quadtree.Sample(vath::Vector2f(RandomFloat(), RandomFloat()), pdf);
+		ASSERT_NEAR(vath::Magnitude(direction), 1.0f, 1e-5f);
+		ASSERT_GT(pdf, 0.0f);
+
+		EXPECT_NEAR(quadtree.GetPdf(direction), pdf, 1e-3f * pdf) << "sample " << si;
+	}
+}
+
+TEST(DirectionalQuadtree, SamplesFollowPdf)
+{
+	const DirectionalQuadtree quadtree = BuildTrainedQuadtree();
+	std::vector<u32> counts(BinCount * BinCount, 0u);
+	GetThreadSampler().Seed(0x87654321, 0u);
+	for (u32 si = 0; si < SampleCount; ++si)
+	{
+		fp32 pdf = 0.0f;
+		const vath::Vector3f direction = quadtree.Sample(vath::Vector2f(RandomFloat(), RandomFloat()), pdf);
+		fp64 phi = std::atan2(static_cast<fp64>(direction.y), static_cast<fp64>(direction.x));
+		phi = phi < 0.0 ? phi + 2.0 * vath::Pi<fp64>() : phi;
+		const u32 bx = vath::Min(static_cast<u32>((static_cast<fp64>(direction.z) + 1.0) * 0.5 * BinCount), BinCount - 1);
+		const u32 by = vath::Min(static_cast<u32>(phi / (2.0 * vath::Pi<fp64>()) * BinCount), BinCount - 1);
+		counts[bx + by * BinCount]++;
+	}
+
+	//The square maps onto the sphere preserving area, every subdivision covers the same solid angle.
+	const fp64 subdivisionSolidAngle = 4.0 * vath::Pi<fp64>() / (BinCount * BinCount * SubdivisionCount * SubdivisionCount);
+	fp64 totalProbability = 0.0;
+	for (u32 by = 0; by < BinCount; ++by)
+	{
+		for (u32 bx = 0; bx < BinCount; ++bx)
+		{
+			fp64 probability = 0.0;
+			for (u32 sy = 0; sy < SubdivisionCount; ++sy)
+			{
+				for (u32 sx = 0; sx < SubdivisionCount; ++sx)
+				{
+					const fp64 x = (bx + (sx + 0.5) / SubdivisionCount) / BinCount;
+					const fp64 y = (by + (sy + 0.5) / SubdivisionCount) / BinCount;
+					probability += quadtree.GetPdf(BinPointToDirection(x, y)) * subdivisionSolidAngle;
+				}
+			}
+
+			const fp64 expected = probability * SampleCount;
+			const fp64 standardDeviation = std::sqrt(vath::Max(expected * (1.0 - probability), 1.0));
+			EXPECT_NEAR(static_cast<fp64>(counts[bx + by * BinCount]), expected, 5.0 * standardDeviation + 0.01 * expected)
+				<< "cos bin " << bx << ", phi bin " << by;
+			totalProbability += probability;
+		}
+	}
+
+	EXPECT_NEAR(totalProbability, 1.0, 1e-3);
+}
@@ -0,0 +1,104 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/photonMap.h"
+
+using namespace dxray;
+using namespace dxray::riow;
+
+static constexpr u32 PhotonCount = 20000;
+static constexpr u32 QueryCount = 2000;
+
+/// <summary>
+/// Photons spread over a box with a dense cluster on a plane, and runs of photons sharing a position so the splits have to handle ties.
+/// </summary>
+static std::vector<Photon> MakeTestPhotons(std::mt19937& a_generator)
+{
+	std::uniform_real_distribution<fp32> distribution(0.0f, 1.0f);
+	std::vector<Photon> photons(PhotonCount);
+	for (u32 pi = 0; pi < PhotonCount; ++pi)
+	{
+		Photon& photon = photons[pi];
+		if (pi % 4 == 0)
+		{
+			photon.Position = vath::Vector3f(distribution(a_generator) * 8.0f - 4.0f, distribution(a_generator) * 2.0f, distribution(a_generator) * 8.0f - 4.0f);
+		}
+		else if (pi % 4 == 1 && pi > 1)
+		{
+			photon.Position = photons[pi - 4].Position;
+		}
+		else
+		{
+			photon.Position = vath::Vector3f(distribution(a_generator) - 0.5f, 0.0f, distribution(a_generator) - 0.5f);
+		}
+
+		photon.Direction = vath::Normalize(vath::Vector3f(distribution(a_generator) - 0.5f, distribution(a_generator) - 0.5f, distribution(a_generator) - 0.5f));
+		photon.Power = Color(0.5f + distribution(a_generator), 0.5f + distribution(a_generator), 0.5f + distribution(a_generator));
+	}
+
+	return photons;
+}
+
+TEST(PhotonMap, GatherMatchesBruteForce)
+{
+	std::mt19937 generator(0x5eed);
+	std::uniform_real_distribution<fp32> distribution(0.0f, 1.0f);
+	const std::vector<Photon> photons = MakeTestPhotons(generator);
+
+	PhotonMap photonMap;
+	photonMap.Build(std::vector<Photon>(photons));
+	ASSERT_EQ(photonMap.GetCount(), PhotonCount);
+
+	for (u32 qi = 0; qi < QueryCount; ++qi)
+	{
+		//Half of the queries land on a photon, so photons exactly on the radius or the split planes are covered as well.
+		const vath::Vector3f point = qi % 2 == 0 ? photons[qi * 7].Position :
+			vath::Vector3f(distribution(generator) * 9.0f - 4.5f, distribution(generator) * 2.5f - 0.25f, distribution(generator) * 9.0f - 4.5f);
+		const vath::Vector3f normal = vath::Normalize(vath::Vector3f(distribution(generator) - 0.5f, distribution(generator) - 0.5f, distribution(generator) - 0.5f));
+		const fp32 radius = qi % 3 == 0 ? 0.0f : std::exp2(distribution(generator) * 8.0f - 6.0f);
+
+		Color expected(0.0f);
+		u32 expectedCount = 0;
+		for (const Photon& photon : photons)
+		{
+			if (vath::SqrMagnitude(photon.Position - point) <= radius * radius && vath::Dot(photon.Direction, normal) < 0.0f)
+			{
+				expected += photon.Power;
+				++expectedCount;
+			}
+		}
+
+		//Every photon carries at least 0.5 per channel, a missed or doubled photon exceeds the tolerance of the summation order.
+		const Color gathered = photonMap.GatherPower(point, normal, radius);
+		SCOPED_TRACE(std::format("Query {}, radius {}, {} photons", qi, radius, expectedCount));
+		EXPECT_NEAR(gathered.x, expected.x, 1e-4f * expected.x + 1e-5f);
+		EXPECT_NEAR(gathered.y, expected.y, 1e-4f * expected.y + 1e-5f);
+		EXPECT_NEAR(gathered.z, expected.z, 1e-4f * expected.z + 1e-5f);
+	}
+
+	photonMap.Clear();
+	EXPECT_TRUE(photonMap.IsEmpty());
+	EXPECT_EQ(photonMap.GatherPower(vath::Vector3f(0.0f), vath::Vector3f(0.0f, 1.0f, 0.0f), 100.0f).x, 0.0f);
+}
+
+//The squared radius follows r(i + 1)^2 = r(i)^2 (i + alpha) / (i + 1), which decays as i^(alpha - 1).
+TEST(PhotonMap, ProgressiveRadiusShrinks)
+{
+	constexpr fp32 initialRadius = 1.5f;
+	for (const fp32 alpha : { 0.5f, 2.0f / 3.0f, 0.9f })
+	{
+		SCOPED_TRACE(std::format("Alpha {}", alpha));
+		EXPECT_EQ(GetProgressiveGatherRadius(initialRadius, alpha, 0), initialRadius);
+
+		fp32 previousRadius = initialRadius;
+		for (u32 pass = 1; pass < 256; ++pass)
+		{
+			const fp32 radius = GetProgressiveGatherRadius(initialRadius, alpha, pass);
+			const fp32 expectedSquared = previousRadius * previousRadius * (static_cast<fp32>(pass) + alpha) / static_cast<fp32>(pass + 1);
+			EXPECT_NEAR(radius * radius, expectedSquared, 1e-5f * expectedSquared) << "pass " << pass;
+			EXPECT_LT(radius, previousRadius) << "pass " << pass;
+			previousRadius = radius;
+		}
+
+		const fp64 decay = std::pow(static_cast<fp64>(GetProgressiveGatherRadius(initialRadius, alpha, 4096)) / GetProgressiveGatherRadius(initialRadius, alpha, 2048), 2.0);
+		EXPECT_NEAR(decay, std::exp2(alpha - 1.0), 1e-3);
+	}
+}
@@ -0,0 +1,128 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/pngEncoder.h"
+#include <stb/stbImageLoad.h>
+
+using namespace dxray;
+using namespace dxray::riow;
+
+/// <summary>
+/// Gradients with a bit of noise on top, so the deflater emits both matches and literals.
+/// </summary>
+static std::vector<u8> MakeTestPixels(const vath::Vector2u32& a_dimensionsInPx, const u32 a_channelCount)
+{
+	std::vector<u8> pixels(static_cast<usize>(a_dimensionsInPx.x) * a_dimensionsInPx.y * a_channelCount);
+	u32 noise = 0x9E3779B9u;
+	for (usize i = 0; i < pixels.size(); ++i)
+	{
+		const usize pixelIndex = i / a_channelCount;
+		const u32 x = static_cast<u32>(pixelIndex % a_dimensionsInPx.x);
+		const u32 y = static_cast<u32>(pixelIndex / a_dimensionsInPx.x);
+		noise ^= noise << 13;
+		noise ^= noise >> 17;
+		noise ^= noise << 5;
+		pixels[i] = static_cast<u8>(x * 3 + y * 5 + (i % a_channelCount) * 64 + (noise & 0x07));
+	}
+
+	return pixels;
+}
+
+static void ExpectDecodesTo(const std::vector<u8>& a_png, const std::vector<u8>& a_pixels, const vath::Vector2u32& a_dimensionsInPx, const u32 a_channelCount)
+{
+	i32 width = 0;
+	i32 height = 0;
+	i32 channelCount = 0;
+	stbi_uc* pDecoded = stbi_load_from_memory(a_png.data(), static_cast<i32>(a_png.size()), &width, &height, &channelCount, 0);
+	ASSERT_NE(pDecoded, nullptr);
+	EXPECT_EQ(width, static_cast<i32>(a_dimensionsInPx.x));
+	EXPECT_EQ(height, static_cast<i32>(a_dimensionsInPx.y));
+	EXPECT_EQ(channelCount, static_cast<i32>(a_channelCount));
+
+	const std::vector<u8> decoded(pDecoded, pDecoded + a_pixels.size());
+	stbi_image_free(pDecoded);
+	EXPECT_TRUE(decoded == a_pixels);
+}
+
+//One strip for the small images, the larger ones end on a strip shorter than the deflate window.
+TEST(PngEncoder, DecodesToTheEncodedPixels)
+{
+	struct ImageLayout final
+	{
+		vath::Vector2u32 DimensionsInPx;
+		u32 ChannelCount;
+	};
+
+	const ImageLayout layouts[] =
+	{
+		{ vath::Vector2u32(1u, 1u), 1u },
+		{ vath::Vector2u32(17u, 5u), 3u },
+		{ vath::Vector2u32(64u, 64u), 4u },
+		{ vath::Vector2u32(333u, 211u), 2u },
+		{ vath::Vector2u32(256u, 270u), 4u },
+		{ vath::Vector2u32(1000u, 300u), 3u },
+	};
+
+	TaskScheduler taskScheduler;
+	for (const ImageLayout& layout : layouts)
+	{
+		SCOPED_TRACE(std::format("{}x{}, {} channels", layout.DimensionsInPx.x, layout.DimensionsInPx.y, layout.ChannelCount));
+		const std::vector<u8> pixels = MakeTestPixels(layout.DimensionsInPx, layout.ChannelCount);
+
+		std::vector<u8> png;
+		EncodePng(pixels.data(), layout.DimensionsInPx, layout.ChannelCount, png);
+		ExpectDecodesTo(png, pixels, layout.DimensionsInPx, layout.ChannelCount);
+
+		std::vector<u8> parallelPng;
+		EncodePng(pixels.data(), layout.DimensionsInPx, layout.ChannelCount, parallelPng, &taskScheduler);
+		EXPECT_TRUE(parallelPng == png);
+	}
+}
+
+//Stitches the filtered rows from strips of any size the way the encoder does, every strip deflated against the window preceding it.
+TEST(PngEncoder, StripsStitchIntoASingleStream)
+{
+	const vath::Vector2u32 dimensionsInPx(301u, 97u);
+	const u32 channelCount = 3;
+	const std::vector<u8> pixels = MakeTestPixels(dimensionsInPx, channelCount);
+
+	const usize filteredRowSize = static_cast<usize>(dimensionsInPx.x) * channelCount + 1;
+	const usize filteredSize = filteredRowSize * dimensionsInPx.y;
+	std::vector<u8> filteredRows(filteredSize);
+	FilterPngRows(pixels.data(), nullptr, dimensionsInPx.x, channelCount, dimensionsInPx.y, filteredRows.data());
+
+	std::vector<u8> imageHeader;
+	for (const u32 value : { dimensionsInPx.x, dimensionsInPx.y })
+	{
+		for (const u32 shift : { 24u, 16u, 8u, 0u })
+		{
+			imageHeader.push_back(static_cast<u8>(value >> shift));
+		}
+	}
+	imageHeader.insert(imageHeader.end(), { 8, 2, 0, 0, 0 });
+
+	for (const usize stripSize : { filteredSize, DeflateWindowSize, usize(20'000), usize(4'096), usize(1'000) })
+	{
+		SCOPED_TRACE(std::format("Strip size {}", stripSize));
+		std::vector<u8> png(std::begin(PngSignature), std::end(PngSignature));
+		AppendPngChunk(png, "IHDR", imageHeader.data(), imageHeader.size());
+		AppendPngChunk(png, "IDAT", ZlibHeader, sizeof(ZlibHeader));
+
+		u32 adler = 1;
+		for (usize stripStart = 0; stripStart < filteredSize; stripStart += stripSize)
+		{
+			const usize stripLength = vath::Min(stripSize, filteredSize - stripStart);
+			const usize dictionarySize = vath::Min(stripStart, DeflateWindowSize);
+
+			std::vector<u8> deflated;
+			DeflateSegment(&filteredRows[stripStart - dictionarySize], dictionarySize, stripLength, stripStart + stripLength == filteredSize, deflated);
+			AppendPngChunk(png, "IDAT", deflated.data(), deflated.size());
+			adler = CombineAdler32(adler, Adler32(&filteredRows[stripStart], stripLength), stripLength);
+		}
+
+		EXPECT_EQ(adler, Adler32(filteredRows.data(), filteredSize));
+		const u8 adlerBytes[4] = { static_cast<u8>(adler >> 24), static_cast<u8>(adler >> 16), static_cast<u8>(adler >> 8), static_cast<u8>(adler) };
+		AppendPngChunk(png, "IDAT", adlerBytes, sizeof(adlerBytes));
+		AppendPngChunk(png, "IEND", nullptr, 0);
+
+		ExpectDecodesTo(png, pixels, dimensionsInPx, channelCount);
+	}
+}
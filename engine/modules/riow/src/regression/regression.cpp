@@ -0,0 +1,220 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/traceable/sphere.h"
+#include "riow/sampler.h"
+#include <stb/stbImageLoad.h>
+#include <stb/stbImageWrite.h>
+
+namespace dxray::riow::regression
+{
+	RegressionSettings& GetRegressionSettings()
+	{
+		static RegressionSettings settings;
+		return settings;
+	}
+
+
+	//--- Image comparison ---
+
+	static constexpr u32 RmseBlockSize = 4;
+	static constexpr u32 MaxErrorBlockSize = 8;
+
+	/// <summary>
+	/// Reinhard tone mapping followed by the display gamma, maps radiance to roughly perceptually uniform values in [0, 1).
+	/// </summary>
+	static fp64 ToPerceptual(const fp32 a_value)
+	{
+		const fp64 value = std::max(static_cast<fp64>(a_value), 0.0);
+		return std::pow(value / (1.0 + value), 1.0 / 2.2);
+	}
+
+	/// <summary>
+	/// Averages the perceptual values of the pixels in each block, blocks on the border only average the pixels inside the image.
+	/// </summary>
+	static std::vector<vath::Vector3d> AverageBlocks(const std::vector<Color>& a_image, const vath::Vector2u32& a_dimensions, const u32 a_blockSize)
+	{
+		const u32 blockCountX = (a_dimensions.x + a_blockSize - 1) / a_blockSize;
+		const u32 blockCountY = (a_dimensions.y + a_blockSize - 1) / a_blockSize;
+		std::vector<vath::Vector3d> blocks(blockCountX * blockCountY, vath::Vector3d(0.0));
+		std::vector<u32> pixelCounts(blocks.size(), 0u);
+		for (u32 y = 0; y < a_dimensions.y; ++y)
+		{
+			for (u32 x = 0; x < a_dimensions.x; ++x)
+			{
+				const Color& pixel = a_image[y * a_dimensions.x + x];
+				const usize blockIndex = (y / a_blockSize) * blockCountX + x / a_blockSize;
+				blocks[blockIndex] += vath::Vector3d(ToPerceptual(pixel.x), ToPerceptual(pixel.y), ToPerceptual(pixel.z));
+				pixelCounts[blockIndex]++;
+			}
+		}
+
+		for (usize i = 0; i < blocks.size(); ++i)
+		{
+			blocks[i] /= static_cast<fp64>(pixelCounts[i]);
+		}
+
+		return blocks;
+	}
+
+	ImageError CompareImages(const std::vector<Color>& a_image, const std::vector<Color>& a_reference, const vath::Vector2u32& a_dimensions)
+	{
+		DXRAY_ASSERT(a_image.size() == a_reference.size());
+		DXRAY_ASSERT(a_image.size() == static_cast<usize>(a_dimensions.x) * a_dimensions.y);
+
+		ImageError error;
+
+		//The mean bias is the mean of the block differences, their spread gives the standard error of that mean.
+		const std::vector<vath::Vector3d> imageBlocks = AverageBlocks(a_image, a_dimensions, RmseBlockSize);
+		const std::vector<vath::Vector3d> referenceBlocks = AverageBlocks(a_reference, a_dimensions, RmseBlockSize);
+		const fp64 blockCount = static_cast<fp64>(imageBlocks.size());
+		fp64 differenceSum = 0.0;
+		fp64 differenceSquaredSum = 0.0;
+		fp64 squaredErrorSum = 0.0;
+		for (usize i = 0; i < imageBlocks.size(); ++i)
+		{
+			const vath::Vector3d difference = imageBlocks[i] - referenceBlocks[i];
+			const fp64 meanDifference = (difference.x + difference.y + difference.z) / 3.0;
+			differenceSum += meanDifference;
+			differenceSquaredSum += meanDifference * meanDifference;
+			squaredErrorSum += vath::Dot(difference, difference);
+		}
+		error.MeanBias = differenceSum / blockCount;
+		error.MeanBiasStandardError = std::sqrt(std::max(differenceSquaredSum / blockCount - error.MeanBias * error.MeanBias, 0.0) / blockCount);
+		error.BlockRmse = std::sqrt(squaredErrorSum / (blockCount * 3.0));
+
+		const std::vector<vath::Vector3d> imageLargeBlocks = AverageBlocks(a_image, a_dimensions, MaxErrorBlockSize);
+		const std::vector<vath::Vector3d> referenceLargeBlocks = AverageBlocks(a_reference, a_dimensions, MaxErrorBlockSize);
+		for (usize i = 0; i < imageLargeBlocks.size(); ++i)
+		{
+			const vath::Vector3d difference = imageLargeBlocks[i] - referenceLargeBlocks[i];
+			error.MaxBlockError = std::max(error.MaxBlockError, (std::abs(difference.x) + std::abs(difference.y) + std::abs(difference.z)) / 3.0);
+		}
+
+		return error;
+	}
+
+
+	//--- Reference files ---
+
+	bool LoadReferenceImage(const Path& a_filePath, vath::Vector2u32& a_dimensions, std::vector<Color>& a_image)
+	{
+		i32 width = 0;
+		i32 height = 0;
+		i32 channelCount = 0;
+		stbi_set_flip_vertically_on_load(false);
+		fp32* pData = stbi_loadf(a_filePath.string().c_str(), &width, &height, &channelCount, 3);
+		if (pData == nullptr)
+		{
+			return false;
+		}
+
+		a_dimensions = vath::Vector2u32(static_cast<u32>(width), static_cast<u32>(height));
+		a_image.resize(static_cast<usize>(width) * height);
+		for (usize i = 0; i < a_image.size(); ++i)
+		{
+			a_image[i] = Color(pData[i * 3], pData[i * 3 + 1], pData[i * 3 + 2]);
+		}
+		stbi_image_free(pData);
+		return true;
+	}
+
+	bool SaveReferenceImage(const Path& a_filePath, const vath::Vector2u32& a_dimensions, const std::vector<Color>& a_image)
+	{
+		static_assert(sizeof(Color) == 3 * sizeof(fp32));
+		std::filesystem::create_directories(a_filePath.parent_path());
+		return stbi_write_hdr(a_filePath.string().c_str(), static_cast<i32>(a_dimensions.x), static_cast<i32>(a_dimensions.y), 3,
+			reinterpret_cast<const fp32*>(a_image.data())) != 0;
+	}
+
+	bool LoadBudgets(const Path& a_filePath, std::map<String, fp64>& a_budgets)
+	{
+		std::ifstream file(a_filePath);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		String line;
+		while (std::getline(file, line))
+		{
+			if (line.empty() || line[0] == '#')
+			{
+				continue;
+			}
+
+			std::istringstream lineStream(line);
+			String sceneName;
+			fp64 budget = 0.0;
+			if (lineStream >> sceneName >> budget)
+			{
+				a_budgets[sceneName] = budget;
+			}
+		}
+
+		return true;
+	}
+
+	bool SaveBudgets(const Path& a_filePath, const std::map<String, fp64>& a_budgets)
+	{
+		std::filesystem::create_directories(a_filePath.parent_path());
+		std::ofstream file(a_filePath);
+		if (!file.is_open())
+		{
+			DXRAY_ERROR("Failed to write budgets: {}", a_filePath.string());
+			return false;
+		}
+
+		file << "# Render time per scene in multiples of the calibration workload, written by riowRegressionSuite --update-references.\n";
+		for (const auto& [sceneName, budget] : a_budgets)
+		{
+			file << sceneName << " " << budget << "\n";
+		}
+
+		return true;
+	}
+
+
+	//--- Calibration ---
+
+	static volatile u32 CalibrationHitCount = 0;
+
+	fp64 MeasureCalibrationTimeInSec()
+	{
+		static constexpr u32 SphereCount = 64;
+		static constexpr u32 RayCount = 1 << 14;
+		static constexpr u32 RunCount = 5;
+
+		Sampler sampler(HashSeed(0xca1b), 0u);
+		std::vector<vath::Vector4f> spheres(SphereCount);
+		for (vath::Vector4f& sphere : spheres)
+		{
+			sphere = vath::Vector4f(sampler.NextFloat(-10.0f, 10.0f), sampler.NextFloat(-10.0f, 10.0f), sampler.NextFloat(-10.0f, 10.0f), sampler.NextFloat(0.5f, 2.0f));
+		}
+
+		fp64 bestTimeInSec = fp64max;
+		u32 hitCount = 0;
+		for (u32 run = 0; run < RunCount; ++run)
+		{
+			Stopwatchd timer(true);
+			for (u32 i = 0; i < RayCount; ++i)
+			{
+				const vath::Vector3f direction(sampler.NextFloat(-0.5f, 0.5f), sampler.NextFloat(-0.5f, 0.5f), 1.0f);
+				const Ray ray(vath::Vector3f(0.0f, 0.0f, -20.0f), direction);
+				fp32 closestT = fp32max;
+				for (const vath::Vector4f& sphere : spheres)
+				{
+					fp32 t = 0.0f;
+					if (Sphere::IntersectRay(vath::Vector3f(sphere.x, sphere.y, sphere.z), sphere.w, ray, 0.001f, closestT, t))
+					{
+						closestT = t;
+					}
+				}
+				hitCount += closestT < fp32max ? 1u : 0u;
+			}
+			bestTimeInSec = std::min(bestTimeInSec, timer.GetElapsedSeconds());
+		}
+
+		//The hit count is stored so the loop can't be optimized away.
+		CalibrationHitCount = hitCount;
+		return bestTimeInSec;
+	}
+}
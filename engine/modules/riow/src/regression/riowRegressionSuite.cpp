@@ -0,0 +1,44 @@
+#include "riowRegressionSuite/regression.h"
+
+using namespace dxray;
+
+//Renders every regression scene and compares it against its golden image, and compares the render time against the budget of the scene.
+//Run with --update-references after an intended change of the output or the performance, and commit the written references and budgets.
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+
+	riow::regression::RegressionSettings& settings = riow::regression::GetRegressionSettings();
+	for (i32 i = 1; i < argc; ++i)
+	{
+		const StringView argument = argv[i];
+		if (argument == "--update-references")
+		{
+			settings.bUpdateReferences = true;
+		}
+		else if (argument == "--budget-tolerance" && i + 1 < argc)
+		{
+			settings.BudgetTolerance = std::stod(argv[++i]);
+		}
+		else if (argument == "--reference-directory" && i + 1 < argc)
+		{
+			settings.ReferenceDirectory = Path(argv[++i]);
+		}
+	}
+
+	const Path budgetsFilePath = settings.ReferenceDirectory / "budgets.txt";
+	if (!settings.bUpdateReferences && !riow::regression::LoadBudgets(budgetsFilePath, settings.Budgets))
+	{
+		DXRAY_ERROR("Failed to read budgets: {}", budgetsFilePath.string());
+	}
+
+	const int result = RUN_ALL_TESTS();
+
+	//Budgets are only measured on release builds, other builds leave the budgets file untouched.
+	if (settings.bUpdateReferences && !settings.Budgets.empty())
+	{
+		riow::regression::SaveBudgets(budgetsFilePath, settings.Budgets);
+	}
+
+	return result;
+}
@@ -0,0 +1,181 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/builtinScenes.h"
+#include "riow/sceneFile.h"
+#include "riow/renderer.h"
+#include "riow/sampler.h"
+
+using namespace dxray;
+using namespace dxray::riow;
+using namespace dxray::riow::regression;
+
+//Every scene is rendered small and with few samples, so the whole suite runs in seconds. The scenes are built from the same seed as riow
+//builds them with, and the render seed is fixed, so a render only changes when the code that produces it changes.
+static constexpr u64 SceneSeed = 0x5eed;
+static constexpr u64 RenderSeed = 0x12345678;
+static constexpr u64 AlternativeRenderSeed = 0x87654321;
+
+//The noise of a scene is measured as the difference between renders with two render seeds. Changes that only alter the random sequences
+//produce a difference of the same size, so a render matches its reference when the difference stays within the bounds of that noise.
+//The block RMSE averages over many blocks and varies little between seeds, the largest block error and the mean bias vary more.
+//Samples of neighbouring pixels are not fully independent, which the standard error of the mean bias does not account for, hence its minimum.
+static constexpr fp64 MaxMeanBiasStandardErrors = 4.0;
+static constexpr fp64 MinMaxMeanBias = 0.001;
+static constexpr fp64 MaxBlockRmseFactor = 1.5;
+static constexpr fp64 MaxBlockErrorFactor = 2.0;
+
+//The render cost of a scene is the best of a few renders, which filters out most of the interference of the rest of the system.
+static constexpr u32 BudgetRenderCount = 5;
+
+static const vath::Vector2u32 RegressionImageDimensions(96, 56);
+static const RendererPipeline RegressionPipeline =
+{
+	.MaxTraceDepth = 8,
+	.SuperSampleFactor = 2,
+	.DepthOfFieldSampleCount = 2,
+	.ClusterSize = 4,
+	.PassCount = 32
+};
+
+static bool BuildRegressionScene(const String& a_sceneName, Camera& a_camera, Scene& a_scene, SceneFileSettings& a_settings)
+{
+	a_camera.SetViewportDimensionInPx(RegressionImageDimensions);
+	GetThreadSampler().Seed(SceneSeed, 0u);
+	if (a_sceneName == "bouncing")
+	{
+		BuildBouncingSpheresSceneComposition(a_camera, a_scene);
+	}
+	else if (a_sceneName == "perlin")
+	{
+		BuildPerlinSphereSceneComposition(a_camera, a_scene, 0u);
+	}
+	else if (a_sceneName == "volumes")
+	{
+		BuildVolumeSceneComposition(a_camera, a_scene);
+	}
+	else
+	{
+		//Scene files set their own image dimensions, the camera is pointed again so its viewport matches the regression dimensions.
+		if (!LoadSceneFile(AssetRootDirectory / "scenes" / (a_sceneName + ".rscene"), a_camera, a_scene, a_settings))
+		{
+			return false;
+		}
+
+		a_camera.SetViewportDimensionInPx(RegressionImageDimensions);
+		a_camera.LookAt(a_camera.GetPosition(), a_camera.GetFocusPoint());
+	}
+
+	a_scene.BuildAccelerationStructure(0.0f, a_camera.GetShutterSpeed());
+	return true;
+}
+
+/// <summary>
+/// Renders a scene with the regression pipeline, the reserved cores are passed on to the renderer.
+/// </summary>
+static bool RenderRegressionScene(const String& a_sceneName, const u64 a_renderSeed, const u16 a_reservedCoreCount, std::vector<Color>& a_image,
+	fp64& a_renderTimeInSec)
+{
+	SceneFileSettings settings;
+	Camera camera;
+	Scene scene;
+	if (!BuildRegressionScene(a_sceneName, camera, scene, settings))
+	{
+		return false;
+	}
+
+	Renderer renderer(a_reservedCoreCount);
+	renderer.SetCamera(camera);
+	renderer.SetBackgroundColor(settings.BackgroundColor);
+	//Scene files can enable path guiding, which trains within the passes of the regression pipeline, reservoir resampling and caustic photons,
+	//and pick the reconstruction filter.
+	RendererPipeline pipeline = RegressionPipeline;
+	pipeline.GuidingTrainingPassCount = settings.Pipeline.GuidingTrainingPassCount;
+	pipeline.ReservoirCandidateCount = settings.Pipeline.ReservoirCandidateCount;
+	pipeline.CausticPhotonCount = settings.Pipeline.CausticPhotonCount;
+	pipeline.Filter = settings.Pipeline.Filter;
+	pipeline.FilterRadiusInPx = settings.Pipeline.FilterRadiusInPx;
+	renderer.SetRenderPipeline(pipeline);
+
+	AccumulationBuffer accumulationBuffer(RegressionImageDimensions, a_renderSeed);
+	renderer.Render(scene, accumulationBuffer);
+	a_image.resize(static_cast<usize>(RegressionImageDimensions.x) * RegressionImageDimensions.y);
+	accumulationBuffer.Resolve(a_image);
+	a_renderTimeInSec = renderer.GetRenderTimeInSec();
+	return true;
+}
+
+class SceneRegression : public ::testing::TestWithParam<String>
+{
+protected:
+	Path GetReferenceFilePath() const
+	{
+		return GetRegressionSettings().ReferenceDirectory / (GetParam() + ".hdr");
+	}
+};
+
+TEST_P(SceneRegression, MatchesReference)
+{
+	const RegressionSettings& settings = GetRegressionSettings();
+	std::vector<Color> image;
+	fp64 renderTimeInSec = 0.0;
+	ASSERT_TRUE(RenderRegressionScene(GetParam(), RenderSeed, 0u, image, renderTimeInSec)) << "Failed to build scene " << GetParam();
+
+	if (settings.bUpdateReferences)
+	{
+		ASSERT_TRUE(SaveReferenceImage(GetReferenceFilePath(), RegressionImageDimensions, image)) << "Failed to write " << GetReferenceFilePath().string();
+		return;
+	}
+
+	vath::Vector2u32 referenceDimensions;
+	std::vector<Color> reference;
+	ASSERT_TRUE(LoadReferenceImage(GetReferenceFilePath(), referenceDimensions, reference))
+		<< "Missing reference " << GetReferenceFilePath().string() << ", create it with --update-references.";
+	ASSERT_TRUE(referenceDimensions.x == RegressionImageDimensions.x && referenceDimensions.y == RegressionImageDimensions.y)
+		<< "The reference was rendered at different dimensions, update it with --update-references.";
+
+	std::vector<Color> alternativeImage;
+	ASSERT_TRUE(RenderRegressionScene(GetParam(), AlternativeRenderSeed, 0u, alternativeImage, renderTimeInSec));
+	const ImageError noise = CompareImages(image, alternativeImage, RegressionImageDimensions);
+
+	const ImageError error = CompareImages(image, reference, RegressionImageDimensions);
+	EXPECT_LE(std::abs(error.MeanBias), std::max(MaxMeanBiasStandardErrors * noise.MeanBiasStandardError, MinMaxMeanBias))
+		<< "Mean bias " << error.MeanBias << ", standard error " << noise.MeanBiasStandardError;
+	EXPECT_LE(error.BlockRmse, MaxBlockRmseFactor * noise.BlockRmse)
+		<< "Block RMSE " << error.BlockRmse << ", noise " << noise.BlockRmse;
+	EXPECT_LE(error.MaxBlockError, MaxBlockErrorFactor * noise.MaxBlockError)
+		<< "Max block error " << error.MaxBlockError << ", noise " << noise.MaxBlockError;
+}
+
+TEST_P(SceneRegression, StaysWithinBudget)
+{
+#if !defined(CONFIG_RELEASE)
+	GTEST_SKIP() << "Budgets are measured on release builds.";
+#endif
+
+	//A single render worker keeps the measurement independent of the core count of the machine. The calibration workload runs right before
+	//every render, so both are measured at the same clock speed.
+	const u16 reservedCoreCount = static_cast<u16>(std::max(std::thread::hardware_concurrency(), 1u) - 1u);
+	fp64 renderCost = fp64max;
+	for (u32 i = 0; i < BudgetRenderCount; ++i)
+	{
+		const fp64 calibrationTimeInSec = MeasureCalibrationTimeInSec();
+		std::vector<Color> image;
+		fp64 renderTimeInSec = 0.0;
+		ASSERT_TRUE(RenderRegressionScene(GetParam(), RenderSeed, reservedCoreCount, image, renderTimeInSec));
+		renderCost = std::min(renderCost, renderTimeInSec / calibrationTimeInSec);
+	}
+
+	RegressionSettings& settings = GetRegressionSettings();
+	if (settings.bUpdateReferences)
+	{
+		settings.Budgets[GetParam()] = renderCost;
+		return;
+	}
+
+	const auto budget = settings.Budgets.find(GetParam());
+	ASSERT_TRUE(budget != settings.Budgets.end()) << "No budget for " << GetParam() << ", create it with --update-references.";
+	EXPECT_LE(renderCost, budget->second * (1.0 + settings.BudgetTolerance))
+		<< "Render cost " << renderCost << " exceeds the budget of " << budget->second << " by more than the tolerance of " << settings.BudgetTolerance;
+}
+
+INSTANTIATE_TEST_SUITE_P(Scenes, SceneRegression, ::testing::Values("bouncing", "perlin", "volumes", "threeSpheres", "outdoorSpheres", "hiddenLight", "manyLights", "caustics"),
+	[](const ::testing::TestParamInfo<String>& a_info) { return a_info.param; });
@@ -0,0 +1,51 @@
+#include "riowRegressionSuite/regression.h"
+#include "riow/scene.h"
+#include "riow/traceable/sphere.h"
+#include "riow/traceable/sphereSet.h"
+
+using namespace dxray;
+using namespace dxray::riow;
+
+//Copies of a scene share their traceables. Building a copy for another frame gathers its own lights, hits in either copy report
+//the light of the primitive that was hit from the light list of that copy.
+TEST(Scene, CopiesLookUpTheLightsOfTheirOwnBuild)
+{
+	Scene scene;
+	const TextureId white = scene.GetTextures().AddSolidColor(Color(1.0f));
+	const MaterialId diffuse = scene.GetMaterials().Add(Lambertian(white));
+	const MaterialId emissive = scene.GetMaterials().Add(DiffuseLight(white, 4.0f));
+
+	scene.AddTraceable(std::make_shared<Sphere>(vath::Vector3f(-4.0f, 0.0f, 0.0f), 1.0f, emissive));
+	scene.AddTraceable(std::make_shared<SphereSet>(std::vector<SphereSet::Element>{
+		{ .Center = vath::Vector3f(0.0f, 0.0f, 0.0f), .Radius = 1.0f, .Material = diffuse },
+		{ .Center = vath::Vector3f(4.0f, 0.0f, 0.0f), .Radius = 1.0f, .Velocity = vath::Vector3f(0.0f, 1.0f, 0.0f), .Material = emissive }
+	}, 0.0f, 2.0f));
+	scene.BuildAccelerationStructure(0.0f, 1.0f);
+
+	Scene nextFrame = scene;
+	nextFrame.BuildAccelerationStructure(1.0f, 2.0f);
+	ASSERT_EQ(scene.GetLights().GetCount(), 2u);
+	ASSERT_EQ(nextFrame.GetLights().GetCount(), 2u);
+
+	for (const Scene* pScene : { &scene, &nextFrame })
+	{
+		const fp32 time = pScene == &scene ? 0.5f : 1.5f;
+		for (const fp32 x : { -4.0f, 0.0f, 4.0f })
+		{
+			const vath::Vector3f center(x, x > 0.0f ? time : 0.0f, 0.0f);
+			IntersectionInfo hitInfo;
+			ASSERT_TRUE(pScene->DoesIntersect(Ray(center + vath::Vector3f(0.0f, 0.0f, 5.0f), vath::Vector3f(0.0f, 0.0f, -1.0f), time), 0.001f, fp32max, hitInfo));
+
+			if (x == 0.0f)
+			{
+				EXPECT_EQ(hitInfo.LightIndex, InvalidLightIndex);
+				continue;
+			}
+
+			ASSERT_NE(hitInfo.LightIndex, InvalidLightIndex);
+			const vath::Vector3f lightCenter = pScene->GetLights().GetLight(hitInfo.LightIndex).GetCenter(time);
+			EXPECT_NEAR(lightCenter.x, center.x, 1e-5f);
+			EXPECT_NEAR(lightCenter.y, center.y, 1e-5f);
+		}
+	}
+}
@@ -0,0 +1,164 @@
+#include "riow/renderStatistics.h"
+#include <bit>
+#include <fstream>
+
+namespace dxray::riow
+{
+	void RenderStatistics::AddTile(const fp64 a_timeInSec)
+	{
+		++TileCount;
+		TileTimeInSec += a_timeInSec;
+		MinTileTimeInSec = vath::Min(MinTileTimeInSec, a_timeInSec);
+		MaxTileTimeInSec = vath::Max(MaxTileTimeInSec, a_timeInSec);
+
+		const u64 timeInUs = static_cast<u64>(a_timeInSec * 1e6);
+		const usize bucket = timeInUs > 0 ? static_cast<usize>(std::bit_width(timeInUs) - 1) : 0;
+		++TileTimeHistogram[vath::Min(bucket, TileTimeBucketCount - 1)];
+	}
+
+	void RenderStatistics::Merge(const RenderStatistics& a_other)
+	{
+		CameraRayCount += a_other.CameraRayCount;
+		SecondaryRayCount += a_other.SecondaryRayCount;
+		ShadowRayCount += a_other.ShadowRayCount;
+		PhotonRayCount += a_other.PhotonRayCount;
+		for (usize i = 0; i < PathTerminationCounts.size(); ++i)
+		{
+			PathTerminationCounts[i] += a_other.PathTerminationCounts[i];
+		}
+
+		for (usize i = 0; i < PathLengthHistogram.size(); ++i)
+		{
+			PathLengthHistogram[i] += a_other.PathLengthHistogram[i];
+		}
+
+		for (usize i = 0; i < ScatterCounts.size(); ++i)
+		{
+			ScatterCounts[i] += a_other.ScatterCounts[i];
+		}
+
+		AddMediumStatistics(a_other.Media);
+
+		TileCount += a_other.TileCount;
+		TileTimeInSec += a_other.TileTimeInSec;
+		MinTileTimeInSec = vath::Min(MinTileTimeInSec, a_other.MinTileTimeInSec);
+		MaxTileTimeInSec = vath::Max(MaxTileTimeInSec, a_other.MaxTileTimeInSec);
+		for (usize i = 0; i < TileTimeHistogram.size(); ++i)
+		{
+			TileTimeHistogram[i] += a_other.TileTimeHistogram[i];
+		}
+	}
+
+
+	//--- JSON report ---
+
+	/// <summary>
+	/// Histogram as a JSON array, trailing empty buckets are left out.
+	/// </summary>
+	template<usize BucketCount>
+	static String FormatHistogram(const std::array<u64, BucketCount>& a_histogram)
+	{
+		usize bucketCount = a_histogram.size();
+		while (bucketCount > 0 && a_histogram[bucketCount - 1] == 0)
+		{
+			--bucketCount;
+		}
+
+		String json = "[";
+		for (usize i = 0; i < bucketCount; ++i)
+		{
+			json += std::format("{}{}", i > 0 ? ", " : "", a_histogram[i]);
+		}
+
+		return json + "]";
+	}
+
+	static fp64 GetMinTileTimeInMs(const RenderStatistics& a_statistics)
+	{
+		return a_statistics.TileCount > 0 ? a_statistics.MinTileTimeInSec * 1e3 : 0.0;
+	}
+
+	static fp64 GetMeanTileTimeInMs(const RenderStatistics& a_statistics)
+	{
+		return a_statistics.TileCount > 0 ? a_statistics.TileTimeInSec / static_cast<fp64>(a_statistics.TileCount) * 1e3 : 0.0;
+	}
+
+	bool SaveRenderStatisticsToFile(const Path& a_filePath, const RenderStatistics& a_statistics, const std::vector<RenderStatistics>& a_threadStatistics, const fp64 a_renderTimeInSec)
+	{
+		std::ofstream file(a_filePath);
+		if (!file.is_open())
+		{
+			DXRAY_ERROR("Failed to write render statistics: {}", a_filePath.string());
+			return false;
+		}
+
+		u64 pathCount = 0;
+		u64 pathRayCount = 0;
+		for (usize length = 0; length < a_statistics.PathLengthHistogram.size(); ++length)
+		{
+			pathCount += a_statistics.PathLengthHistogram[length];
+			pathRayCount += a_statistics.PathLengthHistogram[length] * length;
+		}
+
+		const fp64 renderTimeInSec = vath::Max(a_renderTimeInSec, 1e-9);
+		file << "{\n";
+		file << std::format("\t\"renderTimeInSec\": {},\n", a_renderTimeInSec);
+		file << std::format("\t\"threadCount\": {},\n", a_threadStatistics.size());
+
+		file << "\t\"rays\": {\n";
+		file << std::format("\t\t\"camera\": {},\n", a_statistics.CameraRayCount);
+		file << std::format("\t\t\"secondary\": {},\n", a_statistics.SecondaryRayCount);
+		file << std::format("\t\t\"shadow\": {},\n", a_statistics.ShadowRayCount);
+		file << std::format("\t\t\"photon\": {},\n", a_statistics.PhotonRayCount);
+		file << std::format("\t\t\"total\": {},\n", a_statistics.GetTracedRayCount());
+		file << std::format("\t\t\"megaRaysPerSec\": {}\n", static_cast<fp64>(a_statistics.GetTracedRayCount()) / renderTimeInSec * 1e-6);
+		file << "\t},\n";
+
+		file << "\t\"paths\": {\n";
+		file << std::format("\t\t\"count\": {},\n", pathCount);
+		file << std::format("\t\t\"escaped\": {},\n", a_statistics.PathTerminationCounts[static_cast<usize>(EPathTermination::Escaped)]);
+		file << std::format("\t\t\"absorbed\": {},\n", a_statistics.PathTerminationCounts[static_cast<usize>(EPathTermination::Absorbed)]);
+		file << std::format("\t\t\"maxDepth\": {},\n", a_statistics.PathTerminationCounts[static_cast<usize>(EPathTermination::MaxDepth)]);
+		file << std::format("\t\t\"russianRoulette\": {},\n", a_statistics.PathTerminationCounts[static_cast<usize>(EPathTermination::RussianRoulette)]);
+		file << std::format("\t\t\"meanLength\": {},\n", pathCount > 0 ? static_cast<fp64>(pathRayCount) / static_cast<fp64>(pathCount) : 0.0);
+		file << std::format("\t\t\"lengthHistogram\": {}\n", FormatHistogram(a_statistics.PathLengthHistogram));
+		file << "\t},\n";
+
+		file << "\t\"scatters\": {\n";
+		for (u32 ti = 0; ti < MaterialTable::TypeCount; ++ti)
+		{
+			file << std::format("\t\t\"{}\": {}{}\n", MaterialTable::GetTypeName(ti), a_statistics.ScatterCounts[ti], ti + 1 < MaterialTable::TypeCount ? "," : "");
+		}
+		file << "\t},\n";
+
+		file << "\t\"media\": {\n";
+		file << std::format("\t\t\"trackedRays\": {},\n", a_statistics.Media.TrackedRayCount);
+		file << std::format("\t\t\"steps\": {},\n", a_statistics.Media.StepCount);
+		file << std::format("\t\t\"meanStepsPerRay\": {},\n", static_cast<fp64>(a_statistics.Media.StepCount) / static_cast<fp64>(vath::Max<u64>(a_statistics.Media.TrackedRayCount, 1)));
+		file << std::format("\t\t\"collisions\": {}\n", a_statistics.Media.CollisionCount);
+		file << "\t},\n";
+
+		file << "\t\"tiles\": {\n";
+		file << std::format("\t\t\"count\": {},\n", a_statistics.TileCount);
+		file << std::format("\t\t\"minTimeInMs\": {},\n", GetMinTileTimeInMs(a_statistics));
+		file << std::format("\t\t\"meanTimeInMs\": {},\n", GetMeanTileTimeInMs(a_statistics));
+		file << std::format("\t\t\"maxTimeInMs\": {},\n", a_statistics.MaxTileTimeInSec * 1e3);
+		file << std::format("\t\t\"timeHistogramLog2Us\": {}\n", FormatHistogram(a_statistics.TileTimeHistogram));
+		file << "\t},\n";
+
+		//Per thread totals show how evenly the work was spread over the workers.
+		file << "\t\"threads\": [\n";
+		for (usize ti = 0; ti < a_threadStatistics.size(); ++ti)
+		{
+			const RenderStatistics& threadStatistics = a_threadStatistics[ti];
+			file << "\t\t{ " << std::format("\"tiles\": {}, \"busyTimeInSec\": {}, \"utilization\": {}, \"rays\": {}, \"meanTileTimeInMs\": {}",
+				threadStatistics.TileCount, threadStatistics.TileTimeInSec, threadStatistics.TileTimeInSec / renderTimeInSec,
+				threadStatistics.GetTracedRayCount(), GetMeanTileTimeInMs(threadStatistics));
+			file << (ti + 1 < a_threadStatistics.size() ? " },\n" : " }\n");
+		}
+		file << "\t]\n";
+		file << "}\n";
+
+		return file.good();
+	}
+}
@@ -1,41 +1,124 @@
 #include "riow/renderer.h"
 #include "riow/material.h"
+#include "riow/sampler.h"
+#include "riow/cameraRayGenerator.h"
+#include "riow/aliasTable.h"
+#include "riow/traceable/sphere.h"
+#include <bit>
 
 namespace dxray::riow
 {
 	inline vath::Vector2f GetRandom2dUnitDirection()
 	{
-		const fp32 angle = vath::RandomNumber<fp32>() * 2.0f * vath::Pi<fp32>();
-		const vath::Vector2f direction(std::cosf(angle), std::sinf(angle));
-		return direction * std::sqrtf(vath::RandomNumber<fp32>());
+		return vath::SquareToConcentricDisk(vath::Vector2f(RandomFloat(), RandomFloat()));
 	}
 
-	Renderer::Renderer() :
-		m_taskScheduler(2),
-		m_backgroundColor(0.0f)
+	//Scatter pdf of rays leaving a vertex that resampled its direct light.
+	static constexpr fp32 ResampledScatterPdf = -1.0f;
+
+	/// <summary>
+	/// Weight of emission found by a ray scattered with the density, from a vertex that sampled the light with the light pdf as well.
+	/// A vertex that resampled its direct light accounted for all of the emission that light sampling can reach.
+	/// </summary>
+	static fp32 GetScatteredEmissionWeight(const fp32 a_scatterPdf, const fp32 a_lightPdf)
+	{
+		if (a_scatterPdf == ResampledScatterPdf)
+		{
+			return a_lightPdf > 0.0f ? 0.0f : 1.0f;
+		}
+
+		return PowerHeuristic(a_scatterPdf, a_lightPdf);
+	}
+
+	//Caustic photons are traced in tasks of this many photons, every task seeds the sampler with its index and the pass.
+	static constexpr u32 CausticPhotonsPerTask = 4096;
+	static constexpr u64 CausticPhotonSamplerStream = 0x63617573746963ull;
+
+	//Gather radius of the first pass in pixel footprints, and the alpha of progressive photon mapping that sets how fast it shrinks.
+	static constexpr fp32 CausticInitialGatherRadiusInPx = 1.0f;
+	static constexpr fp32 CausticRadiusAlpha = 2.0f / 3.0f;
+
+	u64 RendererPipeline::GetImageHash() const
+	{
+		const u64 settings[] =
+		{
+			MaxTraceDepth, SuperSampleFactor, DepthOfFieldSampleCount, ClusterSize, GuidingTrainingPassCount, ReservoirCandidateCount,
+			static_cast<u64>(ReservoirReuse), CausticPhotonCount, static_cast<u64>(Filter), std::bit_cast<u32>(FilterRadiusInPx)
+		};
+
+		u64 hash = 0;
+		for (const u64 setting : settings)
+		{
+			hash = HashSeed(hash ^ setting);
+		}
+
+		return hash;
+	}
+
+	Renderer::Renderer(const u16 a_reservedCoreCount /*= 2*/) :
+		m_taskScheduler(a_reservedCoreCount),
+		m_backgroundColor(0.0f),
+		m_causticGatherRadiusInPx(0.0f),
+		m_claimedThreadStatisticsCount(0),
+		m_renderTimeInSec(0.0)
 	{}
 
-	void Renderer::Render(const Scene& a_scene, std::vector<vath::Vector3f>& a_colorDataBuffer)
+	void Renderer::Render(const Scene& a_scene, AccumulationBuffer& a_accumulationBuffer)
 	{
-		//Ray image plane.
-		const vath::Vector3f cameraPosition = m_camera.GetPosition();
+		//Ray image plane, the camera basis is derived once per render by the ray generator.
 		const vath::Vector2u32 viewportDimsInPx = m_camera.GetViewportDimensionsInPx();
-		const vath::Rect<fp32> viewportRect = m_camera.GetViewportRect();
-		const fp32 cameraShutterSpeed = m_camera.GetShutterSpeed();
-		const vath::Vector2f pixelDelta(viewportRect.Width / static_cast<fp32>(viewportDimsInPx.x), viewportRect.Height / static_cast<fp32>(viewportDimsInPx.y));
-		const vath::Vector2f pixelCenter = pixelDelta * 0.5f;
+		const CameraRayGenerator rayGenerator(m_camera);
+		const RayCone primaryCone{ 0.0f, rayGenerator.GetPixelSpreadAngle() };
 
 		//Anti-aliasing.
 		const u8 sampleSize = m_pipelineConfiguration.SuperSampleFactor;
 		const u8 sampleCount = sampleSize * sampleSize;
 		const fp32 pixelSampleSize = static_cast<fp32>(sampleSize) / sampleCount;
-		const fp32 superSampleReciprocal = 1.0f / sampleCount;
 
 		//Depth of field.
-		const fp32 focalLength = m_camera.GetFocalLength();
-		const fp32 lensRadius = m_camera.GetAperture() / 2.0f;
 		const u8 dofSampleCount = m_pipelineConfiguration.DepthOfFieldSampleCount;
-		const fp32 dofReciprocal = 1.0f / dofSampleCount;
+
+		//Progressive passes.
+		const u32 samplesPerPass = m_pipelineConfiguration.GetSamplesPerPass();
+		const u64 seed = a_accumulationBuffer.GetSeed();
+		const bool bCheckpointsEnabled = !m_checkpointFilePath.empty() && m_pipelineConfiguration.CheckpointIntervalInSec > 0.0f;
+		const bool bAdaptiveSampling = m_pipelineConfiguration.AdaptiveErrorThreshold > 0.0f;
+
+		//Path guiding, the guide trains over the first passes this render adds, regardless of the passes the buffer already holds.
+		const u32 firstRenderedPass = a_accumulationBuffer.GetCompletedPassCount();
+		const BoundingBox sceneBounds = a_scene.GetBounds();
+		PathGuide* pPathGuide = nullptr;
+		u32 guidingIterationPassCount = 1;
+		u32 guidingIterationEnd = firstRenderedPass + 1;
+		if (m_pipelineConfiguration.GuidingTrainingPassCount > 0 && sceneBounds.IsValid())
+		{
+			m_pathGuide.Reset(sceneBounds);
+			pPathGuide = &m_pathGuide;
+		}
+
+		//Reservoir resampling, reservoirs carry over between the passes of a render only.
+		ReservoirBuffer* pReservoirs = nullptr;
+		if (m_pipelineConfiguration.ReservoirCandidateCount > 0 && !a_scene.GetLights().IsEmpty())
+		{
+			m_reservoirs.Reset(a_accumulationBuffer.GetDimensions());
+			pReservoirs = &m_reservoirs;
+		}
+
+		//Caustic photon mapping, every pass traces a photon map of its own.
+		const PhotonMap* pCausticMap = nullptr;
+		if (m_pipelineConfiguration.CausticPhotonCount > 0 && a_scene.GetLights().GetCount() > 0)
+		{
+			pCausticMap = &m_causticMap;
+		}
+
+		//Reconstruction, the samples of the passes are filtered into the accumulation buffer.
+		Film film(a_accumulationBuffer, ReconstructionFilter(m_pipelineConfiguration.Filter, m_pipelineConfiguration.FilterRadiusInPx));
+
+		//Time budget.
+		using Clock = std::chrono::steady_clock;
+		const bool bTimeBudgeted = m_pipelineConfiguration.TimeBudgetInSec > 0.0f;
+		const Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<fp32>(m_pipelineConfiguration.TimeBudgetInSec));
+		std::atomic<bool> bDeadlineReached = false;
 
 		//Task threading.
 		const vath::Vector2u8 clusterSize(m_pipelineConfiguration.ClusterSize, m_pipelineConfiguration.ClusterSize);
@@ -45,6 +128,34 @@ namespace dxray::riow
 		DXRAY_INFO("Image dimensions: {}, {}", viewportDimsInPx.x, viewportDimsInPx.y);
 		DXRAY_INFO("AA sample size {}", sampleSize);
 		DXRAY_INFO("DoF sampel count {}", dofSampleCount);
+		static constexpr const char* FilterNames[] = { "box", "tent", "gaussian", "mitchell" };
+		DXRAY_INFO("Reconstruction filter {}, radius {} px", FilterNames[static_cast<u32>(film.GetFilter().GetType())], film.GetFilter().GetRadius());
+		if (bTimeBudgeted)
+		{
+			DXRAY_INFO("Time budget {} s ({} samples per pass)", m_pipelineConfiguration.TimeBudgetInSec, samplesPerPass);
+		}
+		else
+		{
+			DXRAY_INFO("Pass count {} ({} samples per pass)", m_pipelineConfiguration.PassCount, samplesPerPass);
+		}
+		if (bAdaptiveSampling)
+		{
+			DXRAY_INFO("Adaptive error threshold {}", m_pipelineConfiguration.AdaptiveErrorThreshold);
+		}
+		if (pPathGuide != nullptr)
+		{
+			DXRAY_INFO("Path guiding training passes {}", m_pipelineConfiguration.GuidingTrainingPassCount);
+		}
+		if (pReservoirs != nullptr)
+		{
+			static constexpr const char* ReuseNames[] = { "none", "unbiased", "biased" };
+			DXRAY_INFO("Reservoir candidates {}, reuse {}", static_cast<u32>(m_pipelineConfiguration.ReservoirCandidateCount), ReuseNames[static_cast<u32>(m_pipelineConfiguration.ReservoirReuse)]);
+		}
+		if (pCausticMap != nullptr)
+		{
+			DXRAY_INFO("Caustic photons per pass {}", m_pipelineConfiguration.CausticPhotonCount);
+		}
+		DXRAY_INFO("Resuming from pass {}", firstRenderedPass);
 		DXRAY_INFO("=================================");
 		DXRAY_INFO("Threading setup:");
 		DXRAY_INFO("Num worker threads: {}", m_taskScheduler.GetWorkerCount());
@@ -52,120 +163,617 @@ namespace dxray::riow
 		DXRAY_INFO("=================================");
 		DXRAY_INFO("Rendering...");
 
-		//Sample the depth of field of a super-sampled pixel.
-		// Extract camera basis vectors for correct DoF lens offset.
-		const vath::Vector3f camRight = vath::Vector3f(m_camera.GetWorldTransform()[0]);
-		const vath::Vector3f camUp = vath::Vector3f(m_camera.GetWorldTransform()[1]);
-
-		auto SampleDepthOfField = [=](const vath::Vector3f a_rayDirection)
+		//Super sample a pixel location including its depth of field, splats the samples into the film tile and returns their sum.
+		//Camera samples are drawn per pixel and turned into rays eight at a time.
+		auto SuperSamplePixel = [&](const vath::Vector2u32& a_pixelIndex, const u32 a_bufferIndex, FilmTile& a_tile, RenderStatistics& a_statistics)
 		{
-			Color sampleColor(0.0f);
-			const vath::Vector3f normalizedDir = vath::Normalize(a_rayDirection);
-			const vath::Vector3f focalPoint = cameraPosition + normalizedDir * focalLength;
-			for (u32 si = 0; si < dofSampleCount; ++si)
-			{
-				const vath::Vector2f diskSample = GetRandom2dUnitDirection();
-				// Offset along camera-local right and up axes, not world X/Y.
-				const vath::Vector3 rayOrigin = cameraPosition + (camRight * diskSample.x + camUp * diskSample.y) * lensRadius;
+			Color pixelColor(0.0f);
+			CameraSampleBatch samples;
+			CameraRayBatch rays;
+			u32 batchSize = 0;
 
-				//#Note: Shutter speed is randomly sampled so all motion is visible on the image - a real camera needs 1/100 samples to capture a full second of motion,
-				//which is way over the speed of what a CPU path tracer can do, games have a target framerate of 1/60 (most often).
-				const fp32 shutterSpeed = vath::RandomNumber<fp32>(0.0f, cameraShutterSpeed);
-				const riow::Ray camRay(rayOrigin, focalPoint - rayOrigin, shutterSpeed);
-				sampleColor += TraceRayColor(camRay, a_scene, m_pipelineConfiguration.MaxTraceDepth);
-			}
+			auto TraceBatch = [&]()
+			{
+				rayGenerator.Generate(samples, rays);
+				for (u32 li = 0; li < batchSize; ++li)
+				{
+					const Color radiance = TraceRayColor(rays.GetRay(li), primaryCone, a_scene, m_pipelineConfiguration.MaxTraceDepth, 0.0f, pPathGuide, pReservoirs, a_bufferIndex,
+						pCausticMap, false, a_statistics);
+					a_tile.AddSample(vath::Vector2f(samples.PixelX[li], samples.PixelY[li]), radiance);
+					pixelColor += radiance;
+				}
 
-			return sampleColor * dofReciprocal;
-		};
+				batchSize = 0;
+			};
 
-		//Super sample a pixel location.
-		auto SuperSamplePixel = [=](const vath::Vector2u32& a_pixelIndex)
-		{
-			Color pixelColor(0.0f);
 			for (u32 sy = 1; sy <= sampleSize; ++sy)
 			{
 				for (u32 sx = 1; sx <= sampleSize; ++sx)
 				{
 					//Anti-aliasing.
-					const fp32 r = vath::RandomNumber<fp32>();
+					const fp32 r = RandomFloat();
 					const vath::Vector2f sampleOffset(
 						static_cast<fp32>(sx) / sampleSize - pixelSampleSize * r,
 						static_cast<fp32>(sy) / sampleSize - pixelSampleSize * r
 					);
 
-					const vath::Vector2f pixelOffset(
-						a_pixelIndex.x * pixelDelta.x + sampleOffset.x * pixelDelta.x,
-						a_pixelIndex.y * pixelDelta.y + sampleOffset.y * pixelDelta.y
-					);
-
-					const vath::Vector3f rayDirection(m_camera.GetWorldTransform() * vath::Vector4f(
-						viewportRect.x + pixelOffset.x,
-						viewportRect.y + pixelOffset.y,
-						1.0f,
-						0.0f
-					));
+					for (u32 si = 0; si < dofSampleCount; ++si)
+					{
+						const vath::Vector2f diskSample = GetRandom2dUnitDirection();
+						samples.PixelX[batchSize] = static_cast<fp32>(a_pixelIndex.x) + sampleOffset.x;
+						samples.PixelY[batchSize] = static_cast<fp32>(a_pixelIndex.y) + sampleOffset.y;
+						samples.LensX[batchSize] = diskSample.x;
+						samples.LensY[batchSize] = diskSample.y;
 
-					pixelColor += SampleDepthOfField(rayDirection);
+						//#Note: Shutter speed is randomly sampled so all motion is visible on the image - a real camera needs 1/100 samples to capture a full second of motion,
+						//which is way over the speed of what a CPU path tracer can do, games have a target framerate of 1/60 (most often).
+						samples.Time[batchSize] = RandomFloat();
+						if (++batchSize == CameraSampleBatch::Capacity)
+						{
+							TraceBatch();
+						}
+					}
 				}
 			}
 
-			return pixelColor * superSampleReciprocal;
+			if (batchSize > 0)
+			{
+				TraceBatch();
+			}
+
+			return pixelColor;
 		};
 
-		//Render the pixel data into the provided output buffer using the task scheduler.
-		for (u16 py = 0; py < viewportDimsInPx.y; py += clusterSize.y)
+		//The deadline is checked per pixel, so tiles that are in flight when the budget runs out stop within a single pixel.
+		auto HasDeadlinePassed = [&]()
 		{
-			for (u16 px = 0; px < viewportDimsInPx.x; px += clusterSize.x)
+			if (!bTimeBudgeted)
+			{
+				return false;
+			}
+
+			if (!bDeadlineReached.load(std::memory_order_relaxed) && Clock::now() >= deadline)
+			{
+				bDeadlineReached.store(true, std::memory_order_relaxed);
+			}
+
+			return bDeadlineReached.load(std::memory_order_relaxed);
+		};
+
+		//Render the passes into the accumulation buffer using the task scheduler. The buffer can cover a sub-region of the image and a sub-range of the passes.
+		const vath::Vector2u32 imageOffset = a_accumulationBuffer.GetImageOffset();
+		const vath::Vector2u32 bufferDims = a_accumulationBuffer.GetDimensions();
+		const u32 firstPassIndex = a_accumulationBuffer.GetFirstPassIndex();
+		DXRAY_ASSERT_WITH_MSG(imageOffset.x + bufferDims.x <= viewportDimsInPx.x && imageOffset.y + bufferDims.y <= viewportDimsInPx.y, "The accumulation buffer exceeds the viewport");
+		DXRAY_ASSERT_WITH_MSG(bufferDims.x % clusterSize.x == 0 && bufferDims.y % clusterSize.y == 0, "The accumulation buffer should be divisible by the cluster size");
+
+		//Statistics slots of the previous render are released, every thread of this render claims a new one.
+		static std::atomic<u64> renderCount = 0;
+		const u64 renderId = ++renderCount;
+		m_threadStatistics.assign(m_taskScheduler.GetWorkerCount(), RenderStatistics());
+		m_claimedThreadStatisticsCount.store(0);
+
+		Stopwatchf renderTimer(true);
+		Stopwatchf checkpointTimer(true);
+		u64 submittedTileCount = 0;
+		for (u32 pass = a_accumulationBuffer.GetCompletedPassCount(); bTimeBudgeted || pass < m_pipelineConfiguration.PassCount; ++pass)
+		{
+			const u32 passSampleTarget = (pass + 1 - firstPassIndex) * samplesPerPass;
+			std::atomic<u32> convergedPixelCount = 0;
+			if (pReservoirs != nullptr)
+			{
+				pReservoirs->BeginPass();
+			}
+
+			//The photons of a pass depend on the seed and the pass only, so the work units of a split render trace the same caustic map.
+			if (pCausticMap != nullptr)
+			{
+				TraceCausticPhotons(a_scene, seed, pass, renderId);
+				m_causticGatherRadiusInPx = GetProgressiveGatherRadius(CausticInitialGatherRadiusInPx, CausticRadiusAlpha, pass);
+			}
+
+			for (u32 by = 0; by < bufferDims.y && !HasDeadlinePassed(); by += clusterSize.y)
 			{
-				//Spawn a task for the task scheduler in the form of a ray cluster.
-				TaskScheduler::Task task = [&, clusterSize, px, py]()
+				for (u32 bx = 0; bx < bufferDims.x; bx += clusterSize.x)
 				{
-					for (u8 cpy = 0; cpy < clusterSize.y; cpy++)
+					//Spawn a task for the task scheduler in the form of a ray cluster, the film merges overlapping tiles in the order they are spawned in.
+					const u64 tileIndex = submittedTileCount++;
+					TaskScheduler::Task task = [&, clusterSize, passSampleTarget, bx, by, tileIndex]()
 					{
-						for (u8 cpx = 0; cpx < clusterSize.x; cpx++)
+						RenderStatistics& statistics = GetThreadStatistics(renderId);
+						Stopwatchf tileTimer(true);
+						FilmTile tile;
+						film.InitializeTile(vath::Vector2u32(bx, by), vath::Vector2u32(clusterSize.x, clusterSize.y), tile);
+						for (u8 cpy = 0; cpy < clusterSize.y; cpy++)
 						{
-							const Color rgb = SuperSamplePixel(vath::Vector2u32(px + cpx, py + cpy));
-							const u32 pi = (px + cpx + (py + cpy) * viewportDimsInPx.x);
-							a_colorDataBuffer[pi] = LinearToSrgb(rgb);
+							for (u8 cpx = 0; cpx < clusterSize.x; cpx++)
+							{
+								if (HasDeadlinePassed())
+								{
+									film.MergeTile(std::move(tile), tileIndex);
+									statistics.AddTile(tileTimer.GetElapsedSeconds());
+									statistics.AddMediumStatistics(TakeThreadMediumStatistics());
+									return;
+								}
+
+								//Pixels can be ahead of the pass when the render was resumed from a checkpoint made mid-pass.
+								const u32 bi = (bx + cpx + (by + cpy) * bufferDims.x);
+								const u32 pixelSampleCount = a_accumulationBuffer.GetSampleCount(bi);
+								if (pixelSampleCount >= passSampleTarget)
+								{
+									continue;
+								}
+
+								if (bAdaptiveSampling && a_accumulationBuffer.GetRelativeError(bi, samplesPerPass) < m_pipelineConfiguration.AdaptiveErrorThreshold)
+								{
+									convergedPixelCount.fetch_add(1u, std::memory_order_relaxed);
+									continue;
+								}
+
+								//The sampler is seeded per image pixel and pass, which makes the result independent of the order tasks are executed in
+								//and ensures that every work unit of a split render draws disjoint sample sequences.
+								const vath::Vector2u32 pixelIndex(imageOffset.x + bx + cpx, imageOffset.y + by + cpy);
+								const u32 pi = pixelIndex.x + pixelIndex.y * viewportDimsInPx.x;
+								GetThreadSampler().Seed(HashSeed(seed ^ HashSeed(pi)), firstPassIndex + pixelSampleCount / samplesPerPass);
+								const Color radianceSum = SuperSamplePixel(pixelIndex, bi, tile, statistics);
+								a_accumulationBuffer.AddSampleBatch(bi, radianceSum, samplesPerPass);
+							}
 						}
-					}
-				};
 
-				m_taskScheduler.Execute(task);
+						film.MergeTile(std::move(tile), tileIndex);
+						statistics.AddTile(tileTimer.GetElapsedSeconds());
+						statistics.AddMediumStatistics(TakeThreadMediumStatistics());
+					};
+
+					m_taskScheduler.Execute(task);
+				}
+
+				//Checkpoints are made in between tile rows, a pre-emption therefore costs at most one checkpoint interval.
+				if (bCheckpointsEnabled && checkpointTimer.GetElapsedSeconds() >= m_pipelineConfiguration.CheckpointIntervalInSec)
+				{
+					m_taskScheduler.Wait();
+					a_accumulationBuffer.SetCompletedPassCount(pass);
+					a_accumulationBuffer.SaveCheckpoint(m_checkpointFilePath);
+					checkpointTimer.Reset();
+					DXRAY_INFO("Stored checkpoint: {}", m_checkpointFilePath.string());
+				}
 			}
 
-			DXRAY_TRACE("PixelY: {} / {}", py, viewportDimsInPx.y);
+			m_taskScheduler.Wait();
+
+			//A pass cut short by the deadline is not completed, its remaining pixels are picked up when the render is resumed.
+			if (HasDeadlinePassed())
+			{
+				DXRAY_INFO("Time budget reached during pass {}.", pass + 1);
+				break;
+			}
+
+			a_accumulationBuffer.SetCompletedPassCount(pass + 1);
+			DXRAY_INFO("Finished pass {}", pass + 1);
+
+			//A training iteration ends, the next one is twice as long. Once it would run past the training passes the guide stops learning.
+			if (pPathGuide != nullptr && pPathGuide->IsRecording() && pass + 1 == guidingIterationEnd)
+			{
+				pPathGuide->Refine(guidingIterationPassCount);
+				guidingIterationPassCount *= 2;
+				guidingIterationEnd += guidingIterationPassCount;
+				if (guidingIterationEnd - firstRenderedPass > m_pipelineConfiguration.GuidingTrainingPassCount)
+				{
+					pPathGuide->Freeze();
+				}
+
+				DXRAY_INFO("Path guide {}: {} spatial leaves", pPathGuide->IsRecording() ? "refined" : "trained", pPathGuide->GetLeafCount());
+			}
+
+			if (convergedPixelCount.load() == a_accumulationBuffer.GetPixelCount())
+			{
+				DXRAY_INFO("All pixels converged after pass {}.", pass + 1);
+				break;
+			}
+		}
+
+		if (bCheckpointsEnabled)
+		{
+			a_accumulationBuffer.SaveCheckpoint(m_checkpointFilePath);
+		}
+
+		//Merge the statistics of the threads, threads that did not get to render a tile leave their slot unclaimed.
+		m_renderTimeInSec = renderTimer.GetElapsedSeconds();
+		m_threadStatistics.resize(vath::Min<usize>(m_claimedThreadStatisticsCount.load(), m_threadStatistics.size()));
+		m_statistics = RenderStatistics();
+		for (const RenderStatistics& threadStatistics : m_threadStatistics)
+		{
+			m_statistics.Merge(threadStatistics);
+		}
+
+		ReportSampleCounts(a_accumulationBuffer);
+		DXRAY_INFO("Traced rays: {} ({:.2f} Mrays/s)", m_statistics.GetTracedRayCount(), static_cast<fp64>(m_statistics.GetTracedRayCount()) / vath::Max(m_renderTimeInSec, 1e-6) * 1e-6);
+		if (m_statistics.Media.TrackedRayCount > 0)
+		{
+			DXRAY_INFO("Participating media: {} rays, mean steps per ray: {:.2f}, collisions: {}", m_statistics.Media.TrackedRayCount,
+				static_cast<fp64>(m_statistics.Media.StepCount) / static_cast<fp64>(m_statistics.Media.TrackedRayCount), m_statistics.Media.CollisionCount);
+		}
+	}
+
+	void Renderer::RenderGuideBuffer(const Scene& a_scene, GuideBuffer& a_guideBuffer)
+	{
+		//Pinhole rays through the pixel centers, at the middle of the shutter interval.
+		const vath::Vector3f cameraPosition = m_camera.GetPosition();
+		const vath::Vector2u32 viewportDimsInPx = m_camera.GetViewportDimensionsInPx();
+		const CameraRayGenerator rayGenerator(m_camera);
+		a_guideBuffer.Resize(viewportDimsInPx);
+
+		for (u32 y = 0; y < viewportDimsInPx.y; ++y)
+		{
+			TaskScheduler::Task task = [&, y]()
+			{
+				CameraSampleBatch samples;
+				CameraRayBatch rays;
+				for (u32 x = 0; x < viewportDimsInPx.x; x += CameraSampleBatch::Capacity)
+				{
+					const u32 batchSize = vath::Min(CameraSampleBatch::Capacity, viewportDimsInPx.x - x);
+					for (u32 li = 0; li < CameraSampleBatch::Capacity; ++li)
+					{
+						samples.PixelX[li] = static_cast<fp32>(x + li) + 0.5f;
+						samples.PixelY[li] = static_cast<fp32>(y) + 0.5f;
+						samples.Time[li] = 0.5f;
+					}
+
+					rayGenerator.Generate(samples, rays);
+					for (u32 li = 0; li < batchSize; ++li)
+					{
+						const u32 pi = x + li + y * viewportDimsInPx.x;
+						const Ray ray = rays.GetRay(li);
+						IntersectionInfo hitInfo;
+						if (a_scene.DoesIntersect(ray, m_camera.GetZNear(), m_camera.GetZFar(), hitInfo))
+						{
+							a_guideBuffer.Positions[pi] = hitInfo.Point;
+							a_guideBuffer.Velocities[pi] = hitInfo.Velocity;
+							a_guideBuffer.Depths[pi] = vath::Magnitude(hitInfo.Point - cameraPosition);
+						}
+						else
+						{
+							//Misses store a point along the ray, which is reprojected as a direction.
+							a_guideBuffer.Positions[pi] = cameraPosition + ray.GetDirection();
+							a_guideBuffer.Velocities[pi] = vath::Vector3f(0.0f);
+							a_guideBuffer.Depths[pi] = GuideBuffer::MissDepth;
+						}
+					}
+				}
+			};
+
+			m_taskScheduler.Execute(task);
 		}
 
 		m_taskScheduler.Wait();
 	}
 
-	Color Renderer::TraceRayColor(const Ray& a_ray, const riow::Scene& a_scene, const u8 a_maxTraceDepth) const
+	void Renderer::TraceCausticPhotons(const Scene& a_scene, const u64 a_seed, const u32 a_pass, const u64 a_renderId)
+	{
+		//Like in the light hierarchy every light keeps a small share of the power, so lights with dark centers of their texture still emit.
+		constexpr fp32 MinPowerFraction = 0.01f;
+
+		const LightList& lights = a_scene.GetLights();
+		const MaterialTable& materials = a_scene.GetMaterials();
+		const TextureTable& textures = a_scene.GetTextures();
+		std::vector<fp32> lightPowers(lights.GetCount());
+		fp32 maxPower = 0.0f;
+		for (u32 li = 0; li < lights.GetCount(); ++li)
+		{
+			const SphereLight& light = lights.GetLight(li);
+			const Color emitted = materials.Emitted(light.Material, textures, vath::Vector2f(0.5f, 0.5f), light.Center);
+			lightPowers[li] = Luminance(emitted) * 4.0f * vath::Pi<fp32>() * light.Radius * light.Radius;
+			maxPower = vath::Max(maxPower, lightPowers[li]);
+		}
+
+		for (fp32& power : lightPowers)
+		{
+			power = maxPower > 0.0f ? vath::Max(power, MinPowerFraction * maxPower) : 1.0f;
+		}
+
+		const AliasTable lightTable(lightPowers);
+		const u32 photonCount = m_pipelineConfiguration.CausticPhotonCount;
+		const u32 taskCount = (photonCount + CausticPhotonsPerTask - 1) / CausticPhotonsPerTask;
+		const fp32 shutterOpenTime = m_camera.GetShutterOpenTime();
+		const fp32 shutterSpeed = m_camera.GetShutterSpeed();
+		std::vector<std::vector<Photon>> taskPhotons(taskCount);
+		for (u32 ti = 0; ti < taskCount; ++ti)
+		{
+			TaskScheduler::Task task = [&, ti]()
+			{
+				RenderStatistics& statistics = GetThreadStatistics(a_renderId);
+				GetThreadSampler().Seed(HashSeed(a_seed ^ HashSeed(ti)), HashSeed(CausticPhotonSamplerStream + a_pass));
+				std::vector<Photon>& photons = taskPhotons[ti];
+				const u32 taskPhotonCount = vath::Min(CausticPhotonsPerTask, photonCount - ti * CausticPhotonsPerTask);
+				for (u32 pi = 0; pi < taskPhotonCount; ++pi)
+				{
+					//A uniform point on the sphere of the light, emitting into a cosine weighted direction around its normal. The power of the photon is
+					//the emitted radiance over the density of the point (1 / area), of the direction (cos / pi), of the light and over the photon count.
+					const u32 lightIndex = lightTable.Sample(RandomFloat(), RandomFloat());
+					const SphereLight& light = lights.GetLight(lightIndex);
+					const fp32 time = shutterOpenTime + shutterSpeed * RandomFloat();
+					const vath::Vector3f normal = vath::SquareToUniformSphere(vath::Vector2f(RandomFloat(), RandomFloat()));
+					const vath::Vector3f origin = light.GetCenter(time) + normal * light.Radius;
+					const vath::Vector3f direction = vath::OrthonormalBasis<fp32>(normal).ToWorld(vath::SquareToCosineHemisphere(vath::Vector2f(RandomFloat(), RandomFloat())));
+					const fp32 area = 4.0f * vath::Pi<fp32>() * light.Radius * light.Radius;
+					Color power = materials.Emitted(light.Material, textures, Sphere::PointToUv(normal), origin) *
+						(area * vath::Pi<fp32>() / (lightTable.GetProbability(lightIndex) * static_cast<fp32>(photonCount)));
+
+					//Only photons that pass specular surfaces are stored, light that reaches diffuse surfaces directly is sampled by the camera paths.
+					Ray ray(origin, direction, time);
+					bool bSpecularPath = false;
+					for (u8 depth = 0; depth < m_pipelineConfiguration.MaxTraceDepth; ++depth)
+					{
+						++statistics.PhotonRayCount;
+						IntersectionInfo hitInfo;
+						if (!a_scene.DoesIntersect(ray, m_camera.GetZNear(), m_camera.GetZFar(), hitInfo))
+						{
+							break;
+						}
+
+						if (MaterialTable::IsSpecular(hitInfo.Material))
+						{
+							Color attenuation;
+							Ray scattered;
+							if (!materials.Scatter(hitInfo.Material, ray, hitInfo, textures, attenuation, scattered))
+							{
+								break;
+							}
+
+							power = power * attenuation;
+							ray = scattered;
+							bSpecularPath = true;
+							continue;
+						}
+
+						if (bSpecularPath && MaterialTable::IsDiffuseSurface(hitInfo.Material))
+						{
+							photons.push_back(Photon{ hitInfo.Point, vath::Normalize(ray.GetDirection()), power });
+						}
+
+						break;
+					}
+				}
+
+				statistics.AddMediumStatistics(TakeThreadMediumStatistics());
+			};
+
+			m_taskScheduler.Execute(task);
+		}
+
+		m_taskScheduler.Wait();
+
+		usize storedPhotonCount = 0;
+		for (const std::vector<Photon>& photons : taskPhotons)
+		{
+			storedPhotonCount += photons.size();
+		}
+
+		std::vector<Photon> photons;
+		photons.reserve(storedPhotonCount);
+		for (const std::vector<Photon>& taskPhotonList : taskPhotons)
+		{
+			photons.insert(photons.end(), taskPhotonList.begin(), taskPhotonList.end());
+		}
+
+		m_causticMap.Build(std::move(photons));
+	}
+
+	RenderStatistics& Renderer::GetThreadStatistics(const u64 a_renderId)
+	{
+		//The slot is cached per thread, only the first tile of a thread in a render touches the shared claim counter.
+		thread_local u64 threadRenderId = 0;
+		thread_local RenderStatistics* pThreadStatistics = nullptr;
+		if (threadRenderId != a_renderId)
+		{
+			const u32 slot = m_claimedThreadStatisticsCount.fetch_add(1u);
+			DXRAY_ASSERT_WITH_MSG(slot < m_threadStatistics.size(), "More threads render tiles than the task scheduler has workers");
+			pThreadStatistics = &m_threadStatistics[slot];
+			threadRenderId = a_renderId;
+
+			//Media tracked by the thread outside of this render, e.g. for a guide buffer, are not counted towards it.
+			TakeThreadMediumStatistics();
+		}
+
+		return *pThreadStatistics;
+	}
+
+	void Renderer::ReportSampleCounts(const AccumulationBuffer& a_accumulationBuffer) const
+	{
+		u32 minSampleCount = u32max;
+		u32 maxSampleCount = 0;
+		u64 totalSampleCount = 0;
+		for (u32 pi = 0; pi < a_accumulationBuffer.GetPixelCount(); ++pi)
+		{
+			const u32 sampleCount = a_accumulationBuffer.GetSampleCount(pi);
+			minSampleCount = vath::Min(minSampleCount, sampleCount);
+			maxSampleCount = vath::Max(maxSampleCount, sampleCount);
+			totalSampleCount += sampleCount;
+		}
+
+		DXRAY_INFO("=================================");
+		DXRAY_INFO("Samples per pixel:");
+		DXRAY_INFO("Completed passes: {}", a_accumulationBuffer.GetCompletedPassCount());
+		DXRAY_INFO("Min: {}, Max: {}, Mean: {}", minSampleCount, maxSampleCount, static_cast<fp64>(totalSampleCount) / vath::Max(a_accumulationBuffer.GetPixelCount(), 1u));
+		DXRAY_INFO("Total samples: {}", totalSampleCount);
+		DXRAY_INFO("=================================");
+	}
+
+	Color Renderer::TraceRayColor(const Ray& a_ray, const RayCone& a_cone, const riow::Scene& a_scene, const u8 a_maxTraceDepth, const fp32 a_scatterPdf,
+		PathGuide* a_pPathGuide, ReservoirBuffer* a_pReservoirs, const u32 a_pixelIndex, const PhotonMap* a_pCausticMap, const bool a_bCausticsGathered,
+		RenderStatistics& a_statistics) const
 	{
+		//Rays traced along the path so far, the camera ray included.
+		const u32 pathRayCount = static_cast<u32>(m_pipelineConfiguration.MaxTraceDepth - a_maxTraceDepth);
+
 		//When max depth is reached return black.
 		if (a_maxTraceDepth <= 0)
 		{
+			a_statistics.AddPath(EPathTermination::MaxDepth, pathRayCount);
 			return Color(0.0f);
 		}
 
 		//Otherwise keep tracing.
 		riow::IntersectionInfo hitInfo;
+		if (pathRayCount == 0)
+		{
+			++a_statistics.CameraRayCount;
+		}
+		else
+		{
+			++a_statistics.SecondaryRayCount;
+		}
+
 		if (!a_scene.DoesIntersect(a_ray, m_camera.GetZNear(), m_camera.GetZFar(), hitInfo))
 		{
-			//#Todo: Potentially add a skysphere here, which would replace the solid color.
-			return m_backgroundColor;
+			a_statistics.AddPath(EPathTermination::Escaped, pathRayCount + 1);
+			const EnvironmentLight* pEnvironment = a_scene.GetEnvironment();
+			if (pEnvironment == nullptr)
+			{
+				return m_backgroundColor;
+			}
+
+			//Like emitters, the environment is shared with the light sampling of the previous vertex.
+			const Color environmentLight = pEnvironment->Evaluate(a_ray.GetDirection());
+			return a_scatterPdf != 0.0f ? environmentLight * GetScatteredEmissionWeight(a_scatterPdf, a_scene.GetLights().GetEnvironmentPdf(a_ray.GetDirection())) : environmentLight;
 		}
 
+		//Footprint of the ray cone on the surface, widened at grazing angles. Ray directions are not normalized, the hit length is in units of the direction.
+		const fp32 directionMagnitude = vath::Magnitude(a_ray.GetDirection());
+		const RayCone hitCone{ a_cone.GetWidthAt(hitInfo.Length * directionMagnitude), a_cone.SpreadAngle };
+		const fp32 cosIncidence = vath::Max(vath::Abs<fp32>(vath::Dot(a_ray.GetDirection(), hitInfo.Normal)) / directionMagnitude, 0.1f);
+		hitInfo.UvFootprint = hitCone.Width * hitInfo.UvScale / cosIncidence;
+
 		Ray scattered;
 		Color attenuation;
 
-		const Color emissiveLight = hitInfo.Mat->Emitted(hitInfo.UvCoord, hitInfo.Point);
-		if (!hitInfo.Mat->Scatter(a_ray, hitInfo, attenuation, scattered))
+		const MaterialTable& materials = a_scene.GetMaterials();
+		const TextureTable& textures = a_scene.GetTextures();
+		const LightList& lights = a_scene.GetLights();
+		Color emissiveLight = materials.Emitted(hitInfo.Material, textures, hitInfo.UvCoord, hitInfo.Point, hitInfo.UvFootprint);
+		if (a_scatterPdf != 0.0f && hitInfo.LightIndex != InvalidLightIndex)
+		{
+			//The previous vertex sampled this light directly as well, its emission is shared between both techniques.
+			emissiveLight *= GetScatteredEmissionWeight(a_scatterPdf, lights.GetPdf(hitInfo.LightIndex, a_ray.GetOrigin(), a_ray.GetTime()));
+		}
+		else if (a_bCausticsGathered && hitInfo.LightIndex != InvalidLightIndex)
+		{
+			//Found through specular surfaces from the surface that gathered the caustic photons, which carry this light already.
+			emissiveLight = Color(0.0f);
+		}
+
+		a_statistics.AddScatter(hitInfo.Material);
+		if (!materials.Scatter(hitInfo.Material, a_ray, hitInfo, textures, attenuation, scattered))
 		{
+			a_statistics.AddPath(EPathTermination::Absorbed, pathRayCount + 1);
 			return emissiveLight; //An emissive material does not scatter, it emits, hence scatter returns false.
 		}
 
-		Color diffuseReflectance = attenuation * TraceRayColor(scattered, a_scene, a_maxTraceDepth - 1);
-		return emissiveLight + diffuseReflectance;
+		//Materials with a scattering density mix their own sampling with the guide. The density of the mix replaces the density of the material
+		//wherever directions are weighted, its attenuation is the scattering divided by the density of the material.
+		const bool bHasScatterPdf = MaterialTable::HasScatterPdf(hitInfo.Material);
+		const DirectionalQuadtree* pGuideDistribution = a_pPathGuide != nullptr && bHasScatterPdf ? a_pPathGuide->FindDistribution(hitInfo.Point) : nullptr;
+		auto GetMixedScatterPdf = [&](const fp32 a_materialPdf, const vath::Vector3f& a_unitDirection)
+		{
+			return pGuideDistribution == nullptr ? a_materialPdf
+				: PathGuide::MaterialSamplingFraction * a_materialPdf + (1.0f - PathGuide::MaterialSamplingFraction) * pGuideDistribution->GetPdf(a_unitDirection);
+		};
+
+		//Next-event estimation: the attenuation is the scattering divided by the scatter pdf, so scaling it by the pdf of the light direction
+		//gives the scattering towards the light. Specular materials have no pdf and only find lights by scattering into them.
+		//The last vertex of a path skips it, its scattered ray is not traced either, which keeps the maximum path length unchanged.
+		//Camera rays with reservoirs resample their light instead. The reservoir accounts for all of the direct light, so the light sample is not weighted
+		//and the scattered ray only gathers indirect light. The reservoir of the last path of a pixel in a pass is the one its neighbours reuse in the next.
+		Color directLight(0.0f);
+		bool bDirectLightResampled = false;
+		if (a_maxTraceDepth > 1 && bHasScatterPdf && !lights.IsEmpty())
+		{
+			LightSample lightSample;
+			bool bLightSampled = false;
+			if (a_pReservoirs != nullptr)
+			{
+				const ReservoirShadingPoint shadingPoint{ hitInfo.Point, hitInfo.Normal, attenuation, hitInfo.Material, a_ray.GetTime(), hitInfo.Length * directionMagnitude };
+				Reservoir& reservoir = a_pReservoirs->GetCurrent(a_pixelIndex);
+				reservoir = ResampleLights(a_scene, shadingPoint, m_pipelineConfiguration.ReservoirCandidateCount, m_pipelineConfiguration.ReservoirReuse, *a_pReservoirs, a_pixelIndex, lightSample);
+				bLightSampled = lightSample.Pdf > 0.0f;
+				bDirectLightResampled = true;
+			}
+			else
+			{
+				bLightSampled = lights.Sample(hitInfo.Point, a_ray.GetTime(), materials, textures, lightSample);
+			}
+
+			if (bLightSampled)
+			{
+				const fp32 lightScatterPdf = materials.GetScatterPdf(hitInfo.Material, hitInfo.Normal, lightSample.Direction);
+				if (lightScatterPdf > 0.0f)
+				{
+					++a_statistics.ShadowRayCount;
+					const Ray shadowRay(hitInfo.Point, lightSample.Direction, a_ray.GetTime());
+					const fp32 transmittance = a_scene.EstimateTransmittance(shadowRay, m_camera.GetZNear(), vath::Min(lightSample.Distance * 0.999f, m_camera.GetZFar()));
+					if (transmittance > 0.0f)
+					{
+						const fp32 misWeight = bDirectLightResampled ? 1.0f : PowerHeuristic(lightSample.Pdf, GetMixedScatterPdf(lightScatterPdf, lightSample.Direction));
+						directLight = attenuation * lightSample.Radiance * (lightScatterPdf * transmittance * misWeight / lightSample.Pdf);
+					}
+				}
+			}
+		}
+
+		//Caustics: the first diffuse surface of a camera path estimates the light that reaches it through specular surfaces from the photons
+		//around it, the radiance is the scattering, albedo over pi, times the power per area of the gather disk. Specular surfaces pass the state on.
+		Color causticLight(0.0f);
+		const PhotonMap* pCausticMap = nullptr;
+		bool bCausticsGathered = false;
+		if (a_pCausticMap != nullptr && MaterialTable::IsDiffuseSurface(hitInfo.Material))
+		{
+			const fp32 gatherRadius = m_causticGatherRadiusInPx * hitCone.Width;
+			if (gatherRadius > 0.0f)
+			{
+				const Color power = a_pCausticMap->GatherPower(hitInfo.Point, hitInfo.Normal, gatherRadius);
+				causticLight = attenuation * power / (vath::Pi<fp32>() * vath::Pi<fp32>() * gatherRadius * gatherRadius);
+			}
+
+			bCausticsGathered = true;
+		}
+		else if (MaterialTable::IsSpecular(hitInfo.Material))
+		{
+			pCausticMap = a_pCausticMap;
+			bCausticsGathered = a_bCausticsGathered;
+		}
+
+		if (pGuideDistribution != nullptr && RandomFloat() >= PathGuide::MaterialSamplingFraction)
+		{
+			fp32 guidePdf = 0.0f;
+			const vath::Vector3f guidedDirection = pGuideDistribution->Sample(vath::Vector2f(RandomFloat(), RandomFloat()), guidePdf);
+			scattered = Ray(hitInfo.Point, guidedDirection, a_ray.GetTime());
+		}
+
+		const vath::Vector3f scatteredDirection = vath::Normalize(scattered.GetDirection());
+		const fp32 materialScatterPdf = materials.GetScatterPdf(hitInfo.Material, hitInfo.Normal, scatteredDirection);
+		const fp32 scatterPdf = GetMixedScatterPdf(materialScatterPdf, scatteredDirection);
+		if (pGuideDistribution != nullptr)
+		{
+			//Guided directions the material doesn't scatter into, such as ones below a surface, carry no light.
+			if (materialScatterPdf <= 0.0f)
+			{
+				a_statistics.AddPath(EPathTermination::Absorbed, pathRayCount + 1);
+				return emissiveLight + directLight + causticLight;
+			}
+
+			attenuation *= materialScatterPdf / scatterPdf;
+		}
+
+		//#Note: Scattered rays continue the cone with the incoming spread, surface curvature and roughness are not accounted for.
+		//This underestimates the footprint after diffuse bounces, which only costs some texture sharpness that the bounce blurs anyway.
+		const Color incomingLight = TraceRayColor(scattered, hitCone, a_scene, a_maxTraceDepth - 1, bDirectLightResampled ? ResampledScatterPdf : scatterPdf,
+			a_pPathGuide, nullptr, 0, pCausticMap, bCausticsGathered, a_statistics);
+		if (a_pPathGuide != nullptr && a_pPathGuide->IsRecording() && bHasScatterPdf && scatterPdf > 0.0f)
+		{
+			a_pPathGuide->Record(hitInfo.Point, scatteredDirection, Luminance(incomingLight) / scatterPdf);
+		}
+
+		Color diffuseReflectance = attenuation * incomingLight;
+		return emissiveLight + directLight + causticLight + diffuseReflectance;
 	}
 }
\ No newline at end of file
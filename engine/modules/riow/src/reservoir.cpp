@@ -0,0 +1,187 @@
+#include "riow/reservoir.h"
+#include "riow/sampler.h"
+#include <array>
+
+namespace dxray::riow
+{
+	//Neighbours reused per path, picked uniformly within the radius around the pixel. The reservoir of the pixel itself is not reused:
+	//all camera paths of the pixel in a pass would reuse the same one, and mostly keep the same light point.
+	static constexpr u32 ReusedNeighbourCount = 3;
+	static constexpr fp32 ReuseRadiusInPx = 10.0f;
+
+	//Neighbours that face another way or lie at another depth see other lights, reusing them mostly adds candidates that get rejected.
+	static constexpr fp32 MinNeighbourNormalCos = 0.9f;
+	static constexpr fp32 MaxNeighbourRelativeViewDistance = 0.1f;
+
+	//Reused reservoirs stand for at most this many times the own candidates. Without the cap the candidates grow with every pass,
+	//and a light point kept for long would hardly ever be replaced, which correlates the passes a pixel accumulates.
+	static constexpr u32 MaxReusedCandidateFactor = 4;
+
+	bool Reservoir::Add(const LightPoint& a_sample, const fp32 a_targetPdf, const fp32 a_weight, const u32 a_candidateCount)
+	{
+		WeightSum += a_weight;
+		CandidateCount += a_candidateCount;
+		if (a_weight > 0.0f && RandomFloat() * WeightSum < a_weight)
+		{
+			Sample = a_sample;
+			TargetPdf = a_targetPdf;
+			return true;
+		}
+
+		return false;
+	}
+
+	void ReservoirBuffer::Reset(const vath::Vector2u32& a_dimensions)
+	{
+		m_dimensions = a_dimensions;
+		const usize pixelCount = static_cast<usize>(a_dimensions.x) * a_dimensions.y;
+		m_previous.assign(pixelCount, Reservoir());
+		m_current.assign(pixelCount, Reservoir());
+	}
+
+	void ReservoirBuffer::BeginPass()
+	{
+		std::swap(m_previous, m_current);
+		std::fill(m_current.begin(), m_current.end(), Reservoir());
+	}
+
+	/// <summary>
+	/// Target density of the light point at the shading point, fills in the light sample as seen from the shading point and its jacobian.
+	/// </summary>
+	static fp32 EvaluateTargetPdf(const Scene& a_scene, const ReservoirShadingPoint& a_shadingPoint, const LightPoint& a_lightPoint, LightSample& a_sample, fp32& a_jacobian)
+	{
+		const MaterialTable& materials = a_scene.GetMaterials();
+		a_jacobian = a_scene.GetLights().EvaluateLightPoint(a_lightPoint, a_shadingPoint.Point, a_shadingPoint.Time, materials, a_scene.GetTextures(), a_sample);
+		if (a_jacobian <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		const fp32 scatterPdf = materials.GetScatterPdf(a_shadingPoint.Material, a_shadingPoint.Normal, a_sample.Direction);
+		return Luminance(a_shadingPoint.Attenuation * a_sample.Radiance) * scatterPdf * a_jacobian;
+	}
+
+	static bool IsSimilarShadingPoint(const ReservoirShadingPoint& a_shadingPoint, const ReservoirShadingPoint& a_neighbour)
+	{
+		return vath::Dot(a_shadingPoint.Normal, a_neighbour.Normal) >= MinNeighbourNormalCos &&
+			vath::Abs(a_shadingPoint.ViewDistance - a_neighbour.ViewDistance) <= MaxNeighbourRelativeViewDistance * a_shadingPoint.ViewDistance;
+	}
+
+	Reservoir ResampleLights(const Scene& a_scene, const ReservoirShadingPoint& a_shadingPoint, const u32 a_candidateCount, const EReservoirReuse a_reuse,
+		const ReservoirBuffer& a_buffer, const u32 a_pixelIndex, LightSample& a_sample)
+	{
+		const LightList& lights = a_scene.GetLights();
+		const MaterialTable& materials = a_scene.GetMaterials();
+
+		//Candidates of the light list. Their density converted to the measure of the light point has the same jacobian as the target, which cancels in the weight.
+		Reservoir candidates;
+		candidates.ShadingPoint = a_shadingPoint;
+		for (u32 ci = 0; ci < a_candidateCount; ++ci)
+		{
+			LightSample candidate;
+			fp32 targetPdf = 0.0f;
+			fp32 weight = 0.0f;
+			if (lights.Sample(a_shadingPoint.Point, a_shadingPoint.Time, materials, a_scene.GetTextures(), candidate) && candidate.Pdf > 0.0f)
+			{
+				const fp32 scatteredLuminance = Luminance(a_shadingPoint.Attenuation * candidate.Radiance) * materials.GetScatterPdf(a_shadingPoint.Material, a_shadingPoint.Normal, candidate.Direction);
+				targetPdf = scatteredLuminance * lights.GetLightPointJacobian(candidate.Point, a_shadingPoint.Point, a_shadingPoint.Time);
+				weight = scatteredLuminance / candidate.Pdf;
+			}
+
+			candidates.Add(candidate.Point, targetPdf, weight, 1u);
+		}
+
+		if (candidates.TargetPdf > 0.0f)
+		{
+			candidates.ContributionWeight = candidates.WeightSum / (candidates.TargetPdf * static_cast<fp32>(candidates.CandidateCount));
+		}
+
+		//Reservoirs of random neighbours in the previous pass, next to the reservoir of the own candidates.
+		const u32 maxReusedCandidateCount = MaxReusedCandidateFactor * a_candidateCount;
+		constexpr u32 MaxSourceCount = ReusedNeighbourCount + 1;
+		std::array<const Reservoir*, MaxSourceCount> sources = { &candidates };
+		std::array<u32, MaxSourceCount> sourceCandidateCounts = { a_candidateCount };
+		u32 sourceCount = 1;
+		if (a_reuse != EReservoirReuse::None)
+		{
+			const vath::Vector2u32& dimensions = a_buffer.GetDimensions();
+			const i32 x = static_cast<i32>(a_pixelIndex % dimensions.x);
+			const i32 y = static_cast<i32>(a_pixelIndex / dimensions.x);
+			for (u32 ni = 0; ni < ReusedNeighbourCount; ++ni)
+			{
+				const vath::Vector2f offset = vath::SquareToConcentricDisk(vath::Vector2f(RandomFloat(), RandomFloat())) * ReuseRadiusInPx;
+				const i32 neighbourX = vath::Clamp(x + static_cast<i32>(std::round(offset.x)), 0, static_cast<i32>(dimensions.x) - 1);
+				const i32 neighbourY = vath::Clamp(y + static_cast<i32>(std::round(offset.y)), 0, static_cast<i32>(dimensions.y) - 1);
+				const u32 sourceIndex = static_cast<u32>(neighbourX) + static_cast<u32>(neighbourY) * dimensions.x;
+				if (sourceIndex == a_pixelIndex)
+				{
+					continue;
+				}
+
+				const Reservoir& source = a_buffer.GetPrevious(sourceIndex);
+				if (source.CandidateCount > 0 && IsSimilarShadingPoint(a_shadingPoint, source.ShadingPoint))
+				{
+					sources[sourceCount] = &source;
+					sourceCandidateCounts[sourceCount] = vath::Min(source.CandidateCount, maxReusedCandidateCount);
+					++sourceCount;
+				}
+			}
+		}
+
+		//The kept light points of the reservoirs are resampled once more. Each is weighted by the share the reservoir has among all reservoirs that could
+		//have kept the point, proportional to their candidates times their target density there (generalized balance heuristic), so every light point
+		//counts once overall. The target density of the own candidates stands in for the density they were picked with.
+		//The biased reuse shares by the candidates alone, which skips evaluating the light points at the other reservoirs.
+		u32 totalCandidateCount = 0;
+		for (u32 si = 0; si < sourceCount; ++si)
+		{
+			totalCandidateCount += sourceCandidateCounts[si];
+		}
+
+		Reservoir reservoir;
+		reservoir.ShadingPoint = a_shadingPoint;
+		for (u32 si = 0; si < sourceCount; ++si)
+		{
+			const Reservoir& source = *sources[si];
+			LightSample reusedSample;
+			fp32 jacobian = 0.0f;
+			const fp32 targetPdf = source.ContributionWeight <= 0.0f ? 0.0f : si == 0 ? source.TargetPdf : EvaluateTargetPdf(a_scene, a_shadingPoint, source.Sample, reusedSample, jacobian);
+			if (targetPdf <= 0.0f)
+			{
+				reservoir.Add(source.Sample, 0.0f, 0.0f, sourceCandidateCounts[si]);
+				continue;
+			}
+
+			fp32 share = static_cast<fp32>(sourceCandidateCounts[si]) / static_cast<fp32>(totalCandidateCount);
+			if (a_reuse == EReservoirReuse::Unbiased)
+			{
+				fp32 shareSum = 0.0f;
+				for (u32 sj = 0; sj < sourceCount; ++sj)
+				{
+					const fp32 sourceTargetPdf = sj == si ? source.TargetPdf : sj == 0 ? targetPdf : EvaluateTargetPdf(a_scene, sources[sj]->ShadingPoint, source.Sample, reusedSample, jacobian);
+					shareSum += static_cast<fp32>(sourceCandidateCounts[sj]) * sourceTargetPdf;
+				}
+
+				share = static_cast<fp32>(sourceCandidateCounts[si]) * source.TargetPdf / shareSum;
+			}
+
+			reservoir.Add(source.Sample, targetPdf, share * targetPdf * source.ContributionWeight, sourceCandidateCounts[si]);
+		}
+
+		reservoir.CandidateCount = vath::Min(reservoir.CandidateCount, maxReusedCandidateCount);
+		if (reservoir.TargetPdf <= 0.0f)
+		{
+			return reservoir;
+		}
+
+		fp32 jacobian = 0.0f;
+		reservoir.TargetPdf = EvaluateTargetPdf(a_scene, a_shadingPoint, reservoir.Sample, a_sample, jacobian);
+		if (reservoir.TargetPdf > 0.0f)
+		{
+			reservoir.ContributionWeight = reservoir.WeightSum / reservoir.TargetPdf;
+			a_sample.Pdf = 1.0f / (reservoir.ContributionWeight * jacobian);
+		}
+
+		return reservoir;
+	}
+}
@@ -1,113 +1,62 @@
-#include "riow/traceable/sphere.h"
 #include "riow/camera.h"
 #include "riow/renderer.h"
-#include "riow/material.h"
-#include "riow/texture.h"
 #include "riow/image.h"
+#include "riow/sampler.h"
+#include "riow/distributed.h"
+#include "riow/sequence.h"
+#include "riow/postProcess.h"
+#include "riow/streamingFilm.h"
+#include "riow/sceneFile.h"
+#include "riow/builtinScenes.h"
+#include <core/fileSystem/fileIO.h>
 
 using namespace dxray;
 
-/// <summary>
-/// Type defined to identify scenes.
-/// </summary>
-enum class EScene : u8
-{
-	BouncingSpheres = 0,
-	PerlinSpheres
-};
+//#Note: Scenes are generated from a fixed seed, a resumed render has to trace the exact same scene as the checkpointed one.
+constexpr u64 SceneSeed = 0x5eed;
+constexpr u64 RenderSeed = 0x12345678;
+
+//Arguments that override the render pipeline, every one of them takes a value.
+constexpr StringView PipelineArguments[] = { "--path-guiding", "--reservoirs", "--reservoir-reuse", "--caustic-photons", "--filter", "--filter-radius" };
 
-void BuildBouncingSpheresSceneComposition(riow::Camera& a_camera, riow::Scene& a_scene)
+bool HasArgument(int argc, char** argv, const StringView a_argument)
 {
-	//Camera.
-	a_camera.SetVerticalFov(vath::DegToRad(20.0f));
-	a_camera.SetAperture(0.35f);
-	a_camera.SetFocalLength(10.0f);
-	a_camera.SetShutterSpeed(0.001f);
-	a_camera.LookAt(vath::Vector3f(13.0f, 2.0f, 3.0f), vath::Vector3f(0.0f, 0.0f, 0.0f));
-
-	//Scene.
-	std::shared_ptr<riow::CheckerBoard> checkerboardTex = std::make_shared<riow::CheckerBoard>(0.32f, riow::Color(0.1f), riow::Color(0.9f));
-	std::shared_ptr<riow::Lambertian> groundMat = std::make_shared<riow::Lambertian>(checkerboardTex);
-	a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(0.0f, -1000.0f, 0.0f), 1000.0f, groundMat));
-    std::shared_ptr<riow::ImageTexture> moonTexture = std::make_shared<riow::ImageTexture>(riow::Image::LoadFromFile(riow::AssetRootDirectory / "textures/diffuseMoon.jpg", riow::Image::ELoadOptions::FlipVertically, 3));
-
-	for (i32 i = -11; i < 11; i++)
-	{
-		for (i32 j = -11; j < 11; j++)
-		{
-			const fp32 randomMat = vath::RandomNumber<fp32>();
-			const vath::Vector3f center(i + 0.9f * vath::RandomNumber<fp32>(), 0.2f, j + 0.9f * vath::RandomNumber<fp32>());
-			
-			if (vath::Magnitude(center - vath::Vector3f(4.0f, 0.2f, 0.0f)) > 0.9f)
-			{
-				std::shared_ptr<riow::Material> sphereMat;
-                const vath::Vector3f translation = center + vath::Vector3f(0.0f, vath::RandomNumber<fp32>(0.0f, 1.0f), 0.0f);
-
-				if (randomMat < 0.25f)
-				{
-					//5% chance on moon
-                    if (randomMat < 0.05f)
-                    {
-                        //Emissive moon lights.
-                        sphereMat = std::make_shared<riow::DiffuseLight>(moonTexture, 1.0f);
-                        a_scene.AddTraceable(std::make_shared<riow::Sphere>(center, translation, 0.2f, sphereMat));
-						continue;
-                    }
-
-					//20% - Emissive - emitting light.
-                    const riow::Color albedo(vath::RandomNumber<fp32>(), vath::RandomNumber<fp32>(), vath::RandomNumber<fp32>());
-                    sphereMat = std::make_shared<riow::DiffuseLight>(albedo, vath::RandomNumber<fp32>(0.5f, 1.0));
-                    a_scene.AddTraceable(std::make_shared<riow::Sphere>(center, translation, 0.2f, sphereMat));
-					continue;
-				}
-				else if (randomMat < 0.8f)
-				{
-                    //55% - Lambertian.
-					sphereMat = std::make_shared<riow::Lambertian>(riow::Color(vath::RandomNumber<fp32>(), vath::RandomNumber<fp32>(), vath::RandomNumber<fp32>()));
-                    a_scene.AddTraceable(std::make_shared<riow::Sphere>(center, translation, 0.2f, sphereMat));
-					continue;
-				}
-				else if (randomMat < 0.95f)
-				{
-					//15% - Metallic.
-					const riow::Color metallic(vath::RandomNumber<fp32>(), vath::RandomNumber<fp32>(), vath::RandomNumber<fp32>());
-					const fp32 fuzzy = vath::RandomNumber<fp32>();
-					sphereMat = std::make_shared<riow::Metallic>(metallic, fuzzy);
-                    a_scene.AddTraceable(std::make_shared<riow::Sphere>(center, 0.2f, sphereMat));
-					continue;
-				}
-
-				//5% - Dielectric.
-				sphereMat = std::make_shared<riow::Dielectric>(1.5f);
-                a_scene.AddTraceable(std::make_shared<riow::Sphere>(center, 0.2f, sphereMat));
-			}
+	for (i32 i = 1; i < argc; ++i)
+	{
+		if (a_argument == argv[i])
+		{
+			return true;
 		}
 	}
 
-	std::shared_ptr<riow::Dielectric> largeDielectric = std::make_shared<riow::Dielectric>(1.5f);
-	a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(0, 1, 0), 1.0f, largeDielectric));
+	return false;
+}
 
-	std::shared_ptr<riow::DiffuseLight> largeLambert = std::make_shared<riow::DiffuseLight>(riow::Color(0.4f, 0.2f, 0.1f));
-	a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(-4, 1, 0), 1.0f, largeLambert));
+String GetArgumentValue(int argc, char** argv, const StringView a_argument, const String& a_defaultValue)
+{
+	for (i32 i = 1; i < argc - 1; ++i)
+	{
+		if (a_argument == argv[i])
+		{
+			return String(argv[i + 1]);
+		}
+	}
 
-	std::shared_ptr<riow::Metallic> largeMetal = std::make_shared<riow::Metallic>(riow::Color(0.4f, 0.2f, 0.1f), 0.0f);
-	a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(4, 1, 0), 1.0f, largeMetal));
+	return a_defaultValue;
 }
 
-void BuildPerlinSphereSceneComposition(riow::Camera& a_camera, riow::Scene& a_scene)
+/// <summary>
+/// 64-bit FNV-1a hash of a scene description, which identifies the scene a checkpoint was rendered from.
+/// </summary>
+u64 HashSceneDescription(const StringView a_description)
 {
-    //Camera.
-    a_camera.SetVerticalFov(vath::DegToRad(20.0f));
-    a_camera.SetAperture(0.001f);
-    a_camera.SetFocalLength(10.0f);
-    a_camera.SetShutterSpeed(0.001f);
-    a_camera.LookAt(vath::Vector3f(12.0f, 2.0f, 3.0f), vath::Vector3f(0.0f, 0.0f, 0.0f));
-
-	//Scene.
-	std::shared_ptr<riow::NoiseTexture> noiseTex = std::make_shared<riow::NoiseTexture>(4.0f);
-	std::shared_ptr<riow::Lambertian> lambertian = std::make_shared<riow::Lambertian>(noiseTex);
-	a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(0.0f, -1000.0f, 0.0f), 1000.0f, lambertian));
-	a_scene.AddTraceable(std::make_shared<riow::Sphere>(vath::Vector3f(0.0f, 2.0f, 0.0f), 2.0f, lambertian));
+	u64 hash = 0xcbf29ce484222325ull;
+	for (const char character : a_description)
+	{
+		hash = (hash ^ static_cast<u8>(character)) * 0x100000001b3ull;
+	}
+
+	return hash;
 }
 
 int main(int argc, char** argv)
@@ -119,55 +68,227 @@ int main(int argc, char** argv)
 	Stopwatchf timer;
 	timer.Start();
 
+	//--scene-file <path> loads a text or cooked scene file instead of a built-in scene, the file also sets the image dimensions and pipeline.
+	//Together with --cook-scene <path> the text scene file is cooked into the binary format, after which the application exits.
+	const String sceneFilePath = GetArgumentValue(argc, argv, "--scene-file", "");
+	const String cookedSceneFilePath = GetArgumentValue(argc, argv, "--cook-scene", "");
+	if (!sceneFilePath.empty() && !cookedSceneFilePath.empty())
+	{
+		return riow::CookSceneFile(sceneFilePath, cookedSceneFilePath) ? 0 : 1;
+	}
+
+	riow::SceneFileSettings sceneSettings;
+	riow::Camera camera;
+	camera.SetViewportDimensionInPx(sceneSettings.ImageDimensions);
+
+	//--scene bouncing|perlin|volumes selects the scene, --bake-procedural <resolution> bakes procedural textures into grids of the given resolution.
+	const String sceneName = GetArgumentValue(argc, argv, "--scene", "bouncing");
+	const String noiseBakeResolution = GetArgumentValue(argc, argv, "--bake-procedural", "0");
+	const riow::EScene selectedScene = sceneName == "perlin" ? riow::EScene::PerlinSpheres : sceneName == "volumes" ? riow::EScene::Volumes : riow::EScene::BouncingSpheres;
+	riow::GetThreadSampler().Seed(SceneSeed, 0u);
+	riow::Scene scene;
+	if (!sceneFilePath.empty())
+	{
+		if (!riow::LoadSceneFile(sceneFilePath, camera, scene, sceneSettings))
+		{
+			return 1;
+		}
+	}
+	else
+	{
+		switch (selectedScene)
+		{
+		case riow::EScene::BouncingSpheres:
+		{
+			DXRAY_INFO("Scene: Bouncing spheres");
+			riow::BuildBouncingSpheresSceneComposition(camera, scene);
+			break;
+		}
+		case riow::EScene::PerlinSpheres:
+		{
+			DXRAY_INFO("Scene: Perlin spheres");
+			riow::BuildPerlinSphereSceneComposition(camera, scene, static_cast<u32>(std::stoul(noiseBakeResolution)));
+			break;
+		}
+		case riow::EScene::Volumes:
+		{
+			DXRAY_INFO("Scene: Volumes");
+			riow::BuildVolumeSceneComposition(camera, scene);
+			break;
+		}
+		default:
+		{
+			DXRAY_ERROR("Non-recognized scene.");
+			return 1;//exit application.
+		}
+		}
+	}
+
 	//STB expects signed integers for image writing, the values will never be negative regardless within the framework, so use unsigned integers onwards.
-	const vath::Vector2i32 imageDimensions(2560, 1400);
+	const vath::Vector2i32 imageDimensions(sceneSettings.ImageDimensions.x, sceneSettings.ImageDimensions.y);
 	const i32 imageChannelNum = 3;
-	const u32 clusterSize = 4;
+	const u32 clusterSize = sceneSettings.Pipeline.ClusterSize;
 	DXRAY_ASSERT_WITH_MSG(imageDimensions.x % clusterSize == 0, "Image width should be divisible by the cluster size. Clamping is currently not implemented.");
     DXRAY_ASSERT_WITH_MSG(imageDimensions.y % clusterSize == 0, "Image height should be divisible by the cluster size. Clamping is currently not implemented.");
 
-	riow::Camera camera;
-	camera.SetViewportDimensionInPx(vath::Vector2u32(imageDimensions.x, imageDimensions.y));
+	//--time-budget <seconds> keeps adding passes until the deadline, --adaptive-threshold <relative error> stops sampling converged pixels.
+	//Neither combines with --distributed, whose work units are split up by pass count.
+	const fp32 timeBudgetInSec = std::stof(GetArgumentValue(argc, argv, "--time-budget", "0"));
+	const fp32 adaptiveErrorThreshold = std::stof(GetArgumentValue(argc, argv, "--adaptive-threshold", "0"));
 
-	//#Todo: can potentially make the selected scene be a commandline argument.
-	const EScene selectedScene = EScene::BouncingSpheres;
-	riow::Scene scene;
-	switch (selectedScene)
-	{
-	case EScene::BouncingSpheres:
+	riow::RendererPipeline renderPipeline = sceneSettings.Pipeline;
+	renderPipeline.TimeBudgetInSec = timeBudgetInSec;
+	renderPipeline.AdaptiveErrorThreshold = adaptiveErrorThreshold;
+
+	//--path-guiding <training passes> learns a path guide over the first passes, overriding the guiding passes of a scene file.
+	if (HasArgument(argc, argv, "--path-guiding"))
 	{
-		DXRAY_INFO("Scene: Bouncing spheres");
-		BuildBouncingSpheresSceneComposition(camera, scene);
-		break;
+		renderPipeline.GuidingTrainingPassCount = static_cast<u16>(std::stoul(GetArgumentValue(argc, argv, "--path-guiding", "0")));
 	}
-	case EScene::PerlinSpheres:
-    {
-        DXRAY_INFO("Scene: Perlin spheres");
-        BuildPerlinSphereSceneComposition(camera, scene);
-        break;
+
+	//--reservoirs <candidates> resamples the direct light of camera paths out of that many light candidates, overriding the scene file.
+	//--reservoir-reuse unbiased|biased|none picks which reservoirs of the previous pass are reused next to the own candidates.
+	if (HasArgument(argc, argv, "--reservoirs"))
+	{
+		const u64 reservoirCandidateCount = std::stoull(GetArgumentValue(argc, argv, "--reservoirs", "0"));
+		if (reservoirCandidateCount > u8max)
+		{
+			DXRAY_ERROR("--reservoirs takes at most {} candidates, got {}.", static_cast<u32>(u8max), reservoirCandidateCount);
+			return 1;//exit application.
+		}
+
+		renderPipeline.ReservoirCandidateCount = static_cast<u8>(reservoirCandidateCount);
 	}
-	default:
+
+	const String reservoirReuse = GetArgumentValue(argc, argv, "--reservoir-reuse", "unbiased");
+	renderPipeline.ReservoirReuse = reservoirReuse == "biased" ? riow::EReservoirReuse::Biased :
+		reservoirReuse == "none" ? riow::EReservoirReuse::None : riow::EReservoirReuse::Unbiased;
+
+	//--caustic-photons <photons per pass> estimates caustics from a photon map traced every pass, overriding the scene file.
+	if (HasArgument(argc, argv, "--caustic-photons"))
 	{
-		DXRAY_ERROR("Non-recognized scene.");
-		return 1;//exit application.
+		const u64 causticPhotonCount = std::stoull(GetArgumentValue(argc, argv, "--caustic-photons", "0"));
+		if (causticPhotonCount > u32max)
+		{
+			DXRAY_ERROR("--caustic-photons takes at most {} photons, got {}.", u32max, causticPhotonCount);
+			return 1;//exit application.
+		}
+
+		renderPipeline.CausticPhotonCount = static_cast<u32>(causticPhotonCount);
 	}
+
+	//--filter box|tent|gaussian|mitchell picks the reconstruction filter and --filter-radius <pixels> its radius, overriding the scene file.
+	if (HasArgument(argc, argv, "--filter"))
+	{
+		const String filter = GetArgumentValue(argc, argv, "--filter", "box");
+		renderPipeline.Filter = filter == "tent" ? riow::EReconstructionFilter::Tent : filter == "gaussian" ? riow::EReconstructionFilter::Gaussian :
+			filter == "mitchell" ? riow::EReconstructionFilter::Mitchell : riow::EReconstructionFilter::Box;
+		renderPipeline.FilterRadiusInPx = 0.0f;
 	}
 
-	const riow::RendererPipeline renderPipeline =
+	if (HasArgument(argc, argv, "--filter-radius"))
 	{
-		.MaxTraceDepth = 100,
-		.SuperSampleFactor = 2,
-		.DepthOfFieldSampleCount = 2,
-		.ClusterSize = clusterSize
-	};
+		renderPipeline.FilterRadiusInPx = std::stof(GetArgumentValue(argc, argv, "--filter-radius", "0"));
+	}
+
+	//A pre-empted render can be continued by passing --resume, optionally with the --checkpoint file to continue from.
+	const Path checkpointFilePath = GetArgumentValue(argc, argv, "--checkpoint", (std::filesystem::path("bin") / CMAKE_INTDIR / "riowCheckpoint.bin").string());
+	const bool bResume = HasArgument(argc, argv, "--resume");
 
 	riow::Renderer renderer;
 	renderer.SetCamera(camera);
-	renderer.SetBackgroundColor(riow::Color(0.01f));
+	renderer.SetBackgroundColor(sceneSettings.BackgroundColor);
 	renderer.SetRenderPipeline(renderPipeline);
+	renderer.SetCheckpointFile(checkpointFilePath);
+
+	//--tonemap none|reinhard|aces and --exposure <scale> control the display transform of the png output.
+	//--hdr-output exr|pfm additionally stores the linear radiance, untouched by the display transform.
+	const riow::DisplayTransform displayTransform =
+	{
+		.Exposure = std::stof(GetArgumentValue(argc, argv, "--exposure", "1")),
+		.ToneMapping = riow::ParseToneMapping(GetArgumentValue(argc, argv, "--tonemap", "none"))
+	};
+	const String hdrOutputName = GetArgumentValue(argc, argv, "--hdr-output", "none");
+	const riow::Image::EFileExtension hdrOutputFormat = hdrOutputName == "exr" ? riow::Image::EFileExtension::exr :
+		hdrOutputName == "pfm" ? riow::Image::EFileExtension::pfm : riow::Image::EFileExtension::Invalid;
+
+	//--sequence <frame count> renders an animation instead of a still, the shutter of every frame opens 1/24th of a second after the previous one.
+	//--orbit <radians per second> moves the camera around its focus point and --temporal-reuse starts every frame from the samples of the previous frame.
+	const u32 sequenceFrameCount = static_cast<u32>(std::stoul(GetArgumentValue(argc, argv, "--sequence", "0")));
+	if (sequenceFrameCount > 0)
+	{
+		const riow::SequenceSettings sequenceSettings =
+		{
+			.FrameCount = sequenceFrameCount,
+			.CameraOrbitSpeedInRadPerSec = std::stof(GetArgumentValue(argc, argv, "--orbit", "0")),
+			.bTemporalReuse = HasArgument(argc, argv, "--temporal-reuse"),
+			.Display = displayTransform,
+			.HdrOutputFormat = hdrOutputFormat
+		};
+
+		riow::SequenceRenderer sequenceRenderer(renderer, sequenceSettings);
+		sequenceRenderer.Render(scene, RenderSeed);
+		return 0;
+	}
+
+	scene.BuildAccelerationStructure(0.0f, camera.GetShutterSpeed());
+
+	//--stream <band height> renders the image in bands of rows which are written out as they finish, for images too large to hold in memory.
+	const u32 streamBandHeight = static_cast<u32>(std::stoul(GetArgumentValue(argc, argv, "--stream", "0")));
+	if (streamBandHeight > 0)
+	{
+		if (bResume || HasArgument(argc, argv, "--checkpoint"))
+		{
+			DXRAY_WARN("Checkpoints are not supported by streamed renders, --resume and --checkpoint are ignored.");
+		}
+
+		const riow::StreamingFilmSettings streamingSettings =
+		{
+			.BandHeightInPx = streamBandHeight,
+			.Display = displayTransform,
+			.HdrOutputFormat = hdrOutputFormat
+		};
+
+		riow::StreamingFilm streamingFilm(renderer, streamingSettings);
+		return streamingFilm.Render(scene, RenderSeed) ? 0 : 1;
+	}
+
+	//Worker processes are spawned by a distributed render, they build the same scene and render the units they are handed.
+	const u16 workerPort = static_cast<u16>(std::stoul(GetArgumentValue(argc, argv, "--worker", "0")));
+	if (workerPort != 0)
+	{
+		return riow::RunRenderWorker(renderer, scene, camera.GetViewportDimensionsInPx(), workerPort);
+	}
+
+	//--distributed <worker count> splits the render over worker processes, --sharding selects whether they render image regions or sample ranges.
+	const u16 distributedWorkerCount = static_cast<u16>(std::stoul(GetArgumentValue(argc, argv, "--distributed", "0")));
+	const bool bShardSampleRanges = GetArgumentValue(argc, argv, "--sharding", "region") == "samples";
 
     DXRAY_INFO("=================================");
     DXRAY_INFO("Initializing resources.");
+	riow::AccumulationBuffer accumulationBuffer(camera.GetViewportDimensionsInPx(), RenderSeed);
+
+	//Built-in scenes are generated from their name and settings, scene files are identified by their contents.
+	const String sceneDescription = sceneFilePath.empty() ? std::format("{} {} {}", sceneName, noiseBakeResolution, SceneSeed) : ReadFile(sceneFilePath, true);
+	accumulationBuffer.SetSignature(riow::RenderSignature
+	{
+		.SceneHash = HashSceneDescription(sceneDescription),
+		.PipelineHash = renderPipeline.GetImageHash(),
+		.SamplesPerPass = renderPipeline.GetSamplesPerPass()
+	});
+
+	if (bResume)
+	{
+		if (accumulationBuffer.LoadCheckpoint(checkpointFilePath))
+		{
+			DXRAY_INFO("Resuming from checkpoint: {}", checkpointFilePath.string());
+		}
+		else if (std::filesystem::exists(checkpointFilePath))
+		{
+			return 1;//A checkpoint of another render is not overwritten.
+		}
+	}
+
 	std::vector<vath::Vector3> imageData(imageDimensions.x * imageDimensions.y);
 	DXRAY_INFO("Init took {} ms.", timer.GetElapsedMs());
     DXRAY_INFO("=================================\n");
@@ -175,14 +296,77 @@ int main(int argc, char** argv)
 	timer.Reset();
     DXRAY_INFO("=================================");
     DXRAY_INFO("Starting render.");
-	renderer.Render(scene, imageData);
+	if (distributedWorkerCount > 0)
+	{
+		const riow::DistributedRenderSettings distributedSettings =
+		{
+			.ShardingMode = bShardSampleRanges ? riow::EShardingMode::SampleRange : riow::EShardingMode::ImageRegion,
+			.WorkerCount = distributedWorkerCount,
+			.UnitSize = bShardSampleRanges ? 1u : 8u
+		};
+
+		riow::RenderCoordinator coordinator(distributedSettings);
+		//Workers have to build the same scene and render it with the same pipeline, the pipeline overrides are passed on.
+		std::vector<String> workerArguments = sceneFilePath.empty()
+			? std::vector<String>{ "--scene", sceneName, "--bake-procedural", noiseBakeResolution }
+			: std::vector<String>{ "--scene-file", sceneFilePath };
+		for (const StringView pipelineArgument : PipelineArguments)
+		{
+			if (HasArgument(argc, argv, pipelineArgument))
+			{
+				workerArguments.emplace_back(pipelineArgument);
+				workerArguments.push_back(GetArgumentValue(argc, argv, pipelineArgument, ""));
+			}
+		}
+
+		if (!coordinator.Render(accumulationBuffer, renderPipeline, Path(argv[0]), workerArguments))
+		{
+			return 1;
+		}
+
+		if (renderPipeline.CheckpointIntervalInSec > 0.0f)
+		{
+			accumulationBuffer.SaveCheckpoint(checkpointFilePath);
+		}
+	}
+	else
+	{
+		renderer.Render(scene, accumulationBuffer);
+
+		//Counters of the render are stored next to the image, so changes in throughput can be attributed to the work that was done.
+		renderer.SaveStatistics(std::filesystem::path("bin") / CMAKE_INTDIR / "riowStatistics.json");
+	}
+	accumulationBuffer.Resolve(imageData);
 	DXRAY_INFO("Rendering took {} ms.", timer.GetElapsedMs());
     DXRAY_INFO("=================================\n");
 
     DXRAY_INFO("=================================");
     DXRAY_INFO("Storing results to file...");
 	timer.Reset();
-	riow::SaveColorBufferToFile("riowOutput", riow::Image::EFileExtension::png, imageDimensions.x, imageDimensions.y, imageChannelNum, static_cast<riow::Color*>(imageData.data()), true);
+	std::vector<u8> displayPixels;
+	riow::EncodeDisplayImage(imageData, displayPixels, displayTransform, &renderer.GetTaskScheduler());
+	DXRAY_INFO("Display transform took {} ms.", timer.GetElapsedMs());
+	riow::SavePixelBufferToFile("riowOutput", riow::Image::EFileExtension::png, imageDimensions.x, imageDimensions.y, imageChannelNum, displayPixels.data(), &renderer.GetTaskScheduler());
+	if (hdrOutputFormat != riow::Image::EFileExtension::Invalid)
+	{
+		riow::SaveRadianceBufferToFile("riowOutput", hdrOutputFormat, imageDimensions.x, imageDimensions.y, imageData.data());
+	}
+
+	if (timeBudgetInSec > 0.0f || adaptiveErrorThreshold > 0.0f)
+	{
+		//The amount of samples differs per pixel, store where they went next to the image.
+		accumulationBuffer.ResolveSampleCounts(imageData);
+		riow::SaveColorBufferToFile("riowSampleCount", riow::Image::EFileExtension::png, imageDimensions.x, imageDimensions.y, imageChannelNum, static_cast<riow::Color*>(imageData.data()), true);
+	}
+
+	//--film-channels stores the filter weights and the luminance variances of the pixels next to the image.
+	if (HasArgument(argc, argv, "--film-channels"))
+	{
+		accumulationBuffer.ResolveWeights(imageData);
+		riow::SaveColorBufferToFile("riowFilmWeight", riow::Image::EFileExtension::png, imageDimensions.x, imageDimensions.y, imageChannelNum, static_cast<riow::Color*>(imageData.data()), true);
+		accumulationBuffer.ResolveVariances(imageData, renderPipeline.GetSamplesPerPass());
+		riow::SaveColorBufferToFile("riowFilmVariance", riow::Image::EFileExtension::png, imageDimensions.x, imageDimensions.y, imageChannelNum, static_cast<riow::Color*>(imageData.data()), true);
+	}
 	DXRAY_INFO("Saving results took {} ms.", timer.GetElapsedMs());
     DXRAY_INFO("=================================");
 	
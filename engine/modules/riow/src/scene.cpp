@@ -5,27 +5,99 @@ namespace dxray::riow
 	void Scene::AddTraceable(std::shared_ptr<RayTraceable> a_pTraceable)
 	{
 		m_traceables.push_back(a_pTraceable);
+		m_accelerationStructure.Clear();
+	}
+
+	void Scene::AddMedium(std::shared_ptr<MediumVolume> a_pMedium)
+	{
+		m_media.push_back(a_pMedium);
+		AddTraceable(std::move(a_pMedium));
 	}
 
 	void Scene::DeleteAll()
 	{
 		m_traceables.clear();
+		m_media.clear();
+		m_accelerationStructure.Clear();
+		m_lights.Clear();
+		m_environment.reset();
+	}
+
+	void Scene::SetEnvironment(const EnvironmentLight& a_environment)
+	{
+		m_environment = std::make_shared<EnvironmentLight>(a_environment);
+		m_lights.Clear();
+	}
+
+	void Scene::BuildAccelerationStructure(const fp32 a_timeStart, const fp32 a_timeEnd)
+	{
+		m_accelerationStructure.Build(m_traceables, a_timeStart, a_timeEnd);
+
+		m_lights.Clear();
+		for (usize ti = 0; ti < m_traceables.size(); ++ti)
+		{
+			m_traceables[ti]->GatherLights(m_materials, static_cast<u32>(ti), m_lights);
+		}
+		m_lights.Build(m_materials, m_textures, m_environment.get(), a_timeStart, a_timeEnd);
 	}
 
 	bool Scene::DoesIntersect(const Ray& a_ray, fp32 a_tMin, fp32 a_tMax, IntersectionInfo& a_info) const
 	{
+		//Light indices live in the light list of the scene rather than in the traceables, which copies of the scene share.
+		if (!m_accelerationStructure.IsEmpty())
+		{
+			if (!m_accelerationStructure.DoesIntersect(a_ray, a_tMin, a_tMax, a_info))
+			{
+				return false;
+			}
+
+			a_info.LightIndex = m_lights.FindLight(a_info.TraceableIndex, a_info.PrimitiveIndex);
+			return true;
+		}
+
+		//Without acceleration structure the scene has no lights, see BuildAccelerationStructure.
 		IntersectionInfo currentHitInfo;
 		fp32 lastIntersectionMagnitude = a_tMax;
 
-		for (const auto& raytraceable : m_traceables)
+		for (usize ti = 0; ti < m_traceables.size(); ++ti)
 		{
-			if (raytraceable->DoesIntersect(a_ray, a_tMin, lastIntersectionMagnitude, currentHitInfo))
+			if (m_traceables[ti]->DoesIntersect(a_ray, a_tMin, lastIntersectionMagnitude, currentHitInfo))
 			{
 				lastIntersectionMagnitude = currentHitInfo.Length;
 				a_info = currentHitInfo;
+				a_info.TraceableIndex = static_cast<u32>(ti);
 			}
 		}
 
 		return lastIntersectionMagnitude < a_tMax;
 	}
-}
\ No newline at end of file
+
+	fp32 Scene::EstimateTransmittance(const Ray& a_ray, fp32 a_tMin, fp32 a_tMax) const
+	{
+		if (!m_accelerationStructure.IsEmpty())
+		{
+			if (m_accelerationStructure.IsOccluded(a_ray, a_tMin, a_tMax))
+			{
+				return 0.0f;
+			}
+		}
+		else
+		{
+			for (const auto& raytraceable : m_traceables)
+			{
+				if (raytraceable->DoesOcclude(a_ray, a_tMin, a_tMax))
+				{
+					return 0.0f;
+				}
+			}
+		}
+
+		fp32 transmittance = 1.0f;
+		for (const auto& pMedium : m_media)
+		{
+			transmittance *= pMedium->EstimateTransmittance(a_ray, a_tMin, a_tMax);
+		}
+
+		return transmittance;
+	}
+}
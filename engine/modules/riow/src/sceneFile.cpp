@@ -0,0 +1,790 @@
+#include "riow/sceneFile.h"
+#include "riow/traceable/sphereSet.h"
+#include "riow/image.h"
+#include <core/fileSystem/fileIO.h>
+#include <core/fileSystem/mappedFile.h>
+#include <charconv>
+
+namespace dxray::riow
+{
+	//--- Scene records ---
+
+	static constexpr char CookedSceneMagic[8] = { 'R', 'I', 'O', 'W', 'S', 'C', 'N', '\0' };
+	static constexpr u32 CookedSceneVersion = 6;
+	static constexpr usize CookedSectionAlignment = 16;
+	static constexpr u32 MaxStatementTokenCount = 10;
+
+	enum class ETextureType : u32
+	{
+		Solid = 0,
+		Checker,
+		Noise,
+		Image
+	};
+
+	enum class EMaterialType : u32
+	{
+		Lambertian = 0,
+		Metallic,
+		Dielectric,
+		Light,
+		Isotropic
+	};
+
+	/// <summary>
+	/// Statements are parsed into fixed size records, which are stored as is in cooked files.
+	/// </summary>
+	struct CookedTexture final
+	{
+		ETextureType Type = ETextureType::Solid;
+		u32 References[2] = {};		//Earlier textures used by checkers.
+		fp32 Parameters[3] = {};
+		u32 PathOffset = 0;			//Image path within the string section.
+		u32 PathLength = 0;
+	};
+
+	struct CookedMaterial final
+	{
+		EMaterialType Type = EMaterialType::Lambertian;
+		u32 Texture = 0;
+		fp32 Parameters[4] = {};
+	};
+
+	struct CookedEnvironment final
+	{
+		u32 PathOffset = 0;			//Image path within the string section, no environment when empty.
+		u32 PathLength = 0;
+		fp32 Strength = 1.0f;
+	};
+
+	struct CookedCamera final
+	{
+		vath::Vector3f Position = vath::Vector3f(0.0f, 0.0f, 10.0f);
+		vath::Vector3f Target = vath::Vector3f(0.0f);
+		fp32 VerticalFovInDeg = 20.0f;
+		fp32 Aperture = 0.0f;
+		fp32 FocalLength = 10.0f;
+		fp32 ShutterSpeed = 0.001f;
+	};
+
+	struct CookedSection final
+	{
+		u64 Offset = 0;
+		u64 Count = 0;
+	};
+
+	struct CookedSceneHeader final
+	{
+		char Magic[8] = {};
+		u32 Version = CookedSceneVersion;
+		u32 HeaderSizeInBytes = sizeof(CookedSceneHeader);
+		CookedCamera Camera;
+		SceneFileSettings Settings;
+		CookedEnvironment Environment;
+		CookedSection Textures;
+		CookedSection Materials;
+		CookedSection Spheres;
+		CookedSection Nodes;
+		CookedSection Strings;
+	};
+
+	static_assert(std::is_trivially_copyable_v<CookedSceneHeader> && std::is_trivially_copyable_v<SphereSet::Element> && std::is_trivially_copyable_v<BoundingVolumeHierarchy::Node>,
+		"Cooked records are copied in and out of files as raw memory.");
+
+	/// <summary>
+	/// Parsed text scene, sphere materials refer to the index of the material rather than its id.
+	/// </summary>
+	struct SceneDescription final
+	{
+		CookedCamera Camera;
+		SceneFileSettings Settings;
+		CookedEnvironment Environment;
+		std::vector<CookedTexture> Textures;
+		std::vector<CookedMaterial> Materials;
+		std::vector<SphereSet::Element> Spheres;
+		String Strings;
+	};
+
+	/// <summary>
+	/// Records of either a parsed text scene or a mapped cooked scene. Without nodes the sphere hierarchy is built when instantiating.
+	/// </summary>
+	struct SceneView final
+	{
+		const CookedCamera* pCamera = nullptr;
+		const SceneFileSettings* pSettings = nullptr;
+		const CookedEnvironment* pEnvironment = nullptr;
+		const CookedTexture* pTextures = nullptr;
+		usize TextureCount = 0;
+		const CookedMaterial* pMaterials = nullptr;
+		usize MaterialCount = 0;
+		const SphereSet::Element* pSpheres = nullptr;
+		usize SphereCount = 0;
+		const BoundingVolumeHierarchy::Node* pNodes = nullptr;
+		usize NodeCount = 0;
+		StringView Strings;
+	};
+
+
+	//--- Text parsing ---
+
+	struct NameHash final
+	{
+		using is_transparent = void;
+		usize operator()(const StringView a_name) const
+		{
+			return std::hash<StringView>{}(a_name);
+		}
+	};
+
+	using NameTable = std::unordered_map<String, u32, NameHash, std::equal_to<>>;
+
+	/// <summary>
+	/// Whitespace separated tokens of a single line.
+	/// </summary>
+	struct Statement final
+	{
+		StringView Tokens[MaxStatementTokenCount];
+		u32 TokenCount = 0;
+
+		bool Read(const u32 a_tokenIndex, fp32& a_value) const;
+		bool Read(const u32 a_tokenIndex, u32& a_value) const;
+		bool Read(const u32 a_tokenIndex, vath::Vector3f& a_value) const;
+	};
+
+	bool Statement::Read(const u32 a_tokenIndex, fp32& a_value) const
+	{
+		const StringView token = Tokens[a_tokenIndex];
+		const std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), a_value);
+		return result.ec == std::errc() && result.ptr == token.data() + token.size();
+	}
+
+	bool Statement::Read(const u32 a_tokenIndex, u32& a_value) const
+	{
+		const StringView token = Tokens[a_tokenIndex];
+		const std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), a_value);
+		return result.ec == std::errc() && result.ptr == token.data() + token.size();
+	}
+
+	bool Statement::Read(const u32 a_tokenIndex, vath::Vector3f& a_value) const
+	{
+		return Read(a_tokenIndex, a_value.x) && Read(a_tokenIndex + 1, a_value.y) && Read(a_tokenIndex + 2, a_value.z);
+	}
+
+	/// <summary>
+	/// Splits a line into tokens, returns false when the line holds more tokens than any statement.
+	/// </summary>
+	static bool TokenizeLine(const StringView a_line, Statement& a_statement)
+	{
+		a_statement.TokenCount = 0;
+		usize position = 0;
+		while (true)
+		{
+			position = a_line.find_first_not_of(" \t\r", position);
+			if (position == StringView::npos)
+			{
+				return true;
+			}
+
+			if (a_statement.TokenCount == MaxStatementTokenCount)
+			{
+				return false;
+			}
+
+			const usize tokenEnd = vath::Min(a_line.find_first_of(" \t\r", position), a_line.size());
+			a_statement.Tokens[a_statement.TokenCount++] = a_line.substr(position, tokenEnd - position);
+			position = tokenEnd;
+		}
+	}
+
+	static bool ParseStatement(const Statement& a_statement, NameTable& a_textureIndices, NameTable& a_materialIndices, SceneDescription& a_description, String& a_error)
+	{
+		const StringView keyword = a_statement.Tokens[0];
+		const u32 tokenCount = a_statement.TokenCount;
+
+		//Spheres make up nearly all statements of large scenes, they are checked first and look up their material without allocating.
+		if (keyword == "sphere")
+		{
+			SphereSet::Element sphere;
+			if ((tokenCount != 6 && tokenCount != 9) || !a_statement.Read(1, sphere.Center) || !a_statement.Read(4, sphere.Radius) || sphere.Radius <= 0.0f)
+			{
+				a_error = "Expected: sphere <x> <y> <z> <radius> <material> [<end x> <end y> <end z>]";
+				return false;
+			}
+
+			const NameTable::const_iterator material = a_materialIndices.find(a_statement.Tokens[5]);
+			if (material == a_materialIndices.end())
+			{
+				a_error = std::format("Unknown material: {}", a_statement.Tokens[5]);
+				return false;
+			}
+
+			vath::Vector3f endCenter = sphere.Center;
+			if (tokenCount == 9 && !a_statement.Read(6, endCenter))
+			{
+				a_error = "Invalid sphere end center.";
+				return false;
+			}
+
+			sphere.Velocity = endCenter - sphere.Center;
+			sphere.Material = material->second;
+			a_description.Spheres.push_back(sphere);
+			return true;
+		}
+
+		if (keyword == "image")
+		{
+			vath::Vector2u32& dimensions = a_description.Settings.ImageDimensions;
+			if (tokenCount != 3 || !a_statement.Read(1, dimensions.x) || !a_statement.Read(2, dimensions.y) || dimensions.x == 0 || dimensions.y == 0)
+			{
+				a_error = "Expected: image <width> <height>";
+				return false;
+			}
+
+			return true;
+		}
+
+		if (keyword == "background")
+		{
+			if (tokenCount != 4 || !a_statement.Read(1, a_description.Settings.BackgroundColor))
+			{
+				a_error = "Expected: background <r> <g> <b>";
+				return false;
+			}
+
+			return true;
+		}
+
+		if (keyword == "environment")
+		{
+			CookedEnvironment& environment = a_description.Environment;
+			if ((tokenCount != 2 && tokenCount != 3) || (tokenCount == 3 && (!a_statement.Read(2, environment.Strength) || environment.Strength < 0.0f)))
+			{
+				a_error = "Expected: environment <path> [<strength>]";
+				return false;
+			}
+
+			environment.PathOffset = static_cast<u32>(a_description.Strings.size());
+			environment.PathLength = static_cast<u32>(a_statement.Tokens[1].size());
+			a_description.Strings += a_statement.Tokens[1];
+			return true;
+		}
+
+		if (keyword == "camera" && tokenCount >= 3)
+		{
+			CookedCamera& camera = a_description.Camera;
+			const StringView property = a_statement.Tokens[1];
+			const bool bValid =
+				property == "position" ? tokenCount == 5 && a_statement.Read(2, camera.Position) :
+				property == "target" ? tokenCount == 5 && a_statement.Read(2, camera.Target) :
+				property == "fov" ? tokenCount == 3 && a_statement.Read(2, camera.VerticalFovInDeg) :
+				property == "aperture" ? tokenCount == 3 && a_statement.Read(2, camera.Aperture) :
+				property == "focus" ? tokenCount == 3 && a_statement.Read(2, camera.FocalLength) :
+				property == "shutter" ? tokenCount == 3 && a_statement.Read(2, camera.ShutterSpeed) :
+				false;
+
+			if (!bValid)
+			{
+				a_error = "Expected: camera position|target <x> <y> <z>, or camera fov|aperture|focus|shutter <value>";
+				return false;
+			}
+
+			return true;
+		}
+
+		if (keyword == "pipeline" && tokenCount == 3)
+		{
+			RendererPipeline& pipeline = a_description.Settings.Pipeline;
+			const StringView property = a_statement.Tokens[1];
+			u32 value = 0;
+			if (!a_statement.Read(2, value) || value == 0 || value > (property == "caustics" ? u32max : property == "passes" || property == "guiding" ? u16max : u8max))
+			{
+				a_error = std::format("Invalid pipeline value: {}", a_statement.Tokens[2]);
+				return false;
+			}
+
+			if (property == "depth") pipeline.MaxTraceDepth = static_cast<u8>(value);
+			else if (property == "supersample") pipeline.SuperSampleFactor = static_cast<u8>(value);
+			else if (property == "dof") pipeline.DepthOfFieldSampleCount = static_cast<u8>(value);
+			else if (property == "cluster") pipeline.ClusterSize = static_cast<u8>(value);
+			else if (property == "passes") pipeline.PassCount = static_cast<u16>(value);
+			else if (property == "guiding") pipeline.GuidingTrainingPassCount = static_cast<u16>(value);
+			else if (property == "reservoirs") pipeline.ReservoirCandidateCount = static_cast<u8>(value);
+			else if (property == "caustics") pipeline.CausticPhotonCount = value;
+			else
+			{
+				a_error = std::format("Unknown pipeline property: {}", property);
+				return false;
+			}
+
+			return true;
+		}
+
+		if (keyword == "filter" && tokenCount >= 2)
+		{
+			RendererPipeline& pipeline = a_description.Settings.Pipeline;
+			const StringView filter = a_statement.Tokens[1];
+			const bool bKnownFilter = filter == "box" || filter == "tent" || filter == "gaussian" || filter == "mitchell";
+			if (!bKnownFilter || (tokenCount != 2 && tokenCount != 3) ||
+				(tokenCount == 3 && (!a_statement.Read(2, pipeline.FilterRadiusInPx) || pipeline.FilterRadiusInPx <= 0.0f)))
+			{
+				a_error = "Expected: filter box|tent|gaussian|mitchell [<radius in pixels>]";
+				return false;
+			}
+
+			pipeline.Filter = filter == "tent" ? EReconstructionFilter::Tent : filter == "gaussian" ? EReconstructionFilter::Gaussian :
+				filter == "mitchell" ? EReconstructionFilter::Mitchell : EReconstructionFilter::Box;
+			return true;
+		}
+
+		if ((keyword == "texture" || keyword == "material") && tokenCount >= 3)
+		{
+			NameTable& names = keyword == "texture" ? a_textureIndices : a_materialIndices;
+			const StringView name = a_statement.Tokens[1];
+			if (names.find(name) != names.end())
+			{
+				a_error = std::format("Redefinition of {}: {}", keyword, name);
+				return false;
+			}
+
+			const StringView type = a_statement.Tokens[2];
+			auto ReadTexture = [&](const u32 a_tokenIndex, u32& a_textureIndex)
+			{
+				const NameTable::const_iterator texture = a_textureIndices.find(a_statement.Tokens[a_tokenIndex]);
+				if (texture == a_textureIndices.end())
+				{
+					a_error = std::format("Unknown texture: {}", a_statement.Tokens[a_tokenIndex]);
+					return false;
+				}
+
+				a_textureIndex = texture->second;
+				return true;
+			};
+
+			if (keyword == "texture")
+			{
+				CookedTexture texture;
+				vath::Vector3f color;
+				bool bValid = false;
+				if (type == "solid" && tokenCount == 6 && a_statement.Read(3, color))
+				{
+					texture.Type = ETextureType::Solid;
+					texture.Parameters[0] = color.x;
+					texture.Parameters[1] = color.y;
+					texture.Parameters[2] = color.z;
+					bValid = true;
+				}
+				else if (type == "checker" && tokenCount == 6 && a_statement.Read(3, texture.Parameters[0]))
+				{
+					texture.Type = ETextureType::Checker;
+					bValid = ReadTexture(4, texture.References[0]) && ReadTexture(5, texture.References[1]);
+				}
+				else if (type == "noise" && tokenCount == 4 && a_statement.Read(3, texture.Parameters[0]))
+				{
+					texture.Type = ETextureType::Noise;
+					bValid = true;
+				}
+				else if (type == "image" && tokenCount == 4)
+				{
+					texture.Type = ETextureType::Image;
+					texture.PathOffset = static_cast<u32>(a_description.Strings.size());
+					texture.PathLength = static_cast<u32>(a_statement.Tokens[3].size());
+					a_description.Strings += a_statement.Tokens[3];
+					bValid = true;
+				}
+
+				if (!bValid)
+				{
+					if (a_error.empty())
+					{
+						a_error = "Expected: texture <name> solid <r> <g> <b> | checker <scale> <even> <odd> | noise <scale> | image <path>";
+					}
+
+					return false;
+				}
+
+				names.emplace(String(name), static_cast<u32>(a_description.Textures.size()));
+				a_description.Textures.push_back(texture);
+				return true;
+			}
+
+			CookedMaterial material;
+			vath::Vector3f color;
+			bool bValid = false;
+			if (type == "lambertian" && tokenCount == 4)
+			{
+				material.Type = EMaterialType::Lambertian;
+				bValid = ReadTexture(3, material.Texture);
+			}
+			else if (type == "metallic" && tokenCount == 7 && a_statement.Read(3, color) && a_statement.Read(6, material.Parameters[3]))
+			{
+				material.Type = EMaterialType::Metallic;
+				material.Parameters[0] = color.x;
+				material.Parameters[1] = color.y;
+				material.Parameters[2] = color.z;
+				bValid = true;
+			}
+			else if (type == "dielectric" && tokenCount == 4 && a_statement.Read(3, material.Parameters[0]))
+			{
+				material.Type = EMaterialType::Dielectric;
+				bValid = true;
+			}
+			else if (type == "light" && tokenCount == 5 && a_statement.Read(4, material.Parameters[0]))
+			{
+				material.Type = EMaterialType::Light;
+				bValid = ReadTexture(3, material.Texture);
+			}
+			else if (type == "isotropic" && tokenCount == 4)
+			{
+				material.Type = EMaterialType::Isotropic;
+				bValid = ReadTexture(3, material.Texture);
+			}
+
+			if (!bValid)
+			{
+				if (a_error.empty())
+				{
+					a_error = "Expected: material <name> lambertian <texture> | metallic <r> <g> <b> <fuzz> | dielectric <ior> | light <texture> <strength> | isotropic <texture>";
+				}
+
+				return false;
+			}
+
+			names.emplace(String(name), static_cast<u32>(a_description.Materials.size()));
+			a_description.Materials.push_back(material);
+			return true;
+		}
+
+		a_error = std::format("Unknown statement: {}", keyword);
+		return false;
+	}
+
+	static bool ParseSceneText(const StringView a_text, const Path& a_filePath, SceneDescription& a_description)
+	{
+		NameTable textureIndices;
+		NameTable materialIndices;
+		Statement statement;
+		String error;
+
+		usize lineStart = 0;
+		u32 lineNumber = 0;
+		while (lineStart < a_text.size())
+		{
+			const usize lineEnd = vath::Min(a_text.find('\n', lineStart), a_text.size());
+			StringView line = a_text.substr(lineStart, lineEnd - lineStart);
+			lineStart = lineEnd + 1;
+			++lineNumber;
+
+			line = line.substr(0, line.find('#'));
+			if (!TokenizeLine(line, statement))
+			{
+				DXRAY_ERROR("{}({}): Too many tokens.", a_filePath.string(), lineNumber);
+				return false;
+			}
+
+			if (statement.TokenCount > 0 && !ParseStatement(statement, textureIndices, materialIndices, a_description, error))
+			{
+				DXRAY_ERROR("{}({}): {}", a_filePath.string(), lineNumber, error);
+				return false;
+			}
+		}
+
+		const vath::Vector2u32& dimensions = a_description.Settings.ImageDimensions;
+		const u32 clusterSize = a_description.Settings.Pipeline.ClusterSize;
+		if (dimensions.x % clusterSize != 0 || dimensions.y % clusterSize != 0)
+		{
+			DXRAY_ERROR("{}: Image dimensions have to be divisible by the cluster size ({}).", a_filePath.string(), clusterSize);
+			return false;
+		}
+
+		return true;
+	}
+
+	static SceneView GetSceneView(const SceneDescription& a_description)
+	{
+		return SceneView
+		{
+			.pCamera = &a_description.Camera,
+			.pSettings = &a_description.Settings,
+			.pEnvironment = &a_description.Environment,
+			.pTextures = a_description.Textures.data(),
+			.TextureCount = a_description.Textures.size(),
+			.pMaterials = a_description.Materials.data(),
+			.MaterialCount = a_description.Materials.size(),
+			.pSpheres = a_description.Spheres.data(),
+			.SphereCount = a_description.Spheres.size(),
+			.Strings = a_description.Strings
+		};
+	}
+
+
+	//--- Cooked files ---
+
+	/// <summary>
+	/// Resolves the sections of a mapped cooked file, every section has to lie within the file.
+	/// </summary>
+	static bool GetCookedSceneView(const MappedFile& a_file, SceneView& a_view)
+	{
+		if (a_file.GetSizeInBytes() < sizeof(CookedSceneHeader))
+		{
+			return false;
+		}
+
+		const CookedSceneHeader& header = *reinterpret_cast<const CookedSceneHeader*>(a_file.GetData());
+		if (header.Version != CookedSceneVersion || header.HeaderSizeInBytes != sizeof(CookedSceneHeader))
+		{
+			DXRAY_ERROR("Cooked scene was written by a different version, re-cook it from its text scene.");
+			return false;
+		}
+
+		bool bValid = true;
+		auto GetSection = [&]<typename TRecord>(const CookedSection& a_section, const TRecord*& a_pRecords, usize& a_count)
+		{
+			const u64 fileSize = a_file.GetSizeInBytes();
+			bValid = bValid && a_section.Offset % alignof(TRecord) == 0 && a_section.Offset <= fileSize && a_section.Count <= (fileSize - a_section.Offset) / sizeof(TRecord);
+			a_pRecords = reinterpret_cast<const TRecord*>(a_file.GetData() + a_section.Offset);
+			a_count = static_cast<usize>(a_section.Count);
+		};
+
+		const char* pStrings = nullptr;
+		usize stringsSize = 0;
+		a_view.pCamera = &header.Camera;
+		a_view.pSettings = &header.Settings;
+		a_view.pEnvironment = &header.Environment;
+		GetSection(header.Textures, a_view.pTextures, a_view.TextureCount);
+		GetSection(header.Materials, a_view.pMaterials, a_view.MaterialCount);
+		GetSection(header.Spheres, a_view.pSpheres, a_view.SphereCount);
+		GetSection(header.Nodes, a_view.pNodes, a_view.NodeCount);
+		GetSection(header.Strings, pStrings, stringsSize);
+		a_view.Strings = StringView(pStrings, stringsSize);
+
+		//The hierarchy is traversed without bounds checks, corrupt nodes must not be able to index outside of the arrays.
+		for (usize ni = 0; bValid && ni < a_view.NodeCount; ++ni)
+		{
+			const BoundingVolumeHierarchy::Node& node = a_view.pNodes[ni];
+			bValid = node.Count > 0
+				? static_cast<u64>(node.Index) + node.Count <= a_view.SphereCount
+				: node.Index > ni + 1 && node.Index < a_view.NodeCount && ni + 1 < a_view.NodeCount;
+		}
+
+		if (!bValid || (a_view.SphereCount > 0) != (a_view.NodeCount > 0))
+		{
+			DXRAY_ERROR("Cooked scene is corrupt.");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool CookSceneFile(const Path& a_textFilePath, const Path& a_cookedFilePath)
+	{
+		MappedFile textFile;
+		SceneDescription description;
+		if (!textFile.Open(a_textFilePath) || !ParseSceneText(StringView(reinterpret_cast<const char*>(textFile.GetData()), textFile.GetSizeInBytes()), a_textFilePath, description))
+		{
+			return false;
+		}
+
+		CookedSceneHeader header;
+		std::memcpy(header.Magic, CookedSceneMagic, sizeof(CookedSceneMagic));
+		header.Camera = description.Camera;
+		header.Settings = description.Settings;
+		header.Environment = description.Environment;
+
+		std::vector<u8> fileData(sizeof(CookedSceneHeader));
+		auto AppendSection = [&](const void* a_pRecords, const usize a_count, const usize a_recordSize)
+		{
+			fileData.resize((fileData.size() + CookedSectionAlignment - 1) / CookedSectionAlignment * CookedSectionAlignment);
+			const CookedSection section{ fileData.size(), a_count };
+			fileData.insert(fileData.end(), static_cast<const u8*>(a_pRecords), static_cast<const u8*>(a_pRecords) + a_count * a_recordSize);
+			return section;
+		};
+
+		header.Textures = AppendSection(description.Textures.data(), description.Textures.size(), sizeof(CookedTexture));
+		header.Materials = AppendSection(description.Materials.data(), description.Materials.size(), sizeof(CookedMaterial));
+		header.Strings = AppendSection(description.Strings.data(), description.Strings.size(), sizeof(char));
+
+		//The sphere set builds its hierarchy exactly like loading the text file would, its reordered spheres and nodes are stored as is.
+		if (!description.Spheres.empty())
+		{
+			const usize sphereCount = description.Spheres.size();
+			const SphereSet sphereSet(std::move(description.Spheres), 0.0f, description.Camera.ShutterSpeed);
+			const std::vector<BoundingVolumeHierarchy::Node>& nodes = sphereSet.GetHierarchy().GetNodes();
+			fileData.reserve(fileData.size() + CookedSectionAlignment * 2 + sphereCount * sizeof(SphereSet::Element) + nodes.size() * sizeof(BoundingVolumeHierarchy::Node));
+			header.Spheres = AppendSection(sphereSet.GetSpheres().data(), sphereCount, sizeof(SphereSet::Element));
+			header.Nodes = AppendSection(nodes.data(), nodes.size(), sizeof(BoundingVolumeHierarchy::Node));
+		}
+
+		std::memcpy(fileData.data(), &header, sizeof(CookedSceneHeader));
+		if (!WriteBinaryFile(a_cookedFilePath, DataBlob{ fileData.data(), fileData.size() }))
+		{
+			return false;
+		}
+
+		DXRAY_INFO("Cooked {} into {}: {} spheres, {} KiB.", a_textFilePath.string(), a_cookedFilePath.string(), header.Spheres.Count, fileData.size() / 1024);
+		return true;
+	}
+
+
+	//--- Loading ---
+
+	static bool InstantiateScene(const SceneView& a_view, Camera& a_camera, Scene& a_scene, SceneFileSettings& a_settings)
+	{
+		a_settings = *a_view.pSettings;
+
+		const CookedCamera& camera = *a_view.pCamera;
+		a_camera.SetViewportDimensionInPx(a_settings.ImageDimensions);
+		a_camera.SetVerticalFov(vath::DegToRad(camera.VerticalFovInDeg));
+		a_camera.SetAperture(camera.Aperture);
+		a_camera.SetFocalLength(camera.FocalLength);
+		a_camera.SetShutterSpeed(camera.ShutterSpeed);
+		a_camera.LookAt(camera.Position, camera.Target);
+
+		const CookedEnvironment& environment = *a_view.pEnvironment;
+		if (environment.PathLength > 0)
+		{
+			if (static_cast<usize>(environment.PathOffset) + environment.PathLength > a_view.Strings.size())
+			{
+				return false;
+			}
+
+			const Path environmentPath(a_view.Strings.substr(environment.PathOffset, environment.PathLength));
+			a_scene.SetEnvironment(EnvironmentLight::LoadFromFile(environmentPath.is_absolute() ? environmentPath : AssetRootDirectory / environmentPath, environment.Strength));
+		}
+
+		TextureTable& textures = a_scene.GetTextures();
+		std::vector<TextureId> textureIds(a_view.TextureCount);
+		for (usize ti = 0; ti < a_view.TextureCount; ++ti)
+		{
+			const CookedTexture& texture = a_view.pTextures[ti];
+			switch (texture.Type)
+			{
+			case ETextureType::Solid:
+				textureIds[ti] = textures.AddSolidColor(Color(texture.Parameters[0], texture.Parameters[1], texture.Parameters[2]));
+				break;
+			case ETextureType::Checker:
+				if (texture.References[0] >= ti || texture.References[1] >= ti)
+				{
+					return false;
+				}
+
+				textureIds[ti] = textures.Add(CheckerBoard(texture.Parameters[0], textureIds[texture.References[0]], textureIds[texture.References[1]]));
+				break;
+			case ETextureType::Noise:
+				textureIds[ti] = textures.Add(NoiseTexture(texture.Parameters[0]));
+				break;
+			case ETextureType::Image:
+			{
+				if (static_cast<usize>(texture.PathOffset) + texture.PathLength > a_view.Strings.size())
+				{
+					return false;
+				}
+
+				const Path imagePath(a_view.Strings.substr(texture.PathOffset, texture.PathLength));
+				textureIds[ti] = textures.Add(MipTexture::LoadFromFile(imagePath.is_absolute() ? imagePath : AssetRootDirectory / imagePath, Image::ELoadOptions::FlipVertically));
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+
+		MaterialTable& materials = a_scene.GetMaterials();
+		std::vector<MaterialId> materialIds(a_view.MaterialCount);
+		for (usize mi = 0; mi < a_view.MaterialCount; ++mi)
+		{
+			const CookedMaterial& material = a_view.pMaterials[mi];
+			const fp32* pParameters = material.Parameters;
+			if (material.Type != EMaterialType::Metallic && material.Type != EMaterialType::Dielectric && material.Texture >= a_view.TextureCount)
+			{
+				return false;
+			}
+
+			switch (material.Type)
+			{
+			case EMaterialType::Lambertian:
+				materialIds[mi] = materials.Add(Lambertian(textureIds[material.Texture]));
+				break;
+			case EMaterialType::Metallic:
+				materialIds[mi] = materials.Add(Metallic(Color(pParameters[0], pParameters[1], pParameters[2]), pParameters[3]));
+				break;
+			case EMaterialType::Dielectric:
+				materialIds[mi] = materials.Add(Dielectric(pParameters[0]));
+				break;
+			case EMaterialType::Light:
+				materialIds[mi] = materials.Add(DiffuseLight(textureIds[material.Texture], pParameters[0]));
+				break;
+			case EMaterialType::Isotropic:
+				materialIds[mi] = materials.Add(Isotropic(textureIds[material.Texture]));
+				break;
+			default:
+				return false;
+			}
+		}
+
+		if (a_view.SphereCount == 0)
+		{
+			return true;
+		}
+
+		//A single copy of all spheres, material indices are replaced by the ids of the materials on the way.
+		std::vector<SphereSet::Element> spheres(a_view.pSpheres, a_view.pSpheres + a_view.SphereCount);
+		for (SphereSet::Element& sphere : spheres)
+		{
+			if (sphere.Material >= a_view.MaterialCount)
+			{
+				return false;
+			}
+
+			sphere.Material = materialIds[sphere.Material];
+		}
+
+		a_scene.AddTraceable(a_view.NodeCount > 0
+			? std::make_shared<SphereSet>(std::move(spheres), a_view.pNodes, a_view.NodeCount)
+			: std::make_shared<SphereSet>(std::move(spheres), 0.0f, camera.ShutterSpeed)
+		);
+
+		return true;
+	}
+
+	bool LoadSceneFile(const Path& a_filePath, Camera& a_camera, Scene& a_scene, SceneFileSettings& a_settings)
+	{
+		Stopwatchf timer;
+		timer.Start();
+
+		MappedFile file;
+		if (!file.Open(a_filePath))
+		{
+			return false;
+		}
+
+		SceneDescription description;
+		SceneView view;
+		const bool bCooked = file.GetSizeInBytes() >= sizeof(CookedSceneMagic) && std::memcmp(file.GetData(), CookedSceneMagic, sizeof(CookedSceneMagic)) == 0;
+		if (bCooked)
+		{
+			if (!GetCookedSceneView(file, view))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			if (!ParseSceneText(StringView(reinterpret_cast<const char*>(file.GetData()), file.GetSizeInBytes()), a_filePath, description))
+			{
+				return false;
+			}
+
+			view = GetSceneView(description);
+		}
+
+		if (!InstantiateScene(view, a_camera, a_scene, a_settings))
+		{
+			DXRAY_ERROR("Scene file refers to records that do not exist: {}", a_filePath.string());
+			return false;
+		}
+
+		DXRAY_INFO("Loaded {} scene {} in {} ms: {} textures, {} materials, {} spheres.", bCooked ? "cooked" : "text", a_filePath.string(), timer.GetElapsedMs(),
+			view.TextureCount, view.MaterialCount, view.SphereCount);
+		return true;
+	}
+}
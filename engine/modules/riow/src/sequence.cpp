@@ -0,0 +1,188 @@
+#include "riow/sequence.h"
+#include "riow/sampler.h"
+#include <thread>
+
+namespace dxray::riow
+{
+	SequenceRenderer::SequenceRenderer(Renderer& a_renderer, const SequenceSettings& a_settings) :
+		m_renderer(a_renderer),
+		m_settings(a_settings)
+	{
+		DXRAY_ASSERT(m_settings.FrameCount > 0 && m_settings.FramesPerSecond > 0.0f);
+	}
+
+	void SequenceRenderer::Render(const Scene& a_scene, const u64 a_seed)
+	{
+		Camera camera = m_renderer.GetCamera();
+		const vath::Vector2u32 imageDims = camera.GetViewportDimensionsInPx();
+		const fp32 shutterSpeed = camera.GetShutterSpeed();
+		auto GetFrameTime = [this](const u32 a_frameIndex)
+		{
+			return static_cast<fp32>(a_frameIndex) / m_settings.FramesPerSecond;
+		};
+
+		//Double buffered, the scene and image of a frame are in use by the pipeline for two frames. The copies share their traceables, which building
+		//a frame scene only reads, its hierarchy and lights are its own.
+		Scene frameScenes[2] = { a_scene, a_scene };
+		std::vector<Color> frameImages[2];
+		AccumulationBuffer accumulationBuffers[2] = { AccumulationBuffer(imageDims), AccumulationBuffer(imageDims) };
+
+		//Frames don't checkpoint, each would overwrite the checkpoint of the one before it.
+		const RendererPipeline sequencePipeline = m_renderer.GetRenderPipeline();
+		if (sequencePipeline.CheckpointIntervalInSec > 0.0f)
+		{
+			DXRAY_WARN("Checkpoints are not supported by sequences and are disabled.");
+		}
+
+		RendererPipeline pipeline = sequencePipeline;
+		pipeline.CheckpointIntervalInSec = 0.0f;
+		m_renderer.SetRenderPipeline(pipeline);
+
+		//Temporal reuse keeps the first hits and camera of the previous frame around.
+		const u32 samplesPerPass = pipeline.GetSamplesPerPass();
+		GuideBuffer guideBuffers[2];
+		Camera frameCameras[2];
+		AccumulationBuffer historyBuffer;
+		u64 freshSampleCount = 0;
+		u64 reusedSampleCount = 0;
+
+		//Time spent on the overlapped stages, accumulated from the tasks.
+		std::atomic<u64> buildTimeInNs = 0;
+		std::atomic<u64> encodeTimeInNs = 0;
+		fp64 renderTimeInSec = 0.0;
+
+		auto BuildFrameScene = [&](const u32 a_frameIndex)
+		{
+			Stopwatchd buildTimer(true);
+			frameScenes[a_frameIndex % 2].BuildAccelerationStructure(GetFrameTime(a_frameIndex), GetFrameTime(a_frameIndex) + shutterSpeed);
+			buildTimeInNs += static_cast<u64>(buildTimer.GetElapsedSeconds() * 1'000'000'000.0);
+		};
+
+		auto EncodeFrame = [&](const u32 a_frameIndex)
+		{
+			Stopwatchd encodeTimer(true);
+			const String fileName = std::format("{}_{:04}", m_settings.OutputName, a_frameIndex);
+			const std::vector<Color>& frameImage = frameImages[a_frameIndex % 2];
+
+			//Runs next to the render, which occupies the task scheduler, so the display transform stays on this thread.
+			std::vector<u8> framePixels;
+			EncodeDisplayImage(frameImage, framePixels, m_settings.Display);
+			SavePixelBufferToFile(fileName, Image::EFileExtension::png, imageDims.x, imageDims.y, 3, framePixels.data());
+			if (m_settings.HdrOutputFormat != Image::EFileExtension::Invalid)
+			{
+				SaveRadianceBufferToFile(fileName, m_settings.HdrOutputFormat, imageDims.x, imageDims.y, frameImage.data());
+			}
+
+			encodeTimeInNs += static_cast<u64>(encodeTimer.GetElapsedSeconds() * 1'000'000'000.0);
+		};
+
+		DXRAY_INFO("=================================");
+		DXRAY_INFO("Rendering sequence: {} frames at {} fps", m_settings.FrameCount, m_settings.FramesPerSecond);
+		DXRAY_INFO("=================================");
+
+		Stopwatchd sequenceTimer(true);
+		BuildFrameScene(0);
+		for (u32 frame = 0; frame < m_settings.FrameCount; ++frame)
+		{
+			//The renderer waits on the task scheduler after every pass, tasks queued on it would hold up the first pass of the frame instead of
+			//overlapping the whole of it. The neighbouring frames get a thread of their own, joined once the frame is rendered.
+			std::thread frameStageThread([this, &BuildFrameScene, &EncodeFrame, frame]()
+			{
+				if (frame + 1 < m_settings.FrameCount)
+				{
+					BuildFrameScene(frame + 1);
+				}
+
+				if (frame > 0)
+				{
+					EncodeFrame(frame - 1);
+				}
+			});
+
+			Stopwatchd frameTimer(true);
+			const u32 current = frame % 2;
+			const u32 previous = (frame + 1) % 2;
+			const Scene& frameScene = frameScenes[current];
+			AccumulationBuffer& accumulationBuffer = accumulationBuffers[current];
+			frameCameras[current] = GetFrameCamera(camera, GetFrameTime(frame));
+			m_renderer.SetCamera(frameCameras[current]);
+			accumulationBuffer.Clear();
+			accumulationBuffer.SetSeed(HashSeed(a_seed + frame));
+
+			if (m_settings.bTemporalReuse)
+			{
+				m_renderer.RenderGuideBuffer(frameScene, guideBuffers[current]);
+			}
+
+			if (m_settings.bTemporalReuse && frame > 0)
+			{
+				TemporalReuseStatistics reuseStatistics;
+				ReprojectHistory(accumulationBuffers[previous], guideBuffers[previous], frameCameras[previous], guideBuffers[current], frameCameras[current],
+					GetFrameTime(1), samplesPerPass, m_settings.TemporalReuse, historyBuffer, reuseStatistics);
+
+				//Fresh passes first, the history is validated against them before the remaining passes fill up the pixels without history.
+				RendererPipeline freshPipeline = pipeline;
+				freshPipeline.PassCount = static_cast<u16>(vath::Min<u32>(m_settings.TemporalReuse.FreshPassCount, pipeline.PassCount));
+				m_renderer.SetRenderPipeline(freshPipeline);
+				m_renderer.Render(frameScene, accumulationBuffer);
+				MergeHistory(historyBuffer, samplesPerPass, m_settings.TemporalReuse, accumulationBuffer, reuseStatistics);
+				m_renderer.SetRenderPipeline(pipeline);
+				m_renderer.Render(frameScene, accumulationBuffer);
+
+				const fp32 pixelPercentage = 100.0f / accumulationBuffer.GetPixelCount();
+				DXRAY_INFO("Temporal reuse: {}% reused, {}% offscreen, {}% disoccluded, {}% rejected by variance",
+					reuseStatistics.ReusedPixelCount * pixelPercentage, reuseStatistics.OffscreenPixelCount * pixelPercentage,
+					reuseStatistics.DisoccludedPixelCount * pixelPercentage, reuseStatistics.VarianceRejectedPixelCount * pixelPercentage);
+				reusedSampleCount += reuseStatistics.ReusedSampleCount;
+			}
+			else
+			{
+				m_renderer.Render(frameScene, accumulationBuffer);
+			}
+
+			frameStageThread.join();
+			accumulationBuffer.Resolve(frameImages[current]);
+			for (u32 pi = 0; pi < accumulationBuffer.GetPixelCount(); ++pi)
+			{
+				freshSampleCount += accumulationBuffer.GetSampleCount(pi);
+			}
+
+			const fp64 frameTimeInSec = frameTimer.GetElapsedSeconds();
+			renderTimeInSec += frameTimeInSec;
+			DXRAY_INFO("Frame {} / {} took {} s.", frame + 1, m_settings.FrameCount, frameTimeInSec);
+		}
+
+		EncodeFrame(m_settings.FrameCount - 1);
+		m_renderer.SetRenderPipeline(sequencePipeline);
+		freshSampleCount -= reusedSampleCount;
+		const fp64 sequenceTimeInSec = sequenceTimer.GetElapsedSeconds();
+		const fp64 buildTimeInSec = static_cast<fp64>(buildTimeInNs.load()) / 1'000'000'000.0;
+		const fp64 encodeTimeInSec = static_cast<fp64>(encodeTimeInNs.load()) / 1'000'000'000.0;
+
+		DXRAY_INFO("=================================");
+		DXRAY_INFO("Sequence statistics:");
+		DXRAY_INFO("Total: {} s for {} frames", sequenceTimeInSec, m_settings.FrameCount);
+		DXRAY_INFO("Amortized time per frame: {} s", sequenceTimeInSec / m_settings.FrameCount);
+		DXRAY_INFO("Acceleration structure builds: {} s, encoding: {} s, rendering: {} s", buildTimeInSec, encodeTimeInSec, renderTimeInSec);
+		DXRAY_INFO("Fresh samples: {}, reused samples: {}", freshSampleCount, reusedSampleCount);
+		DXRAY_INFO("=================================");
+	}
+
+	Camera SequenceRenderer::GetFrameCamera(const Camera& a_camera, const fp32 a_frameTime) const
+	{
+		Camera frameCamera = a_camera;
+		frameCamera.SetShutterOpenTime(a_frameTime);
+		if (m_settings.CameraOrbitSpeedInRadPerSec != 0.0f)
+		{
+			const vath::Vector3f focusPoint = a_camera.GetFocusPoint();
+			const vath::Vector3f offset = a_camera.GetPosition() - focusPoint;
+			const fp32 angle = m_settings.CameraOrbitSpeedInRadPerSec * a_frameTime;
+			const fp32 cosAngle = std::cos(angle);
+			const fp32 sinAngle = std::sin(angle);
+			const vath::Vector3f orbitOffset(offset.x * cosAngle - offset.z * sinAngle, offset.y, offset.x * sinAngle + offset.z * cosAngle);
+			frameCamera.LookAt(focusPoint + orbitOffset, focusPoint);
+		}
+
+		return frameCamera;
+	}
+}
@@ -0,0 +1,122 @@
+#include "riow/streamingFilm.h"
+#include <thread>
+
+namespace dxray::riow
+{
+	StreamingFilm::StreamingFilm(Renderer& a_renderer, const StreamingFilmSettings& a_settings) :
+		m_renderer(a_renderer),
+		m_settings(a_settings)
+	{
+		DXRAY_ASSERT(m_settings.BandHeightInPx > 0);
+	}
+
+	bool StreamingFilm::Render(const Scene& a_scene, const u64 a_seed)
+	{
+		const vath::Vector2u32 imageDims = m_renderer.GetCamera().GetViewportDimensionsInPx();
+		const RendererPipeline pipeline = m_renderer.GetRenderPipeline();
+		DXRAY_ASSERT_WITH_MSG(m_settings.BandHeightInPx % pipeline.ClusterSize == 0, "The band height should be divisible by the cluster size");
+
+		//A band only holds its own rows, samples near a band border would lose their splats into the neighbouring band.
+		if (ReconstructionFilter(pipeline.Filter, pipeline.FilterRadiusInPx).GetMarginInPx() > 0)
+		{
+			DXRAY_ERROR("Streamed renders do not support reconstruction filters wider than a pixel.");
+			return false;
+		}
+
+		//Every band is a render of its own, the guide and the reservoirs would start over at every band instead of once for the image.
+		if (pipeline.GuidingTrainingPassCount > 0 || pipeline.ReservoirCandidateCount > 0)
+		{
+			DXRAY_WARN("Path guiding and reservoir resampling restart at every band of a streamed render, the image differs from a render of the full image.");
+		}
+
+		//Scene files enable checkpoints by default, they are disabled quietly and only a requested time budget is worth a warning.
+		if (pipeline.TimeBudgetInSec > 0.0f)
+		{
+			DXRAY_WARN("Time budgets are not supported by streamed renders and are disabled.");
+		}
+
+		RendererPipeline bandPipeline = pipeline;
+		bandPipeline.CheckpointIntervalInSec = 0.0f;
+		bandPipeline.TimeBudgetInSec = 0.0f;
+		m_renderer.SetRenderPipeline(bandPipeline);
+
+		ScanlineImageWriter displayWriter(m_settings.OutputName, Image::EFileExtension::png, imageDims, m_settings.Display);
+		std::unique_ptr<ScanlineImageWriter> pHdrWriter;
+		if (m_settings.HdrOutputFormat != Image::EFileExtension::Invalid)
+		{
+			pHdrWriter = std::make_unique<ScanlineImageWriter>(m_settings.OutputName, m_settings.HdrOutputFormat, imageDims);
+		}
+
+		//Double buffered, the resolved radiance of a band is written while the next band renders.
+		const u32 bandCount = (imageDims.y + m_settings.BandHeightInPx - 1) / m_settings.BandHeightInPx;
+		AccumulationBuffer bandBuffer;
+		std::vector<Color> bandImages[2];
+		std::atomic<bool> bWriteFailed = false;
+		std::atomic<u64> writeTimeInNs = 0;
+		auto GetBandHeight = [&](const u32 a_bandIndex)
+		{
+			return vath::Min(m_settings.BandHeightInPx, imageDims.y - a_bandIndex * m_settings.BandHeightInPx);
+		};
+
+		auto WriteBand = [&](const u32 a_bandIndex)
+		{
+			Stopwatchd writeTimer(true);
+			const std::vector<Color>& bandImage = bandImages[a_bandIndex % 2];
+			const u32 bandHeight = GetBandHeight(a_bandIndex);
+			bool bWritten = displayWriter.WriteRows(bandImage.data(), bandHeight);
+			if (pHdrWriter != nullptr)
+			{
+				bWritten = pHdrWriter->WriteRows(bandImage.data(), bandHeight) && bWritten;
+			}
+
+			if (!bWritten)
+			{
+				bWriteFailed.store(true);
+			}
+
+			writeTimeInNs += static_cast<u64>(writeTimer.GetElapsedSeconds() * 1'000'000'000.0);
+		};
+
+		DXRAY_INFO("=================================");
+		DXRAY_INFO("Streaming render: {} bands of {} rows", bandCount, m_settings.BandHeightInPx);
+		DXRAY_INFO("=================================");
+
+		Stopwatchd renderTimer(true);
+		for (u32 band = 0; band < bandCount && !bWriteFailed.load(); ++band)
+		{
+			//The renderer waits on the task scheduler after every pass, a write queued on it would only overlap the first pass of the band.
+			//The previous band is written from a thread of its own instead, joined before its image is overwritten by the band after this one.
+			std::thread writeThread([&WriteBand, band]()
+			{
+				if (band > 0)
+				{
+					WriteBand(band - 1);
+				}
+			});
+
+			bandBuffer.Resize(vath::Vector2u32(imageDims.x, GetBandHeight(band)));
+			bandBuffer.SetImageOffset(vath::Vector2u32(0u, band * m_settings.BandHeightInPx));
+			bandBuffer.SetSeed(a_seed);
+			m_renderer.Render(a_scene, bandBuffer);
+			writeThread.join();
+			bandBuffer.Resolve(bandImages[band % 2]);
+			DXRAY_INFO("Band {} / {} finished after {} s.", band + 1, bandCount, renderTimer.GetElapsedSeconds());
+		}
+
+		if (!bWriteFailed.load())
+		{
+			WriteBand(bandCount - 1);
+		}
+
+		m_renderer.SetRenderPipeline(pipeline);
+		const bool bStored = !bWriteFailed.load() && displayWriter.Finish() && (pHdrWriter == nullptr || pHdrWriter->Finish());
+
+		DXRAY_INFO("=================================");
+		DXRAY_INFO("Streaming statistics:");
+		DXRAY_INFO("Total: {} s", renderTimer.GetElapsedSeconds());
+		DXRAY_INFO("Writing (overlapped with rendering): {} s", static_cast<fp64>(writeTimeInNs.load()) / 1'000'000'000.0);
+		DXRAY_INFO("Peak band memory: {} MiB", static_cast<fp64>(imageDims.x) * m_settings.BandHeightInPx * (sizeof(Color) * 3 + sizeof(u32) + sizeof(fp32)) / (1024.0 * 1024.0));
+		DXRAY_INFO("=================================");
+		return bStored;
+	}
+}
@@ -0,0 +1,137 @@
+#include "riow/temporalReuse.h"
+
+namespace dxray::riow
+{
+	void GuideBuffer::Resize(const vath::Vector2u32& a_dimensionsInPx)
+	{
+		Dimensions = a_dimensionsInPx;
+		const usize pixelCount = static_cast<usize>(a_dimensionsInPx.x) * a_dimensionsInPx.y;
+		Positions.resize(pixelCount);
+		Velocities.resize(pixelCount);
+		Depths.resize(pixelCount);
+	}
+
+	void ReprojectHistory(const AccumulationBuffer& a_previousBuffer, const GuideBuffer& a_previousGuide, const Camera& a_previousCamera,
+		const GuideBuffer& a_guide, const Camera& a_camera, const fp32 a_frameDeltaTimeInSec, const u32 a_samplesPerPass,
+		const TemporalReuseSettings& a_settings, AccumulationBuffer& a_historyBuffer, TemporalReuseStatistics& a_statistics)
+	{
+		DXRAY_ASSERT(a_previousBuffer.GetPixelCount() == a_guide.Depths.size() && a_previousGuide.Depths.size() == a_guide.Depths.size());
+
+		a_historyBuffer.Resize(a_guide.Dimensions);
+		const vath::Vector3f previousCameraPosition = a_previousCamera.GetPosition();
+		const vath::Vector3f cameraPosition = a_camera.GetPosition();
+		const Color* const pPreviousRadiance = a_previousBuffer.GetRadianceSumData();
+		const fp32* const pPreviousWeights = a_previousBuffer.GetWeightSumData();
+		const u32* const pPreviousSampleCounts = a_previousBuffer.GetSampleCountData();
+		const fp32* const pPreviousLuminance = a_previousBuffer.GetLuminanceSumData();
+		const fp32* const pPreviousLuminanceSquared = a_previousBuffer.GetLuminanceSquaredSumData();
+
+		for (u32 pi = 0; pi < a_historyBuffer.GetPixelCount(); ++pi)
+		{
+			//Surfaces are moved back along their motion vector, the background only moves with the camera.
+			const bool bMiss = a_guide.Depths[pi] == GuideBuffer::MissDepth;
+			const vath::Vector3f previousPosition = a_guide.Positions[pi] - a_guide.Velocities[pi] * a_frameDeltaTimeInSec;
+			const vath::Vector4f projected = bMiss
+				? vath::Vector4f(a_guide.Positions[pi] - cameraPosition, 0.0f)
+				: vath::Vector4f(previousPosition, 1.0f);
+
+			vath::Vector2f previousPixel;
+			if (!a_previousCamera.ProjectToPixel(projected, previousPixel))
+			{
+				a_statistics.OffscreenPixelCount++;
+				continue;
+			}
+
+			const u32 qi = static_cast<u32>(previousPixel.x) + static_cast<u32>(previousPixel.y) * a_guide.Dimensions.x;
+			const fp32 previousDepth = a_previousGuide.Depths[qi];
+			const bool bPreviousMiss = previousDepth == GuideBuffer::MissDepth;
+			if (bMiss != bPreviousMiss)
+			{
+				a_statistics.DisoccludedPixelCount++;
+				continue;
+			}
+
+			if (!bMiss)
+			{
+				const fp32 expectedDepth = vath::Magnitude(previousPosition - previousCameraPosition);
+				if (vath::Abs(previousDepth - expectedDepth) > a_settings.DepthTolerance * expectedDepth)
+				{
+					a_statistics.DisoccludedPixelCount++;
+					continue;
+				}
+			}
+
+			//Only whole passes are reused, so the history keeps the same batch structure as freshly rendered samples.
+			const u32 previousPassCount = pPreviousSampleCounts[qi] / a_samplesPerPass;
+			const u32 historyPassCount = vath::Min(previousPassCount, a_settings.MaxHistoryPassCount);
+			if (historyPassCount == 0)
+			{
+				continue;
+			}
+
+			const fp32 historyScale = static_cast<fp32>(historyPassCount) / static_cast<fp32>(previousPassCount);
+			a_historyBuffer.GetRadianceSumData()[pi] = pPreviousRadiance[qi] * historyScale;
+			a_historyBuffer.GetWeightSumData()[pi] = pPreviousWeights[qi] * historyScale;
+			a_historyBuffer.GetSampleCountData()[pi] = historyPassCount * a_samplesPerPass;
+			a_historyBuffer.GetLuminanceSumData()[pi] = pPreviousLuminance[qi] * historyScale;
+			a_historyBuffer.GetLuminanceSquaredSumData()[pi] = pPreviousLuminanceSquared[qi] * historyScale;
+			a_statistics.ReprojectedPixelCount++;
+		}
+	}
+
+	void MergeHistory(const AccumulationBuffer& a_historyBuffer, const u32 a_samplesPerPass, const TemporalReuseSettings& a_settings,
+		AccumulationBuffer& a_accumulationBuffer, TemporalReuseStatistics& a_statistics)
+	{
+		DXRAY_ASSERT(a_historyBuffer.GetPixelCount() == a_accumulationBuffer.GetPixelCount());
+
+		//#Note: Dark pixels are compared with a minimum luminance difference, otherwise noise-free black pixels would reject any history.
+		constexpr fp32 MinLuminanceDifference = 1.0f / 256.0f;
+		const Color* const pHistoryRadiance = a_historyBuffer.GetRadianceSumData();
+		const fp32* const pHistoryWeights = a_historyBuffer.GetWeightSumData();
+		const u32* const pHistorySampleCounts = a_historyBuffer.GetSampleCountData();
+		const fp32* const pHistoryLuminance = a_historyBuffer.GetLuminanceSumData();
+		const fp32* const pHistoryLuminanceSquared = a_historyBuffer.GetLuminanceSquaredSumData();
+		Color* const pRadiance = a_accumulationBuffer.GetRadianceSumData();
+		fp32* const pWeights = a_accumulationBuffer.GetWeightSumData();
+		u32* const pSampleCounts = a_accumulationBuffer.GetSampleCountData();
+		fp32* const pLuminance = a_accumulationBuffer.GetLuminanceSumData();
+		fp32* const pLuminanceSquared = a_accumulationBuffer.GetLuminanceSquaredSumData();
+
+		for (u32 pi = 0; pi < a_accumulationBuffer.GetPixelCount(); ++pi)
+		{
+			const u32 historyBatchCount = pHistorySampleCounts[pi] / a_samplesPerPass;
+			const u32 freshBatchCount = pSampleCounts[pi] / a_samplesPerPass;
+			if (historyBatchCount == 0 || freshBatchCount == 0)
+			{
+				continue;
+			}
+
+			//The batch variance is estimated from the history alone, a biased history would otherwise inflate the variance it is tested against.
+			//The history is consistent when both means agree within their standard errors.
+			if (historyBatchCount < 2)
+			{
+				a_statistics.VarianceRejectedPixelCount++;
+				continue;
+			}
+
+			const fp32 n = static_cast<fp32>(historyBatchCount);
+			const fp32 historyMean = pHistoryLuminance[pi] / n;
+			const fp32 freshMean = pLuminance[pi] / static_cast<fp32>(freshBatchCount);
+			const fp32 batchVariance = vath::Max(pHistoryLuminanceSquared[pi] / n - historyMean * historyMean, 0.0f) * n / (n - 1.0f);
+			const fp32 standardError = std::sqrt(batchVariance / n + batchVariance / freshBatchCount);
+			if (vath::Abs(historyMean - freshMean) > a_settings.RejectionSigmaScale * standardError + MinLuminanceDifference)
+			{
+				a_statistics.VarianceRejectedPixelCount++;
+				continue;
+			}
+
+			pRadiance[pi] += pHistoryRadiance[pi];
+			pWeights[pi] += pHistoryWeights[pi];
+			pSampleCounts[pi] += pHistorySampleCounts[pi];
+			pLuminance[pi] += pHistoryLuminance[pi];
+			pLuminanceSquared[pi] += pHistoryLuminanceSquared[pi];
+			a_statistics.ReusedPixelCount++;
+			a_statistics.ReusedSampleCount += pHistorySampleCounts[pi];
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#include "riow/texture.h"
+
+namespace dxray::riow
+{
+    void NoiseTexture::Bake(const BoundingBox& a_bounds, const u32 a_resolution)
+    {
+        DXRAY_ASSERT(a_bounds.IsValid());
+        DXRAY_ASSERT(a_resolution >= 2);
+
+        Stopwatchf timer;
+        timer.Start();
+
+        std::shared_ptr<BakedGrid> grid = std::make_shared<BakedGrid>();
+        const vath::Vector3f extent = a_bounds.Max - a_bounds.Min;
+        const fp32 longestExtent = vath::Max(extent.x, vath::Max(extent.y, extent.z));
+        grid->Bounds = a_bounds;
+        grid->CellsPerUnit = static_cast<fp32>(a_resolution - 1) / longestExtent;
+        grid->Resolution = vath::Vector3u32(
+            vath::Max(static_cast<u32>(std::ceil(extent.x * grid->CellsPerUnit)) + 1, 2u),
+            vath::Max(static_cast<u32>(std::ceil(extent.y * grid->CellsPerUnit)) + 1, 2u),
+            vath::Max(static_cast<u32>(std::ceil(extent.z * grid->CellsPerUnit)) + 1, 2u)
+        );
+        grid->Values.resize(static_cast<usize>(grid->Resolution.x) * grid->Resolution.y * grid->Resolution.z);
+
+        //Rows are baked eight grid points at a time.
+        constexpr u32 laneCount = static_cast<u32>(vath::Float8::LaneCount);
+        const fp32 cellSize = 1.0f / grid->CellsPerUnit;
+        usize valueIndex = 0;
+        for (u32 z = 0; z < grid->Resolution.z; ++z)
+        {
+            const vath::Float8 pointZ(a_bounds.Min.z + static_cast<fp32>(z) * cellSize);
+            for (u32 y = 0; y < grid->Resolution.y; ++y)
+            {
+                const vath::Float8 pointY(a_bounds.Min.y + static_cast<fp32>(y) * cellSize);
+                for (u32 x = 0; x < grid->Resolution.x; x += laneCount)
+                {
+                    alignas(32) fp32 pointX[laneCount];
+                    for (u32 li = 0; li < laneCount; ++li)
+                    {
+                        pointX[li] = a_bounds.Min.x + static_cast<fp32>(x + li) * cellSize;
+                    }
+
+                    alignas(32) fp32 turbulence[laneCount];
+                    m_perlin.Turbulence(vath::Float8::Load(pointX), pointY, pointZ, m_accumilationDepth).Store(turbulence);
+
+                    const u32 pointCount = vath::Min(grid->Resolution.x - x, laneCount);
+                    for (u32 li = 0; li < pointCount; ++li)
+                    {
+                        grid->Values[valueIndex++] = turbulence[li];
+                    }
+                }
+            }
+        }
+
+        DXRAY_INFO("Baked noise texture into a {}x{}x{} grid ({} MB) in {} ms.", grid->Resolution.x, grid->Resolution.y, grid->Resolution.z,
+            static_cast<fp64>(grid->Values.size() * sizeof(fp32)) / (1024.0 * 1024.0), timer.GetElapsedMs());
+        m_bakedGrid = std::move(grid);
+    }
+
+    bool NoiseTexture::SampleBakedGrid(const BakedGrid& a_grid, const vath::Vector3f& a_point, fp32& a_value)
+    {
+        const BoundingBox& bounds = a_grid.Bounds;
+        if (a_point.x < bounds.Min.x || a_point.y < bounds.Min.y || a_point.z < bounds.Min.z ||
+            a_point.x > bounds.Max.x || a_point.y > bounds.Max.y || a_point.z > bounds.Max.z)
+        {
+            return false;
+        }
+
+        const vath::Vector3f gridPoint = (a_point - bounds.Min) * a_grid.CellsPerUnit;
+        const u32 x0 = vath::Min(static_cast<u32>(gridPoint.x), a_grid.Resolution.x - 2);
+        const u32 y0 = vath::Min(static_cast<u32>(gridPoint.y), a_grid.Resolution.y - 2);
+        const u32 z0 = vath::Min(static_cast<u32>(gridPoint.z), a_grid.Resolution.z - 2);
+        const fp32 tx = gridPoint.x - static_cast<fp32>(x0);
+        const fp32 ty = gridPoint.y - static_cast<fp32>(y0);
+        const fp32 tz = gridPoint.z - static_cast<fp32>(z0);
+
+        const usize rowStride = a_grid.Resolution.x;
+        const usize sliceStride = rowStride * a_grid.Resolution.y;
+        const fp32* pCell = &a_grid.Values[z0 * sliceStride + y0 * rowStride + x0];
+
+        const fp32 front = vath::Lerp(vath::Lerp(pCell[0], pCell[1], tx), vath::Lerp(pCell[rowStride], pCell[rowStride + 1], tx), ty);
+        const fp32 back = vath::Lerp(vath::Lerp(pCell[sliceStride], pCell[sliceStride + 1], tx), vath::Lerp(pCell[sliceStride + rowStride], pCell[sliceStride + rowStride + 1], tx), ty);
+        a_value = vath::Lerp(front, back, tz);
+        return true;
+    }
+}
@@ -0,0 +1,92 @@
+#include "riow/traceable/mediumVolume.h"
+
+namespace dxray::riow
+{
+	MediumVolume::MediumVolume(std::shared_ptr<RayTraceable> a_pBoundary, const MediumDensity& a_density, const MaterialId a_phaseMaterial) :
+		m_pBoundary(std::move(a_pBoundary)),
+		m_density(a_density),
+		m_phaseMaterial(a_phaseMaterial)
+	{
+		DXRAY_ASSERT(m_pBoundary != nullptr);
+	}
+
+	bool MediumVolume::DoesIntersect(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, IntersectionInfo& a_info) const
+	{
+		fp32 tEnter = 0.0f;
+		fp32 tExit = 0.0f;
+		if (!GetBoundaryInterval(a_ray, a_tMin, a_tMax, tEnter, tExit))
+		{
+			return false;
+		}
+
+		fp32 tCollision = 0.0f;
+		u32 stepCount = 0;
+		const bool bCollided = m_density.SampleCollision(a_ray, tEnter, tExit, tCollision, stepCount);
+
+		MediumStatistics& statistics = GetThreadMediumStatistics();
+		++statistics.TrackedRayCount;
+		statistics.StepCount += stepCount;
+		if (!bCollided)
+		{
+			return false;
+		}
+
+		++statistics.CollisionCount;
+
+		//Phase functions ignore the normal and uvs, they are filled with arbitrary but valid values.
+		a_info.Point = a_ray.At(tCollision);
+		a_info.Length = tCollision;
+		a_info.Normal = vath::Vector3f(1.0f, 0.0f, 0.0f);
+		a_info.FrontFace = true;
+		a_info.Material = m_phaseMaterial;
+		a_info.PrimitiveIndex = 0;
+		a_info.LightIndex = InvalidLightIndex;
+		a_info.UvCoord = vath::Vector2f(0.0f, 0.0f);
+		a_info.UvScale = 0.0f;
+		a_info.Velocity = vath::Vector3f(0.0f);
+		return true;
+	}
+
+	BoundingBox MediumVolume::GetBounds(const fp32 a_timeStart, const fp32 a_timeEnd) const
+	{
+		return m_pBoundary->GetBounds(a_timeStart, a_timeEnd);
+	}
+
+	fp32 MediumVolume::EstimateTransmittance(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax) const
+	{
+		fp32 tEnter = 0.0f;
+		fp32 tExit = 0.0f;
+		if (!GetBoundaryInterval(a_ray, a_tMin, a_tMax, tEnter, tExit))
+		{
+			return 1.0f;
+		}
+
+		u32 stepCount = 0;
+		const fp32 transmittance = m_density.EstimateTransmittance(a_ray, tEnter, tExit, stepCount);
+
+		MediumStatistics& statistics = GetThreadMediumStatistics();
+		++statistics.TrackedRayCount;
+		statistics.StepCount += stepCount;
+		return transmittance;
+	}
+
+	bool MediumVolume::GetBoundaryInterval(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, fp32& a_tEnter, fp32& a_tExit) const
+	{
+		//The boundary is intersected over the full line, rays starting inside the volume enter it behind their origin.
+		IntersectionInfo enterInfo;
+		if (!m_pBoundary->DoesIntersect(a_ray, -fp32max, fp32max, enterInfo))
+		{
+			return false;
+		}
+
+		IntersectionInfo exitInfo;
+		if (!m_pBoundary->DoesIntersect(a_ray, enterInfo.Length + 0.0001f, fp32max, exitInfo))
+		{
+			return false;
+		}
+
+		a_tEnter = vath::Max(enterInfo.Length, a_tMin);
+		a_tExit = vath::Min(exitInfo.Length, a_tMax);
+		return a_tEnter < a_tExit;
+	}
+}
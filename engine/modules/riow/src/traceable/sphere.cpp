@@ -1,14 +1,15 @@
 #include "riow/traceable/sphere.h"
+#include "riow/light.h"
 
 namespace dxray::riow
 {
-	Sphere::Sphere(const vath::Vector3& a_center, const fp32 a_radius, std::shared_ptr<Material> a_material) :
+	Sphere::Sphere(const vath::Vector3& a_center, const fp32 a_radius, const MaterialId a_material) :
 		m_translation(a_center, vath::Vector3f(0.0f)),
 		m_radius(a_radius),
 		m_material(a_material)
 	{ }
 
-    Sphere::Sphere(const vath::Vector3& a_frameStartCenter, const vath::Vector3& a_frameEndCenter, const fp32 a_radius, std::shared_ptr<Material> a_material /*= nullptr*/) :
+    Sphere::Sphere(const vath::Vector3& a_frameStartCenter, const vath::Vector3& a_frameEndCenter, const fp32 a_radius, const MaterialId a_material /*= InvalidResourceId*/) :
 		m_translation(a_frameStartCenter, a_frameEndCenter - a_frameStartCenter),
 		m_radius(std::fmaxf(0.0f, a_radius)),
 		m_material(a_material)
@@ -17,10 +18,61 @@ namespace dxray::riow
 	bool Sphere::DoesIntersect(const Ray& a_ray, const fp32 a_tMin, fp32 const a_tMax, IntersectionInfo& a_info) const
 	{
 		const vath::Vector3f centerAtTime = m_translation.At(a_ray.GetTime());
-		const vath::Vector3f rayFromCenter = centerAtTime - a_ray.GetOrigin();
+		fp32 t = 0.0f;
+		if (!IntersectRay(centerAtTime, m_radius, a_ray, a_tMin, a_tMax, t))
+		{
+			return false;
+		}
+
+		SetIntersectionInfo(centerAtTime, m_radius, m_translation.GetDirection(), m_material, a_ray, t, a_info);
+		a_info.PrimitiveIndex = 0;
+		return true;
+	}
+
+	bool Sphere::DoesOcclude(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax) const
+	{
+		fp32 t = 0.0f;
+		return IntersectRay(m_translation.At(a_ray.GetTime()), m_radius, a_ray, a_tMin, a_tMax, t);
+	}
+
+	BoundingBox Sphere::GetBounds(const fp32 a_timeStart, const fp32 a_timeEnd) const
+	{
+		//Motion is linear, the bounds at the start and end of the window enclose the full motion.
+		const vath::Vector3f extent(m_radius);
+		BoundingBox bounds;
+		bounds.Expand(m_translation.At(a_timeStart) - extent);
+		bounds.Expand(m_translation.At(a_timeStart) + extent);
+		bounds.Expand(m_translation.At(a_timeEnd) - extent);
+		bounds.Expand(m_translation.At(a_timeEnd) + extent);
+		return bounds;
+	}
+
+	void Sphere::GatherLights(const MaterialTable& a_materials, const u32 a_traceableIndex, LightList& a_lights) const
+	{
+		if (MaterialTable::IsEmissive(m_material))
+		{
+			a_lights.Add(SphereLight{ .Center = m_translation.GetOrigin(), .Radius = m_radius, .Velocity = m_translation.GetDirection(), .Material = m_material }, a_traceableIndex, 0);
+		}
+	}
+
+	vath::Vector2f Sphere::PointToUv(const vath::Vector3f& a_point)
+	{
+		//The point is a normal computed from the hit, rounding can push it just past the poles, where acos returns NaN.
+		const fp32 theta = std::acos(vath::Clamp(-a_point.y, -1.0f, 1.0f));
+		const fp32 phi = std::atan2(-a_point.z, a_point.x) + vath::Pi<fp32>();
+
+		return vath::Vector2f(
+			phi / (2.0f * vath::Pi<fp32>()),
+			theta / vath::Pi<fp32>()
+		);
+	}
+
+	bool Sphere::IntersectRay(const vath::Vector3f& a_center, const fp32 a_radius, const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, fp32& a_t)
+	{
+		const vath::Vector3f rayFromCenter = a_center - a_ray.GetOrigin();
 		const fp32 a = vath::SqrMagnitude(a_ray.GetDirection());
 		const fp32 h = vath::Dot(a_ray.GetDirection(), rayFromCenter);
-		const fp32 c = vath::SqrMagnitude(rayFromCenter) - m_radius * m_radius;
+		const fp32 c = vath::SqrMagnitude(rayFromCenter) - a_radius * a_radius;
 
 		const fp32 discriminant = h * h - a * c;
 		if (discriminant < 0.0f)
@@ -39,24 +91,20 @@ namespace dxray::riow
 			}
 		}
 
-		a_info.Point = a_ray.At(t);
-		a_info.Length = t;
-		a_info.Mat = m_material;
-		const vath::Vector3f outwardNormal = (a_info.Point - centerAtTime) / m_radius;
-		a_info.SetFaceNormal(a_ray, outwardNormal);
-		a_info.UvCoord = Sphere::PointToUv(outwardNormal);
-
+		a_t = t;
 		return true;
 	}
 
-	vath::Vector2f Sphere::PointToUv(const vath::Vector3f& a_point)
+	void Sphere::SetIntersectionInfo(const vath::Vector3f& a_center, const fp32 a_radius, const vath::Vector3f& a_velocity, const MaterialId a_material, const Ray& a_ray, const fp32 a_t, IntersectionInfo& a_info)
 	{
-		const fp32 theta = std::acos(-a_point.y);
-		const fp32 phi = std::atan2(-a_point.z, a_point.x) + vath::Pi<fp32>();
-
-		return vath::Vector2f(
-			phi / (2.0f * vath::Pi<fp32>()),
-			theta / vath::Pi<fp32>()
-		);
+		a_info.Point = a_ray.At(a_t);
+		a_info.Length = a_t;
+		a_info.Material = a_material;
+		a_info.LightIndex = InvalidLightIndex;
+		a_info.Velocity = a_velocity;
+		const vath::Vector3f outwardNormal = (a_info.Point - a_center) / a_radius;
+		a_info.SetFaceNormal(a_ray, outwardNormal);
+		a_info.UvCoord = Sphere::PointToUv(outwardNormal);
+		a_info.UvScale = 1.0f / (vath::Pi<fp32>() * a_radius); //v spans half the circumference.
 	}
-}
\ No newline at end of file
+}
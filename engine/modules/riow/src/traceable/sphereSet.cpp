@@ -0,0 +1,116 @@
+#include "riow/traceable/sphereSet.h"
+#include "riow/traceable/sphere.h"
+#include "riow/light.h"
+
+namespace dxray::riow
+{
+	static_assert(sizeof(SphereSet::Element) == 32, "Sphere set elements are stored as is in cooked scene files.");
+
+	SphereSet::SphereSet(std::vector<Element> a_spheres, const fp32 a_timeStart, const fp32 a_timeEnd)
+	{
+		DXRAY_ASSERT(!a_spheres.empty());
+
+		std::vector<BoundingBox> bounds(a_spheres.size());
+		for (usize si = 0; si < a_spheres.size(); ++si)
+		{
+			bounds[si] = GetElementBounds(a_spheres[si], a_timeStart, a_timeEnd);
+		}
+
+		std::vector<u32> sphereOrder;
+		m_hierarchy.Build(bounds, sphereOrder);
+
+		m_spheres.resize(a_spheres.size());
+		for (usize si = 0; si < sphereOrder.size(); ++si)
+		{
+			m_spheres[si] = a_spheres[sphereOrder[si]];
+		}
+	}
+
+	SphereSet::SphereSet(std::vector<Element> a_spheres, const BoundingVolumeHierarchy::Node* a_pNodes, const usize a_nodeCount) :
+		m_spheres(std::move(a_spheres))
+	{
+		DXRAY_ASSERT(!m_spheres.empty() && a_nodeCount > 0);
+		m_hierarchy.SetNodes(a_pNodes, a_nodeCount);
+	}
+
+	bool SphereSet::DoesIntersect(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax, IntersectionInfo& a_info) const
+	{
+		//Leaves only narrow down the closest sphere, the hit info is filled in once for it.
+		const Element* pHitSphere = nullptr;
+		fp32 tHit = a_tMax;
+		m_hierarchy.Traverse(a_ray, a_tMin, a_tMax, [&](const u32 a_first, const u32 a_count, fp32& a_closestHit)
+		{
+			bool bLeafHit = false;
+			for (u32 si = a_first; si < a_first + a_count; ++si)
+			{
+				const Element& sphere = m_spheres[si];
+				if (Sphere::IntersectRay(sphere.Center + sphere.Velocity * a_ray.GetTime(), sphere.Radius, a_ray, a_tMin, a_closestHit, a_closestHit))
+				{
+					pHitSphere = &sphere;
+					tHit = a_closestHit;
+					bLeafHit = true;
+				}
+			}
+
+			return bLeafHit;
+		});
+
+		if (pHitSphere == nullptr)
+		{
+			return false;
+		}
+
+		Sphere::SetIntersectionInfo(pHitSphere->Center + pHitSphere->Velocity * a_ray.GetTime(), pHitSphere->Radius, pHitSphere->Velocity, pHitSphere->Material, a_ray, tHit, a_info);
+		a_info.PrimitiveIndex = static_cast<u32>(pHitSphere - m_spheres.data());
+		return true;
+	}
+
+	bool SphereSet::DoesOcclude(const Ray& a_ray, const fp32 a_tMin, const fp32 a_tMax) const
+	{
+		//Any hit ends the traversal, a closest hit below every entry distance culls the remaining nodes.
+		return m_hierarchy.Traverse(a_ray, a_tMin, a_tMax, [&](const u32 a_first, const u32 a_count, fp32& a_closestHit)
+		{
+			for (u32 si = a_first; si < a_first + a_count; ++si)
+			{
+				const Element& sphere = m_spheres[si];
+				fp32 t = 0.0f;
+				if (Sphere::IntersectRay(sphere.Center + sphere.Velocity * a_ray.GetTime(), sphere.Radius, a_ray, a_tMin, a_closestHit, t))
+				{
+					a_closestHit = -fp32max;
+					return true;
+				}
+			}
+
+			return false;
+		});
+	}
+
+	BoundingBox SphereSet::GetBounds(const fp32 a_timeStart, const fp32 a_timeEnd) const
+	{
+		//#Note: The window is fixed when building the hierarchy, see the class description.
+		return m_hierarchy.GetBounds();
+	}
+
+	void SphereSet::GatherLights(const MaterialTable& a_materials, const u32 a_traceableIndex, LightList& a_lights) const
+	{
+		for (usize si = 0; si < m_spheres.size(); ++si)
+		{
+			const Element& sphere = m_spheres[si];
+			if (MaterialTable::IsEmissive(sphere.Material))
+			{
+				a_lights.Add(SphereLight{ .Center = sphere.Center, .Radius = sphere.Radius, .Velocity = sphere.Velocity, .Material = sphere.Material }, a_traceableIndex, static_cast<u32>(si));
+			}
+		}
+	}
+
+	BoundingBox SphereSet::GetElementBounds(const Element& a_sphere, const fp32 a_timeStart, const fp32 a_timeEnd)
+	{
+		const vath::Vector3f extent(a_sphere.Radius);
+		BoundingBox bounds;
+		bounds.Expand(a_sphere.Center + a_sphere.Velocity * a_timeStart - extent);
+		bounds.Expand(a_sphere.Center + a_sphere.Velocity * a_timeStart + extent);
+		bounds.Expand(a_sphere.Center + a_sphere.Velocity * a_timeEnd - extent);
+		bounds.Expand(a_sphere.Center + a_sphere.Velocity * a_timeEnd + extent);
+		return bounds;
+	}
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "core/fileSystem/fileIO.h"
+#include "core/fileSystem/mappedFile.h"
+
+using namespace dxray;
+
+TEST(MappedFile, MapsFileContents)
+{
+	const Path filePath = std::filesystem::temp_directory_path() / "dxrayMappedFileTest.bin";
+	std::vector<u32> values(10000);
+	for (u32 i = 0; i < values.size(); ++i)
+	{
+		values[i] = i * 2654435761u;
+	}
+
+	ASSERT_TRUE(WriteBinaryFile(filePath, DataBlob{ values.data(), values.size() * sizeof(u32) }));
+
+	MappedFile file;
+	ASSERT_TRUE(file.Open(filePath));
+	EXPECT_TRUE(file.IsOpen());
+	ASSERT_EQ(file.GetSizeInBytes(), values.size() * sizeof(u32));
+	EXPECT_EQ(std::memcmp(file.GetData(), values.data(), file.GetSizeInBytes()), 0);
+
+	//Moving transfers the mapping.
+	MappedFile movedFile = std::move(file);
+	EXPECT_FALSE(file.IsOpen());
+	EXPECT_TRUE(movedFile.IsOpen());
+	EXPECT_EQ(std::memcmp(movedFile.GetData(), values.data(), movedFile.GetSizeInBytes()), 0);
+
+	movedFile.Close();
+	EXPECT_FALSE(movedFile.IsOpen());
+	EXPECT_EQ(movedFile.GetSizeInBytes(), 0u);
+	std::filesystem::remove(filePath);
+}
+
+TEST(MappedFile, FailsOnMissingOrEmptyFile)
+{
+	MappedFile file;
+	EXPECT_FALSE(file.Open(std::filesystem::temp_directory_path() / "dxrayMappedFileTestMissing.bin"));
+	EXPECT_FALSE(file.IsOpen());
+
+	const Path emptyFilePath = std::filesystem::temp_directory_path() / "dxrayMappedFileTestEmpty.bin";
+	ASSERT_TRUE(WriteBinaryFile(emptyFilePath, DataBlob{ nullptr, 0 }));
+	EXPECT_FALSE(file.Open(emptyFilePath));
+	EXPECT_EQ(file.GetData(), nullptr);
+	std::filesystem::remove(emptyFilePath);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "core/vath/vath.h"
+
+using namespace dxray;
+using namespace dxray::vath;
+
+static void ExpectLanes(const Float8& a_value, const fp32 (&a_expected)[8])
+{
+	fp32 lanes[8];
+	a_value.Store(lanes);
+	for (usize i = 0; i < 8; ++i)
+	{
+		EXPECT_FLOAT_EQ(lanes[i], a_expected[i]);
+	}
+}
+
+TEST(Float8, Construction)
+{
+	const Float8 broadcast(2.5f);
+	const Float8 lanes(0, 1, 2, 3, 4, 5, 6, 7);
+	const fp32 data[9] = { -1, 1, 2, 3, 4, 5, 6, 7, 8 };
+	const Float8 loaded = Float8::Load(data + 1);
+
+	ExpectLanes(broadcast, { 2.5f, 2.5f, 2.5f, 2.5f, 2.5f, 2.5f, 2.5f, 2.5f });
+	ExpectLanes(lanes, { 0, 1, 2, 3, 4, 5, 6, 7 });
+	ExpectLanes(loaded, { 1, 2, 3, 4, 5, 6, 7, 8 });
+	EXPECT_EQ(lanes[5], 5.0f);
+}
+
+TEST(Float8, Arithmetic)
+{
+	const Float8 a(0, 1, 2, 3, 4, 5, 6, 7);
+	const Float8 b(8, 7, 6, 5, 4, 3, 2, 1);
+
+	ExpectLanes(a + b, { 8, 8, 8, 8, 8, 8, 8, 8 });
+	ExpectLanes(a - b, { -8, -6, -4, -2, 0, 2, 4, 6 });
+	ExpectLanes(a * b, { 0, 7, 12, 15, 16, 15, 12, 7 });
+	ExpectLanes(a / b, { 0.0f, 1.0f / 7.0f, 2.0f / 6.0f, 3.0f / 5.0f, 1.0f, 5.0f / 3.0f, 3.0f, 7.0f });
+	ExpectLanes(a * 0.5f, { 0, 0.5f, 1, 1.5f, 2, 2.5f, 3, 3.5f });
+
+	Float8 c = a;
+	c += b;
+	c *= Float8(2.0f);
+	ExpectLanes(c, { 16, 16, 16, 16, 16, 16, 16, 16 });
+}
+
+TEST(Float8, Functions)
+{
+	const Float8 a(0, 1, 4, 9, 16, 25, 36, 49);
+	const Float8 b(8, 7, 6, 5, 4, 3, 2, 1);
+
+	ExpectLanes(Sqrt(a), { 0, 1, 2, 3, 4, 5, 6, 7 });
+	ExpectLanes(Min(a, b), { 0, 1, 4, 5, 4, 3, 2, 1 });
+	ExpectLanes(Max(a, b), { 8, 7, 6, 9, 16, 25, 36, 49 });
+	ExpectLanes(MultiplyAdd(a, b, Float8(1.0f)), { 1, 8, 25, 46, 65, 76, 73, 50 });
+}
+
+TEST(Float8, Floor)
+{
+	const Float8 values(-2.5f, -1.0f, -0.25f, 0.0f, 0.25f, 1.0f, 1.75f, 1000.5f);
+	ExpectLanes(Floor(values), { -3, -1, -1, 0, 0, 1, 1, 1000 });
+}
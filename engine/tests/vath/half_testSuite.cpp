@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include "core/vath/vath.h"
+
+using namespace dxray;
+using namespace dxray::vath;
+
+TEST(Half, ExactValues)
+{
+	EXPECT_EQ(FloatToHalf(0.0f), 0x0000u);
+	EXPECT_EQ(FloatToHalf(-0.0f), 0x8000u);
+	EXPECT_EQ(FloatToHalf(1.0f), 0x3C00u);
+	EXPECT_EQ(FloatToHalf(-2.0f), 0xC000u);
+	EXPECT_EQ(FloatToHalf(65504.0f), 0x7BFFu);
+	EXPECT_EQ(HalfToFloat(0x3555u), 0.333251953125f);
+	EXPECT_EQ(HalfToFloat(FloatToHalf(1000.5f)), 1000.5f);
+}
+
+TEST(Half, SpecialValues)
+{
+	EXPECT_EQ(FloatToHalf(100000.0f), 0x7C00u);
+	EXPECT_EQ(FloatToHalf(-std::numeric_limits<fp32>::infinity()), 0xFC00u);
+	EXPECT_TRUE(std::isnan(HalfToFloat(FloatToHalf(std::numeric_limits<fp32>::quiet_NaN()))));
+
+	//Smallest denormal and values below it.
+	EXPECT_EQ(FloatToHalf(std::ldexp(1.0f, -24)), 0x0001u);
+	EXPECT_EQ(HalfToFloat(0x0001u), std::ldexp(1.0f, -24));
+	EXPECT_EQ(FloatToHalf(std::ldexp(1.0f, -26)), 0x0000u);
+}
+
+TEST(Half, Rounding)
+{
+	//1 + 2^-11 lies exactly between two halfs and rounds to the even one, anything above it rounds up.
+	EXPECT_EQ(FloatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3C00u);
+	EXPECT_EQ(FloatToHalf(1.0f + std::ldexp(1.0f, -11) + std::ldexp(1.0f, -20)), 0x3C01u);
+	EXPECT_EQ(FloatToHalf(1.0f + std::ldexp(3.0f, -11)), 0x3C02u);
+
+	for (fp32 value = 0.001f; value < 60000.0f; value *= 1.37f)
+	{
+		EXPECT_NEAR(HalfToFloat(FloatToHalf(value)), value, value * std::ldexp(1.0f, -11));
+	}
+}
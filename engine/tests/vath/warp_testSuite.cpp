@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include "core/vath/vath.h"
+
+using namespace dxray;
+using namespace dxray::vath;
+
+static constexpr u32 SampleCount = 1 << 20;
+static constexpr u32 CosThetaBinCount = 16;
+static constexpr u32 PhiBinCount = 32;
+
+/**
+ * @brief Uniform samples of the unit square from a fixed seed, so every run tests the same samples.
+ */
+class SquareSampler final
+{
+public:
+	Vector2f Next()
+	{
+		return Vector2f(m_distribution(m_generator), m_distribution(m_generator));
+	}
+
+private:
+	std::mt19937 m_generator{ 0x5eed };
+	std::uniform_real_distribution<fp32> m_distribution{ 0.0f, 1.0f };
+};
+
+/**
+ * @brief Bins warped directions by cos theta within [cosMin, 1] and by phi, and compares every bin against the integral of the pdf over the bin.
+ * Each bin count follows a binomial distribution, a correct warp stays within a few standard deviations of the expected count in every bin.
+ */
+template<typename TWarp, typename TPdf>
+static void ExpectDirectionsFollowPdf(TWarp a_warp, TPdf a_pdf, const fp64 a_cosMin)
+{
+	std::vector<u32> counts(CosThetaBinCount * PhiBinCount, 0u);
+	SquareSampler sampler;
+	for (u32 i = 0; i < SampleCount; ++i)
+	{
+		const Vector3f direction = a_warp(sampler.Next());
+		ASSERT_NEAR(Magnitude(direction), 1.0f, 1e-5f);
+		ASSERT_GE(direction.z, a_cosMin - 1e-6);
+
+		const fp64 phi = std::atan2(static_cast<fp64>(direction.y), static_cast<fp64>(direction.x)) + Pi<fp64>();
+		const u32 cosBin = Min(static_cast<u32>((direction.z - a_cosMin) / (1.0 - a_cosMin) * CosThetaBinCount), CosThetaBinCount - 1);
+		const u32 phiBin = Min(static_cast<u32>(phi / (2.0 * Pi<fp64>()) * PhiBinCount), PhiBinCount - 1);
+		counts[cosBin * PhiBinCount + phiBin]++;
+	}
+
+	//The pdf is integrated over each bin with the midpoint rule in theta and phi, steps in theta stay narrow around the pole where peaked densities
+	//such as GGX with low roughness change the fastest.
+	constexpr u32 SubdivisionCount = 16;
+	const fp64 cosExtent = (1.0 - a_cosMin) / CosThetaBinCount;
+	const fp64 phiExtent = 2.0 * Pi<fp64>() / PhiBinCount;
+	fp64 totalProbability = 0.0;
+	for (u32 cb = 0; cb < CosThetaBinCount; ++cb)
+	{
+		const fp64 thetaBegin = std::acos(Min(a_cosMin + cosExtent * (cb + 1), 1.0));
+		const fp64 thetaEnd = std::acos(a_cosMin + cosExtent * cb);
+		const fp64 thetaStep = (thetaEnd - thetaBegin) / SubdivisionCount;
+		for (u32 pb = 0; pb < PhiBinCount; ++pb)
+		{
+			fp64 probability = 0.0;
+			for (u32 ts = 0; ts < SubdivisionCount; ++ts)
+			{
+				const fp64 theta = thetaBegin + thetaStep * (ts + 0.5);
+				for (u32 ps = 0; ps < SubdivisionCount; ++ps)
+				{
+					const fp64 phi = phiExtent * (pb + (ps + 0.5) / SubdivisionCount) - Pi<fp64>();
+					const Vector3f direction(static_cast<fp32>(std::sin(theta) * std::cos(phi)), static_cast<fp32>(std::sin(theta) * std::sin(phi)), static_cast<fp32>(std::cos(theta)));
+					probability += a_pdf(direction) * std::sin(theta) * thetaStep * phiExtent / SubdivisionCount;
+				}
+			}
+
+			const fp64 expected = probability * SampleCount;
+			const fp64 standardDeviation = std::sqrt(Max(expected * (1.0 - probability), 1.0));
+			EXPECT_NEAR(static_cast<fp64>(counts[cb * PhiBinCount + pb]), expected, 5.0 * standardDeviation + 0.01 * expected)
+				<< "cos bin " << cb << ", phi bin " << pb;
+			totalProbability += probability;
+		}
+	}
+
+	EXPECT_NEAR(totalProbability, 1.0, 1e-2);
+}
+
+TEST(Warp, OrthonormalBasis)
+{
+	const Vector3f normals[] =
+	{
+		Vector3f(0.0f, 0.0f, 1.0f), Vector3f(0.0f, 0.0f, -1.0f), Vector3f(1.0f, 0.0f, 0.0f), Vector3f(0.0f, -1.0f, 0.0f),
+		Normalize(Vector3f(1.0f, 2.0f, 3.0f)), Normalize(Vector3f(-0.3f, 0.1f, -0.00001f)), Normalize(Vector3f(0.00001f, 0.00001f, -1.0f))
+	};
+
+	for (const Vector3f& normal : normals)
+	{
+		const OrthonormalBasis<fp32> basis(normal);
+		EXPECT_NEAR(Magnitude(basis.Tangent), 1.0f, 1e-5f);
+		EXPECT_NEAR(Magnitude(basis.Bitangent), 1.0f, 1e-5f);
+		EXPECT_NEAR(Dot(basis.Tangent, basis.Bitangent), 0.0f, 1e-5f);
+		EXPECT_NEAR(Dot(basis.Tangent, normal), 0.0f, 1e-5f);
+		EXPECT_NEAR(Dot(basis.Bitangent, normal), 0.0f, 1e-5f);
+		EXPECT_NEAR(Magnitude(Cross(basis.Tangent, basis.Bitangent) - normal), 0.0f, 1e-5f);
+
+		const Vector3f local(0.2f, -0.5f, 0.7f);
+		EXPECT_NEAR(Magnitude(basis.ToLocal(basis.ToWorld(local)) - local), 0.0f, 1e-5f);
+		EXPECT_NEAR(Magnitude(basis.ToWorld(Vector3f(0.0f, 0.0f, 1.0f)) - normal), 0.0f, 1e-6f);
+	}
+}
+
+TEST(Warp, ConcentricDisk)
+{
+	//Corners and center of the square map onto the border and center of the disk.
+	EXPECT_NEAR(Magnitude(SquareToConcentricDisk(Vector2f(0.5f, 0.5f))), 0.0f, 1e-6f);
+	EXPECT_NEAR(Magnitude(SquareToConcentricDisk(Vector2f(0.0f, 0.0f))), 1.0f, 1e-6f);
+	EXPECT_NEAR(Magnitude(SquareToConcentricDisk(Vector2f(1.0f, 0.5f)) - Vector2f(1.0f, 0.0f)), 0.0f, 1e-6f);
+	EXPECT_NEAR(Magnitude(SquareToConcentricDisk(Vector2f(0.5f, 1.0f)) - Vector2f(0.0f, 1.0f)), 0.0f, 1e-6f);
+
+	//Equal area rings and sectors receive equal shares of the samples.
+	constexpr u32 RingCount = 8;
+	constexpr u32 SectorCount = 16;
+	std::vector<u32> counts(RingCount * SectorCount, 0u);
+	SquareSampler sampler;
+	for (u32 i = 0; i < SampleCount; ++i)
+	{
+		const Vector2f point = SquareToConcentricDisk(sampler.Next());
+		const fp32 radiusSquared = point.x * point.x + point.y * point.y;
+		ASSERT_LE(radiusSquared, 1.0f + 1e-5f);
+
+		const fp64 angle = std::atan2(static_cast<fp64>(point.y), static_cast<fp64>(point.x)) + Pi<fp64>();
+		const u32 ring = Min(static_cast<u32>(radiusSquared * RingCount), RingCount - 1);
+		const u32 sector = Min(static_cast<u32>(angle / (2.0 * Pi<fp64>()) * SectorCount), SectorCount - 1);
+		counts[ring * SectorCount + sector]++;
+	}
+
+	const fp64 expected = static_cast<fp64>(SampleCount) / (RingCount * SectorCount);
+	for (const u32 count : counts)
+	{
+		EXPECT_NEAR(static_cast<fp64>(count), expected, 5.0 * std::sqrt(expected));
+	}
+
+	EXPECT_FLOAT_EQ(ConcentricDiskPdf<fp32>(), 1.0f / Pi<fp32>());
+}
+
+TEST(Warp, CosineHemisphere)
+{
+	ExpectDirectionsFollowPdf(
+		[](const Vector2f& a_sample) { return SquareToCosineHemisphere(a_sample); },
+		[](const Vector3f& a_direction) { return static_cast<fp64>(CosineHemispherePdf(a_direction.z)); },
+		0.0);
+
+	EXPECT_EQ(CosineHemispherePdf(-0.5f), 0.0f);
+}
+
+TEST(Warp, UniformSphere)
+{
+	ExpectDirectionsFollowPdf(
+		[](const Vector2f& a_sample) { return SquareToUniformSphere(a_sample); },
+		[](const Vector3f&) { return static_cast<fp64>(UniformSpherePdf<fp32>()); },
+		-1.0);
+}
+
+TEST(Warp, UniformCone)
+{
+	for (const fp32 oneMinusCosThetaMax : { 2.0f, 0.3f, 1e-3f })
+	{
+		ExpectDirectionsFollowPdf(
+			[&](const Vector2f& a_sample) { return SquareToUniformCone(a_sample, oneMinusCosThetaMax); },
+			[&](const Vector3f&) { return static_cast<fp64>(UniformConePdf(oneMinusCosThetaMax)); },
+			1.0 - oneMinusCosThetaMax);
+	}
+
+	//Narrow cones keep their width, the cosine of their directions would round to 1.
+	const Vector3f narrow = SquareToUniformCone(Vector2f(1.0f, 0.0f), 1e-10f);
+	EXPECT_NEAR(narrow.x, std::sqrt(2e-10f), 1e-9f);
+}
+
+TEST(Warp, SphereCone)
+{
+	EXPECT_EQ(SphereConeOneMinusCos(0.5f, 1.0f), 0.0f);
+	EXPECT_EQ(SphereConeOneMinusCos(1.0f, 1.0f), 0.0f);
+	EXPECT_NEAR(SphereConeOneMinusCos(4.0f, 1.0f), 1.0f - std::cos(Pi<fp32>() / 6.0f), 1e-6f);
+
+	//A sphere of radius 1 at a distance of 1e4 covers a cone of half angle asin(1e-4).
+	const fp64 expected = 1.0 - std::cos(std::asin(1e-4));
+	EXPECT_NEAR(SphereConeOneMinusCos(1e8f, 1.0f), expected, expected * 1e-4);
+}
+
+TEST(Warp, GgxDistributionIsNormalized)
+{
+	//The projected microfacet area covers the macro surface exactly: the integral of D(h) cos(h) over the hemisphere is 1.
+	constexpr u32 CosStepCount = 2048;
+	constexpr u32 PhiStepCount = 64;
+	for (const Vector2f alpha : { Vector2f(0.5f, 0.5f), Vector2f(0.2f, 0.6f), Vector2f(0.9f, 0.9f) })
+	{
+		fp64 integral = 0.0;
+		for (u32 ci = 0; ci < CosStepCount; ++ci)
+		{
+			const fp64 cosTheta = (ci + 0.5) / CosStepCount;
+			const fp64 sinTheta = std::sqrt(1.0 - cosTheta * cosTheta);
+			for (u32 pi = 0; pi < PhiStepCount; ++pi)
+			{
+				const fp64 phi = 2.0 * Pi<fp64>() * (pi + 0.5) / PhiStepCount;
+				const Vector3f normal(static_cast<fp32>(sinTheta * std::cos(phi)), static_cast<fp32>(sinTheta * std::sin(phi)), static_cast<fp32>(cosTheta));
+				integral += GgxDistribution(normal, alpha.x, alpha.y) * cosTheta * (2.0 * Pi<fp64>() / (CosStepCount * PhiStepCount));
+			}
+		}
+
+		EXPECT_NEAR(integral, 1.0, 1e-2);
+	}
+
+	EXPECT_EQ(GgxDistribution(Vector3f(0.0f, 0.0f, -1.0f), 0.5f, 0.5f), 0.0f);
+}
+
+TEST(Warp, GgxMasking)
+{
+	EXPECT_NEAR(GgxSmithMasking(Vector3f(0.0f, 0.0f, 1.0f), 0.5f, 0.5f), 1.0f, 1e-6f);
+	EXPECT_EQ(GgxSmithMasking(Vector3f(0.0f, 1.0f, -0.1f), 0.5f, 0.5f), 0.0f);
+
+	//Grazing directions and rougher surfaces are masked more.
+	const Vector3f grazing = Normalize(Vector3f(1.0f, 0.0f, 0.1f));
+	EXPECT_LT(GgxSmithMasking(grazing, 0.5f, 0.5f), GgxSmithMasking(Normalize(Vector3f(1.0f, 0.0f, 1.0f)), 0.5f, 0.5f));
+	EXPECT_LT(GgxSmithMasking(grazing, 0.8f, 0.8f), GgxSmithMasking(grazing, 0.2f, 0.2f));
+}
+
+TEST(Warp, GgxVisibleNormals)
+{
+	const Vector3f directions[] = { Vector3f(0.0f, 0.0f, 1.0f), Normalize(Vector3f(0.6f, -0.3f, 0.5f)), Normalize(Vector3f(-1.0f, 0.2f, 0.15f)) };
+	for (const Vector3f& direction : directions)
+	{
+		for (const Vector2f alpha : { Vector2f(0.3f, 0.3f), Vector2f(0.15f, 0.7f) })
+		{
+			ExpectDirectionsFollowPdf(
+				[&](const Vector2f& a_sample)
+				{
+					const Vector3f normal = SampleGgxVisibleNormal(direction, alpha.x, alpha.y, a_sample);
+					EXPECT_GE(Dot(normal, direction), -1e-5f);
+					return normal;
+				},
+				[&](const Vector3f& a_normal) { return static_cast<fp64>(GgxVisibleNormalPdf(direction, a_normal, alpha.x, alpha.y)); },
+				0.0);
+		}
+	}
+}